@@ -10,11 +10,20 @@
 
 #include "mode.h"
 
+/*** AT macros ***/
+
+#define AT_RESPONSE_BUFFER_LENGTH	128 // Allocated in arena while a response is built.
+
+/*** AT structures ***/
+
+typedef void (*AT_response_callback_t)(char* response);
+
 /*** AT functions ***/
 
 void AT_init(void);
 void AT_task(void);
 void AT_fill_rx_buffer(unsigned char rx_byte);
 void AT_print_test_result(unsigned char status, int rssi);
+void AT_set_response_callback(AT_response_callback_t callback);
 
 #endif /* AT_H */
@@ -0,0 +1,25 @@
+/*
+ * at_bench.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef AT_BENCH_H
+#define AT_BENCH_H
+
+#include "mode.h"
+
+/*** AT BENCH macros ***/
+
+#ifndef AT_BENCH_ITERATIONS
+#define AT_BENCH_ITERATIONS		100 // Number of times each scenario is replayed.
+#endif
+
+/*** AT BENCH functions ***/
+
+#ifdef AT_BENCH
+void AT_BENCH_run(void);
+#endif
+
+#endif /* AT_BENCH_H */
@@ -23,7 +23,8 @@
 
 typedef enum {
 	UHFM_SUCCESS = 0,
-	UHFM_ERROR_BASE_PARSER = 0x0100
+	UHFM_ERROR_BASE_PARSER = 0x0100,
+	UHFM_ERROR_BASE_TELEMETRY = 0x0200
 } UHFM_status_t;
 
 #endif /* ERROR_H */
@@ -0,0 +1,30 @@
+/*
+ * scheduler.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/*** SCHEDULER structures ***/
+
+// Events are processed in enumeration order (highest priority first).
+typedef enum {
+	SCHEDULER_EVENT_TIMER = 0,
+	SCHEDULER_EVENT_AT,
+	SCHEDULER_EVENT_TELEMETRY,
+	SCHEDULER_EVENT_LAST
+} SCHEDULER_event_t;
+
+typedef void (*SCHEDULER_handler_t)(void);
+
+/*** SCHEDULER functions ***/
+
+void SCHEDULER_init(void);
+void SCHEDULER_register_task(SCHEDULER_event_t event, SCHEDULER_handler_t handler);
+void SCHEDULER_post_event(SCHEDULER_event_t event);
+void SCHEDULER_run(void);
+
+#endif /* SCHEDULER_H */
@@ -0,0 +1,49 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+/*** TELEMETRY macros ***/
+
+#define TELEMETRY_MAX_AGE_SECONDS_DEFAULT	60
+#define TELEMETRY_SUPPLY_DEFER_MAX_SECONDS	10 // Must be lower than the watchdog period.
+
+/*** TELEMETRY structures ***/
+
+typedef enum {
+	TELEMETRY_SUPPLY_OK = 0,
+	TELEMETRY_SUPPLY_LOW,
+	TELEMETRY_SUPPLY_LAST
+} TELEMETRY_supply_status_t;
+
+typedef struct {
+	unsigned int voltage_rf_mv;
+	unsigned int voltage_idle_mv;
+	unsigned int voltage_tx_mv;
+	signed char temperature_degrees;
+	unsigned int idle_age_seconds;
+	unsigned char voltage_tx_valid;
+	TELEMETRY_supply_status_t supply_status;
+} TELEMETRY_data_t;
+
+/*** TELEMETRY functions ***/
+
+void TELEMETRY_init(void);
+void TELEMETRY_set_max_age(unsigned int max_age_seconds);
+unsigned int TELEMETRY_get_max_age(void);
+void TELEMETRY_refresh(void);
+void TELEMETRY_task(void);
+void TELEMETRY_start_tx_capture(void);
+void TELEMETRY_capture_tx(void);
+void TELEMETRY_stop_tx_capture(void);
+void TELEMETRY_set_supply_limits(unsigned int vrf_limit_mv, unsigned int vmcu_limit_mv);
+void TELEMETRY_get_supply_limits(unsigned int* vrf_limit_mv, unsigned int* vmcu_limit_mv);
+TELEMETRY_supply_status_t TELEMETRY_check_supply(void);
+void TELEMETRY_get_data(TELEMETRY_data_t* telemetry_data);
+
+#endif /* TELEMETRY_H */
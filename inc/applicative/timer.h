@@ -0,0 +1,37 @@
+/*
+ * timer.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+/*** TIMER macros ***/
+
+#define TIMER_RESOLUTION_MS		1 // Granularity of the underlying time base (LPTIM1 monotonic clock).
+
+/*** TIMER structures ***/
+
+typedef void (*TIMER_callback_t)(void);
+
+typedef struct TIMER_t {
+	unsigned int deadline_ms;
+	unsigned int period_ms;
+	TIMER_callback_t callback;
+	volatile unsigned char running;
+	struct TIMER_t* next;
+} TIMER_t;
+
+/*** TIMER functions ***/
+
+void TIMER_init(void);
+unsigned int TIMER_get_time_ms(void);
+void TIMER_start(TIMER_t* timer, unsigned int duration_ms, unsigned int period_ms, TIMER_callback_t callback);
+void TIMER_stop(TIMER_t* timer);
+unsigned char TIMER_is_running(TIMER_t* timer);
+void TIMER_task(void);
+void TIMER_wait(TIMER_t* timer, volatile unsigned char* wake_up_flag);
+
+#endif /* TIMER_H */
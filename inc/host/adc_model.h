@@ -0,0 +1,32 @@
+/*
+ * adc_model.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef ADC_MODEL_H
+#define ADC_MODEL_H
+
+/*** ADC MODEL macros ***/
+
+#define ADC_MODEL_VMCU_DEFAULT_MV		3300
+#define ADC_MODEL_VRF_DEFAULT_MV		5000 // Before the resistor divider.
+#define ADC_MODEL_TMCU_DEFAULT_DEGREES	25
+#define ADC_MODEL_RAW_VALUE_NONE		(-1)
+
+/*** ADC MODEL structures ***/
+
+typedef enum {
+	ADC_MODEL_INPUT_VRF = 0,
+	ADC_MODEL_INPUT_VREFINT,
+	ADC_MODEL_INPUT_TMCU,
+	ADC_MODEL_INPUT_LAST
+} ADC_MODEL_input_t;
+
+/*** ADC MODEL functions ***/
+
+void ADC_MODEL_trigger(void);
+void ADC_MODEL_set_raw_value(ADC_MODEL_input_t input, int raw_value);
+
+#endif /* ADC_MODEL_H */
@@ -0,0 +1,28 @@
+/*
+ * bus.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef BUS_H
+#define BUS_H
+
+/*** BUS macros ***/
+
+#define BUS_ACCESS_CYCLES	8 // Core cycles charged for each peripheral access (wait states and polling loop overhead).
+
+/*** BUS structures ***/
+
+// Called before a read access (offset from peripheral base address), the model updates its registers so that the firmware reads the current value.
+typedef void (*BUS_read_callback_t)(unsigned int offset);
+// Called after a write access, with the previous value of the written 32-bits register (write-1-to-clear and key registers).
+typedef void (*BUS_write_callback_t)(unsigned int offset, unsigned int previous_value);
+
+/*** BUS functions ***/
+
+void* BUS_map_peripheral(unsigned long base_address, unsigned int size, BUS_read_callback_t read_callback, BUS_write_callback_t write_callback);
+unsigned int BUS_read(unsigned long address, unsigned char size_bytes);
+void BUS_write(unsigned long address, unsigned int value, unsigned char size_bytes);
+
+#endif /* BUS_H */
@@ -0,0 +1,40 @@
+/*
+ * dbpsk_model.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef DBPSK_MODEL_H
+#define DBPSK_MODEL_H
+
+#include "rf_api_ext.h"
+
+/*** DBPSK MODEL macros ***/
+
+#define DBPSK_MODEL_STREAM_SIZE_MAX			32
+#define DBPSK_MODEL_SYMBOL_LENGTH_BYTES		RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES
+// FIFO bytes of a stream: ramp-up, one symbol per bit, ramp-down and padding.
+#define DBPSK_MODEL_FIFO_LENGTH(stream_size)	((3 + (8 * (stream_size))) * DBPSK_MODEL_SYMBOL_LENGTH_BYTES)
+
+/*** DBPSK MODEL structures ***/
+
+typedef enum {
+	DBPSK_MODEL_SUCCESS = 0,
+	DBPSK_MODEL_ERROR_LENGTH,
+	DBPSK_MODEL_ERROR_RAMP_UP,
+	DBPSK_MODEL_ERROR_SYMBOL,
+	DBPSK_MODEL_ERROR_PHASE,
+	DBPSK_MODEL_ERROR_RAMP_DOWN,
+	DBPSK_MODEL_ERROR_MISMATCH,
+	DBPSK_MODEL_ERROR_LAST
+} DBPSK_MODEL_status_t;
+
+/*** DBPSK MODEL functions ***/
+
+DBPSK_MODEL_status_t DBPSK_MODEL_encode(unsigned char* stream, unsigned char stream_size, unsigned char* fifo, unsigned int fifo_size);
+DBPSK_MODEL_status_t DBPSK_MODEL_decode(unsigned char* fifo, unsigned int fifo_length, unsigned char* stream, unsigned char stream_size_max, unsigned int* number_of_bits, unsigned int* error_idx);
+void DBPSK_MODEL_start_frame(void);
+DBPSK_MODEL_status_t DBPSK_MODEL_check_frame(unsigned char* stream, unsigned char stream_size);
+
+#endif /* DBPSK_MODEL_H */
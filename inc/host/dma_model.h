@@ -0,0 +1,26 @@
+/*
+ * dma_model.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef DMA_MODEL_H
+#define DMA_MODEL_H
+
+/*** DMA MODEL structures ***/
+
+// Peripherals requests handled by the model.
+typedef enum {
+	DMA_MODEL_REQUEST_ADC = 0,
+	DMA_MODEL_REQUEST_AES_IN,
+	DMA_MODEL_REQUEST_AES_OUT,
+	DMA_MODEL_REQUEST_SPI1_TX,
+	DMA_MODEL_REQUEST_LAST
+} DMA_MODEL_request_t;
+
+/*** DMA MODEL functions ***/
+
+void DMA_MODEL_set_request(DMA_MODEL_request_t request, unsigned char level);
+
+#endif /* DMA_MODEL_H */
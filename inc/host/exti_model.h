@@ -0,0 +1,22 @@
+/*
+ * exti_model.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef EXTI_MODEL_H
+#define EXTI_MODEL_H
+
+/*** EXTI MODEL macros ***/
+
+#define EXTI_MODEL_LINE_GPIO_LAST	15
+#define EXTI_MODEL_LINE_RTC_ALARM	17
+#define EXTI_MODEL_LINE_RTC_WAKEUP	20
+
+/*** EXTI MODEL functions ***/
+
+unsigned char EXTI_MODEL_edge(unsigned char line, unsigned char rising);
+unsigned char EXTI_MODEL_gpio_edge(unsigned char port_index, unsigned char pin_index, unsigned char rising);
+
+#endif /* EXTI_MODEL_H */
@@ -0,0 +1,27 @@
+/*
+ * gpio_model.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef GPIO_MODEL_H
+#define GPIO_MODEL_H
+
+#include "gpio.h"
+
+/*** GPIO MODEL macros ***/
+
+#define GPIO_MODEL_PORT_NUMBER	4 // GPIOA to GPIOD.
+
+/*** GPIO MODEL structures ***/
+
+// Called when the level driven by the MCU on a pin changes.
+typedef void (*GPIO_MODEL_callback_t)(unsigned char state);
+
+/*** GPIO MODEL functions ***/
+
+void GPIO_MODEL_set_callback(const GPIO_pin_t* gpio, GPIO_MODEL_callback_t callback);
+unsigned char GPIO_MODEL_set_input(const GPIO_pin_t* gpio, unsigned char level);
+
+#endif /* GPIO_MODEL_H */
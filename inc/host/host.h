@@ -0,0 +1,58 @@
+/*
+ * host.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+#include "nvic.h"
+
+/*** HOST macros ***/
+
+#define HOST_EOF_EXIT_DELAY_MS				60000 // Virtual time simulated after end of input before exiting (pending Sigfox sequences).
+#define HOST_CONSTRUCTOR_PRIORITY_CORE		101 // Memory map and interrupt controller.
+#define HOST_CONSTRUCTOR_PRIORITY_MODEL		102 // Peripherals models (registers mapping and reset values).
+
+/*** HOST structures ***/
+
+typedef void (*HOST_event_callback_t)(void);
+typedef void (*HOST_rx_callback_t)(unsigned char rx_byte);
+
+// Virtual hardware event (timer expiry, end of transfer, etc), callback is executed from the host core and usually sets an interrupt pending.
+typedef struct HOST_event_t {
+	unsigned long long deadline_ns;
+	HOST_event_callback_t callback;
+	unsigned char armed;
+	struct HOST_event_t* next;
+} HOST_event_t;
+
+/*** HOST functions ***/
+
+// Virtual time.
+unsigned long long HOST_get_time_ns(void);
+unsigned long long HOST_get_time_us(void);
+void HOST_start_event(HOST_event_t* event, unsigned long long delay_us, HOST_event_callback_t callback);
+void HOST_start_event_at(HOST_event_t* event, unsigned long long deadline_ns, HOST_event_callback_t callback);
+void HOST_stop_event(HOST_event_t* event);
+// Core clock.
+void HOST_set_sysclk_khz(unsigned int sysclk_khz);
+unsigned int HOST_get_sysclk_khz(void);
+void HOST_consume_cycles(unsigned int cycles);
+void HOST_set_wake_up_callback(HOST_event_callback_t callback);
+// Core instructions and interrupt controller.
+void HOST_set_irq_pending(NVIC_interrupt_t it_num);
+unsigned char HOST_is_irq_ready(void);
+void HOST_dispatch_interrupts(void);
+void HOST_disable_interrupts(void);
+void HOST_enable_interrupts(void);
+unsigned int HOST_get_primask(void);
+void HOST_set_primask(unsigned int primask);
+void HOST_wait_for_interrupt(void);
+// Standard input.
+void HOST_set_rx_callback(HOST_rx_callback_t callback, unsigned int byte_duration_us);
+void HOST_set_rx_enable(unsigned char enable);
+
+#endif /* HOST_H */
@@ -0,0 +1,45 @@
+/*
+ * s2lp_model.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef S2LP_MODEL_H
+#define S2LP_MODEL_H
+
+/*** S2LP MODEL macros ***/
+
+#define S2LP_MODEL_RX_QUEUE_LENGTH			4
+#define S2LP_MODEL_RX_FRAME_LENGTH_MAX		32
+#define S2LP_MODEL_RX_RSSI_DEFAULT_DBM		-100
+#define S2LP_MODEL_RX_DELAY_DEFAULT_MS		1000 // Delay between RX command and end of frame reception.
+#define S2LP_MODEL_TX_CAPTURE_LENGTH_MAX	20480 // Longest uplink frame is 16880 FIFO bytes.
+
+/*** S2LP MODEL structures ***/
+
+// Statistics of the last transmission.
+typedef struct {
+	unsigned int fifo_bytes_sent;
+	unsigned int duration_us;
+	unsigned char fifo_level_min; // Lowest TX FIFO level reached before a refill (timing margin).
+	unsigned int fifo_underflow_count;
+	unsigned int fifo_overflow_count;
+} S2LP_MODEL_tx_statistics_t;
+
+// Cumulated MCU activity on the chip interface.
+typedef struct {
+	unsigned int spi_byte_count;
+	unsigned int gpio0_interrupt_count;
+} S2LP_MODEL_activity_t;
+
+/*** S2LP MODEL functions ***/
+
+unsigned char S2LP_MODEL_spi_transfer(unsigned char mosi);
+void S2LP_MODEL_inject_rx_frame(unsigned char* frame, unsigned char frame_length_bytes, signed short rssi_dbm, unsigned int delay_ms);
+unsigned char S2LP_MODEL_get_register(unsigned char addr);
+void S2LP_MODEL_get_tx_statistics(S2LP_MODEL_tx_statistics_t* tx_statistics);
+void S2LP_MODEL_get_tx_capture(unsigned char** capture, unsigned int* capture_length);
+void S2LP_MODEL_get_activity(S2LP_MODEL_activity_t* activity);
+
+#endif /* S2LP_MODEL_H */
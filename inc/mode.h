@@ -17,6 +17,18 @@
 
 //#define DEBUG		// Use programming pins for debug purpose if defined.
 
+/*** Benchmark mode ***/
+
+//#define AT_BENCH	// Replay synthetic AT traffic and print throughput, latency and stack reports at startup if defined.
+
+/*** Trace mode ***/
+
+//#define TRACE		// Record interrupts, S2LP commands and Sigfox callbacks in a RAM ring (dumped with AT$TRC?) if defined.
+
+/*** Probe mode ***/
+
+//#define PROBE		// Drive GPIO_TP1 to GPIO_TP3 at uplink, SPI, stop mode and AT decode events (see probe.h) if defined.
+
 /*** Error management ***/
 
 #if (defined ATM && defined NM)
@@ -23,6 +23,9 @@ typedef enum {
 void ADC1_init(void);
 void ADC1_disable(void);
 void ADC1_perform_measurements(void);
+void ADC1_start_supply_watchdog(unsigned int vrf_threshold_mv, unsigned int vmcu_threshold_mv);
+void ADC1_stop_supply_watchdog(void);
+unsigned char ADC1_get_supply_watchdog_flag(void);
 void ADC1_get_data(ADC_data_index_t data_idx, unsigned int* data);
 void ADC1_get_tmcu_comp2(signed char* tmcu_degrees);
 void ADC1_get_tmcu_comp1(unsigned char* tmcu_degrees);
@@ -12,10 +12,18 @@
 
 #define AES_BLOCK_SIZE 	16 // 128-bits is 16 bytes.
 
+// AES peripheral is only embedded in the crypto devices of the STM32L0 family (STM32L021, STM32L041, STM32L06x and STM32L08x).
+#ifdef HW1_0
+#define AES_PERIPHERAL_AVAILABLE	// STM32L041K6U6.
+#endif
+
 /*** AES functions ***/
 
 void AES_init(void);
 void AES_disable(void);
-void AES_encrypt(unsigned char data_in[AES_BLOCK_SIZE], unsigned char data_out[AES_BLOCK_SIZE], unsigned char init_vector[AES_BLOCK_SIZE], unsigned char key[AES_BLOCK_SIZE]);
+void AES_set_key(unsigned char key[AES_BLOCK_SIZE]);
+void AES_start_cbc(unsigned int* data_in, unsigned int* data_out, unsigned char number_of_blocks, unsigned char init_vector[AES_BLOCK_SIZE]);
+unsigned char AES_get_cbc_status(void);
+void AES_stop_cbc(void);
 
 #endif /* AES_H_ */
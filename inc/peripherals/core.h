@@ -0,0 +1,32 @@
+/*
+ * core.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef CORE_H
+#define CORE_H
+
+#ifdef HOST
+#include "host.h"
+#endif
+
+/*** CORE macros ***/
+
+// Cortex-M0+ instructions which have no memory mapped equivalent (executed by the virtual core on host).
+#ifdef HOST
+#define CORE_wait_for_interrupt()			HOST_wait_for_interrupt()
+#define CORE_disable_interrupts()			HOST_disable_interrupts()
+#define CORE_enable_interrupts()			HOST_enable_interrupts()
+#define CORE_save_primask(primask)			do { (primask) = HOST_get_primask(); HOST_disable_interrupts(); } while (0)
+#define CORE_restore_primask(primask)		HOST_set_primask(primask)
+#else
+#define CORE_wait_for_interrupt()			__asm volatile ("wfi")
+#define CORE_disable_interrupts()			__asm volatile ("cpsid i")
+#define CORE_enable_interrupts()			__asm volatile ("cpsie i")
+#define CORE_save_primask(primask)			do { __asm volatile ("mrs %0, primask" : "=r" (primask)); __asm volatile ("cpsid i"); } while (0)
+#define CORE_restore_primask(primask)		__asm volatile ("msr primask, %0" : : "r" (primask))
+#endif
+
+#endif /* CORE_H */
@@ -10,6 +10,18 @@
 
 /*** DMA functions ***/
 
+void DMA1_init_channel1(void);
+void DMA1_start_channel1(void);
+void DMA1_stop_channel1(void);
+void DMA1_set_channel1_source_addr(unsigned int source_buf_addr, unsigned short source_buf_size);
+void DMA1_init_channel1_adc(void);
+void DMA1_set_channel1_dest_addr(unsigned int dest_buf_addr, unsigned short dest_buf_size);
+unsigned char DMA1_get_channel1_status(void);
+void DMA1_init_channel2(void);
+void DMA1_start_channel2(void);
+void DMA1_stop_channel2(void);
+void DMA1_set_channel2_dest_addr(unsigned int dest_buf_addr, unsigned short dest_buf_size);
+unsigned char DMA1_get_channel2_status(void);
 void DMA1_init_channel3(void);
 void DMA1_start_channel3(void);
 void DMA1_stop_channel3(void);
@@ -8,11 +8,21 @@
 #ifndef LPTIM_H
 #define LPTIM_H
 
+/*** LPTIM macros ***/
+
+#define LPTIM_PRESCALER_LOG2			3 // LSE / 8.
+#define LPTIM_TICK_FREQUENCY_LOG2		(15 - LPTIM_PRESCALER_LOG2)
+#define LPTIM_TICK_FREQUENCY_HZ			(0b1 << LPTIM_TICK_FREQUENCY_LOG2) // 4096Hz (244us resolution).
+
 /*** LPTIM functions ***/
 
 void LPTIM1_init(void);
 void LPTIM1_enable(void);
 void LPTIM1_disable(void);
+unsigned long long LPTIM1_get_timestamp_ticks_64(void);
+unsigned int LPTIM1_get_timestamp_ticks(void);
+unsigned int LPTIM1_get_timestamp_us(void);
+unsigned int LPTIM1_get_timestamp_ms(void);
 void LPTIM1_delay_milliseconds(unsigned int delay_ms, unsigned char stop_mode);
 
 #endif /* LPTIM_H */
@@ -0,0 +1,33 @@
+/*
+ * mem.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef MEM_H
+#define MEM_H
+
+/*** MEM macros ***/
+
+#define MEM_STACK_PATTERN	0xA5A5A5A5 // Must match __STARTUP_STACK_PATTERN of startup_ARMCM0plus.c.
+
+/*** MEM structures ***/
+
+typedef struct {
+	unsigned int flash_bytes; // Code, constants and .data initial values.
+	unsigned int ramfunc_bytes; // Functions copied to RAM (included in flash_bytes and data_bytes).
+	unsigned int data_bytes;
+	unsigned int bss_bytes;
+	unsigned int heap_bytes;
+	unsigned int stack_bytes;
+	unsigned int stack_used_bytes; // High-water mark since reset (kept over MEM_paint_stack calls).
+} MEM_statistics_t;
+
+/*** MEM functions ***/
+
+unsigned int MEM_get_stack_used(void);
+void MEM_get_statistics(MEM_statistics_t* statistics);
+void MEM_paint_stack(void);
+
+#endif /* MEM_H */
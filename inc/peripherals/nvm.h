@@ -17,15 +17,24 @@
 #define NVM_ADDRESS_SIGFOX_MESSAGE_COUNTER				22
 #define NVM_ADDRESS_FH				24
 #define NVM_ADDRESS_SIGFOX_FH				26
-// Device configuration (mapped on downlink frame).
+// Device configuration (mapped on downlink frame, 8 bytes).
 #define NVM_ADDRESS_DEVICE_CONFIGURATION				27
+// Sigfox payload encryption flag.
+#define NVM_ADDRESS_SIGFOX_PAYLOAD_ENCRYPTION				35
+// Supply monitoring thresholds (16-bits values in mV, little endian).
+#define NVM_ADDRESS_VRF_LIMIT_MV				36
+#define NVM_ADDRESS_VMCU_LIMIT_MV				38
 
 /*** NVM functions ***/
 
+void NVM_init(void);
 void NVM_enable(void);
 void NVM_disable(void);
 void NVM_read_byte(unsigned short address_offset, unsigned char* byte_to_read);
 void NVM_write_byte(unsigned short address_offset, unsigned char byte_to_store);
+void NVM_write_byte_deferred(unsigned short address_offset, unsigned char byte_to_store);
+void NVM_flush(void);
+unsigned char NVM_is_busy(void);
 void NVM_reset_default(void);
 
 #endif /* NVM_H */
@@ -0,0 +1,47 @@
+/*
+ * probe.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef PROBE_H
+#define PROBE_H
+
+#include "gpio_reg.h"
+#include "mode.h"
+
+/*** PROBE macros ***/
+
+// Test point driven by each probe (1 to 3, 0 to disable the probe).
+#ifndef PROBE_UPLINK_REFILL_TP
+#define PROBE_UPLINK_REFILL_TP	1 // High from S2LP FIFO empty interrupt entry to DMA refill complete.
+#endif
+#ifndef PROBE_SPI_BURST_TP
+#define PROBE_SPI_BURST_TP		2 // High during S2LP FIFO SPI burst.
+#endif
+#ifndef PROBE_STOP_MODE_TP
+#define PROBE_STOP_MODE_TP		3 // High while MCU is in stop mode.
+#endif
+#ifndef PROBE_AT_DECODE_TP
+#define PROBE_AT_DECODE_TP		0 // High during AT command decoding and execution.
+#endif
+
+// Test points are on GPIOA (must match GPIO_TP1 to GPIO_TP3 of mapping.h).
+#define PROBE_TP1_PIN_INDEX		0
+#define PROBE_TP2_PIN_INDEX		5
+#define PROBE_TP3_PIN_INDEX		12
+#define PROBE_PIN_MASK(tp)		(((tp) == 1) ? (0b1 << PROBE_TP1_PIN_INDEX) : (((tp) == 2) ? (0b1 << PROBE_TP2_PIN_INDEX) : (((tp) == 3) ? (0b1 << PROBE_TP3_PIN_INDEX) : 0)))
+
+/*** PROBE functions ***/
+
+#ifdef PROBE
+// Single store to BSRR (BR bits are located 16 bits above BS bits).
+#define PROBE_high(tp)	do { if ((tp) != 0) GPIOA -> BSRR = PROBE_PIN_MASK(tp); } while (0)
+#define PROBE_low(tp)	do { if ((tp) != 0) GPIOA -> BSRR = (PROBE_PIN_MASK(tp) << 16); } while (0)
+#else
+#define PROBE_high(tp)
+#define PROBE_low(tp)
+#endif
+
+#endif /* PROBE_H */
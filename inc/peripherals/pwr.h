@@ -8,10 +8,40 @@
 #ifndef PWR_H
 #define PWR_H
 
+/*** PWR macros ***/
+
+#define PWR_STATISTICS_MS_MAX	0x7FFFFFFF // Residency durations saturate after ~24.8 days (AT$PWRR restarts accounting).
+
+/*** PWR structures ***/
+
+typedef enum {
+	PWR_MODE_SLEEP = 0,
+	PWR_MODE_STOP,
+	PWR_MODE_LAST
+} PWR_mode_t;
+
+typedef enum {
+	PWR_REQUESTER_NVM = 0,
+	PWR_REQUESTER_ADC,
+	PWR_REQUESTER_DMA1_CHANNEL1,
+	PWR_REQUESTER_DMA1_CHANNEL2,
+	PWR_REQUESTER_DMA1_CHANNEL3,
+	PWR_REQUESTER_LAST
+} PWR_requester_t;
+
+typedef struct {
+	unsigned int run_ms;
+	unsigned int sleep_ms;
+	unsigned int stop_ms;
+} PWR_statistics_t;
+
 /*** PWR functions ***/
 
 void PWR_init(void);
+void PWR_set_mode_vote(PWR_requester_t requester, PWR_mode_t deepest_mode);
 void PWR_enter_sleep_mode(void);
-void PWR_enter_stop_mode(void);
+void PWR_enter_low_power_mode(void);
+void PWR_get_statistics(PWR_statistics_t* statistics);
+void PWR_reset_statistics(void);
 
 #endif /* PWR_H */
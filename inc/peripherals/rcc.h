@@ -13,11 +13,29 @@
 #define RCC_LSI_FREQUENCY_HZ	38000
 #define RCC_LSE_FREQUENCY_HZ	32768
 #define RCC_MSI_FREQUENCY_KHZ	2100
+#define RCC_HSI_FREQUENCY_KHZ	16000
+#define RCC_CLOCK_CALLBACK_MAX	4
+
+/*** RCC structures ***/
+
+typedef enum {
+	RCC_SYSCLK_MSI = 0,
+	RCC_SYSCLK_HSI,
+	RCC_SYSCLK_LAST
+} RCC_sysclk_t;
+
+// Called after each system clock switch with the new frequency.
+typedef void (*RCC_clock_callback_t)(unsigned int sysclk_khz);
 
 /*** RCC functions ***/
 
 void RCC_init(void);
 void RCC_enable_lsi(void);
 void RCC_enable_lse(void);
+void RCC_register_clock_callback(RCC_clock_callback_t callback);
+void RCC_request_high_speed(void);
+void RCC_release_high_speed(void);
+RCC_sysclk_t RCC_get_sysclk(void);
+unsigned int RCC_get_sysclk_khz(void);
 
 #endif /* RCC_H */
@@ -10,19 +10,19 @@
 
 #include "mode.h"
 
-/*** RTC macros ***/
-
-// RTC wake-up timer period.
-// Warning: this value must be lower than the watchdog period = 25s.
- #define RTC_WAKEUP_PERIOD_SECONDS	5
-
 /*** RTC functions ***/
 
 void RTC_reset(void);
 void RTC_init(void);
 void RTC_start_wakeup_timer(unsigned int delay_seconds);
+void RTC_start_wakeup_timer_milliseconds(unsigned int delay_ms);
 void RTC_stop_wakeup_timer(void);
 volatile unsigned char RTC_get_wakeup_timer_flag(void);
 void RTC_clear_wakeup_timer_flag(void);
+unsigned int RTC_get_timestamp_seconds(void);
+void RTC_start_alarm_a(unsigned int delay_seconds);
+void RTC_stop_alarm_a(void);
+volatile unsigned char RTC_get_alarm_a_flag(void);
+void RTC_clear_alarm_a_flag(void);
 
 #endif /* RTC_H */
@@ -0,0 +1,21 @@
+/*
+ * systick.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef SYSTICK_H
+#define SYSTICK_H
+
+/*** SYSTICK macros ***/
+
+#define SYSTICK_COUNTER_MAX		0x00FFFFFF // 24-bits down counter.
+
+/*** SYSTICK functions ***/
+
+void SYSTICK_start(void);
+unsigned int SYSTICK_get_cycles(void);
+void SYSTICK_stop(void);
+
+#endif /* SYSTICK_H */
@@ -0,0 +1,16 @@
+/*
+ * tim.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef TIM_H
+#define TIM_H
+
+/*** TIM functions ***/
+
+void TIM2_start_trigger(unsigned int period_us);
+void TIM2_stop(void);
+
+#endif /* TIM_H */
@@ -30,7 +30,7 @@ typedef struct {
 
 /*** EEPROM address range ***/
 
-#define EEPROM_START_ADDRESS	(unsigned int) 0x08080000
+#define EEPROM_START_ADDRESS	((unsigned long) 0x08080000)
 #define EEPROM_SIZE				1024 // 1kB for STM32L041xxxx (category 2 device).
 
 #endif /* FLASH_REG_H */
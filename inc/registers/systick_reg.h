@@ -0,0 +1,24 @@
+/*
+ * systick_reg.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef SYSTICK_REG_H
+#define SYSTICK_REG_H
+
+/*** SYSTICK registers ***/
+
+typedef struct {
+	volatile unsigned int CSR;		// SysTick control and status register.
+	volatile unsigned int RVR;		// SysTick reload value register.
+	volatile unsigned int CVR;		// SysTick current value register.
+	volatile unsigned int CALIB;	// SysTick calibration value register.
+} SYSTICK_base_address_t;
+
+/*** SYSTICK base address ***/
+
+#define SYSTICK		((SYSTICK_base_address_t*) ((unsigned int) 0xE000E010))
+
+#endif /* SYSTICK_REG_H */
@@ -0,0 +1,41 @@
+/*
+ * tim_reg.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef TIM_REG_H
+#define TIM_REG_H
+
+/*** TIM registers ***/
+
+typedef struct {
+	volatile unsigned int CR1;    	// TIM control register 1.
+	volatile unsigned int CR2;    	// TIM control register 2.
+	volatile unsigned int SMCR;    	// TIM slave mode control register.
+	volatile unsigned int DIER;    	// TIM DMA interrupt enable register.
+	volatile unsigned int SR;    	// TIM status register.
+	volatile unsigned int EGR;    	// TIM event generation register.
+	volatile unsigned int CCMR1;    // TIM capture/compare mode register 1.
+	volatile unsigned int CCMR2;    // TIM capture/compare mode register 2.
+	volatile unsigned int CCER;    	// TIM capture/compare enable register.
+	volatile unsigned int CNT;    	// TIM counter register.
+	volatile unsigned int PSC;    	// TIM prescaler register.
+	volatile unsigned int ARR;    	// TIM auto-reload register.
+	unsigned int RESERVED0;			// Reserved 0x30.
+	volatile unsigned int CCR1;    	// TIM capture/compare register 1.
+	volatile unsigned int CCR2;    	// TIM capture/compare register 2.
+	volatile unsigned int CCR3;    	// TIM capture/compare register 3.
+	volatile unsigned int CCR4;    	// TIM capture/compare register 4.
+	unsigned int RESERVED1;			// Reserved 0x44.
+	volatile unsigned int DCR;    	// TIM DMA control register.
+	volatile unsigned int DMAR;    	// TIM DMA address for full transfer register.
+	volatile unsigned int OR;    	// TIM option register.
+} TIM_base_address_t;
+
+/*** TIM base address ***/
+
+#define TIM2	((TIM_base_address_t*) ((unsigned int) 0x40000000))
+
+#endif /* TIM_REG_H */
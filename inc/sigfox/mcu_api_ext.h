@@ -0,0 +1,26 @@
+/*
+ * mcu_api_ext.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef MCU_API_EXT_H
+#define MCU_API_EXT_H
+
+/*** MCU API extension structures ***/
+
+typedef struct {
+	unsigned int number_of_blocks;
+	unsigned int cycles;
+	unsigned int duration_us;
+	unsigned int energy_nj;
+} MCU_API_aes_statistics_t;
+
+/*** MCU API extension functions (not called by the Sigfox library) ***/
+
+void MCU_API_set_payload_encryption(unsigned char enable);
+unsigned char MCU_API_get_payload_encryption(void);
+void MCU_API_get_aes_statistics(MCU_API_aes_statistics_t* aes_statistics);
+
+#endif /* MCU_API_EXT_H */
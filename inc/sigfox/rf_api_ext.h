@@ -0,0 +1,26 @@
+/*
+ * rf_api_ext.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef RF_API_EXT_H
+#define RF_API_EXT_H
+
+/*** RF API extension macros ***/
+
+// Uplink modulation samples (each symbol is made of deviation and PA level pairs in S2LP FIFO).
+#define RF_API_SYMBOL_PROFILE_LENGTH_BYTES		40
+#define RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES	(2 * RF_API_SYMBOL_PROFILE_LENGTH_BYTES) // Size is twice to store PA and FDEV values.
+
+#define RF_API_S2LP_FDEV_NEGATIVE				0x7F // fdev * (+1)
+#define RF_API_S2LP_FDEV_POSITIVE				0x81 // fdev * (-1)
+#define RF_API_S2LP_FIFO_BUFFER_FDEV_IDX		(RF_API_SYMBOL_PROFILE_LENGTH_BYTES / 2) // Index where deviation is performed to invert phase.
+
+/*** RF API extension global variables ***/
+
+extern unsigned char rf_api_etsi_ramp_amplitude_profile[RF_API_SYMBOL_PROFILE_LENGTH_BYTES];
+extern unsigned char rf_api_etsi_bit0_amplitude_profile[RF_API_SYMBOL_PROFILE_LENGTH_BYTES];
+
+#endif /* RF_API_EXT_H */
@@ -0,0 +1,20 @@
+/*
+ * aes_sw.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef AES_SW_H
+#define AES_SW_H
+
+#include "aes.h"
+
+/*** AES SW functions ***/
+
+void AES_SW_set_key(unsigned char key[AES_BLOCK_SIZE]);
+void AES_SW_clear_key(void);
+void AES_SW_encrypt_block(unsigned char data_in[AES_BLOCK_SIZE], unsigned char data_out[AES_BLOCK_SIZE], unsigned char init_vector[AES_BLOCK_SIZE]);
+void AES_SW_encrypt(unsigned char data_in[AES_BLOCK_SIZE], unsigned char data_out[AES_BLOCK_SIZE], unsigned char init_vector[AES_BLOCK_SIZE], unsigned char key[AES_BLOCK_SIZE]);
+
+#endif /* AES_SW_H */
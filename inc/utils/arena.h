@@ -0,0 +1,41 @@
+/*
+ * arena.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+/*** ARENA macros ***/
+
+#ifndef ARENA_SIZE_BYTES
+#define ARENA_SIZE_BYTES	328 // Worst case of nested phases (checked by users at compile time).
+#endif
+#define ARENA_ALIGN(size)	((((size) + 3) / 4) * 4) // Blocks are 32-bits aligned (usable in preprocessor checks).
+
+/*** ARENA structures ***/
+
+// Phases are allocated in a stack: leaving a phase also releases the phases entered after it.
+typedef enum {
+	ARENA_PHASE_SIGFOX_SESSION = 0, // Sigfox library memory (MCU_API_malloc to MCU_API_free).
+	ARENA_PHASE_UPLINK, // S2LP FIFO samples buffer (RF_API_send).
+	ARENA_PHASE_AT_RESPONSE, // AT response buffer (first added string to transmission, never pending when a Sigfox session starts).
+	ARENA_PHASE_LAST
+} ARENA_phase_t;
+
+typedef struct {
+	unsigned int size_bytes;
+	unsigned int used_bytes;
+	unsigned int high_water_bytes; // Since reset.
+	unsigned int error_count; // Requests which did not fit.
+} ARENA_statistics_t;
+
+/*** ARENA functions ***/
+
+void* ARENA_enter(ARENA_phase_t phase, unsigned int size_bytes);
+void ARENA_exit(ARENA_phase_t phase);
+void ARENA_get_statistics(ARENA_statistics_t* statistics);
+
+#endif /* ARENA_H */
@@ -8,10 +8,28 @@
 #ifndef MATH_H
 #define MATH_H
 
+/*** MATH macros ***/
+
+#define MATH_MEDIAN_FILTER_LENGTH_MAX	32 // Bounds the stack footprint of MATH_median_filter (128 bytes).
+
+/*** MATH structures ***/
+
+typedef struct {
+	unsigned int count;
+	unsigned long long sum;
+	unsigned long long sum_of_squares;
+	unsigned int min;
+	unsigned int max;
+} MATH_statistics_t;
+
 /*** MATH functions ***/
 
 unsigned int MATH_pow_10(unsigned char power);
 unsigned int MATH_average(unsigned int* data, unsigned char data_length);
 unsigned int MATH_median_filter(unsigned int* data, unsigned char median_length, unsigned char average_length);
+void MATH_statistics_reset(MATH_statistics_t* statistics);
+void MATH_statistics_add(MATH_statistics_t* statistics, unsigned int value);
+unsigned int MATH_statistics_get_mean(MATH_statistics_t* statistics);
+unsigned int MATH_statistics_get_variance(MATH_statistics_t* statistics);
 
 #endif /* MATH_H */
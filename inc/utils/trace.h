@@ -0,0 +1,86 @@
+/*
+ * trace.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "mode.h"
+
+/*** TRACE macros ***/
+
+#ifndef TRACE_RING_LENGTH
+#define TRACE_RING_LENGTH			64 // Number of records (must be a power of 2, 8 bytes each).
+#endif
+#define TRACE_EVENT_EXIT_FLAG		0x80 // Set in event ID of function exit records.
+#define TRACE_ARGUMENT_MASK			0x00FFFFFF
+
+/*** TRACE structures ***/
+
+// Event IDs (decoded by script/trace_decode.py, append new events at the end).
+typedef enum {
+	TRACE_EVENT_NONE = 0,
+	// Interrupts (argument = peripheral status register).
+	TRACE_EVENT_EXTI4_15_IRQ,
+	TRACE_EVENT_DMA1_CHANNEL2_3_IRQ,
+	TRACE_EVENT_LPTIM1_IRQ,
+	// S2LP (argument = command).
+	TRACE_EVENT_S2LP_COMMAND,
+	// RF API (entry argument = first parameter, exit argument = returned value).
+	TRACE_EVENT_RF_API_INIT,
+	TRACE_EVENT_RF_API_STOP,
+	TRACE_EVENT_RF_API_SEND,
+	TRACE_EVENT_RF_API_START_CONTINUOUS_TRANSMISSION,
+	TRACE_EVENT_RF_API_STOP_CONTINUOUS_TRANSMISSION,
+	TRACE_EVENT_RF_API_CHANGE_FREQUENCY, // Entry argument in 100Hz unit.
+	TRACE_EVENT_RF_API_WAIT_FRAME,
+	TRACE_EVENT_RF_API_WAIT_FOR_CLEAR_CHANNEL,
+	TRACE_EVENT_RF_API_GET_VERSION,
+	// MCU API (entry argument = first parameter, exit argument = returned value).
+	TRACE_EVENT_MCU_API_MALLOC,
+	TRACE_EVENT_MCU_API_FREE,
+	TRACE_EVENT_MCU_API_GET_VOLTAGE_TEMPERATURE,
+	TRACE_EVENT_MCU_API_DELAY,
+	TRACE_EVENT_MCU_API_AES_128_CBC_ENCRYPT,
+	TRACE_EVENT_MCU_API_GET_NV_MEM,
+	TRACE_EVENT_MCU_API_SET_NV_MEM,
+	TRACE_EVENT_MCU_API_TIMER_START_CARRIER_SENSE,
+	TRACE_EVENT_MCU_API_TIMER_START,
+	TRACE_EVENT_MCU_API_TIMER_STOP,
+	TRACE_EVENT_MCU_API_TIMER_STOP_CARRIER_SENSE,
+	TRACE_EVENT_MCU_API_TIMER_WAIT_FOR_END,
+	TRACE_EVENT_MCU_API_REPORT_TEST_RESULT,
+	TRACE_EVENT_MCU_API_GET_VERSION,
+	TRACE_EVENT_MCU_API_GET_DEVICE_ID_AND_PAYLOAD_ENCRYPTION_FLAG,
+	TRACE_EVENT_MCU_API_GET_MSG_COUNTER_ROLLOVER,
+	TRACE_EVENT_MCU_API_GET_INITIAL_PAC,
+	TRACE_EVENT_LAST
+} TRACE_event_t;
+
+typedef struct {
+	unsigned int timestamp; // LPTIM1 ticks.
+	unsigned int data; // Event ID (8 MSB) and argument (24 LSB).
+} TRACE_record_t;
+
+/*** TRACE functions ***/
+
+#ifdef TRACE
+void TRACE_add(unsigned char event, unsigned int argument);
+unsigned int TRACE_get_count(unsigned int* lost_count);
+void TRACE_get_record(unsigned int record_idx, TRACE_record_t* record);
+void TRACE_reset(void);
+
+// Instrumentation points (removed when TRACE is not defined).
+#define TRACE_event(event, argument)	TRACE_add((event), (unsigned int) (argument))
+#define TRACE_enter(event, argument)	TRACE_add((event), (unsigned int) (argument))
+#define TRACE_exit(event, argument)		TRACE_add(((event) | TRACE_EVENT_EXIT_FLAG), (unsigned int) (argument))
+#else
+#define TRACE_event(event, argument)
+#define TRACE_enter(event, argument)
+#define TRACE_exit(event, argument)
+#endif
+
+#endif /* TRACE_H */
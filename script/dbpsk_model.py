@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+# DBPSK golden model of the uplink S2-LP FIFO samples (same tables as src/sigfox/rf_api.c).
+# Usage: script/dbpsk_model.py encode <hex_stream>
+#        script/dbpsk_model.py decode <hex_fifo | capture_file>
+# Capture files are written by the host build (HOST_S2LP_TX_CAPTURE_FILE), one hexadecimal line per transmission.
+
+import os
+import re
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+
+
+def load_constants():
+    with open(os.path.join(ROOT, "inc", "sigfox", "rf_api_ext.h")) as f:
+        header = f.read()
+    with open(os.path.join(ROOT, "src", "sigfox", "rf_api.c")) as f:
+        source = f.read()
+    def macro(name):
+        return int(re.search(r"#define\s+" + name + r"\s+(\w+)", header).group(1), 0)
+    def table(name):
+        values = re.search(name + r"\[[^\]]*\]\s*=\s*\{([^}]*)\}", source).group(1)
+        return [int(value, 0) for value in values.split(",")]
+    return {
+        "ramp": table("rf_api_etsi_ramp_amplitude_profile"),
+        "bit0": table("rf_api_etsi_bit0_amplitude_profile"),
+        "fdev_negative": macro("RF_API_S2LP_FDEV_NEGATIVE"),
+        "fdev_positive": macro("RF_API_S2LP_FDEV_POSITIVE"),
+    }
+
+
+def symbol(constants, kind, fdev=0):
+    ramp = constants["ramp"]
+    bit0 = constants["bit0"]
+    length = len(ramp)
+    samples = []
+    for idx in range(length):
+        if kind == "ramp_up":
+            samples += [0, ramp[length - idx - 1]]
+        elif kind == "bit0":
+            samples += [fdev if idx == (length // 2) else 0, bit0[idx]]
+        elif kind == "bit1":
+            samples += [0, 1]
+        elif kind == "ramp_down":
+            samples += [0, ramp[idx]]
+        else:
+            samples += [0, 0]
+    return samples
+
+
+def toggle(constants, fdev):
+    return constants["fdev_positive"] if fdev == constants["fdev_negative"] else constants["fdev_negative"]
+
+
+def encode(constants, stream):
+    fifo = symbol(constants, "ramp_up")
+    fdev = constants["fdev_negative"]
+    for byte in stream:
+        for bit_idx in range(8):
+            if (byte & (1 << (7 - bit_idx))) == 0:
+                fdev = toggle(constants, fdev)
+                fifo += symbol(constants, "bit0", fdev)
+            else:
+                fifo += symbol(constants, "bit1")
+    return fifo + symbol(constants, "ramp_down") + symbol(constants, "padding")
+
+
+def decode(constants, fifo):
+    length = 2 * len(constants["ramp"])
+    if fifo[:length] != symbol(constants, "ramp_up"):
+        raise ValueError("invalid ramp-up")
+    bits = []
+    fdev = constants["fdev_negative"]
+    for idx in range(length, len(fifo) - length + 1, length):
+        samples = fifo[idx:idx + length]
+        if samples == symbol(constants, "ramp_down"):
+            return bits
+        if samples == symbol(constants, "bit1"):
+            bits.append(1)
+        elif samples == symbol(constants, "bit0", toggle(constants, fdev)):
+            fdev = toggle(constants, fdev)
+            bits.append(0)
+        elif samples == symbol(constants, "bit0", fdev):
+            raise ValueError("phase not inverted at FIFO byte %d (symbol %d)" % (idx, idx // length))
+        else:
+            raise ValueError("invalid symbol at FIFO byte %d (symbol %d)" % (idx, idx // length))
+    raise ValueError("missing ramp-down")
+
+
+def to_hex(data):
+    return "".join("%02X" % value for value in data)
+
+
+def main():
+    if len(sys.argv) != 3 or sys.argv[1] not in ("encode", "decode"):
+        sys.exit("Usage: %s encode <hex_stream> | decode <hex_fifo | capture_file>" % sys.argv[0])
+    constants = load_constants()
+    if sys.argv[1] == "encode":
+        print(to_hex(encode(constants, bytes.fromhex(sys.argv[2]))))
+        return
+    if os.path.isfile(sys.argv[2]):
+        with open(sys.argv[2]) as f:
+            lines = [line.strip() for line in f if line.strip()]
+    else:
+        lines = [sys.argv[2]]
+    for line in lines:
+        try:
+            bits = decode(constants, list(bytes.fromhex(line)))
+        except ValueError as error:
+            print("ERROR: %s" % error)
+            continue
+        stream = bytes(int("".join(str(bit) for bit in bits[idx:idx + 8]).ljust(8, "0"), 2) for idx in range(0, len(bits), 8))
+        print("%d bits: %s" % (len(bits), to_hex(stream)))
+
+
+if __name__ == "__main__":
+    main()
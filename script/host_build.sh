@@ -0,0 +1,24 @@
+#!/bin/sh
+# Build the UHFM firmware as a host executable (virtual peripherals, AT interface on stdin/stdout).
+# Usage: script/host_build.sh [output_file]
+
+cd "$(dirname "$0")/.." || exit 1
+OUTPUT=${1:-UHFM_host}
+CC=${CC:-gcc}
+
+INCLUDES="-Iinc -Iinc/host -Iinc/registers -Iinc/utils -Iinc/peripherals -Iinc/components -Iinc/applicative -Iinc/sigfox"
+
+# All drivers are shared with the target: src/host provides the registers models, the virtual core and the Sigfox library emulation.
+# Memory statistics driver reads target linker symbols: it is replaced by src/host/mem.c.
+PERIPHERALS=$(ls src/peripherals/*.c | grep -v "src/peripherals/mem.c")
+SOURCES="src/main.c \
+src/applicative/*.c \
+src/components/*.c \
+src/sigfox/*.c \
+src/utils/*.c \
+$PERIPHERALS \
+src/host/*.c"
+
+# Position dependent executable: buffer addresses are given to DMA as 32-bits values like on the MCU.
+# Main function is called on the firmware stack by the startup code.
+$CC -std=gnu99 -O1 -g -DHW1_0 -DHOST $CFLAGS -no-pie -Wall -Wl,--wrap=main $INCLUDES $SOURCES -o "$OUTPUT"
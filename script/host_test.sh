@@ -0,0 +1,36 @@
+#!/bin/sh
+# Build and run the host unit tests (one executable per test/test_*.c file, linked with the firmware sources except main).
+# Usage: script/host_test.sh [output_directory]
+
+cd "$(dirname "$0")/.." || exit 1
+OUTPUT_DIRECTORY=${1:-test_build}
+CC=${CC:-gcc}
+
+INCLUDES="-Iinc -Iinc/host -Iinc/registers -Iinc/utils -Iinc/peripherals -Iinc/components -Iinc/applicative -Iinc/sigfox"
+
+# Same sources as script/host_build.sh, test file provides the main function.
+PERIPHERALS=$(ls src/peripherals/*.c | grep -v "src/peripherals/mem.c")
+SOURCES="src/applicative/*.c \
+src/components/*.c \
+src/sigfox/*.c \
+src/utils/*.c \
+$PERIPHERALS \
+src/host/*.c"
+
+mkdir -p "$OUTPUT_DIRECTORY" || exit 1
+FAILURES=0
+for TEST in test/test_*.c; do
+	NAME=$(basename "$TEST" .c)
+	if ! $CC -std=gnu99 -O1 -g -DHW1_0 -DHOST $CFLAGS -no-pie -Wall -Wl,--wrap=main $INCLUDES $SOURCES "$TEST" -o "$OUTPUT_DIRECTORY/$NAME"; then
+		echo "FAIL $NAME (build)"
+		FAILURES=$((FAILURES + 1))
+		continue
+	fi
+	# Tests do not use the AT interface.
+	if ! "$OUTPUT_DIRECTORY/$NAME" < /dev/null; then
+		echo "FAIL $NAME"
+		FAILURES=$((FAILURES + 1))
+	fi
+done
+echo "$FAILURES test(s) failed"
+[ "$FAILURES" -eq 0 ]
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+# Per module flash and static RAM usage report, generated from the GNU linker map file.
+# Usage: script/mem_report.py <map_file> [budget_file]
+# Budget file lines: <module> <flash_bytes> <ram_bytes> ('-' for no limit, TOTAL for the whole image, see script/mem_budget.txt).
+# Exit status is 1 if any budget is exceeded, so that the script can be used as a post-build step.
+
+import os
+import re
+import sys
+
+# Input section name prefix, category.
+CATEGORIES = [
+    (".vectors", "text"),
+    (".text", "text"),
+    (".rodata", "rodata"),
+    (".ARM", "rodata"),
+    (".eh_frame", "rodata"),
+    (".ramfunc", "ramfunc"),
+    (".init_array", "data"),
+    (".fini_array", "data"),
+    (".data", "data"),
+    (".bss", "bss"),
+    ("COMMON", "bss"),
+    (".heap", "heap"),
+    (".stack", "stack"),
+]
+
+SECTION_LINE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$")
+SECTION_NAME_LINE = re.compile(r"^ (\S+)$")
+SECTION_VALUES_LINE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$")
+
+
+def module_name(object_file):
+    # Archive members are accounted to their library.
+    match = re.match(r"(.*\.a)\(.*\)$", object_file)
+    if match is not None:
+        return os.path.basename(match.group(1))
+    return os.path.normpath(object_file)
+
+
+def category(section):
+    for prefix, name in CATEGORIES:
+        if section.startswith(prefix):
+            return name
+    return None
+
+
+def parse_map(map_file):
+    modules = {}
+    with open(map_file) as f:
+        lines = f.read().splitlines()
+    try:
+        start = lines.index("Linker script and memory map")
+    except ValueError:
+        sys.exit("ERROR: %s is not a GNU linker map file" % map_file)
+    pending_section = None
+    for line in lines[start:]:
+        section = None
+        match = SECTION_LINE.match(line)
+        if match is not None:
+            section, address, size, object_file = match.groups()
+        elif pending_section is not None:
+            # Long section names are printed alone and followed by the address line.
+            match = SECTION_VALUES_LINE.match(line)
+            if match is not None:
+                section = pending_section
+                address, size, object_file = match.groups()
+        pending_section = None
+        if section is None:
+            match = SECTION_NAME_LINE.match(line)
+            if match is not None:
+                pending_section = match.group(1)
+            continue
+        kind = category(section)
+        # Skip discarded sections (null address) and linker statements.
+        if (kind is None) or (int(address, 16) == 0) or (object_file.strip().startswith("load address")):
+            continue
+        usage = modules.setdefault(module_name(object_file.strip()), dict.fromkeys(["text", "rodata", "ramfunc", "data", "bss", "heap", "stack"], 0))
+        usage[kind] += int(size, 16)
+    return modules
+
+
+def load_budgets(budget_file):
+    budgets = {}
+    with open(budget_file) as f:
+        for line in f:
+            fields = line.split("#")[0].split()
+            if len(fields) == 0:
+                continue
+            if len(fields) != 3:
+                sys.exit("ERROR: invalid budget line: %s" % line.strip())
+            budgets[fields[0]] = [None if value == "-" else int(value, 0) for value in fields[1:]]
+    return budgets
+
+
+def flash_bytes(usage):
+    return usage["text"] + usage["rodata"] + usage["ramfunc"] + usage["data"]
+
+
+def ram_bytes(usage):
+    return usage["ramfunc"] + usage["data"] + usage["bss"]
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.exit("Usage: %s <map_file> [budget_file]" % sys.argv[0])
+    modules = parse_map(sys.argv[1])
+    budgets = load_budgets(sys.argv[2]) if len(sys.argv) == 3 else {}
+    total = dict.fromkeys(["text", "rodata", "ramfunc", "data", "bss", "heap", "stack"], 0)
+    for usage in modules.values():
+        for kind in total:
+            total[kind] += usage[kind]
+    # Print report (biggest RAM consumers first).
+    print("%-48s %7s %7s %7s %7s %7s %7s %7s" % ("module", "text", "rodata", "ramfunc", "data", "bss", "flash", "ram"))
+    for name, usage in sorted(modules.items(), key=lambda item: (-ram_bytes(item[1]), -flash_bytes(item[1]), item[0])):
+        if (flash_bytes(usage) + ram_bytes(usage)) == 0:
+            continue
+        print("%-48s %7d %7d %7d %7d %7d %7d %7d" % (name, usage["text"], usage["rodata"], usage["ramfunc"], usage["data"], usage["bss"], flash_bytes(usage), ram_bytes(usage)))
+    print("%-48s %7d %7d %7d %7d %7d %7d %7d" % ("TOTAL", total["text"], total["rodata"], total["ramfunc"], total["data"], total["bss"], flash_bytes(total), ram_bytes(total)))
+    print("heap=%d stack=%d" % (total["heap"], total["stack"]))
+    # Functions executed from RAM are stored in flash and copied at reset: they cost their size twice.
+    print("ramfunc=%d bytes of RAM (flash copy included in flash column)" % total["ramfunc"])
+    # Check budgets.
+    modules["TOTAL"] = total
+    exceeded = 0
+    for name, (flash_budget, ram_budget) in sorted(budgets.items()):
+        usage = modules.get(name)
+        if usage is None:
+            continue
+        if (flash_budget is not None) and (flash_bytes(usage) > flash_budget):
+            print("BUDGET EXCEEDED: %s flash=%d budget=%d" % (name, flash_bytes(usage), flash_budget))
+            exceeded = 1
+        if (ram_budget is not None) and (ram_bytes(usage) > ram_budget):
+            print("BUDGET EXCEEDED: %s ram=%d budget=%d" % (name, ram_bytes(usage), ram_budget))
+            exceeded = 1
+    sys.exit(exceeded)
+
+
+if __name__ == "__main__":
+    main()
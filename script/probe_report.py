@@ -0,0 +1,39 @@
+#!/usr/bin/env python3
+# Timing probes report from the host probe log (HOST_PROBE_LOG_FILE) or a logic analyzer export with the same format.
+# Usage: script/probe_report.py <log_file> [TPn=max_high_us ...]
+# Log lines: <time_us> TP<n> <state>. Exit status is 1 if a high pulse exceeds its limit.
+
+import sys
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit("Usage: %s <log_file> [TPn=max_high_us ...]" % sys.argv[0])
+    limits = {}
+    for argument in sys.argv[2:]:
+        name, value = argument.split("=")
+        limits[name] = int(value)
+    rising = {}
+    pulses = {}
+    with open(sys.argv[1]) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) != 3:
+                continue
+            time_us, name, state = int(fields[0]), fields[1], int(fields[2])
+            if state != 0:
+                rising[name] = time_us
+            elif name in rising:
+                pulses.setdefault(name, []).append(time_us - rising.pop(name))
+    exceeded = 0
+    for name in sorted(pulses):
+        durations = pulses[name]
+        print("%s pulses=%d min_us=%d avg_us=%d max_us=%d" % (name, len(durations), min(durations), sum(durations) // len(durations), max(durations)))
+        if (name in limits) and (max(durations) > limits[name]):
+            print("LIMIT EXCEEDED: %s max_us=%d limit_us=%d" % (name, max(durations), limits[name]))
+            exceeded = 1
+    sys.exit(exceeded)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# Decode the event trace dumped with the AT$TRC? command (firmware compiled with the TRACE flag).
+# Usage: script/trace_decode.py [log_file]
+# The log is the AT interface output (standard input if no file is given), event names are read from inc/utils/trace.h.
+
+import os
+import re
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+
+
+def load_events():
+    with open(os.path.join(ROOT, "inc", "utils", "trace.h")) as f:
+        header = f.read()
+    macros = dict(re.findall(r"#define\s+(TRACE_\w+)\s+(0x[0-9A-Fa-f]+|\d+)", header))
+    body = re.search(r"typedef enum \{(.*?)\} TRACE_event_t;", header, re.S).group(1)
+    names = []
+    for line in body.splitlines():
+        line = line.split("//")[0].strip().rstrip(",")
+        if not line.startswith("TRACE_EVENT_"):
+            continue
+        name, _, value = line.partition("=")
+        if value.strip():
+            while len(names) < int(value.strip(), 0):
+                names.append(None)
+        names.append(name.strip()[len("TRACE_EVENT_"):])
+    return names, int(macros["TRACE_EVENT_EXIT_FLAG"], 0)
+
+
+def main():
+    names, exit_flag = load_events()
+    log = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    ticks_hz = 4096
+    records = []
+    for line in log:
+        line = line.strip()
+        header = re.match(r"TRC records=(\d+) lost=(\d+) ticks_hz=(\d+)", line)
+        if header:
+            records = []
+            ticks_hz = int(header.group(3))
+            print("# %s records, %s lost" % (header.group(1), header.group(2)))
+            continue
+        if line.startswith("TRC "):
+            data = line[4:]
+            for idx in range(0, len(data) - 15, 16):
+                records.append((int(data[idx:idx + 8], 16), int(data[idx + 8:idx + 16], 16)))
+    previous = None
+    for timestamp, data in records:
+        event = data >> 24
+        argument = data & 0x00FFFFFF
+        kind = "exit " if (event & exit_flag) != 0 else ""
+        event &= ~exit_flag
+        name = names[event] if ((event < len(names)) and (names[event] is not None)) else ("EVENT_%d" % event)
+        time_ms = (timestamp * 1000.0) / ticks_hz
+        delta_ms = 0.0 if previous is None else ((timestamp - previous) * 1000.0) / ticks_hz
+        previous = timestamp
+        print("%12.3f ms %+10.3f ms  %s%s 0x%06X" % (time_ms, delta_ms, kind, name, argument))
+
+
+if __name__ == "__main__":
+    main()
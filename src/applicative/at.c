@@ -11,16 +11,24 @@
 #include "adc.h"
 #include "aes.h"
 #include "addon_sigfox_rf_protocol_api.h"
+#include "arena.h"
 #include "flash_reg.h"
 #include "lpuart.h"
 #include "lptim.h"
 #include "mapping.h"
 #include "math.h"
+#include "mcu_api_ext.h"
+#include "mem.h"
 #include "nvic.h"
 #include "nvm.h"
 #include "parser.h"
+#include "probe.h"
+#include "pwr.h"
+#include "scheduler.h"
 #include "sigfox_api.h"
 #include "string.h"
+#include "telemetry.h"
+#include "trace.h"
 #include "uhfm.h"
 
 /*** AT local macros ***/
@@ -32,7 +40,6 @@
 // Common macros.
 #define AT_COMMAND_LENGTH_MIN			2
 #define AT_COMMAND_BUFFER_LENGTH		128
-#define AT_RESPONSE_BUFFER_LENGTH		128
 #define AT_STRING_VALUE_BUFFER_LENGTH	16
 // Parameters separator.
 #define AT_CHAR_SEPARATOR				','
@@ -40,12 +47,17 @@
 #define AT_RESPONSE_END					"\n"
 #define AT_RESPONSE_TAB					"     "
 
+#define AT_TRACE_RECORDS_PER_LINE		6
+
 /*** AT callbacks declaration ***/
 
 static void AT_print_ok(void);
 static void AT_print_command_list(void);
 static void AT_read_callback(void);
 static void AT_write_callback(void);
+static void AT_get_pwr_callback(void);
+static void AT_pwrr_callback(void);
+static void AT_get_mem_callback(void);
 #ifdef AT_COMMANDS_NVM
 static void AT_nvmr_callback(void);
 static void AT_nvm_callback(void);
@@ -58,10 +70,21 @@ static void AT_set_key_callback(void);
 static void AT_so_callback(void);
 static void AT_sb_callback(void);
 static void AT_sf_callback(void);
+static void AT_get_pe_callback(void);
+static void AT_set_pe_callback(void);
+static void AT_aes_callback(void);
+static void AT_get_tlm_callback(void);
+static void AT_set_tlm_callback(void);
+static void AT_get_sup_callback(void);
+static void AT_set_sup_callback(void);
 #endif
 #ifdef AT_COMMANDS_TEST_MODES
 static void AT_tm_callback(void);
 #endif
+#ifdef TRACE
+static void AT_get_trc_callback(void);
+static void AT_trcr_callback(void);
+#endif
 
 /*** AT local structures ***/
 
@@ -79,8 +102,9 @@ typedef struct {
 	volatile unsigned int command_buf_idx;
 	volatile unsigned char line_end_flag;
 	PARSER_context_t parser;
-	char response_buf[AT_RESPONSE_BUFFER_LENGTH];
+	char* response_buf; // Allocated in arena from first added string to response transmission.
 	unsigned int response_buf_idx;
+	AT_response_callback_t response_callback;
 	// Sigfox RC.
 	sfx_rc_t sigfox_rc;
 	sfx_u32 sigfox_rc_std_config[SIGFOX_RC_STD_CONFIG_SIZE];
@@ -94,6 +118,9 @@ static const AT_command_t AT_COMMAND_LIST[] = {
 	{PARSER_MODE_COMMAND, "AT?", "\0", "List all available AT commands", AT_print_command_list},
 	{PARSER_MODE_HEADER, "AT$R=", "address[dec]", "Read board register", AT_read_callback},
 	{PARSER_MODE_HEADER, "AT$W=", "address[dec]", "Write board register", AT_write_callback},
+	{PARSER_MODE_COMMAND, "AT$PWR?", "\0", "Get run, sleep and stop modes residency", AT_get_pwr_callback},
+	{PARSER_MODE_COMMAND, "AT$PWRR", "\0", "Reset power modes residency", AT_pwrr_callback},
+	{PARSER_MODE_COMMAND, "AT$MEM?", "\0", "Get flash, RAM functions, static RAM, stack and arena high-water usage in bytes", AT_get_mem_callback},
 #ifdef AT_COMMANDS_NVM
 	{PARSER_MODE_COMMAND, "AT$NVMR", "\0", "Reset NVM data", AT_nvmr_callback},
 	{PARSER_MODE_HEADER,  "AT$NVM=", "address[dec]", "Get NVM data", AT_nvm_callback},
@@ -106,10 +133,21 @@ static const AT_command_t AT_COMMAND_LIST[] = {
 	{PARSER_MODE_COMMAND, "AT$SO", "\0", "Sigfox send control message", AT_so_callback},
 	{PARSER_MODE_HEADER,  "AT$SB=", "data[bit],(bidir_flag[bit])", "Sigfox send bit", AT_sb_callback},
 	{PARSER_MODE_HEADER,  "AT$SF=", "data[hex],(bidir_flag[bit])", "Sigfox send frame", AT_sf_callback},
+	{PARSER_MODE_COMMAND, "AT$PE?", "\0", "Get Sigfox payload encryption flag", AT_get_pe_callback},
+	{PARSER_MODE_HEADER,  "AT$PE=", "enable[bit]", "Set Sigfox payload encryption flag", AT_set_pe_callback},
+	{PARSER_MODE_COMMAND, "AT$AES?", "\0", "Get AES cost of last Sigfox message", AT_aes_callback},
+	{PARSER_MODE_COMMAND, "AT$TLM?", "\0", "Get cached Sigfox telemetry", AT_get_tlm_callback},
+	{PARSER_MODE_HEADER,  "AT$TLM=", "max_age[s]", "Set Sigfox telemetry maximum age", AT_set_tlm_callback},
+	{PARSER_MODE_COMMAND, "AT$SUP?", "\0", "Get supply monitoring limits and status", AT_get_sup_callback},
+	{PARSER_MODE_HEADER,  "AT$SUP=", "vrf_limit[mV],vmcu_limit[mV]", "Set supply monitoring limits (0 to disable)", AT_set_sup_callback},
 #endif
 #ifdef AT_COMMANDS_TEST_MODES
 	{PARSER_MODE_HEADER,  "AT$TM=", "rc_index[dec],test_mode[dec]", "Execute Sigfox test mode", AT_tm_callback},
 #endif
+#ifdef TRACE
+	{PARSER_MODE_COMMAND, "AT$TRC?", "\0", "Dump event trace (decode with script/trace_decode.py)", AT_get_trc_callback},
+	{PARSER_MODE_COMMAND, "AT$TRCR", "\0", "Reset event trace", AT_trcr_callback},
+#endif
 };
 
 static AT_context_t at_ctx = {
@@ -124,6 +162,15 @@ static AT_context_t at_ctx = {
  * @return:				None.
  */
 static void AT_response_add_string(char* tx_string) {
+	// Local variables.
+	unsigned int idx = 0;
+	// Allocate response buffer if needed.
+	if (at_ctx.response_buf == 0) {
+		at_ctx.response_buf = (char*) ARENA_enter(ARENA_PHASE_AT_RESPONSE, AT_RESPONSE_BUFFER_LENGTH);
+		if (at_ctx.response_buf == 0) return;
+		for (idx=0 ; idx<AT_RESPONSE_BUFFER_LENGTH ; idx++) at_ctx.response_buf[idx] = STRING_CHAR_NULL;
+		at_ctx.response_buf_idx = 0;
+	}
 	// Fill TX buffer with new bytes.
 	while (*tx_string) {
 		at_ctx.response_buf[at_ctx.response_buf_idx++] = *(tx_string++);
@@ -157,12 +204,18 @@ static void AT_response_add_value(int tx_value, STRING_format_t format, unsigned
  * @return:	None.
  */
 static void AT_response_send(void) {
-	// Local variables.
-	unsigned int idx = 0;
-	// Send response over UART.
-	LPUART1_send_string(at_ctx.response_buf);
-	// Flush response buffer.
-	for (idx=0 ; idx<AT_RESPONSE_BUFFER_LENGTH ; idx++) at_ctx.response_buf[idx] = STRING_CHAR_NULL;
+	// Check buffer (nothing was added or arena is full).
+	if (at_ctx.response_buf == 0) return;
+	// Send response over UART or give it to the registered callback.
+	if (at_ctx.response_callback != 0) {
+		at_ctx.response_callback(at_ctx.response_buf);
+	}
+	else {
+		LPUART1_send_string(at_ctx.response_buf);
+	}
+	// Release response buffer.
+	ARENA_exit(ARENA_PHASE_AT_RESPONSE);
+	at_ctx.response_buf = 0;
 	at_ctx.response_buf_idx = 0;
 }
 
@@ -248,6 +301,71 @@ static void AT_write_callback(void) {
 
 }
 
+/* AT$PWR? EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_get_pwr_callback(void) {
+	// Local variables.
+	PWR_statistics_t pwr_statistics;
+	// Get residency.
+	PWR_get_statistics(&pwr_statistics);
+	// Print values.
+	AT_response_add_string("run=");
+	AT_response_add_value((int) pwr_statistics.run_ms, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("ms sleep=");
+	AT_response_add_value((int) pwr_statistics.sleep_ms, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("ms stop=");
+	AT_response_add_value((int) pwr_statistics.stop_ms, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("ms");
+	AT_response_add_string(AT_RESPONSE_END);
+	AT_response_send();
+}
+
+/* AT$PWRR EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_pwrr_callback(void) {
+	// Restart accounting.
+	PWR_reset_statistics();
+	AT_print_ok();
+}
+
+/* AT$MEM? EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_get_mem_callback(void) {
+	// Local variables.
+	MEM_statistics_t mem_statistics;
+	ARENA_statistics_t arena_statistics;
+	// Get usage.
+	MEM_get_statistics(&mem_statistics);
+	ARENA_get_statistics(&arena_statistics);
+	// Print values.
+	AT_response_add_string("flash=");
+	AT_response_add_value((int) mem_statistics.flash_bytes, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" ramfunc=");
+	AT_response_add_value((int) mem_statistics.ramfunc_bytes, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" data=");
+	AT_response_add_value((int) mem_statistics.data_bytes, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" bss=");
+	AT_response_add_value((int) mem_statistics.bss_bytes, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" heap=");
+	AT_response_add_value((int) mem_statistics.heap_bytes, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" stack=");
+	AT_response_add_value((int) mem_statistics.stack_used_bytes, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("/");
+	AT_response_add_value((int) mem_statistics.stack_bytes, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" arena=");
+	AT_response_add_value((int) arena_statistics.high_water_bytes, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("/");
+	AT_response_add_value((int) arena_statistics.size_bytes, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(AT_RESPONSE_END);
+	AT_response_send();
+}
+
 #ifdef AT_COMMANDS_NVM
 /* AT$NVMR EXECUTION CALLBACK.
  * @param:	None.
@@ -396,6 +514,10 @@ static void AT_print_dl_payload(sfx_u8* dl_payload) {
  */
 static void AT_so_callback(void) {
 	// Local variables.
+	TELEMETRY_supply_status_t supply_status = TELEMETRY_SUPPLY_LAST;
+	// Check supply before turning radio on (transmission would end in a brown-out reset).
+	supply_status = TELEMETRY_check_supply();
+	AT_status_check(supply_status, TELEMETRY_SUPPLY_OK, UHFM_ERROR_BASE_TELEMETRY);
 	// Send Sigfox OOB frame.
 	SIGFOX_API_open(&at_ctx.sigfox_rc);
 	SIGFOX_API_set_std_config(at_ctx.sigfox_rc_std_config, SFX_FALSE);
@@ -405,6 +527,7 @@ static void AT_so_callback(void) {
 	SIGFOX_API_send_outofband(SFX_OOB_SERVICE);
 	AT_print_ok();
 	SIGFOX_API_close();
+errors:
 	return;
 }
 
@@ -418,6 +541,10 @@ static void AT_sb_callback(void) {
 	int data = 0;
 	int bidir_flag = 0;
 	sfx_u8 dl_payload[SIGFOX_DOWNLINK_DATA_SIZE_BYTES];
+	TELEMETRY_supply_status_t supply_status = TELEMETRY_SUPPLY_LAST;
+	// Check supply before turning radio on (transmission would end in a brown-out reset).
+	supply_status = TELEMETRY_check_supply();
+	AT_status_check(supply_status, TELEMETRY_SUPPLY_OK, UHFM_ERROR_BASE_TELEMETRY);
 	// First try with 2 parameters.
 	parser_status = PARSER_get_parameter(&at_ctx.parser, STRING_FORMAT_BOOLEAN, AT_CHAR_SEPARATOR, 0, &data);
 	if (parser_status == PARSER_SUCCESS) {
@@ -447,6 +574,7 @@ static void AT_sb_callback(void) {
 	}
 	AT_print_ok();
 	SIGFOX_API_close();
+errors:
 	return;
 }
 
@@ -461,6 +589,10 @@ static void AT_sf_callback(void) {
 	unsigned char extracted_length = 0;
 	int bidir_flag = 0;
 	sfx_u8 dl_payload[SIGFOX_DOWNLINK_DATA_SIZE_BYTES];
+	TELEMETRY_supply_status_t supply_status = TELEMETRY_SUPPLY_LAST;
+	// Check supply before turning radio on (transmission would end in a brown-out reset).
+	supply_status = TELEMETRY_check_supply();
+	AT_status_check(supply_status, TELEMETRY_SUPPLY_OK, UHFM_ERROR_BASE_TELEMETRY);
 	// First try with 2 parameters.
 	parser_status = PARSER_get_byte_array(&at_ctx.parser, AT_CHAR_SEPARATOR, 0, 12, data, &extracted_length);
 	if (parser_status == PARSER_SUCCESS) {
@@ -490,6 +622,150 @@ static void AT_sf_callback(void) {
 	}
 	AT_print_ok();
 	SIGFOX_API_close();
+errors:
+	return;
+}
+/* AT$PE? EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_get_pe_callback(void) {
+	// Print flag.
+	AT_response_add_value(MCU_API_get_payload_encryption(), STRING_FORMAT_BOOLEAN, 0);
+	AT_response_add_string(AT_RESPONSE_END);
+	AT_response_send();
+	return;
+}
+
+/* AT$PE EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_set_pe_callback(void) {
+	// Local variables.
+	PARSER_status_t parser_status = PARSER_ERROR_UNKNOWN_COMMAND;
+	int enable = 0;
+	// Read flag parameter.
+	parser_status = PARSER_get_parameter(&at_ctx.parser, STRING_FORMAT_BOOLEAN, AT_CHAR_SEPARATOR, 1, &enable);
+	AT_status_check(parser_status, PARSER_SUCCESS, UHFM_ERROR_BASE_PARSER);
+	// Store flag in NVM.
+	MCU_API_set_payload_encryption((unsigned char) enable);
+	AT_print_ok();
+errors:
+	return;
+}
+
+/* AT$AES? EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_aes_callback(void) {
+	// Local variables.
+	MCU_API_aes_statistics_t aes_statistics;
+	// Get statistics.
+	MCU_API_get_aes_statistics(&aes_statistics);
+	// Print values.
+	AT_response_add_string("blocks=");
+	AT_response_add_value((int) aes_statistics.number_of_blocks, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" cycles=");
+	AT_response_add_value((int) aes_statistics.cycles, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" t=");
+	AT_response_add_value((int) aes_statistics.duration_us, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("us E=");
+	AT_response_add_value((int) aes_statistics.energy_nj, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("nJ");
+	AT_response_add_string(AT_RESPONSE_END);
+	AT_response_send();
+	return;
+}
+
+/* AT$TLM? EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_get_tlm_callback(void) {
+	// Local variables.
+	TELEMETRY_data_t telemetry_data;
+	// Get data.
+	TELEMETRY_get_data(&telemetry_data);
+	// Print values.
+	AT_response_add_string("Vidle=");
+	AT_response_add_value((int) telemetry_data.voltage_idle_mv, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("mV Vtx=");
+	AT_response_add_value((int) telemetry_data.voltage_tx_mv, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string((telemetry_data.voltage_tx_valid != 0) ? "mV T=" : "mV(idle) T=");
+	AT_response_add_value((int) telemetry_data.temperature_degrees, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("C age=");
+	AT_response_add_value((int) telemetry_data.idle_age_seconds, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("s");
+	AT_response_add_string(AT_RESPONSE_END);
+	AT_response_send();
+	return;
+}
+
+/* AT$TLM EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_set_tlm_callback(void) {
+	// Local variables.
+	PARSER_status_t parser_status = PARSER_ERROR_UNKNOWN_COMMAND;
+	int max_age_seconds = 0;
+	// Read age parameter.
+	parser_status = PARSER_get_parameter(&at_ctx.parser, STRING_FORMAT_DECIMAL, AT_CHAR_SEPARATOR, 1, &max_age_seconds);
+	AT_status_check(parser_status, PARSER_SUCCESS, UHFM_ERROR_BASE_PARSER);
+	// Update policy.
+	TELEMETRY_set_max_age((unsigned int) max_age_seconds);
+	AT_print_ok();
+errors:
+	return;
+}
+
+/* AT$SUP? EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_get_sup_callback(void) {
+	// Local variables.
+	TELEMETRY_data_t telemetry_data;
+	unsigned int vrf_limit_mv = 0;
+	unsigned int vmcu_limit_mv = 0;
+	// Get limits and status.
+	TELEMETRY_get_supply_limits(&vrf_limit_mv, &vmcu_limit_mv);
+	TELEMETRY_get_data(&telemetry_data);
+	// Print values.
+	AT_response_add_string("Vrf=");
+	AT_response_add_value((int) telemetry_data.voltage_rf_mv, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("/");
+	AT_response_add_value((int) vrf_limit_mv, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("mV Vmcu=");
+	AT_response_add_value((int) telemetry_data.voltage_idle_mv, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string("/");
+	AT_response_add_value((int) vmcu_limit_mv, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string((telemetry_data.supply_status == TELEMETRY_SUPPLY_OK) ? "mV OK" : "mV LOW");
+	AT_response_add_string(AT_RESPONSE_END);
+	AT_response_send();
+	return;
+}
+
+/* AT$SUP EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_set_sup_callback(void) {
+	// Local variables.
+	PARSER_status_t parser_status = PARSER_ERROR_UNKNOWN_COMMAND;
+	int vrf_limit_mv = 0;
+	int vmcu_limit_mv = 0;
+	// Read limits parameters.
+	parser_status = PARSER_get_parameter(&at_ctx.parser, STRING_FORMAT_DECIMAL, AT_CHAR_SEPARATOR, 0, &vrf_limit_mv);
+	AT_status_check(parser_status, PARSER_SUCCESS, UHFM_ERROR_BASE_PARSER);
+	parser_status = PARSER_get_parameter(&at_ctx.parser, STRING_FORMAT_DECIMAL, AT_CHAR_SEPARATOR, 1, &vmcu_limit_mv);
+	AT_status_check(parser_status, PARSER_SUCCESS, UHFM_ERROR_BASE_PARSER);
+	// Update and store limits.
+	TELEMETRY_set_supply_limits((unsigned int) vrf_limit_mv, (unsigned int) vmcu_limit_mv);
+	AT_print_ok();
+errors:
 	return;
 }
 #endif
@@ -530,6 +806,65 @@ errors:
 }
 #endif
 
+#ifdef TRACE
+/* APPEND A 32-BITS HEXADECIMAL WORD (FIXED WIDTH) TO THE RESPONSE BUFFER.
+ * @param word:	Word to add.
+ * @return:		None.
+ */
+static void AT_response_add_word(unsigned int word) {
+	// Local variables.
+	char str_value[9];
+	unsigned char idx = 0;
+	for (idx=0 ; idx<8 ; idx++) str_value[idx] = STRING_hexa_to_ascii((word >> (28 - (4 * idx))) & 0x0F);
+	str_value[8] = STRING_CHAR_NULL;
+	AT_response_add_string(str_value);
+}
+
+/* AT$TRC? EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_get_trc_callback(void) {
+	// Local variables.
+	TRACE_record_t record;
+	unsigned int record_count = 0;
+	unsigned int lost_count = 0;
+	unsigned int idx = 0;
+	// Print header.
+	record_count = TRACE_get_count(&lost_count);
+	AT_response_add_string("TRC records=");
+	AT_response_add_value((int) record_count, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" lost=");
+	AT_response_add_value((int) lost_count, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(" ticks_hz=");
+	AT_response_add_value(LPTIM_TICK_FREQUENCY_HZ, STRING_FORMAT_DECIMAL, 0);
+	AT_response_add_string(AT_RESPONSE_END);
+	AT_response_send();
+	// Print raw records (oldest first): timestamp then event and argument.
+	for (idx=0 ; idx<record_count ; idx++) {
+		if ((idx % AT_TRACE_RECORDS_PER_LINE) == 0) {
+			AT_response_add_string("TRC ");
+		}
+		TRACE_get_record(idx, &record);
+		AT_response_add_word(record.timestamp);
+		AT_response_add_word(record.data);
+		if ((((idx + 1) % AT_TRACE_RECORDS_PER_LINE) == 0) || ((idx + 1) == record_count)) {
+			AT_response_add_string(AT_RESPONSE_END);
+			AT_response_send();
+		}
+	}
+}
+
+/* AT$TRCR EXECUTION CALLBACK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_trcr_callback(void) {
+	TRACE_reset();
+	AT_print_ok();
+}
+#endif
+
 /* RESET AT PARSER.
  * @param:	None.
  * @return:	None.
@@ -552,6 +887,7 @@ static void AT_decode(void) {
 	// Local variables.
 	unsigned int idx = 0;
 	unsigned char decode_success = 0;
+	PROBE_high(PROBE_AT_DECODE_TP);
 	// Empty or too short command.
 	if (at_ctx.command_buf_idx < AT_COMMAND_LENGTH_MIN) {
 		AT_print_status(UHFM_ERROR_BASE_PARSER + PARSER_ERROR_UNKNOWN_COMMAND);
@@ -575,6 +911,7 @@ static void AT_decode(void) {
 	}
 errors:
 	AT_reset_parser();
+	PROBE_low(PROBE_AT_DECODE_TP);
 	return;
 }
 
@@ -588,7 +925,7 @@ void AT_init(void) {
 	// Init context.
 	unsigned int idx = 0;
 	for (idx=0 ; idx<AT_COMMAND_BUFFER_LENGTH ; idx++) at_ctx.command_buf[idx] = '\0';
-	for (idx=0 ; idx<AT_RESPONSE_BUFFER_LENGTH ; idx++) at_ctx.response_buf[idx] = '\0';
+	at_ctx.response_buf = 0;
 	at_ctx.response_buf_idx = 0;
 	// Reset parser.
 	AT_reset_parser();
@@ -606,6 +943,8 @@ void AT_task(void) {
 		LPUART1_disable_rx();
 		AT_decode();
 		LPUART1_enable_rx();
+		// MCU is awake anyway: let telemetry refresh its cache if needed.
+		SCHEDULER_post_event(SCHEDULER_EVENT_TELEMETRY);
 	}
 }
 
@@ -627,9 +966,18 @@ void AT_fill_rx_buffer(unsigned char rx_byte) {
 	// Set LF flag to trigger decoding.
 	if (rx_byte == STRING_CHAR_LF) {
 		at_ctx.line_end_flag = 1;
+		SCHEDULER_post_event(SCHEDULER_EVENT_AT);
 	}
 }
 
+/* REDIRECT AT RESPONSES (USED BY BENCHMARK TO DISCARD OUTPUT).
+ * @param callback:	Function called with each response instead of UART transmission (0 to restore UART).
+ * @return:			None.
+ */
+void AT_set_response_callback(AT_response_callback_t callback) {
+	at_ctx.response_callback = callback;
+}
+
 /* PRINT SIGFOX LIBRARY RESULT.
  * @param test_result:	Test result.
  * @param rssi:			Downlink signal rssi in dBm.
@@ -0,0 +1,454 @@
+/*
+ * at_bench.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "at_bench.h"
+
+#ifdef AT_BENCH
+
+#include "aes.h"
+#include "aes_sw.h"
+#include "at.h"
+#include "iwdg.h"
+#include "lpuart.h"
+#include "math.h"
+#include "mem.h"
+#include "nvm.h"
+#include "pwr.h"
+#include "sigfox_api.h"
+#include "string.h"
+#ifdef HOST
+#include <time.h>
+#else
+#include "rcc.h"
+#include "systick.h"
+#endif
+
+/*** AT BENCH local macros ***/
+
+#define AT_BENCH_LINE_LENGTH_MAX				126 // Longest command accepted by AT command buffer (with line end).
+#define AT_BENCH_LINE_LENGTH_OVERFLOW			200 // Line which overflows AT command buffer.
+#define AT_BENCH_REPORT_BUFFER_LENGTH			16
+#define AT_BENCH_AES_CHUNK_BLOCKS				4 // Same chunk size as the Sigfox AES callback.
+#define AT_BENCH_MATH_CALLS_PER_MEASUREMENT		16 // Calls are measured by batch to hide the measurement overhead.
+// Latency histogram: 2^AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2 buckets per octave, from 2^AT_BENCH_HISTOGRAM_OCTAVE_MIN to 2^AT_BENCH_HISTOGRAM_OCTAVE_MAX ns.
+#define AT_BENCH_HISTOGRAM_OCTAVE_MIN			6
+#define AT_BENCH_HISTOGRAM_OCTAVE_MAX			30
+#define AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2		2
+#define AT_BENCH_HISTOGRAM_LENGTH				((AT_BENCH_HISTOGRAM_OCTAVE_MAX - AT_BENCH_HISTOGRAM_OCTAVE_MIN) << AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2)
+
+/*** AT BENCH local structures ***/
+
+typedef struct {
+	char* name;
+	char** lines;
+	unsigned char number_of_lines;
+} AT_BENCH_scenario_t;
+
+typedef struct {
+	// Generated lines.
+	char id_set_line[AT_BENCH_LINE_LENGTH_MAX + 1];
+	char key_set_line[AT_BENCH_LINE_LENGTH_MAX + 1];
+	char max_length_line[AT_BENCH_LINE_LENGTH_MAX + 1];
+	char overflow_line[AT_BENCH_LINE_LENGTH_OVERFLOW + 1];
+	// Statistics of current scenario.
+	unsigned short histogram[AT_BENCH_HISTOGRAM_LENGTH];
+	unsigned int command_count;
+	unsigned int error_count;
+	unsigned int response_bytes;
+	unsigned long long total_ns;
+	unsigned int max_ns;
+	// Report.
+	char report_buf[AT_BENCH_REPORT_BUFFER_LENGTH];
+#ifdef HOST
+	struct timespec start_time;
+#endif
+} AT_BENCH_context_t;
+
+/*** AT BENCH local global variables ***/
+
+static AT_BENCH_context_t at_bench_ctx;
+
+static char* AT_BENCH_PING[] = {"AT"};
+static char* AT_BENCH_LIST[] = {"AT?"};
+static char* AT_BENCH_NVM_READ[] = {"AT$NVM=0", "AT$NVM=20", "AT$NVM=31"};
+static char* AT_BENCH_ID_GET[] = {"AT$ID?"};
+static char* AT_BENCH_ID_SET[] = {at_bench_ctx.id_set_line};
+static char* AT_BENCH_KEY_GET[] = {"AT$KEY?"};
+static char* AT_BENCH_KEY_SET[] = {at_bench_ctx.key_set_line};
+static char* AT_BENCH_MALFORMED[] = {"", "A", "AT$XYZ", "AT$NVM=", "AT$NVM=abc", "AT$ID=0102", "AT$ID=ZZZZZZZZ", "ATZ,,,="};
+static char* AT_BENCH_MAX_LENGTH[] = {at_bench_ctx.max_length_line, at_bench_ctx.overflow_line};
+
+static const AT_BENCH_scenario_t AT_BENCH_SCENARIO_LIST[] = {
+	{"ping", AT_BENCH_PING, (sizeof(AT_BENCH_PING) / sizeof(char*))},
+	{"list", AT_BENCH_LIST, (sizeof(AT_BENCH_LIST) / sizeof(char*))},
+	{"nvm_read", AT_BENCH_NVM_READ, (sizeof(AT_BENCH_NVM_READ) / sizeof(char*))},
+	{"id_get", AT_BENCH_ID_GET, (sizeof(AT_BENCH_ID_GET) / sizeof(char*))},
+	{"id_set", AT_BENCH_ID_SET, (sizeof(AT_BENCH_ID_SET) / sizeof(char*))},
+	{"key_get", AT_BENCH_KEY_GET, (sizeof(AT_BENCH_KEY_GET) / sizeof(char*))},
+	{"key_set", AT_BENCH_KEY_SET, (sizeof(AT_BENCH_KEY_SET) / sizeof(char*))},
+	{"malformed", AT_BENCH_MALFORMED, (sizeof(AT_BENCH_MALFORMED) / sizeof(char*))},
+	{"max_length", AT_BENCH_MAX_LENGTH, (sizeof(AT_BENCH_MAX_LENGTH) / sizeof(char*))},
+};
+
+/*** AT BENCH local functions ***/
+
+/* AT RESPONSE CALLBACK (RESPONSES ARE COUNTED BUT NOT SENT).
+ * @param response:	Formatted response.
+ * @return:			None.
+ */
+static void AT_BENCH_response_callback(char* response) {
+	// Check error.
+	if ((response[0] == 'E') && (response[1] == 'R')) {
+		at_bench_ctx.error_count++;
+	}
+	while (*response) {
+		at_bench_ctx.response_bytes++;
+		response++;
+	}
+}
+
+/* APPEND HEXADECIMAL BYTE TO A LINE.
+ * @param line:		Line to complete.
+ * @param line_idx:	Pointer to the current line index.
+ * @param byte:		Byte to add.
+ * @return:			None.
+ */
+static void AT_BENCH_add_byte(char* line, unsigned char* line_idx, unsigned char byte) {
+	line[(*line_idx)++] = STRING_hexa_to_ascii((byte >> 4) & 0x0F);
+	line[(*line_idx)++] = STRING_hexa_to_ascii(byte & 0x0F);
+}
+
+/* BUILD LINES WHICH DEPEND ON DEVICE DATA.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_BENCH_build_lines(void) {
+	// Local variables.
+	char id_header[] = "AT$ID=";
+	char key_header[] = "AT$KEY=";
+	unsigned char line_idx = 0;
+	unsigned char idx = 0;
+	unsigned char nvm_byte = 0;
+	// Set commands write the current values back to keep device identity (EEPROM is still programmed).
+	NVM_enable();
+	for (line_idx=0 ; id_header[line_idx] != STRING_CHAR_NULL ; line_idx++) at_bench_ctx.id_set_line[line_idx] = id_header[line_idx];
+	for (idx=0 ; idx<ID_LENGTH ; idx++) {
+		NVM_read_byte((NVM_ADDRESS_SIGFOX_DEVICE_ID + ID_LENGTH - idx - 1), &nvm_byte);
+		AT_BENCH_add_byte(at_bench_ctx.id_set_line, &line_idx, nvm_byte);
+	}
+	for (line_idx=0 ; key_header[line_idx] != STRING_CHAR_NULL ; line_idx++) at_bench_ctx.key_set_line[line_idx] = key_header[line_idx];
+	for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) {
+		NVM_read_byte((NVM_ADDRESS_SIGFOX_DEVICE_KEY + idx), &nvm_byte);
+		AT_BENCH_add_byte(at_bench_ctx.key_set_line, &line_idx, nvm_byte);
+	}
+	NVM_disable();
+	// Longest accepted line (too many key bytes) and line which overflows command buffer.
+	for (line_idx=0 ; key_header[line_idx] != STRING_CHAR_NULL ; line_idx++) at_bench_ctx.max_length_line[line_idx] = key_header[line_idx];
+	for (; line_idx<AT_BENCH_LINE_LENGTH_MAX ; line_idx++) at_bench_ctx.max_length_line[line_idx] = 'F';
+	for (idx=0 ; idx<AT_BENCH_LINE_LENGTH_OVERFLOW ; idx++) at_bench_ctx.overflow_line[idx] = 'A';
+}
+
+/* START LATENCY MEASUREMENT.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_BENCH_start_measurement(void) {
+#ifdef HOST
+	clock_gettime(CLOCK_MONOTONIC, &at_bench_ctx.start_time);
+#else
+	SYSTICK_start();
+#endif
+}
+
+/* STOP LATENCY MEASUREMENT.
+ * @param:	None.
+ * @return:	Elapsed time in ns.
+ */
+static unsigned int AT_BENCH_stop_measurement(void) {
+#ifdef HOST
+	// Local variables.
+	struct timespec stop_time;
+	clock_gettime(CLOCK_MONOTONIC, &stop_time);
+	return (unsigned int) (((stop_time.tv_sec - at_bench_ctx.start_time.tv_sec) * 1000000000LL) + (stop_time.tv_nsec - at_bench_ctx.start_time.tv_nsec));
+#else
+	// Local variables.
+	unsigned int cycles = SYSTICK_get_cycles();
+	SYSTICK_stop();
+	return (unsigned int) ((cycles * 1000000ULL) / RCC_get_sysclk_khz());
+#endif
+}
+
+/* GET HISTOGRAM BUCKET OF A LATENCY.
+ * @param latency_ns:	Latency in ns.
+ * @return bucket_idx:	Histogram bucket.
+ */
+static unsigned char AT_BENCH_get_bucket(unsigned int latency_ns) {
+	// Local variables.
+	unsigned char msb = 0;
+	unsigned char sub_bucket = 0;
+	// Get octave.
+	while ((msb < 31) && ((latency_ns >> (msb + 1)) != 0)) msb++;
+	if (msb < AT_BENCH_HISTOGRAM_OCTAVE_MIN) return 0;
+	if (msb >= AT_BENCH_HISTOGRAM_OCTAVE_MAX) return (AT_BENCH_HISTOGRAM_LENGTH - 1);
+	// Get sub-bucket from the bits following MSB.
+	sub_bucket = (latency_ns >> (msb - AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2)) & ((0b1 << AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2) - 1);
+	return (((msb - AT_BENCH_HISTOGRAM_OCTAVE_MIN) << AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2) + sub_bucket);
+}
+
+/* GET LATENCY PERCENTILE FROM HISTOGRAM.
+ * @param percent:	Percentile to compute.
+ * @return:			Upper bound of the bucket containing the percentile in ns.
+ */
+static unsigned int AT_BENCH_get_percentile(unsigned char percent) {
+	// Local variables.
+	unsigned int threshold = ((at_bench_ctx.command_count * percent) + 99) / 100;
+	unsigned int count = 0;
+	unsigned char bucket_idx = 0;
+	unsigned char octave = 0;
+	unsigned char sub_bucket = 0;
+	unsigned int upper_bound = 0;
+	for (bucket_idx=0 ; bucket_idx<AT_BENCH_HISTOGRAM_LENGTH ; bucket_idx++) {
+		count += at_bench_ctx.histogram[bucket_idx];
+		if (count >= threshold) break;
+	}
+	if (bucket_idx >= AT_BENCH_HISTOGRAM_LENGTH) bucket_idx = (AT_BENCH_HISTOGRAM_LENGTH - 1);
+	octave = AT_BENCH_HISTOGRAM_OCTAVE_MIN + (bucket_idx >> AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2);
+	sub_bucket = bucket_idx & ((0b1 << AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2) - 1);
+	upper_bound = ((0b1 << AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2) + sub_bucket + 1) << (octave - AT_BENCH_HISTOGRAM_SUB_BUCKETS_LOG2);
+	// Bucket bound is clipped to the measured maximum.
+	return (upper_bound > at_bench_ctx.max_ns) ? at_bench_ctx.max_ns : upper_bound;
+}
+
+/* SEND A REPORT FIELD OVER UART.
+ * @param label:	Field label.
+ * @param value:	Field value.
+ * @return:			None.
+ */
+static void AT_BENCH_print_field(char* label, unsigned int value) {
+	// Local variables.
+	unsigned char idx = 0;
+	for (idx=0 ; idx<AT_BENCH_REPORT_BUFFER_LENGTH ; idx++) at_bench_ctx.report_buf[idx] = STRING_CHAR_NULL;
+	STRING_value_to_string((int) value, STRING_FORMAT_DECIMAL, 0, at_bench_ctx.report_buf);
+	LPUART1_send_string(label);
+	LPUART1_send_string(at_bench_ctx.report_buf);
+}
+
+/* SEND ONE LINE THROUGH THE AT INTERFACE.
+ * @param line:	Command to send (without line end).
+ * @return:		Execution time in ns.
+ */
+static unsigned int AT_BENCH_replay_line(char* line) {
+	AT_BENCH_start_measurement();
+	// Same path as UART interrupt and scheduler.
+	while (*line) AT_fill_rx_buffer(*(line++));
+	AT_fill_rx_buffer(STRING_CHAR_LF);
+	AT_task();
+	return AT_BENCH_stop_measurement();
+}
+
+/* REPLAY ONE SCENARIO AND PRINT ITS REPORT.
+ * @param scenario:	Scenario to run.
+ * @return:			None.
+ */
+static void AT_BENCH_run_scenario(const AT_BENCH_scenario_t* scenario) {
+	// Local variables.
+	unsigned int iteration = 0;
+	unsigned char line_idx = 0;
+	unsigned int latency_ns = 0;
+	unsigned int stack_bytes = 0;
+	unsigned int idx = 0;
+	// Warm-up pass (not measured, first calls may perform one-time initializations).
+	for (line_idx=0 ; line_idx<(scenario -> number_of_lines) ; line_idx++) {
+		AT_BENCH_replay_line((scenario -> lines)[line_idx]);
+	}
+	// Reset statistics.
+	for (idx=0 ; idx<AT_BENCH_HISTOGRAM_LENGTH ; idx++) at_bench_ctx.histogram[idx] = 0;
+	at_bench_ctx.command_count = 0;
+	at_bench_ctx.error_count = 0;
+	at_bench_ctx.response_bytes = 0;
+	at_bench_ctx.total_ns = 0;
+	at_bench_ctx.max_ns = 0;
+	MEM_paint_stack();
+	// Replay traffic.
+	for (iteration=0 ; iteration<AT_BENCH_ITERATIONS ; iteration++) {
+		IWDG_reload();
+		for (line_idx=0 ; line_idx<(scenario -> number_of_lines) ; line_idx++) {
+			latency_ns = AT_BENCH_replay_line((scenario -> lines)[line_idx]);
+			// Update statistics.
+			if (at_bench_ctx.histogram[AT_BENCH_get_bucket(latency_ns)] < 0xFFFF) {
+				at_bench_ctx.histogram[AT_BENCH_get_bucket(latency_ns)]++;
+			}
+			if (latency_ns > at_bench_ctx.max_ns) at_bench_ctx.max_ns = latency_ns;
+			at_bench_ctx.total_ns += latency_ns;
+			at_bench_ctx.command_count++;
+		}
+	}
+	// Read stack usage before printing report.
+	stack_bytes = MEM_get_stack_used();
+	// Print report.
+	LPUART1_send_string("BENCH ");
+	LPUART1_send_string(scenario -> name);
+	AT_BENCH_print_field(" cmd=", at_bench_ctx.command_count);
+	AT_BENCH_print_field(" err=", at_bench_ctx.error_count);
+	AT_BENCH_print_field(" cmd/s=", (at_bench_ctx.total_ns == 0) ? 0 : (unsigned int) ((at_bench_ctx.command_count * 1000000000ULL) / at_bench_ctx.total_ns));
+	AT_BENCH_print_field(" p50_ns=", AT_BENCH_get_percentile(50));
+	AT_BENCH_print_field(" p90_ns=", AT_BENCH_get_percentile(90));
+	AT_BENCH_print_field(" p99_ns=", AT_BENCH_get_percentile(99));
+	AT_BENCH_print_field(" max_ns=", at_bench_ctx.max_ns);
+	AT_BENCH_print_field(" resp_bytes=", at_bench_ctx.response_bytes);
+	AT_BENCH_print_field(" stack_bytes=", stack_bytes);
+	LPUART1_send_string("\n");
+}
+
+/* PRINT THROUGHPUT REPORT.
+ * @param name:		Scenario name.
+ * @param unit:		Name of the processed item (block, call, etc).
+ * @param count:	Number of processed items.
+ * @param total_ns:	Total processing time in ns.
+ * @return:			None.
+ */
+static void AT_BENCH_print_throughput(char* name, char* unit, unsigned int count, unsigned long long total_ns) {
+	LPUART1_send_string("BENCH ");
+	LPUART1_send_string(name);
+	LPUART1_send_string(" ");
+	LPUART1_send_string(unit);
+	AT_BENCH_print_field("s=", count);
+	LPUART1_send_string(" ");
+	LPUART1_send_string(unit);
+	AT_BENCH_print_field("s/s=", (total_ns == 0) ? 0 : (unsigned int) ((count * 1000000000ULL) / total_ns));
+	LPUART1_send_string(" ns/");
+	LPUART1_send_string(unit);
+	AT_BENCH_print_field("=", (count == 0) ? 0 : (unsigned int) (total_ns / count));
+	LPUART1_send_string("\n");
+}
+
+/* MEASURE AES-128 CBC THROUGHPUT OF SOFTWARE AND HARDWARE IMPLEMENTATIONS.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_BENCH_run_aes(void) {
+	// Local variables.
+	unsigned char key[AES_BLOCK_SIZE];
+	unsigned char init_vector[AES_BLOCK_SIZE];
+	unsigned int aes_buf[AT_BENCH_AES_CHUNK_BLOCKS * (AES_BLOCK_SIZE / 4)]; // 32-bits aligned buffer for DMA.
+	unsigned char* aes_buf_bytes = (unsigned char*) aes_buf;
+	unsigned long long total_ns = 0;
+	unsigned int iteration = 0;
+	unsigned char block_idx = 0;
+	unsigned char idx = 0;
+	// Arbitrary key and data (only timing is measured).
+	for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) {
+		key[idx] = idx;
+		init_vector[idx] = 0;
+	}
+	for (idx=0 ; idx<(AT_BENCH_AES_CHUNK_BLOCKS * AES_BLOCK_SIZE) ; idx++) aes_buf_bytes[idx] = idx;
+	// Software implementation (key schedule is computed once, like in a Sigfox session).
+	AES_SW_set_key(key);
+	for (iteration=0 ; iteration<AT_BENCH_ITERATIONS ; iteration++) {
+		IWDG_reload();
+		AT_BENCH_start_measurement();
+		for (block_idx=0 ; block_idx<AT_BENCH_AES_CHUNK_BLOCKS ; block_idx++) {
+			AES_SW_encrypt_block(&(aes_buf_bytes[block_idx * AES_BLOCK_SIZE]), &(aes_buf_bytes[block_idx * AES_BLOCK_SIZE]), init_vector);
+			for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) init_vector[idx] = aes_buf_bytes[(block_idx * AES_BLOCK_SIZE) + idx];
+		}
+		total_ns += AT_BENCH_stop_measurement();
+	}
+	AES_SW_clear_key();
+	AT_BENCH_print_throughput("aes_sw", "block", (AT_BENCH_ITERATIONS * AT_BENCH_AES_CHUNK_BLOCKS), total_ns);
+#ifdef AES_PERIPHERAL_AVAILABLE
+	// Hardware peripheral fed by DMA.
+	total_ns = 0;
+	AES_init();
+	AES_set_key(key);
+	for (iteration=0 ; iteration<AT_BENCH_ITERATIONS ; iteration++) {
+		IWDG_reload();
+		AT_BENCH_start_measurement();
+		AES_start_cbc(aes_buf, aes_buf, AT_BENCH_AES_CHUNK_BLOCKS, init_vector);
+		while (AES_get_cbc_status() == 0) {
+			PWR_enter_sleep_mode();
+		}
+		AES_stop_cbc();
+		total_ns += AT_BENCH_stop_measurement();
+		for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) init_vector[idx] = aes_buf_bytes[((AT_BENCH_AES_CHUNK_BLOCKS - 1) * AES_BLOCK_SIZE) + idx];
+	}
+	// Wipe key registers.
+	for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) key[idx] = 0;
+	AES_set_key(key);
+	AES_disable();
+	AT_BENCH_print_throughput("aes_hw", "block", (AT_BENCH_ITERATIONS * AT_BENCH_AES_CHUNK_BLOCKS), total_ns);
+#endif
+}
+
+/* MEASURE STATISTICS FUNCTIONS ON BUFFERS OF MAXIMUM LENGTH.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AT_BENCH_run_math(void) {
+	// Local variables.
+	unsigned int data[MATH_MEDIAN_FILTER_LENGTH_MAX];
+	MATH_statistics_t statistics;
+	unsigned long long median_ns = 0;
+	unsigned long long center_average_ns = 0;
+	unsigned long long average_ns = 0;
+	unsigned long long statistics_ns = 0;
+	volatile unsigned int result = 0;
+	unsigned int random = 1;
+	unsigned int iteration = 0;
+	unsigned char call_idx = 0;
+	unsigned char idx = 0;
+	MATH_statistics_reset(&statistics);
+	for (iteration=0 ; iteration<AT_BENCH_ITERATIONS ; iteration++) {
+		IWDG_reload();
+		// New pseudo-random 12-bits samples (linear congruential generator).
+		for (idx=0 ; idx<MATH_MEDIAN_FILTER_LENGTH_MAX ; idx++) {
+			random = (random * 1103515245) + 12345;
+			data[idx] = (random >> 20);
+		}
+		AT_BENCH_start_measurement();
+		for (call_idx=0 ; call_idx<AT_BENCH_MATH_CALLS_PER_MEASUREMENT ; call_idx++) result = MATH_median_filter(data, MATH_MEDIAN_FILTER_LENGTH_MAX, 0);
+		median_ns += AT_BENCH_stop_measurement();
+		AT_BENCH_start_measurement();
+		for (call_idx=0 ; call_idx<AT_BENCH_MATH_CALLS_PER_MEASUREMENT ; call_idx++) result = MATH_median_filter(data, MATH_MEDIAN_FILTER_LENGTH_MAX, (MATH_MEDIAN_FILTER_LENGTH_MAX / 4));
+		center_average_ns += AT_BENCH_stop_measurement();
+		AT_BENCH_start_measurement();
+		for (call_idx=0 ; call_idx<AT_BENCH_MATH_CALLS_PER_MEASUREMENT ; call_idx++) result = MATH_average(data, MATH_MEDIAN_FILTER_LENGTH_MAX);
+		average_ns += AT_BENCH_stop_measurement();
+		AT_BENCH_start_measurement();
+		for (idx=0 ; idx<MATH_MEDIAN_FILTER_LENGTH_MAX ; idx++) MATH_statistics_add(&statistics, data[idx]);
+		statistics_ns += AT_BENCH_stop_measurement();
+	}
+	result = MATH_statistics_get_variance(&statistics);
+	(void) result;
+	AT_BENCH_print_throughput("math_median", "call", (AT_BENCH_ITERATIONS * AT_BENCH_MATH_CALLS_PER_MEASUREMENT), median_ns);
+	AT_BENCH_print_throughput("math_median_average", "call", (AT_BENCH_ITERATIONS * AT_BENCH_MATH_CALLS_PER_MEASUREMENT), center_average_ns);
+	AT_BENCH_print_throughput("math_average", "call", (AT_BENCH_ITERATIONS * AT_BENCH_MATH_CALLS_PER_MEASUREMENT), average_ns);
+	AT_BENCH_print_throughput("math_statistics_add", "sample", (AT_BENCH_ITERATIONS * MATH_MEDIAN_FILTER_LENGTH_MAX), statistics_ns);
+}
+
+/*** AT BENCH functions ***/
+
+/* REPLAY SYNTHETIC AT TRAFFIC AND PRINT THROUGHPUT, LATENCY AND STACK USAGE OF EACH SCENARIO, THEN AES AND STATISTICS THROUGHPUT.
+ * @param:	None.
+ * @return:	None.
+ */
+void AT_BENCH_run(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	AT_BENCH_build_lines();
+	// Responses are only counted (UART time is not measured).
+	LPUART1_disable_rx();
+	AT_set_response_callback(&AT_BENCH_response_callback);
+	for (idx=0 ; idx<(sizeof(AT_BENCH_SCENARIO_LIST) / sizeof(AT_BENCH_scenario_t)) ; idx++) {
+		AT_BENCH_run_scenario(&(AT_BENCH_SCENARIO_LIST[idx]));
+	}
+	AT_BENCH_run_aes();
+	AT_BENCH_run_math();
+	AT_set_response_callback(0);
+	LPUART1_enable_rx();
+}
+
+#endif /* AT_BENCH */
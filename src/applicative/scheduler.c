@@ -0,0 +1,116 @@
+/*
+ * scheduler.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "scheduler.h"
+
+#include "core.h"
+#include "iwdg.h"
+#include "pwr.h"
+
+/*** SCHEDULER local structures ***/
+
+typedef struct {
+	// One byte per event: posting from interrupt is a single store (no read-modify-write race with the main loop).
+	volatile unsigned char event_flag[SCHEDULER_EVENT_LAST];
+	SCHEDULER_handler_t handler[SCHEDULER_EVENT_LAST];
+} SCHEDULER_context_t;
+
+/*** SCHEDULER local global variables ***/
+
+static SCHEDULER_context_t scheduler_ctx;
+
+/*** SCHEDULER local functions ***/
+
+/* CHECK IF AN EVENT IS PENDING.
+ * @param:	None.
+ * @return:	1 if at least one event is pending, 0 otherwise.
+ */
+static unsigned char SCHEDULER_is_event_pending(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	for (idx=0 ; idx<SCHEDULER_EVENT_LAST ; idx++) {
+		if (scheduler_ctx.event_flag[idx] != 0) return 1;
+	}
+	return 0;
+}
+
+/* RUN THE HIGHEST PRIORITY PENDING TASK.
+ * @param:	None.
+ * @return:	1 if a task was executed, 0 if no event is pending.
+ */
+static unsigned char SCHEDULER_run_next_task(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	// Search pending event.
+	for (idx=0 ; idx<SCHEDULER_EVENT_LAST ; idx++) {
+		if (scheduler_ctx.event_flag[idx] != 0) {
+			// Clear flag before running task so that events posted meanwhile are not lost.
+			scheduler_ctx.event_flag[idx] = 0;
+			if (scheduler_ctx.handler[idx] != 0) {
+				scheduler_ctx.handler[idx]();
+			}
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*** SCHEDULER functions ***/
+
+/* INIT SCHEDULER.
+ * @param:	None.
+ * @return:	None.
+ */
+void SCHEDULER_init(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	// Init context.
+	for (idx=0 ; idx<SCHEDULER_EVENT_LAST ; idx++) {
+		scheduler_ctx.event_flag[idx] = 0;
+		scheduler_ctx.handler[idx] = 0;
+	}
+}
+
+/* REGISTER THE TASK RUN WHEN AN EVENT IS POSTED.
+ * @param event:	Event triggering the task.
+ * @param handler:	Run-to-completion task function.
+ * @return:			None.
+ */
+void SCHEDULER_register_task(SCHEDULER_event_t event, SCHEDULER_handler_t handler) {
+	if (event < SCHEDULER_EVENT_LAST) {
+		scheduler_ctx.handler[event] = handler;
+	}
+}
+
+/* POST AN EVENT (CAN BE CALLED FROM INTERRUPT).
+ * @param event:	Event to post.
+ * @return:			None.
+ */
+void SCHEDULER_post_event(SCHEDULER_event_t event) {
+	if (event < SCHEDULER_EVENT_LAST) {
+		scheduler_ctx.event_flag[event] = 1;
+	}
+}
+
+/* SCHEDULER MAIN LOOP (NEVER RETURNS).
+ * @param:	None.
+ * @return:	None.
+ */
+void SCHEDULER_run(void) {
+	while (1) {
+		IWDG_reload();
+		// Run pending tasks one by one (priority is re-evaluated after each task).
+		if (SCHEDULER_run_next_task() != 0) continue;
+		// No runnable task: enter low power mode with interrupts masked to avoid missing an event posted after the check.
+		CORE_disable_interrupts();
+		if (SCHEDULER_is_event_pending() == 0) {
+			// Pending interrupts still wake-up the core while masked, they are serviced after unmasking.
+			PWR_enter_low_power_mode();
+		}
+		CORE_enable_interrupts();
+	}
+}
@@ -0,0 +1,285 @@
+/*
+ * telemetry.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "telemetry.h"
+
+#include "adc.h"
+#include "iwdg.h"
+#include "lptim.h"
+#include "nvm.h"
+#include "rtc.h"
+#include "scheduler.h"
+
+/*** TELEMETRY local structures ***/
+
+typedef struct {
+	unsigned int max_age_seconds;
+	// Idle measurements.
+	unsigned int voltage_rf_mv;
+	unsigned int voltage_idle_mv;
+	signed char temperature_degrees;
+	unsigned int idle_timestamp_seconds;
+	unsigned char idle_valid;
+	// Measurement performed during last transmission.
+	unsigned int voltage_tx_mv;
+	unsigned char voltage_tx_valid;
+	unsigned char tx_capture_armed;
+	// Supply monitoring.
+	unsigned int vrf_limit_mv;
+	unsigned int vmcu_limit_mv;
+	unsigned char supply_watchdog_running;
+	unsigned char tx_supply_drop;
+	TELEMETRY_supply_status_t supply_status;
+} TELEMETRY_context_t;
+
+/*** TELEMETRY local global variables ***/
+
+static TELEMETRY_context_t telemetry_ctx;
+
+/*** TELEMETRY local functions ***/
+
+/* GET AGE OF IDLE MEASUREMENTS.
+ * @param:	None.
+ * @return:	Age in seconds.
+ */
+static unsigned int TELEMETRY_get_idle_age(void) {
+	return (RTC_get_timestamp_seconds() - telemetry_ctx.idle_timestamp_seconds);
+}
+
+/* READ A 16-BITS VALUE IN NVM.
+ * @param address:	NVM address of the value (little endian).
+ * @return:			Value read.
+ */
+static unsigned int TELEMETRY_read_nvm_short(unsigned short address) {
+	// Local variables.
+	unsigned char lsb = 0;
+	unsigned char msb = 0;
+	// Read bytes.
+	NVM_enable();
+	NVM_read_byte((address + 0), &lsb);
+	NVM_read_byte((address + 1), &msb);
+	NVM_disable();
+	return ((msb << 8) | lsb);
+}
+
+/* COMPARE CACHED IDLE MEASUREMENTS WITH SUPPLY LIMITS.
+ * @param:	None.
+ * @return:	None.
+ */
+static void TELEMETRY_update_supply_status(void) {
+	// Check both supplies (a null limit disables the check).
+	telemetry_ctx.supply_status = TELEMETRY_SUPPLY_OK;
+	if ((telemetry_ctx.vrf_limit_mv != 0) && (telemetry_ctx.voltage_rf_mv < telemetry_ctx.vrf_limit_mv)) {
+		telemetry_ctx.supply_status = TELEMETRY_SUPPLY_LOW;
+	}
+	if ((telemetry_ctx.vmcu_limit_mv != 0) && (telemetry_ctx.voltage_idle_mv < telemetry_ctx.vmcu_limit_mv)) {
+		telemetry_ctx.supply_status = TELEMETRY_SUPPLY_LOW;
+	}
+}
+
+/*** TELEMETRY functions ***/
+
+/* INIT TELEMETRY SERVICE.
+ * @param:	None.
+ * @return:	None.
+ */
+void TELEMETRY_init(void) {
+	// Init context.
+	telemetry_ctx.max_age_seconds = TELEMETRY_MAX_AGE_SECONDS_DEFAULT;
+	telemetry_ctx.voltage_rf_mv = 0;
+	telemetry_ctx.voltage_idle_mv = 0;
+	telemetry_ctx.temperature_degrees = 0;
+	telemetry_ctx.idle_timestamp_seconds = 0;
+	telemetry_ctx.idle_valid = 0;
+	telemetry_ctx.voltage_tx_mv = 0;
+	telemetry_ctx.voltage_tx_valid = 0;
+	telemetry_ctx.tx_capture_armed = 0;
+	telemetry_ctx.supply_watchdog_running = 0;
+	telemetry_ctx.tx_supply_drop = 0;
+	telemetry_ctx.supply_status = TELEMETRY_SUPPLY_OK;
+	// Load supply limits.
+	telemetry_ctx.vrf_limit_mv = TELEMETRY_read_nvm_short(NVM_ADDRESS_VRF_LIMIT_MV);
+	telemetry_ctx.vmcu_limit_mv = TELEMETRY_read_nvm_short(NVM_ADDRESS_VMCU_LIMIT_MV);
+	// First measurement.
+	SCHEDULER_post_event(SCHEDULER_EVENT_TELEMETRY);
+}
+
+/* SET MAXIMUM AGE OF CACHED MEASUREMENTS.
+ * @param max_age_seconds:	Maximum age in seconds (0 forces a new measurement on each request).
+ * @return:					None.
+ */
+void TELEMETRY_set_max_age(unsigned int max_age_seconds) {
+	telemetry_ctx.max_age_seconds = max_age_seconds;
+}
+
+/* GET MAXIMUM AGE OF CACHED MEASUREMENTS.
+ * @param:	None.
+ * @return:	Maximum age in seconds.
+ */
+unsigned int TELEMETRY_get_max_age(void) {
+	return telemetry_ctx.max_age_seconds;
+}
+
+/* PERFORM IDLE MEASUREMENTS AND UPDATE CACHE.
+ * @param:	None.
+ * @return:	None.
+ */
+void TELEMETRY_refresh(void) {
+	// Perform measurements.
+	ADC1_init();
+	ADC1_perform_measurements();
+	ADC1_disable();
+	// Update cache.
+	ADC1_get_data(ADC_DATA_IDX_VPV_MV, &telemetry_ctx.voltage_rf_mv);
+	ADC1_get_data(ADC_DATA_IDX_VMCU_MV, &telemetry_ctx.voltage_idle_mv);
+	ADC1_get_tmcu_comp2(&telemetry_ctx.temperature_degrees);
+	telemetry_ctx.idle_timestamp_seconds = RTC_get_timestamp_seconds();
+	telemetry_ctx.idle_valid = 1;
+	// Background supply check.
+	TELEMETRY_update_supply_status();
+}
+
+/* TELEMETRY TASK (POSTED WHEN THE MCU IS ALREADY AWAKE, NEVER FROM A DEDICATED WAKE-UP).
+ * @param:	None.
+ * @return:	None.
+ */
+void TELEMETRY_task(void) {
+	// Refresh cache opportunistically once it reaches half the maximum age, so that requests rarely wait for a measurement.
+	if ((telemetry_ctx.idle_valid == 0) || (TELEMETRY_get_idle_age() > (telemetry_ctx.max_age_seconds >> 1))) {
+		TELEMETRY_refresh();
+	}
+}
+
+/* PREPARE MEASUREMENT DURING TRANSMISSION (TO BE CALLED BEFORE RADIO START).
+ * @param:	None.
+ * @return:	None.
+ */
+void TELEMETRY_start_tx_capture(void) {
+	// Power ADC and internal references before transmission to keep capture short.
+	ADC1_init();
+	telemetry_ctx.tx_capture_armed = 1;
+}
+
+/* MEASURE SUPPLY VOLTAGE DURING TRANSMISSION.
+ * @param:	None.
+ * @return:	None.
+ */
+void TELEMETRY_capture_tx(void) {
+	// Check capture has been prepared.
+	if (telemetry_ctx.tx_capture_armed == 0) return;
+	// Perform measurements.
+	ADC1_perform_measurements();
+	ADC1_get_data(ADC_DATA_IDX_VMCU_MV, &telemetry_ctx.voltage_tx_mv);
+	telemetry_ctx.voltage_tx_valid = 1;
+	telemetry_ctx.tx_capture_armed = 0;
+	// Monitor RF and MCU supplies with analog watchdog until the end of transmission.
+	if ((telemetry_ctx.vrf_limit_mv != 0) || (telemetry_ctx.vmcu_limit_mv != 0)) {
+		ADC1_start_supply_watchdog(telemetry_ctx.vrf_limit_mv, telemetry_ctx.vmcu_limit_mv);
+		telemetry_ctx.supply_watchdog_running = 1;
+	}
+	else {
+		ADC1_disable();
+	}
+}
+
+/* STOP SUPPLY MONITORING AT THE END OF TRANSMISSION.
+ * @param:	None.
+ * @return:	None.
+ */
+void TELEMETRY_stop_tx_capture(void) {
+	// Check analog watchdog status.
+	if (telemetry_ctx.supply_watchdog_running != 0) {
+		if (ADC1_get_supply_watchdog_flag() != 0) {
+			// Force a new check before next transmission.
+			telemetry_ctx.tx_supply_drop = 1;
+		}
+		ADC1_stop_supply_watchdog();
+		ADC1_disable();
+		telemetry_ctx.supply_watchdog_running = 0;
+	}
+	// Abort capture if it was not performed.
+	if (telemetry_ctx.tx_capture_armed != 0) {
+		ADC1_disable();
+		telemetry_ctx.tx_capture_armed = 0;
+	}
+}
+
+/* SET SUPPLY MONITORING LIMITS.
+ * @param vrf_limit_mv:		RF supply minimum voltage in mV (0 to disable).
+ * @param vmcu_limit_mv:	MCU supply minimum voltage in mV (0 to disable).
+ * @return:					None.
+ */
+void TELEMETRY_set_supply_limits(unsigned int vrf_limit_mv, unsigned int vmcu_limit_mv) {
+	// Update context.
+	telemetry_ctx.vrf_limit_mv = (vrf_limit_mv & 0xFFFF);
+	telemetry_ctx.vmcu_limit_mv = (vmcu_limit_mv & 0xFFFF);
+	// Store limits in NVM.
+	NVM_enable();
+	NVM_write_byte((NVM_ADDRESS_VRF_LIMIT_MV + 0), (telemetry_ctx.vrf_limit_mv >> 0) & 0xFF);
+	NVM_write_byte((NVM_ADDRESS_VRF_LIMIT_MV + 1), (telemetry_ctx.vrf_limit_mv >> 8) & 0xFF);
+	NVM_write_byte((NVM_ADDRESS_VMCU_LIMIT_MV + 0), (telemetry_ctx.vmcu_limit_mv >> 0) & 0xFF);
+	NVM_write_byte((NVM_ADDRESS_VMCU_LIMIT_MV + 1), (telemetry_ctx.vmcu_limit_mv >> 8) & 0xFF);
+	NVM_disable();
+	// Update status.
+	TELEMETRY_update_supply_status();
+}
+
+/* GET SUPPLY MONITORING LIMITS.
+ * @param vrf_limit_mv:		Pointer that will contain the RF supply minimum voltage in mV.
+ * @param vmcu_limit_mv:	Pointer that will contain the MCU supply minimum voltage in mV.
+ * @return:					None.
+ */
+void TELEMETRY_get_supply_limits(unsigned int* vrf_limit_mv, unsigned int* vmcu_limit_mv) {
+	(*vrf_limit_mv) = telemetry_ctx.vrf_limit_mv;
+	(*vmcu_limit_mv) = telemetry_ctx.vmcu_limit_mv;
+}
+
+/* CHECK SUPPLY BEFORE TRANSMISSION (TRANSMISSION IS DEFERRED WHILE SUPPLY IS LOW).
+ * @param:	None.
+ * @return:	Supply status after deferral.
+ */
+TELEMETRY_supply_status_t TELEMETRY_check_supply(void) {
+	// Local variables.
+	unsigned int defer_seconds = 0;
+	// Monitoring disabled.
+	if ((telemetry_ctx.vrf_limit_mv == 0) && (telemetry_ctx.vmcu_limit_mv == 0)) return TELEMETRY_SUPPLY_OK;
+	// Measure again if cache is too old or if supply dropped during previous transmission.
+	if ((telemetry_ctx.idle_valid == 0) || (telemetry_ctx.tx_supply_drop != 0) || (TELEMETRY_get_idle_age() > telemetry_ctx.max_age_seconds)) {
+		TELEMETRY_refresh();
+		telemetry_ctx.tx_supply_drop = 0;
+	}
+	// Wait for supply recovery.
+	while (telemetry_ctx.supply_status != TELEMETRY_SUPPLY_OK) {
+		if (defer_seconds >= TELEMETRY_SUPPLY_DEFER_MAX_SECONDS) break;
+		LPTIM1_delay_milliseconds(1000, 1);
+		IWDG_reload();
+		defer_seconds++;
+		TELEMETRY_refresh();
+	}
+	return telemetry_ctx.supply_status;
+}
+
+/* GET TELEMETRY DATA (NEW IDLE MEASUREMENT IS PERFORMED IF CACHE IS TOO OLD).
+ * @param telemetry_data:	Pointer to structure that will contain the data.
+ * @return:					None.
+ */
+void TELEMETRY_get_data(TELEMETRY_data_t* telemetry_data) {
+	// Abort pending capture.
+	TELEMETRY_stop_tx_capture();
+	// Check cache age.
+	if ((telemetry_ctx.idle_valid == 0) || (TELEMETRY_get_idle_age() > telemetry_ctx.max_age_seconds)) {
+		TELEMETRY_refresh();
+	}
+	// Copy data.
+	telemetry_data -> voltage_rf_mv = telemetry_ctx.voltage_rf_mv;
+	telemetry_data -> voltage_idle_mv = telemetry_ctx.voltage_idle_mv;
+	telemetry_data -> temperature_degrees = telemetry_ctx.temperature_degrees;
+	telemetry_data -> idle_age_seconds = TELEMETRY_get_idle_age();
+	telemetry_data -> voltage_tx_valid = telemetry_ctx.voltage_tx_valid;
+	telemetry_data -> voltage_tx_mv = (telemetry_ctx.voltage_tx_valid != 0) ? telemetry_ctx.voltage_tx_mv : telemetry_ctx.voltage_idle_mv;
+	telemetry_data -> supply_status = telemetry_ctx.supply_status;
+}
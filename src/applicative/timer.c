@@ -0,0 +1,226 @@
+/*
+ * timer.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "timer.h"
+
+#include "core.h"
+#include "iwdg.h"
+#include "lptim.h"
+#include "pwr.h"
+#include "rtc.h"
+
+/*** TIMER local macros ***/
+
+// Longest delay programmed in hardware before the watchdog is reloaded.
+// Warning: this value must be lower than the watchdog period = 25s.
+#define TIMER_HARDWARE_DELAY_MAX_SECONDS	IWDG_REFRESH_PERIOD_SECONDS
+
+/*** TIMER local structures ***/
+
+typedef struct {
+	TIMER_t* head; // Running timers sorted by deadline.
+} TIMER_context_t;
+
+/*** TIMER local global variables ***/
+
+static TIMER_context_t timer_ctx;
+
+/*** TIMER local functions ***/
+
+/* CHECK IF A DEADLINE IS REACHED (WRAP-AROUND SAFE).
+ * @param deadline_ms:	Deadline to check.
+ * @param now_ms:		Current time.
+ * @return:				1 if the deadline is reached, 0 otherwise.
+ */
+static unsigned char TIMER_is_expired(unsigned int deadline_ms, unsigned int now_ms) {
+	return (((signed int) (now_ms - deadline_ms)) >= 0) ? 1 : 0;
+}
+
+/* REMOVE A TIMER FROM THE RUNNING LIST.
+ * @param timer:	Timer to remove.
+ * @return:			None.
+ */
+static void TIMER_unlink(TIMER_t* timer) {
+	// Local variables.
+	TIMER_t** link = &(timer_ctx.head);
+	// Search timer.
+	while ((*link) != 0) {
+		if ((*link) == timer) {
+			(*link) = (timer -> next);
+			break;
+		}
+		link = &((*link) -> next);
+	}
+	timer -> next = 0;
+	timer -> running = 0;
+}
+
+/* INSERT A TIMER IN THE RUNNING LIST (SORTED BY DEADLINE).
+ * @param timer:	Timer to insert.
+ * @param now_ms:	Current time used as reference for deadline comparison.
+ * @return:			None.
+ */
+static void TIMER_link(TIMER_t* timer, unsigned int now_ms) {
+	// Local variables.
+	TIMER_t** link = &(timer_ctx.head);
+	// Search position (relative to now to handle wrap-around).
+	while (((*link) != 0) && (((*link) -> deadline_ms - now_ms) <= ((timer -> deadline_ms) - now_ms))) {
+		link = &((*link) -> next);
+	}
+	timer -> next = (*link);
+	(*link) = timer;
+	timer -> running = 1;
+}
+
+/* PROGRAM HARDWARE TIMER FOR THE NEAREST DEADLINE.
+ * @param now_ms:	Current time.
+ * @return:			None.
+ */
+static void TIMER_program_hardware(unsigned int now_ms) {
+	// Local variables.
+	unsigned int delay_ms = (TIMER_HARDWARE_DELAY_MAX_SECONDS * 1000);
+	// Compute delay to nearest deadline.
+	if (timer_ctx.head != 0) {
+		if (TIMER_is_expired(timer_ctx.head -> deadline_ms, now_ms) != 0) {
+			delay_ms = 1;
+		}
+		else if (((timer_ctx.head -> deadline_ms) - now_ms) < delay_ms) {
+			delay_ms = ((timer_ctx.head -> deadline_ms) - now_ms);
+		}
+	}
+	// Restart wake-up timer (idle chunks also guarantee the watchdog is fed).
+	RTC_stop_wakeup_timer();
+	RTC_clear_wakeup_timer_flag();
+	RTC_start_wakeup_timer_milliseconds(delay_ms);
+}
+
+/*** TIMER functions ***/
+
+/* INIT TIMER SERVICE.
+ * @param:	None.
+ * @return:	None.
+ */
+void TIMER_init(void) {
+	// Init context.
+	timer_ctx.head = 0;
+	// Start idle chunk.
+	TIMER_program_hardware(TIMER_get_time_ms());
+}
+
+/* GET CURRENT TIME OF THE TIMER SERVICE.
+ * @param:	None.
+ * @return:	Current time in ms (wraps around, only differences are meaningful).
+ */
+unsigned int TIMER_get_time_ms(void) {
+	return LPTIM1_get_timestamp_ms();
+}
+
+/* START A SOFTWARE TIMER.
+ * @param timer:		Timer structure (owned by the caller, must remain valid while running).
+ * @param duration_ms:	Delay before first expiration.
+ * @param period_ms:	Reload period, 0 for a single shot timer.
+ * @param callback:		Function called from TIMER_task() on expiration (can be null).
+ * @return:				None.
+ */
+void TIMER_start(TIMER_t* timer, unsigned int duration_ms, unsigned int period_ms, TIMER_callback_t callback) {
+	// Local variables.
+	unsigned int now_ms = TIMER_get_time_ms();
+	// Restart timer if already running.
+	TIMER_unlink(timer);
+	// Round deadline up so that the timer never expires early.
+	timer -> deadline_ms = now_ms + duration_ms + (TIMER_RESOLUTION_MS - 1);
+	timer -> period_ms = period_ms;
+	timer -> callback = callback;
+	TIMER_link(timer, now_ms);
+	// Update hardware if the new timer is the nearest one.
+	if (timer_ctx.head == timer) {
+		TIMER_program_hardware(now_ms);
+	}
+}
+
+/* STOP A SOFTWARE TIMER.
+ * @param timer:	Timer to stop.
+ * @return:			None.
+ */
+void TIMER_stop(TIMER_t* timer) {
+	// Local variables.
+	unsigned char was_head = (timer_ctx.head == timer) ? 1 : 0;
+	TIMER_unlink(timer);
+	// Update hardware if the nearest deadline was removed (avoid a useless wake-up).
+	if (was_head != 0) {
+		TIMER_program_hardware(TIMER_get_time_ms());
+	}
+}
+
+/* GET SOFTWARE TIMER STATUS.
+ * @param timer:	Timer to check.
+ * @return:			1 if the timer is running, 0 if it expired or was stopped.
+ */
+unsigned char TIMER_is_running(TIMER_t* timer) {
+	return (timer -> running);
+}
+
+/* PROCESS EXPIRED TIMERS AND PROGRAM HARDWARE FOR THE NEXT DEADLINE (TO BE CALLED AFTER EACH WAKE-UP).
+ * @param:	None.
+ * @return:	None.
+ */
+void TIMER_task(void) {
+	// Local variables.
+	unsigned int now_ms = TIMER_get_time_ms();
+	TIMER_t* timer = 0;
+	// Process expired timers in deadline order.
+	while ((timer_ctx.head != 0) && (TIMER_is_expired(timer_ctx.head -> deadline_ms, now_ms) != 0)) {
+		timer = timer_ctx.head;
+		TIMER_unlink(timer);
+		// Reload periodic timer.
+		if ((timer -> period_ms) != 0) {
+			timer -> deadline_ms += (timer -> period_ms);
+			// Skip missed periods.
+			if (TIMER_is_expired(timer -> deadline_ms, now_ms) != 0) {
+				timer -> deadline_ms = now_ms + (timer -> period_ms);
+			}
+			TIMER_link(timer, now_ms);
+		}
+		// Execute callback (may start or stop timers).
+		if ((timer -> callback) != 0) {
+			timer -> callback();
+		}
+		now_ms = TIMER_get_time_ms();
+	}
+	// Program next wake-up if hardware expired or list changed.
+	if ((RTC_get_wakeup_timer_flag() != 0) || (timer != 0)) {
+		TIMER_program_hardware(now_ms);
+	}
+}
+
+/* WAIT FOR A SOFTWARE TIMER EXPIRATION IN STOP MODE (WATCHDOG IS FED BETWEEN CHUNKS).
+ * @param timer:		Timer to wait for.
+ * @param wake_up_flag:	Optional flag which ends the wait when set by an interrupt (can be null).
+ * @return:				None.
+ */
+void TIMER_wait(TIMER_t* timer, volatile unsigned char* wake_up_flag) {
+	// Local variables.
+	unsigned char wait = 0;
+	// Clear watchdog.
+	IWDG_reload();
+	while (1) {
+		// Check conditions with interrupts masked so that an event occuring before WFI is not missed.
+		CORE_disable_interrupts();
+		wait = TIMER_is_running(timer);
+		if ((wake_up_flag != 0) && ((*wake_up_flag) != 0)) {
+			wait = 0;
+		}
+		if (wait != 0) {
+			// Enter stop mode until nearest deadline, watchdog chunk or interrupt (a pending interrupt wakes-up the core while masked).
+			PWR_enter_low_power_mode();
+		}
+		CORE_enable_interrupts();
+		if (wait == 0) break;
+		IWDG_reload();
+		TIMER_task();
+	}
+}
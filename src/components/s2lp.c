@@ -12,9 +12,11 @@
 #include "gpio.h"
 #include "lptim.h"
 #include "mapping.h"
+#include "probe.h"
 #include "pwr.h"
 #include "s2lp_reg.h"
 #include "spi.h"
+#include "trace.h"
 
 /*** S2LP local macros ***/
 
@@ -31,6 +33,10 @@
 
 #define S2LP_TX_FIFO_USE_DMA // Use DMA to fill TX FIFO, standard SPI access otherwise.
 
+/*** S2LP local global variables ***/
+
+static GPIO_pin_t s2lp_fifo_cs_gpio; // Copy of chip select pin used during uplink (mapping constants are located in flash).
+
 /*** S2LP local functions ***/
 
 /* S2LP REGISTER WRITE FUNCTION.
@@ -72,6 +78,8 @@ static void S2LP_read_register(unsigned char addr, unsigned char* value) {
  * @return:	None.
  */
 void S2LP_init(void) {
+	// Copy chip select pin for FIFO accesses.
+	s2lp_fifo_cs_gpio = GPIO_S2LP_CS;
 	// Configure TCXO power control pin.
 	GPIO_configure(&GPIO_TCXO_POWER_ENABLE, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
 	GPIO_write(&GPIO_TCXO_POWER_ENABLE, 0);
@@ -146,6 +154,7 @@ void S2LP_exit_shutdown(void) {
  * @return:			None.
  */
 void S2LP_send_command(S2LP_command_t command) {
+	TRACE_event(TRACE_EVENT_S2LP_COMMAND, command);
 	// Falling edge on CS pin.
 	GPIO_write(&GPIO_S2LP_CS, 0);
 	// Write sequence.
@@ -518,13 +527,14 @@ void S2LP_set_tx_source(S2LP_tx_source_t tx_source) {
  * @param:	None.
  * @return:	None.
  */
-void S2LP_write_fifo(unsigned char* tx_data, unsigned char tx_data_length_bytes) {
+void __attribute__((section(".ramfunc"))) S2LP_write_fifo(unsigned char* tx_data, unsigned char tx_data_length_bytes) {
 #ifdef S2LP_TX_FIFO_USE_DMA
 	// Set buffer address.
-	DMA1_set_channel3_source_addr((unsigned int) tx_data, tx_data_length_bytes);
+	DMA1_set_channel3_source_addr((unsigned long) tx_data, tx_data_length_bytes);
 #endif
 	// Falling edge on CS pin.
-	GPIO_write(&GPIO_S2LP_CS, 0);
+	PROBE_high(PROBE_SPI_BURST_TP);
+	GPIO_write(&s2lp_fifo_cs_gpio, 0);
 	// Access FIFO.
 	SPI1_write_byte(S2LP_HEADER_BYTE_WRITE); // A/C='1' and W/R='0'.
 	SPI1_write_byte(S2LP_REG_FIFO);
@@ -542,7 +552,8 @@ void S2LP_write_fifo(unsigned char* tx_data, unsigned char tx_data_length_bytes)
 	}
 #endif
 	// Rising edge on CS pin.
-	GPIO_write(&GPIO_S2LP_CS, 1);
+	GPIO_write(&s2lp_fifo_cs_gpio, 1);
+	PROBE_low(PROBE_SPI_BURST_TP);
 }
 
 /* SET S2LP RX SOURCE.
@@ -0,0 +1,312 @@
+/*
+ * adc_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "adc_model.h"
+
+#include "adc_reg.h"
+#include "bus.h"
+#include "dma_model.h"
+#include "host.h"
+#include "nvic.h"
+#include <stddef.h>
+#include <stdlib.h>
+
+/*** ADC MODEL local macros ***/
+
+#define ADC_MODEL_VMCU_VARIABLE				"HOST_ADC_VMCU_MV"
+#define ADC_MODEL_VRF_VARIABLE				"HOST_ADC_VRF_MV"
+#define ADC_MODEL_TMCU_VARIABLE				"HOST_ADC_TMCU_DEGREES"
+
+#define ADC_MODEL_CHANNEL_NUMBER			19
+#define ADC_MODEL_CHANNEL_VRF				7
+#define ADC_MODEL_CHANNEL_VREFINT			17
+#define ADC_MODEL_CHANNEL_TMCU				18
+#define ADC_MODEL_CHANNEL_NONE				0xFF
+
+#define ADC_MODEL_FULL_SCALE				4095
+#define ADC_MODEL_VRF_DIVIDER_RATIO			10
+#define ADC_MODEL_CONVERSION_HALF_CYCLES	25 // 12.5 ADC clock cycles.
+#define ADC_MODEL_ISR_FLAGS_MASK			0x0000089F
+
+// Factory calibration values (typical device).
+#define ADC_MODEL_CALIBRATION_ADDRESS		0x1FF80078
+#define ADC_MODEL_CALIBRATION_SIZE			8
+#define ADC_MODEL_VREFINT_CAL				1671
+#define ADC_MODEL_TS_CAL1					914
+#define ADC_MODEL_TS_CAL2					1134
+
+/*** ADC MODEL callbacks declaration ***/
+
+static void ADC_MODEL_conversion_event_callback(void);
+
+/*** ADC MODEL local structures ***/
+
+typedef struct {
+	ADC_base_address_t* adc;
+	unsigned short* calibration;
+	// Analog inputs.
+	int vmcu_mv;
+	int vrf_mv;
+	int tmcu_degrees;
+	int raw_value[ADC_MODEL_INPUT_LAST]; // Forced 12-bits results (ADC_MODEL_RAW_VALUE_NONE to use analog inputs).
+	// Sequence.
+	unsigned char channel; // Channel being converted.
+	HOST_event_t conversion_event;
+} ADC_MODEL_context_t;
+
+/*** ADC MODEL local global variables ***/
+
+static ADC_MODEL_context_t adc_model_ctx;
+static const unsigned short ADC_MODEL_SMP_HALF_CYCLES[8] = {3, 7, 15, 25, 39, 79, 159, 321};
+
+/*** ADC MODEL local functions ***/
+
+/* UPDATE ADC INTERRUPT LINE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void ADC_MODEL_update_irq(void) {
+	if (((adc_model_ctx.adc -> ISR) & (adc_model_ctx.adc -> IER) & ADC_MODEL_ISR_FLAGS_MASK) != 0) {
+		HOST_set_irq_pending(NVIC_IT_ADC_COMP);
+	}
+}
+
+/* GET NEXT CHANNEL OF THE SEQUENCE.
+ * @param channel:	Current channel (ADC_MODEL_CHANNEL_NONE to get the first one).
+ * @return:			Next selected channel (forward scan), ADC_MODEL_CHANNEL_NONE at the end of the sequence.
+ */
+static unsigned char ADC_MODEL_get_next_channel(unsigned char channel) {
+	channel = (channel == ADC_MODEL_CHANNEL_NONE) ? 0 : (channel + 1);
+	for (; channel<ADC_MODEL_CHANNEL_NUMBER ; channel++) {
+		if (((adc_model_ctx.adc -> CHSELR) & (0b1 << channel)) != 0) return channel;
+	}
+	return ADC_MODEL_CHANNEL_NONE;
+}
+
+/* GET THE 12-BITS RESULT OF A CHANNEL.
+ * @param channel:	Channel to convert.
+ * @return:			Raw result.
+ */
+static int ADC_MODEL_get_raw_value(unsigned char channel) {
+	// Local variables.
+	int ts_cal1 = (int) adc_model_ctx.calibration[1];
+	int ts_cal2 = (int) adc_model_ctx.calibration[3];
+	int raw = 0;
+	switch (channel) {
+	case ADC_MODEL_CHANNEL_VRF:
+		raw = ((adc_model_ctx.vrf_mv / ADC_MODEL_VRF_DIVIDER_RATIO) * ADC_MODEL_FULL_SCALE) / adc_model_ctx.vmcu_mv;
+		if (adc_model_ctx.raw_value[ADC_MODEL_INPUT_VRF] != ADC_MODEL_RAW_VALUE_NONE) raw = adc_model_ctx.raw_value[ADC_MODEL_INPUT_VRF];
+		break;
+	case ADC_MODEL_CHANNEL_VREFINT:
+		// Internal reference buffer must be enabled (VREFEN='1').
+		if (((adc_model_ctx.adc -> CCR) & (0b1 << 22)) == 0) break;
+		raw = ((int) adc_model_ctx.calibration[0] * VREFINT_VCC_CALIB_MV) / adc_model_ctx.vmcu_mv;
+		if (adc_model_ctx.raw_value[ADC_MODEL_INPUT_VREFINT] != ADC_MODEL_RAW_VALUE_NONE) raw = adc_model_ctx.raw_value[ADC_MODEL_INPUT_VREFINT];
+		break;
+	case ADC_MODEL_CHANNEL_TMCU:
+		// Temperature sensor must be enabled (TSEN='1').
+		if (((adc_model_ctx.adc -> CCR) & (0b1 << 23)) == 0) break;
+		raw = ts_cal1 + (((adc_model_ctx.tmcu_degrees - TS_CAL1_TEMP) * (ts_cal2 - ts_cal1)) / (TS_CAL2_TEMP - TS_CAL1_TEMP));
+		raw = (raw * TS_VCC_CALIB_MV) / adc_model_ctx.vmcu_mv;
+		if (adc_model_ctx.raw_value[ADC_MODEL_INPUT_TMCU] != ADC_MODEL_RAW_VALUE_NONE) raw = adc_model_ctx.raw_value[ADC_MODEL_INPUT_TMCU];
+		break;
+	default:
+		break;
+	}
+	if (raw < 0) raw = 0;
+	if (raw > ADC_MODEL_FULL_SCALE) raw = ADC_MODEL_FULL_SCALE;
+	return raw;
+}
+
+/* START CONVERSION OF A CHANNEL.
+ * @param channel:	Channel to convert.
+ * @return:			None.
+ */
+static void ADC_MODEL_start_conversion(unsigned char channel) {
+	// Local variables.
+	unsigned long long cycles = (ADC_MODEL_SMP_HALF_CYCLES[(adc_model_ctx.adc -> SMPR) & 0b111] + ADC_MODEL_CONVERSION_HALF_CYCLES);
+	// ADCCLK = SYSCLK / 2: one half ADC cycle is one system clock cycle.
+	if (((adc_model_ctx.adc -> CFGR2) & (0b1 << 0)) != 0) {
+		cycles <<= ((((adc_model_ctx.adc -> CFGR2) >> 2) & 0b111) + 1); // Oversampling ratio.
+	}
+	adc_model_ctx.channel = channel;
+	HOST_start_event_at(&adc_model_ctx.conversion_event, (HOST_get_time_ns() + ((cycles * 1000000ULL) / HOST_get_sysclk_khz())), &ADC_MODEL_conversion_event_callback);
+}
+
+/* END OF CONVERSION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void ADC_MODEL_conversion_event_callback(void) {
+	// Local variables.
+	unsigned int cfgr1 = (adc_model_ctx.adc -> CFGR1);
+	unsigned int cfgr2 = (adc_model_ctx.adc -> CFGR2);
+	unsigned int raw = (unsigned int) ADC_MODEL_get_raw_value(adc_model_ctx.channel);
+	unsigned int data = raw;
+	unsigned char next_channel = 0;
+	// Oversampler accumulates identical samples then shifts the sum.
+	if ((cfgr2 & (0b1 << 0)) != 0) {
+		data = ((raw << (((cfgr2 >> 2) & 0b111) + 1)) >> ((cfgr2 >> 5) & 0b1111));
+	}
+	if (((adc_model_ctx.adc -> ISR) & (0b1 << 2)) != 0) {
+		adc_model_ctx.adc -> ISR |= (0b1 << 4); // OVR='1'.
+	}
+	adc_model_ctx.adc -> DR = data;
+	adc_model_ctx.adc -> ISR |= (0b1 << 2); // EOC='1'.
+	// Analog watchdog on all channels (AWDEN='1' and AWDSGL='0').
+	if ((cfgr1 & (0b1 << 23)) != 0) {
+		if ((raw < ((adc_model_ctx.adc -> TR) & 0x0FFF)) || (raw > (((adc_model_ctx.adc -> TR) >> 16) & 0x0FFF))) {
+			adc_model_ctx.adc -> ISR |= (0b1 << 7); // AWD='1'.
+		}
+	}
+	// Next channel.
+	next_channel = ADC_MODEL_get_next_channel(adc_model_ctx.channel);
+	if (next_channel != ADC_MODEL_CHANNEL_NONE) {
+		ADC_MODEL_start_conversion(next_channel);
+	}
+	else {
+		adc_model_ctx.channel = ADC_MODEL_CHANNEL_NONE;
+		adc_model_ctx.adc -> ISR |= (0b1 << 3); // EOS='1'.
+		// Software triggered sequence is over, hardware triggered sequences wait for the next trigger.
+		if ((cfgr1 & (0b11 << 10)) == 0) {
+			adc_model_ctx.adc -> CR &= ~(0b1 << 2); // ADSTART='0'.
+		}
+	}
+	// Result is read by DMA if enabled.
+	if ((cfgr1 & (0b1 << 0)) != 0) {
+		DMA_MODEL_set_request(DMA_MODEL_REQUEST_ADC, 1);
+	}
+	ADC_MODEL_update_irq();
+}
+
+/* START A SEQUENCE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void ADC_MODEL_start_sequence(void) {
+	// Local variables.
+	unsigned char channel = ADC_MODEL_get_next_channel(ADC_MODEL_CHANNEL_NONE);
+	if (channel == ADC_MODEL_CHANNEL_NONE) return;
+	ADC_MODEL_start_conversion(channel);
+}
+
+/* ADC REGISTERS READ CALLBACK.
+ * @param offset:	Register offset.
+ * @return:			None.
+ */
+static void ADC_MODEL_read_callback(unsigned int offset) {
+	// Reading the data register clears the end of conversion flag.
+	if (offset != offsetof(ADC_base_address_t, DR)) return;
+	adc_model_ctx.adc -> ISR &= ~(0b1 << 2);
+	DMA_MODEL_set_request(DMA_MODEL_REQUEST_ADC, 0);
+}
+
+/* ADC REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void ADC_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int cr = 0;
+	switch (offset) {
+	case offsetof(ADC_base_address_t, ISR):
+		// Flags are cleared by writing '1'.
+		adc_model_ctx.adc -> ISR = (previous_value & ~(adc_model_ctx.adc -> ISR));
+		break;
+	case offsetof(ADC_base_address_t, DR):
+		// Read-only.
+		adc_model_ctx.adc -> DR = previous_value;
+		break;
+	case offsetof(ADC_base_address_t, CR):
+		cr = (adc_model_ctx.adc -> CR);
+		// Calibration is immediate.
+		if ((cr & (0b1 << 31)) != 0) {
+			cr &= ~(0b1 << 31);
+			adc_model_ctx.adc -> ISR |= (0b1 << 11); // EOCAL='1'.
+		}
+		// Stop or disable command.
+		if ((cr & ((0b1 << 4) | (0b1 << 1))) != 0) {
+			HOST_stop_event(&adc_model_ctx.conversion_event);
+			adc_model_ctx.channel = ADC_MODEL_CHANNEL_NONE;
+			cr &= ~((0b1 << 4) | (0b1 << 2)); // ADSTP='0' and ADSTART='0'.
+		}
+		if ((cr & (0b1 << 1)) != 0) {
+			cr &= ~((0b1 << 1) | (0b1 << 0)); // ADDIS='0' and ADEN='0'.
+		}
+		adc_model_ctx.adc -> CR = cr;
+		if ((((cr & ~previous_value) & (0b1 << 0)) != 0)) {
+			adc_model_ctx.adc -> ISR |= (0b1 << 0); // ADRDY='1'.
+		}
+		// Software trigger (EXTEN='00').
+		if ((((cr & ~previous_value) & (0b1 << 2)) != 0) && ((cr & (0b1 << 0)) != 0) && (((adc_model_ctx.adc -> CFGR1) & (0b11 << 10)) == 0)) {
+			ADC_MODEL_start_sequence();
+		}
+		break;
+	default:
+		break;
+	}
+	ADC_MODEL_update_irq();
+}
+
+/* INIT ADC MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) ADC_MODEL_init(void) {
+	// Local variables.
+	char* vmcu = getenv(ADC_MODEL_VMCU_VARIABLE);
+	char* vrf = getenv(ADC_MODEL_VRF_VARIABLE);
+	char* tmcu = getenv(ADC_MODEL_TMCU_VARIABLE);
+	unsigned char idx = 0;
+	// Registers and factory calibration values (VREFINT_CAL, TS_CAL1 and TS_CAL2).
+	adc_model_ctx.adc = BUS_map_peripheral((unsigned long) ADC1, sizeof(ADC_base_address_t), &ADC_MODEL_read_callback, &ADC_MODEL_write_callback);
+	adc_model_ctx.calibration = BUS_map_peripheral(ADC_MODEL_CALIBRATION_ADDRESS, ADC_MODEL_CALIBRATION_SIZE, 0, 0);
+	adc_model_ctx.calibration[0] = ADC_MODEL_VREFINT_CAL;
+	adc_model_ctx.calibration[1] = ADC_MODEL_TS_CAL1;
+	adc_model_ctx.calibration[3] = ADC_MODEL_TS_CAL2;
+	adc_model_ctx.channel = ADC_MODEL_CHANNEL_NONE;
+	// Analog inputs given by environment.
+	adc_model_ctx.vmcu_mv = (vmcu != 0) ? atoi(vmcu) : ADC_MODEL_VMCU_DEFAULT_MV;
+	adc_model_ctx.vrf_mv = (vrf != 0) ? atoi(vrf) : ADC_MODEL_VRF_DEFAULT_MV;
+	adc_model_ctx.tmcu_degrees = (tmcu != 0) ? atoi(tmcu) : ADC_MODEL_TMCU_DEFAULT_DEGREES;
+	if (adc_model_ctx.vmcu_mv <= 0) {
+		adc_model_ctx.vmcu_mv = ADC_MODEL_VMCU_DEFAULT_MV;
+	}
+	for (idx=0 ; idx<ADC_MODEL_INPUT_LAST ; idx++) adc_model_ctx.raw_value[idx] = ADC_MODEL_RAW_VALUE_NONE;
+}
+
+/*** ADC MODEL functions ***/
+
+/* TIM2 TRIGGER OUTPUT EVENT.
+ * @param:	None.
+ * @return:	None.
+ */
+void ADC_MODEL_trigger(void) {
+	// Local variables.
+	unsigned int cfgr1 = (adc_model_ctx.adc -> CFGR1);
+	// Sequence starts on TIM2_TRGO rising edge (EXTEN='01' and EXTSEL='010') if armed and idle.
+	if (((adc_model_ctx.adc -> CR) & ((0b1 << 2) | (0b1 << 0))) != ((0b1 << 2) | (0b1 << 0))) return;
+	if ((((cfgr1 >> 10) & 0b11) != 0b01) || (((cfgr1 >> 6) & 0b111) != 0b010)) return;
+	if (adc_model_ctx.channel != ADC_MODEL_CHANNEL_NONE) return;
+	ADC_MODEL_start_sequence();
+}
+
+/* FORCE THE CONVERSION RESULT OF AN INPUT (HOST TESTS).
+ * @param input:		Input to override.
+ * @param raw_value:	12-bits result, ADC_MODEL_RAW_VALUE_NONE to compute the result from the analog inputs again.
+ * @return:				None.
+ */
+void ADC_MODEL_set_raw_value(ADC_MODEL_input_t input, int raw_value) {
+	if (input >= ADC_MODEL_INPUT_LAST) return;
+	if (raw_value > ADC_MODEL_FULL_SCALE) raw_value = ADC_MODEL_FULL_SCALE;
+	adc_model_ctx.raw_value[input] = (raw_value < 0) ? ADC_MODEL_RAW_VALUE_NONE : raw_value;
+}
+
+#endif /* HOST */
@@ -0,0 +1,234 @@
+/*
+ * aes_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "aes.h"
+#include "aes_reg.h"
+#include "aes_sw.h"
+#include "bus.h"
+#include "dma_model.h"
+#include "host.h"
+#include <stddef.h>
+
+/*** AES MODEL local macros ***/
+
+#define AES_MODEL_WORDS_PER_BLOCK		(AES_BLOCK_SIZE / 4)
+#define AES_MODEL_COMPUTATION_CYCLES	202 // Encryption duration given in RM0377.
+#define AES_MODEL_DATATYPE_BYTE			0b10
+#define AES_MODEL_SWAP_BYTES(word)		((((word) & 0xFF000000) >> 24) | (((word) & 0x00FF0000) >> 8) | (((word) & 0x0000FF00) << 8) | (((word) & 0x000000FF) << 24))
+
+/*** AES MODEL callbacks declaration ***/
+
+static void AES_MODEL_computation_event_callback(void);
+
+/*** AES MODEL local structures ***/
+
+typedef struct {
+	AES_base_address_t* aes;
+	unsigned char data_in[AES_BLOCK_SIZE];
+	unsigned char data_out[AES_BLOCK_SIZE];
+	unsigned char input_count; // Number of input words written.
+	unsigned char output_count; // Number of output words available.
+	unsigned char busy;
+	HOST_event_t computation_event;
+} AES_MODEL_context_t;
+
+/*** AES MODEL local global variables ***/
+
+static AES_MODEL_context_t aes_model_ctx;
+
+/*** AES MODEL local functions ***/
+
+/* CONVERT A DATA WORD ACCORDING TO THE SELECTED DATA TYPE.
+ * @param word:	Register value.
+ * @return:		Word with first byte of the block in most significant position.
+ */
+static unsigned int AES_MODEL_convert_word(unsigned int word) {
+	// Only 32-bits and byte data types are used by the driver.
+	if ((((aes_model_ctx.aes -> CR) >> 1) & 0b11) == AES_MODEL_DATATYPE_BYTE) {
+		word = AES_MODEL_SWAP_BYTES(word);
+	}
+	return word;
+}
+
+/* SPLIT A 32-BITS WORD INTO A BYTE BUFFER.
+ * @param word:		Word to store (most significant byte first).
+ * @param buffer:	Destination buffer.
+ * @return:			None.
+ */
+static void AES_MODEL_store_word(unsigned int word, unsigned char* buffer) {
+	buffer[0] = (unsigned char) (word >> 24);
+	buffer[1] = (unsigned char) (word >> 16);
+	buffer[2] = (unsigned char) (word >> 8);
+	buffer[3] = (unsigned char) (word >> 0);
+}
+
+/* BUILD A 32-BITS WORD FROM A BYTE BUFFER.
+ * @param buffer:	Source buffer.
+ * @return:			Word (first byte in most significant position).
+ */
+static unsigned int AES_MODEL_load_word(unsigned char* buffer) {
+	return (((unsigned int) buffer[0] << 24) | ((unsigned int) buffer[1] << 16) | ((unsigned int) buffer[2] << 8) | ((unsigned int) buffer[3] << 0));
+}
+
+/* UPDATE AES DMA REQUESTS.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AES_MODEL_update_dma_requests(void) {
+	// Local variables.
+	unsigned int cr = (aes_model_ctx.aes -> CR);
+	unsigned char enabled = ((cr & (0b1 << 0)) != 0) ? 1 : 0;
+	unsigned char request_in = 0;
+	unsigned char request_out = 0;
+	// Input request while the block is incomplete, output request while result words remain.
+	if ((enabled != 0) && ((cr & (0b1 << 11)) != 0) && (aes_model_ctx.busy == 0) && (aes_model_ctx.input_count < AES_MODEL_WORDS_PER_BLOCK) && (aes_model_ctx.output_count == 0)) {
+		request_in = 1;
+	}
+	if ((enabled != 0) && ((cr & (0b1 << 12)) != 0) && (aes_model_ctx.output_count != 0)) {
+		request_out = 1;
+	}
+	DMA_MODEL_set_request(DMA_MODEL_REQUEST_AES_IN, request_in);
+	DMA_MODEL_set_request(DMA_MODEL_REQUEST_AES_OUT, request_out);
+}
+
+/* RESET COMPUTATION STATE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AES_MODEL_reset_state(void) {
+	HOST_stop_event(&aes_model_ctx.computation_event);
+	aes_model_ctx.input_count = 0;
+	aes_model_ctx.output_count = 0;
+	aes_model_ctx.busy = 0;
+}
+
+/* ENCRYPT THE INPUT BLOCK.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AES_MODEL_start_computation(void) {
+	// Local variables.
+	unsigned char key[AES_BLOCK_SIZE];
+	unsigned char init_vector[AES_BLOCK_SIZE];
+	unsigned char idx = 0;
+	// Registers with highest index hold the most significant words.
+	AES_MODEL_store_word((aes_model_ctx.aes -> KEYR3), &(key[0]));
+	AES_MODEL_store_word((aes_model_ctx.aes -> KEYR2), &(key[4]));
+	AES_MODEL_store_word((aes_model_ctx.aes -> KEYR1), &(key[8]));
+	AES_MODEL_store_word((aes_model_ctx.aes -> KEYR0), &(key[12]));
+	AES_MODEL_store_word((aes_model_ctx.aes -> IVR3), &(init_vector[0]));
+	AES_MODEL_store_word((aes_model_ctx.aes -> IVR2), &(init_vector[4]));
+	AES_MODEL_store_word((aes_model_ctx.aes -> IVR1), &(init_vector[8]));
+	AES_MODEL_store_word((aes_model_ctx.aes -> IVR0), &(init_vector[12]));
+	// Only CBC encryption (CHMOD='01' and MODE='00') is used by the driver.
+	AES_SW_encrypt(aes_model_ctx.data_in, aes_model_ctx.data_out, init_vector, key);
+	// Chaining: initialization vector registers are updated with the cipher text.
+	aes_model_ctx.aes -> IVR3 = AES_MODEL_load_word(&(aes_model_ctx.data_out[0]));
+	aes_model_ctx.aes -> IVR2 = AES_MODEL_load_word(&(aes_model_ctx.data_out[4]));
+	aes_model_ctx.aes -> IVR1 = AES_MODEL_load_word(&(aes_model_ctx.data_out[8]));
+	aes_model_ctx.aes -> IVR0 = AES_MODEL_load_word(&(aes_model_ctx.data_out[12]));
+	for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) key[idx] = 0;
+	// Result is available after the computation time.
+	aes_model_ctx.busy = 1;
+	HOST_start_event_at(&aes_model_ctx.computation_event, (HOST_get_time_ns() + ((AES_MODEL_COMPUTATION_CYCLES * 1000000ULL) / HOST_get_sysclk_khz())), &AES_MODEL_computation_event_callback);
+}
+
+/* END OF COMPUTATION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void AES_MODEL_computation_event_callback(void) {
+	aes_model_ctx.busy = 0;
+	aes_model_ctx.output_count = AES_MODEL_WORDS_PER_BLOCK;
+	// CCF is not set when the result is read by DMA.
+	if (((aes_model_ctx.aes -> CR) & (0b1 << 12)) == 0) {
+		aes_model_ctx.aes -> SR |= (0b1 << 0); // CCF='1'.
+	}
+	AES_MODEL_update_dma_requests();
+}
+
+/* AES REGISTERS READ CALLBACK.
+ * @param offset:	Register offset.
+ * @return:			None.
+ */
+static void AES_MODEL_read_callback(unsigned int offset) {
+	// Local variables.
+	unsigned char word_index = 0;
+	if (offset != offsetof(AES_base_address_t, DOUTR)) return;
+	if (aes_model_ctx.output_count == 0) {
+		aes_model_ctx.aes -> SR |= (0b1 << 1); // RDERR='1'.
+		return;
+	}
+	// Output words are read most significant first.
+	word_index = (AES_MODEL_WORDS_PER_BLOCK - aes_model_ctx.output_count);
+	aes_model_ctx.aes -> DOUTR = AES_MODEL_convert_word(AES_MODEL_load_word(&(aes_model_ctx.data_out[4 * word_index])));
+	aes_model_ctx.output_count--;
+	if (aes_model_ctx.output_count == 0) {
+		// Ready for next block.
+		aes_model_ctx.input_count = 0;
+		AES_MODEL_update_dma_requests();
+	}
+}
+
+/* AES REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void AES_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int cr = 0;
+	switch (offset) {
+	case offsetof(AES_base_address_t, CR):
+		cr = (aes_model_ctx.aes -> CR);
+		// Flags clear bits are always read as '0'.
+		if ((cr & (0b1 << 7)) != 0) {
+			aes_model_ctx.aes -> SR &= ~(0b1 << 0); // CCFC: CCF='0'.
+		}
+		if ((cr & (0b1 << 8)) != 0) {
+			aes_model_ctx.aes -> SR &= ~(0b11 << 1); // ERRC: RDERR='0' and WRERR='0'.
+		}
+		aes_model_ctx.aes -> CR = cr & ~(0b11 << 7);
+		// Disabling the peripheral aborts the current computation.
+		if (((previous_value & ~cr) & (0b1 << 0)) != 0) {
+			AES_MODEL_reset_state();
+		}
+		break;
+	case offsetof(AES_base_address_t, SR):
+	case offsetof(AES_base_address_t, DOUTR):
+		// Read-only.
+		*((unsigned int*) (((unsigned char*) aes_model_ctx.aes) + offset)) = previous_value;
+		break;
+	case offsetof(AES_base_address_t, DINR):
+		if (((aes_model_ctx.aes -> CR) & (0b1 << 0)) == 0) break;
+		if ((aes_model_ctx.busy != 0) || (aes_model_ctx.output_count != 0) || (aes_model_ctx.input_count >= AES_MODEL_WORDS_PER_BLOCK)) {
+			aes_model_ctx.aes -> SR |= (0b1 << 2); // WRERR='1'.
+			break;
+		}
+		AES_MODEL_store_word(AES_MODEL_convert_word(aes_model_ctx.aes -> DINR), &(aes_model_ctx.data_in[4 * aes_model_ctx.input_count]));
+		aes_model_ctx.input_count++;
+		if (aes_model_ctx.input_count == AES_MODEL_WORDS_PER_BLOCK) {
+			AES_MODEL_start_computation();
+		}
+		break;
+	default:
+		break;
+	}
+	AES_MODEL_update_dma_requests();
+}
+
+/* INIT AES MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) AES_MODEL_init(void) {
+	aes_model_ctx.aes = BUS_map_peripheral((unsigned long) AES, sizeof(AES_base_address_t), &AES_MODEL_read_callback, &AES_MODEL_write_callback);
+}
+
+#endif /* HOST */
@@ -0,0 +1,331 @@
+/*
+ * bus.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#define _GNU_SOURCE
+
+#include "bus.h"
+
+#include "host.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+/*** BUS local macros ***/
+
+#define BUS_PAGE_SIZE				4096
+#define BUS_PAGE_MASK				(~((unsigned long) (BUS_PAGE_SIZE - 1)))
+#define BUS_PAGES_MAX				24
+#define BUS_REGIONS_MAX				32
+#define BUS_SIGNAL_STACK_SIZE		65536
+#define BUS_X86_TRAP_FLAG			(0b1 << 8) // EFLAGS single step bit.
+#define BUS_X86_PAGE_FAULT_WRITE	(0b1 << 1) // Page fault error code write bit.
+#define BUS_X86_RED_ZONE_SIZE		128 // Area below stack pointer which may be used by the interrupted function.
+
+/*** BUS local structures ***/
+
+// Physical page of the MCU memory map, mapped twice: at its MCU address for the firmware (always trapped) and anywhere for the models.
+typedef struct {
+	unsigned long address;
+	unsigned char* model_view;
+} BUS_page_t;
+
+typedef struct {
+	unsigned long base_address;
+	unsigned int size;
+	unsigned char* model_view;
+	BUS_read_callback_t read_callback;
+	BUS_write_callback_t write_callback;
+} BUS_region_t;
+
+typedef struct {
+	// Memory map.
+	int memory_fd;
+	BUS_page_t page[BUS_PAGES_MAX];
+	unsigned char page_count;
+	BUS_region_t region[BUS_REGIONS_MAX];
+	unsigned char region_count;
+	// Firmware access being executed in single step mode.
+	BUS_region_t* step_region;
+	unsigned long step_page_address;
+	unsigned int step_offset;
+	unsigned int step_previous_value;
+	unsigned char step_write;
+} BUS_context_t;
+
+/*** BUS local global variables ***/
+
+static BUS_context_t bus_ctx;
+static unsigned char bus_signal_stack[BUS_SIGNAL_STACK_SIZE];
+
+/*** BUS local functions ***/
+
+// Interrupt entry: executed on the firmware stack after the instruction which accessed a peripheral, like an exception entry on the MCU.
+// The signal handler pushes the return address below the red zone, all registers which may be modified by the handlers are saved here.
+void BUS_interrupt_entry(void);
+__asm__ (
+	".text\n"
+	".globl BUS_interrupt_entry\n"
+	"BUS_interrupt_entry:\n"
+	"	pushfq\n"
+	"	pushq %rax\n"
+	"	pushq %rcx\n"
+	"	pushq %rdx\n"
+	"	pushq %rsi\n"
+	"	pushq %rdi\n"
+	"	pushq %r8\n"
+	"	pushq %r9\n"
+	"	pushq %r10\n"
+	"	pushq %r11\n"
+	"	pushq %rbp\n"
+	"	movq %rsp, %rbp\n"
+	"	subq $512, %rsp\n"
+	"	andq $-64, %rsp\n"
+	"	fxsave (%rsp)\n"
+	"	cld\n"
+	"	call HOST_dispatch_interrupts\n"
+	"	fxrstor (%rsp)\n"
+	"	movq %rbp, %rsp\n"
+	"	popq %rbp\n"
+	"	popq %r11\n"
+	"	popq %r10\n"
+	"	popq %r9\n"
+	"	popq %r8\n"
+	"	popq %rdi\n"
+	"	popq %rsi\n"
+	"	popq %rdx\n"
+	"	popq %rcx\n"
+	"	popq %rax\n"
+	"	popfq\n"
+	"	ret $128\n"
+);
+
+/* GET THE REGION CONTAINING AN ADDRESS.
+ * @param address:	MCU address.
+ * @return:			Pointer to region, 0 if the address is not mapped.
+ */
+static BUS_region_t* BUS_get_region(unsigned long address) {
+	// Local variables.
+	unsigned char idx = 0;
+	for (idx=0 ; idx<bus_ctx.region_count ; idx++) {
+		if ((address >= bus_ctx.region[idx].base_address) && (address < (bus_ctx.region[idx].base_address + bus_ctx.region[idx].size))) {
+			return &(bus_ctx.region[idx]);
+		}
+	}
+	return 0;
+}
+
+/* GET OR CREATE THE PAGE CONTAINING AN ADDRESS.
+ * @param address:	MCU address.
+ * @return:			Pointer to page.
+ */
+static BUS_page_t* BUS_get_page(unsigned long address) {
+	// Local variables.
+	unsigned long page_address = (address & BUS_PAGE_MASK);
+	BUS_page_t* page = 0;
+	void* firmware_view = 0;
+	unsigned char idx = 0;
+	for (idx=0 ; idx<bus_ctx.page_count ; idx++) {
+		if (bus_ctx.page[idx].address == page_address) return &(bus_ctx.page[idx]);
+	}
+	if (bus_ctx.page_count >= BUS_PAGES_MAX) goto errors;
+	page = &(bus_ctx.page[bus_ctx.page_count]);
+	// Allocate physical page.
+	if (ftruncate(bus_ctx.memory_fd, (bus_ctx.page_count + 1) * BUS_PAGE_SIZE) != 0) goto errors;
+	firmware_view = mmap((void*) page_address, BUS_PAGE_SIZE, PROT_NONE, (MAP_SHARED | MAP_FIXED_NOREPLACE), bus_ctx.memory_fd, (bus_ctx.page_count * BUS_PAGE_SIZE));
+	if (firmware_view != ((void*) page_address)) goto errors;
+	page -> model_view = mmap(0, BUS_PAGE_SIZE, (PROT_READ | PROT_WRITE), MAP_SHARED, bus_ctx.memory_fd, (bus_ctx.page_count * BUS_PAGE_SIZE));
+	if (page -> model_view == MAP_FAILED) goto errors;
+	page -> address = page_address;
+	bus_ctx.page_count++;
+	return page;
+errors:
+	fprintf(stderr, "HOST: cannot map address 0x%08lX\n", address);
+	exit(EXIT_FAILURE);
+}
+
+/* FIRMWARE PERIPHERAL ACCESS HANDLER (FIRST STEP: BEFORE THE ACCESS).
+ * @param signal_number:	Signal number.
+ * @param info:				Fault information.
+ * @param context:			Interrupted context.
+ * @return:					None.
+ */
+static void BUS_fault_handler(int signal_number, siginfo_t* info, void* context) {
+	// Local variables.
+	ucontext_t* user_context = (ucontext_t*) context;
+	unsigned long address = (unsigned long) (info -> si_addr);
+	BUS_region_t* region = BUS_get_region(address);
+	// Unmapped address or access from a model callback.
+	if ((region == 0) || (bus_ctx.step_region != 0)) {
+		fprintf(stderr, "HOST: bus fault at 0x%08lX\n", address);
+		abort();
+	}
+	(void) signal_number;
+	// Bus access duration.
+	HOST_consume_cycles(BUS_ACCESS_CYCLES);
+	// Update register before read.
+	bus_ctx.step_offset = ((address - (region -> base_address)) & ~0b11);
+	bus_ctx.step_write = ((user_context -> uc_mcontext.gregs[REG_ERR] & BUS_X86_PAGE_FAULT_WRITE) != 0) ? 1 : 0;
+	if ((bus_ctx.step_write == 0) && ((region -> read_callback) != 0)) {
+		region -> read_callback(bus_ctx.step_offset);
+	}
+	bus_ctx.step_previous_value = *((unsigned int*) ((region -> model_view) + bus_ctx.step_offset));
+	// Execute the access instruction alone.
+	bus_ctx.step_region = region;
+	bus_ctx.step_page_address = (address & BUS_PAGE_MASK);
+	mprotect((void*) bus_ctx.step_page_address, BUS_PAGE_SIZE, (PROT_READ | PROT_WRITE));
+	user_context -> uc_mcontext.gregs[REG_EFL] |= BUS_X86_TRAP_FLAG;
+}
+
+/* FIRMWARE PERIPHERAL ACCESS HANDLER (SECOND STEP: AFTER THE ACCESS).
+ * @param signal_number:	Signal number.
+ * @param info:				Trap information.
+ * @param context:			Interrupted context.
+ * @return:					None.
+ */
+static void BUS_step_handler(int signal_number, siginfo_t* info, void* context) {
+	// Local variables.
+	ucontext_t* user_context = (ucontext_t*) context;
+	BUS_region_t* region = bus_ctx.step_region;
+	unsigned long* stack_pointer = 0;
+	(void) signal_number;
+	(void) info;
+	if (region == 0) return;
+	// Protect page again.
+	mprotect((void*) bus_ctx.step_page_address, BUS_PAGE_SIZE, PROT_NONE);
+	user_context -> uc_mcontext.gregs[REG_EFL] &= ~BUS_X86_TRAP_FLAG;
+	bus_ctx.step_region = 0;
+	// Apply write side effects.
+	if ((bus_ctx.step_write != 0) && ((region -> write_callback) != 0)) {
+		region -> write_callback(bus_ctx.step_offset, bus_ctx.step_previous_value);
+	}
+	// Enter interrupt if the access made one ready (flag cleared, interrupt enabled, etc) or if one occured during the access.
+	if (HOST_is_irq_ready() != 0) {
+		stack_pointer = (unsigned long*) (user_context -> uc_mcontext.gregs[REG_RSP] - BUS_X86_RED_ZONE_SIZE);
+		stack_pointer--;
+		(*stack_pointer) = (unsigned long) (user_context -> uc_mcontext.gregs[REG_RIP]);
+		user_context -> uc_mcontext.gregs[REG_RSP] = (greg_t) stack_pointer;
+		user_context -> uc_mcontext.gregs[REG_RIP] = (greg_t) &BUS_interrupt_entry;
+	}
+}
+
+/* INIT HOST BUS BEFORE PERIPHERALS MODELS.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_CORE))) BUS_init(void) {
+	// Local variables.
+	struct sigaction action = {0};
+	stack_t signal_stack;
+	// Physical memory of peripherals.
+	bus_ctx.memory_fd = memfd_create("UHFM_bus", 0);
+	if (bus_ctx.memory_fd < 0) {
+		fprintf(stderr, "HOST: cannot create bus memory\n");
+		exit(EXIT_FAILURE);
+	}
+	// Handlers run on their own stack since the firmware stack pointer may be anywhere.
+	signal_stack.ss_sp = bus_signal_stack;
+	signal_stack.ss_size = BUS_SIGNAL_STACK_SIZE;
+	signal_stack.ss_flags = 0;
+	sigaltstack(&signal_stack, 0);
+	action.sa_flags = (SA_SIGINFO | SA_ONSTACK);
+	sigemptyset(&action.sa_mask);
+	action.sa_sigaction = &BUS_fault_handler;
+	sigaction(SIGSEGV, &action, 0);
+	action.sa_sigaction = &BUS_step_handler;
+	sigaction(SIGTRAP, &action, 0);
+}
+
+/*** BUS functions ***/
+
+/* MAP A PERIPHERAL AT ITS MCU ADDRESS.
+ * @param base_address:		MCU base address.
+ * @param size:				Size in bytes (the region must not cross a page boundary).
+ * @param read_callback:	Function called before each firmware read (0 if registers are always up to date).
+ * @param write_callback:	Function called after each firmware write (0 for plain memory).
+ * @return:					Registers as seen by the model (firmware accesses are trapped, model accesses are not).
+ */
+void* BUS_map_peripheral(unsigned long base_address, unsigned int size, BUS_read_callback_t read_callback, BUS_write_callback_t write_callback) {
+	// Local variables.
+	BUS_page_t* page = BUS_get_page(base_address);
+	BUS_region_t* region = 0;
+	if ((bus_ctx.region_count >= BUS_REGIONS_MAX) || (((base_address + size - 1) & BUS_PAGE_MASK) != (page -> address))) {
+		fprintf(stderr, "HOST: cannot map peripheral at 0x%08lX\n", base_address);
+		exit(EXIT_FAILURE);
+	}
+	region = &(bus_ctx.region[bus_ctx.region_count++]);
+	region -> base_address = base_address;
+	region -> size = size;
+	region -> model_view = ((page -> model_view) + (base_address - (page -> address)));
+	region -> read_callback = read_callback;
+	region -> write_callback = write_callback;
+	return (region -> model_view);
+}
+
+/* READ MEMORY ON BEHALF OF A BUS MASTER (DMA).
+ * @param address:		MCU address (peripheral or RAM).
+ * @param size_bytes:	Access size (1, 2 or 4).
+ * @return:				Read value.
+ */
+unsigned int BUS_read(unsigned long address, unsigned char size_bytes) {
+	// Local variables.
+	BUS_region_t* region = BUS_get_region(address);
+	unsigned char* data = (unsigned char*) address;
+	if (region != 0) {
+		if ((region -> read_callback) != 0) {
+			region -> read_callback((address - (region -> base_address)) & ~0b11);
+		}
+		data = ((region -> model_view) + (address - (region -> base_address)));
+	}
+	switch (size_bytes) {
+	case 1:
+		return *data;
+	case 2:
+		return *((unsigned short*) data);
+	default:
+		return *((unsigned int*) data);
+	}
+}
+
+/* WRITE MEMORY ON BEHALF OF A BUS MASTER (DMA).
+ * @param address:		MCU address (peripheral or RAM).
+ * @param value:		Value to write.
+ * @param size_bytes:	Access size (1, 2 or 4).
+ * @return:				None.
+ */
+void BUS_write(unsigned long address, unsigned int value, unsigned char size_bytes) {
+	// Local variables.
+	BUS_region_t* region = BUS_get_region(address);
+	unsigned char* data = (unsigned char*) address;
+	unsigned int offset = 0;
+	unsigned int previous_value = 0;
+	if (region != 0) {
+		offset = ((address - (region -> base_address)) & ~0b11);
+		previous_value = *((unsigned int*) ((region -> model_view) + offset));
+		data = ((region -> model_view) + (address - (region -> base_address)));
+	}
+	switch (size_bytes) {
+	case 1:
+		(*data) = (unsigned char) value;
+		break;
+	case 2:
+		(*((unsigned short*) data)) = (unsigned short) value;
+		break;
+	default:
+		(*((unsigned int*) data)) = value;
+		break;
+	}
+	if ((region != 0) && ((region -> write_callback) != 0)) {
+		region -> write_callback(offset, previous_value);
+	}
+}
+
+#endif /* HOST */
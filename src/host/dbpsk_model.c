@@ -0,0 +1,247 @@
+/*
+ * dbpsk_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "dbpsk_model.h"
+
+#include "rf_api_ext.h"
+#include "s2lp_model.h"
+#include <stdio.h>
+#include <time.h>
+
+/*** DBPSK MODEL local macros ***/
+
+#define DBPSK_MODEL_PADDING_LENGTH_BYTES	DBPSK_MODEL_SYMBOL_LENGTH_BYTES // Padding is not completely sent before radio is stopped.
+
+/*** DBPSK MODEL local structures ***/
+
+typedef enum {
+	DBPSK_MODEL_SYMBOL_RAMP_UP,
+	DBPSK_MODEL_SYMBOL_BIT0,
+	DBPSK_MODEL_SYMBOL_BIT1,
+	DBPSK_MODEL_SYMBOL_RAMP_DOWN,
+	DBPSK_MODEL_SYMBOL_PADDING
+} DBPSK_MODEL_symbol_t;
+
+typedef struct {
+	unsigned char expected_fifo[DBPSK_MODEL_FIFO_LENGTH(DBPSK_MODEL_STREAM_SIZE_MAX)];
+	unsigned char decoded_stream[DBPSK_MODEL_STREAM_SIZE_MAX];
+	struct timespec start_cpu_time;
+	S2LP_MODEL_activity_t start_activity;
+	unsigned int frame_count;
+} DBPSK_MODEL_context_t;
+
+/*** DBPSK MODEL local global variables ***/
+
+static DBPSK_MODEL_context_t dbpsk_model_ctx;
+
+/*** DBPSK MODEL local functions ***/
+
+/* WRITE THE FIFO SAMPLES OF ONE SYMBOL (SAME ORDER AS RF_API_send).
+ * @param symbol:	Symbol type.
+ * @param fdev:		Deviation applied in the middle of bit 0 symbols.
+ * @param fifo:		Destination (DBPSK_MODEL_SYMBOL_LENGTH_BYTES bytes).
+ * @return:			None.
+ */
+static void DBPSK_MODEL_write_symbol(DBPSK_MODEL_symbol_t symbol, unsigned char fdev, unsigned char* fifo) {
+	// Local variables.
+	unsigned char sample_idx = 0;
+	for (sample_idx=0 ; sample_idx<RF_API_SYMBOL_PROFILE_LENGTH_BYTES ; sample_idx++) {
+		switch (symbol) {
+		case DBPSK_MODEL_SYMBOL_RAMP_UP:
+			fifo[(2 * sample_idx)] = 0;
+			fifo[(2 * sample_idx) + 1] = rf_api_etsi_ramp_amplitude_profile[RF_API_SYMBOL_PROFILE_LENGTH_BYTES - sample_idx - 1];
+			break;
+		case DBPSK_MODEL_SYMBOL_BIT0:
+			fifo[(2 * sample_idx)] = (sample_idx == RF_API_S2LP_FIFO_BUFFER_FDEV_IDX) ? fdev : 0;
+			fifo[(2 * sample_idx) + 1] = rf_api_etsi_bit0_amplitude_profile[sample_idx];
+			break;
+		case DBPSK_MODEL_SYMBOL_BIT1:
+			fifo[(2 * sample_idx)] = 0;
+			fifo[(2 * sample_idx) + 1] = 1;
+			break;
+		case DBPSK_MODEL_SYMBOL_RAMP_DOWN:
+			fifo[(2 * sample_idx)] = 0;
+			fifo[(2 * sample_idx) + 1] = rf_api_etsi_ramp_amplitude_profile[sample_idx];
+			break;
+		default:
+			fifo[(2 * sample_idx)] = 0;
+			fifo[(2 * sample_idx) + 1] = 0;
+			break;
+		}
+	}
+}
+
+/* COMPARE A RECEIVED SYMBOL WITH A REFERENCE.
+ * @param symbol:	Reference symbol type.
+ * @param fdev:		Expected deviation for bit 0 symbols.
+ * @param fifo:		Received samples.
+ * @return:			1 if samples are identical, 0 otherwise.
+ */
+static unsigned char DBPSK_MODEL_match_symbol(DBPSK_MODEL_symbol_t symbol, unsigned char fdev, unsigned char* fifo) {
+	// Local variables.
+	unsigned char reference[DBPSK_MODEL_SYMBOL_LENGTH_BYTES];
+	unsigned char byte_idx = 0;
+	DBPSK_MODEL_write_symbol(symbol, fdev, reference);
+	for (byte_idx=0 ; byte_idx<DBPSK_MODEL_SYMBOL_LENGTH_BYTES ; byte_idx++) {
+		if (fifo[byte_idx] != reference[byte_idx]) return 0;
+	}
+	return 1;
+}
+
+/*** DBPSK MODEL functions ***/
+
+/* GENERATE THE EXPECTED S2LP FIFO CONTENT OF AN UPLINK STREAM.
+ * @param stream:		Stream given to RF_API_send.
+ * @param stream_size:	Stream length in bytes.
+ * @param fifo:			Destination buffer (DBPSK_MODEL_FIFO_LENGTH(stream_size) bytes are written).
+ * @param fifo_size:	Size of destination buffer.
+ * @return status:		Function execution status.
+ */
+DBPSK_MODEL_status_t DBPSK_MODEL_encode(unsigned char* stream, unsigned char stream_size, unsigned char* fifo, unsigned int fifo_size) {
+	// Local variables.
+	unsigned int fifo_idx = 0;
+	unsigned char byte_idx = 0;
+	unsigned char bit_idx = 0;
+	unsigned char fdev = RF_API_S2LP_FDEV_NEGATIVE;
+	// Check size.
+	if (fifo_size < DBPSK_MODEL_FIFO_LENGTH(stream_size)) return DBPSK_MODEL_ERROR_LENGTH;
+	// Ramp-up.
+	DBPSK_MODEL_write_symbol(DBPSK_MODEL_SYMBOL_RAMP_UP, 0, &(fifo[fifo_idx]));
+	fifo_idx += DBPSK_MODEL_SYMBOL_LENGTH_BYTES;
+	// Bits (MSB first), phase is inverted on each bit 0.
+	for (byte_idx=0 ; byte_idx<stream_size ; byte_idx++) {
+		for (bit_idx=0 ; bit_idx<8 ; bit_idx++) {
+			if ((stream[byte_idx] & (0b1 << (7 - bit_idx))) == 0) {
+				fdev = (fdev == RF_API_S2LP_FDEV_NEGATIVE) ? RF_API_S2LP_FDEV_POSITIVE : RF_API_S2LP_FDEV_NEGATIVE;
+				DBPSK_MODEL_write_symbol(DBPSK_MODEL_SYMBOL_BIT0, fdev, &(fifo[fifo_idx]));
+			}
+			else {
+				DBPSK_MODEL_write_symbol(DBPSK_MODEL_SYMBOL_BIT1, 0, &(fifo[fifo_idx]));
+			}
+			fifo_idx += DBPSK_MODEL_SYMBOL_LENGTH_BYTES;
+		}
+	}
+	// Ramp-down and padding.
+	DBPSK_MODEL_write_symbol(DBPSK_MODEL_SYMBOL_RAMP_DOWN, 0, &(fifo[fifo_idx]));
+	fifo_idx += DBPSK_MODEL_SYMBOL_LENGTH_BYTES;
+	DBPSK_MODEL_write_symbol(DBPSK_MODEL_SYMBOL_PADDING, 0, &(fifo[fifo_idx]));
+	return DBPSK_MODEL_SUCCESS;
+}
+
+/* DECODE A CAPTURED S2LP FIFO CONTENT INTO BITS.
+ * @param fifo:				Captured FIFO bytes (modulator input).
+ * @param fifo_length:		Number of captured bytes.
+ * @param stream:			Destination of decoded bits (MSB first).
+ * @param stream_size_max:	Size of destination buffer.
+ * @param number_of_bits:	Pointer to the number of decoded bits.
+ * @param error_idx:		Pointer to the index of the first invalid FIFO byte (in case of error).
+ * @return status:			Function execution status.
+ */
+DBPSK_MODEL_status_t DBPSK_MODEL_decode(unsigned char* fifo, unsigned int fifo_length, unsigned char* stream, unsigned char stream_size_max, unsigned int* number_of_bits, unsigned int* error_idx) {
+	// Local variables.
+	unsigned int fifo_idx = 0;
+	unsigned char fdev = RF_API_S2LP_FDEV_NEGATIVE;
+	unsigned char next_fdev = 0;
+	(*number_of_bits) = 0;
+	(*error_idx) = 0;
+	// Ramp-up.
+	if (fifo_length < DBPSK_MODEL_SYMBOL_LENGTH_BYTES) return DBPSK_MODEL_ERROR_LENGTH;
+	if (DBPSK_MODEL_match_symbol(DBPSK_MODEL_SYMBOL_RAMP_UP, 0, fifo) == 0) return DBPSK_MODEL_ERROR_RAMP_UP;
+	fifo_idx += DBPSK_MODEL_SYMBOL_LENGTH_BYTES;
+	// Symbols until ramp-down.
+	while ((fifo_idx + DBPSK_MODEL_SYMBOL_LENGTH_BYTES) <= fifo_length) {
+		(*error_idx) = fifo_idx;
+		if (DBPSK_MODEL_match_symbol(DBPSK_MODEL_SYMBOL_RAMP_DOWN, 0, &(fifo[fifo_idx])) != 0) return DBPSK_MODEL_SUCCESS;
+		if (((*number_of_bits) / 8) >= stream_size_max) return DBPSK_MODEL_ERROR_LENGTH;
+		next_fdev = (fdev == RF_API_S2LP_FDEV_NEGATIVE) ? RF_API_S2LP_FDEV_POSITIVE : RF_API_S2LP_FDEV_NEGATIVE;
+		if (DBPSK_MODEL_match_symbol(DBPSK_MODEL_SYMBOL_BIT1, 0, &(fifo[fifo_idx])) != 0) {
+			stream[(*number_of_bits) / 8] |= (0b1 << (7 - ((*number_of_bits) % 8)));
+		}
+		else if (DBPSK_MODEL_match_symbol(DBPSK_MODEL_SYMBOL_BIT0, next_fdev, &(fifo[fifo_idx])) != 0) {
+			stream[(*number_of_bits) / 8] &= ~(0b1 << (7 - ((*number_of_bits) % 8)));
+			fdev = next_fdev;
+		}
+		else if (DBPSK_MODEL_match_symbol(DBPSK_MODEL_SYMBOL_BIT0, fdev, &(fifo[fifo_idx])) != 0) {
+			// Deviation has not been inverted.
+			return DBPSK_MODEL_ERROR_PHASE;
+		}
+		else {
+			return DBPSK_MODEL_ERROR_SYMBOL;
+		}
+		(*number_of_bits)++;
+		fifo_idx += DBPSK_MODEL_SYMBOL_LENGTH_BYTES;
+	}
+	(*error_idx) = fifo_idx;
+	return DBPSK_MODEL_ERROR_RAMP_DOWN;
+}
+
+/* START COST MEASUREMENT OF AN UPLINK FRAME (CALLED BEFORE RF_API_send).
+ * @param:	None.
+ * @return:	None.
+ */
+void DBPSK_MODEL_start_frame(void) {
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &dbpsk_model_ctx.start_cpu_time);
+	S2LP_MODEL_get_activity(&dbpsk_model_ctx.start_activity);
+}
+
+/* CHECK THE MODULATOR INPUT OF THE LAST TRANSMISSION AGAINST THE GOLDEN MODEL AND PRINT ENGINE COST (CALLED AFTER RF_API_send).
+ * @param stream:		Stream given to RF_API_send.
+ * @param stream_size:	Stream length in bytes.
+ * @return status:		Function execution status.
+ */
+DBPSK_MODEL_status_t DBPSK_MODEL_check_frame(unsigned char* stream, unsigned char stream_size) {
+	// Local variables.
+	DBPSK_MODEL_status_t status = DBPSK_MODEL_SUCCESS;
+	struct timespec stop_cpu_time;
+	S2LP_MODEL_activity_t stop_activity;
+	unsigned char* capture = 0;
+	unsigned int capture_length = 0;
+	unsigned int expected_length = DBPSK_MODEL_FIFO_LENGTH(stream_size);
+	unsigned int number_of_bits = 0;
+	unsigned int error_idx = 0;
+	unsigned int idx = 0;
+	unsigned int cpu_time_us = 0;
+	// Engine cost.
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &stop_cpu_time);
+	S2LP_MODEL_get_activity(&stop_activity);
+	cpu_time_us = (unsigned int) (((stop_cpu_time.tv_sec - dbpsk_model_ctx.start_cpu_time.tv_sec) * 1000000) + ((stop_cpu_time.tv_nsec - dbpsk_model_ctx.start_cpu_time.tv_nsec) / 1000));
+	dbpsk_model_ctx.frame_count++;
+	// Expected samples.
+	if (stream_size > DBPSK_MODEL_STREAM_SIZE_MAX) return DBPSK_MODEL_ERROR_LENGTH;
+	DBPSK_MODEL_encode(stream, stream_size, dbpsk_model_ctx.expected_fifo, sizeof(dbpsk_model_ctx.expected_fifo));
+	S2LP_MODEL_get_tx_capture(&capture, &capture_length);
+	// Padding may be truncated, ramp-down must be complete.
+	if ((capture_length < (expected_length - DBPSK_MODEL_PADDING_LENGTH_BYTES)) || (capture_length > expected_length)) {
+		status = DBPSK_MODEL_ERROR_LENGTH;
+		error_idx = capture_length;
+	}
+	for (idx=0 ; (idx<capture_length) && (idx<expected_length) ; idx++) {
+		if (capture[idx] != dbpsk_model_ctx.expected_fifo[idx]) {
+			status = DBPSK_MODEL_ERROR_MISMATCH;
+			error_idx = idx;
+			break;
+		}
+	}
+	if (status == DBPSK_MODEL_SUCCESS) {
+		fprintf(stderr, "HOST: DBPSK frame %u: %u bits bit-exact, host CPU %u us, %u SPI bytes, %u GPIO0 interrupts\n",
+			dbpsk_model_ctx.frame_count, (8 * stream_size), cpu_time_us,
+			(stop_activity.spi_byte_count - dbpsk_model_ctx.start_activity.spi_byte_count),
+			(stop_activity.gpio0_interrupt_count - dbpsk_model_ctx.start_activity.gpio0_interrupt_count));
+	}
+	else {
+		// Decode capture to locate the faulty symbol.
+		for (idx=0 ; idx<DBPSK_MODEL_STREAM_SIZE_MAX ; idx++) dbpsk_model_ctx.decoded_stream[idx] = 0;
+		DBPSK_MODEL_decode(capture, capture_length, dbpsk_model_ctx.decoded_stream, DBPSK_MODEL_STREAM_SIZE_MAX, &number_of_bits, &idx);
+		fprintf(stderr, "HOST: DBPSK frame %u: error %u at FIFO byte %u/%u (symbol %u), %u bits decoded\n",
+			dbpsk_model_ctx.frame_count, status, error_idx, expected_length, (error_idx / DBPSK_MODEL_SYMBOL_LENGTH_BYTES), number_of_bits);
+	}
+	return status;
+}
+
+#endif /* HOST */
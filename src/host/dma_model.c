@@ -0,0 +1,259 @@
+/*
+ * dma_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "dma_model.h"
+
+#include "bus.h"
+#include "dma_reg.h"
+#include "host.h"
+#include "nvic.h"
+#include <stddef.h>
+
+/*** DMA MODEL local macros ***/
+
+#define DMA_MODEL_CHANNEL_NUMBER		7
+#define DMA_MODEL_CHANNEL_STRIDE		(offsetof(DMA_base_address_t, CCR2) - offsetof(DMA_base_address_t, CCR1))
+#define DMA_MODEL_FLAGS_MASK			0b1110 // TCIF, HTIF and TEIF (same position as interrupt enable bits in CCR).
+
+/*** DMA MODEL local structures ***/
+
+// Channel registers layout.
+typedef struct {
+	volatile unsigned int CCR;
+	volatile unsigned int CNDTR;
+	volatile unsigned int CPAR;
+	volatile unsigned int CMAR;
+} DMA_MODEL_channel_registers_t;
+
+// Request line wiring (see DMA1 request mapping table of RM0377).
+typedef struct {
+	unsigned char channel_index;
+	unsigned char selection;
+} DMA_MODEL_request_mapping_t;
+
+typedef struct {
+	unsigned int peripheral_address;
+	unsigned int memory_address;
+	unsigned int number_of_data;
+} DMA_MODEL_channel_t;
+
+typedef struct {
+	DMA_base_address_t* dma;
+	DMA_MODEL_channel_t channel[DMA_MODEL_CHANNEL_NUMBER];
+	unsigned char request[DMA_MODEL_REQUEST_LAST];
+	unsigned char servicing;
+} DMA_MODEL_context_t;
+
+/*** DMA MODEL local global variables ***/
+
+static const DMA_MODEL_request_mapping_t DMA_MODEL_REQUEST_MAPPING[DMA_MODEL_REQUEST_LAST] = {
+	{0, 0b0000}, // ADC on channel 1.
+	{0, 0b1011}, // AES_IN on channel 1.
+	{1, 0b1011}, // AES_OUT on channel 2.
+	{2, 0b0001}, // SPI1_TX on channel 3.
+};
+
+static DMA_MODEL_context_t dma_model_ctx;
+
+/*** DMA MODEL local functions ***/
+
+/* GET REGISTERS OF A CHANNEL.
+ * @param channel_index:	Channel index (0 for channel 1).
+ * @return:					Pointer to channel registers.
+ */
+static DMA_MODEL_channel_registers_t* DMA_MODEL_get_registers(unsigned char channel_index) {
+	return (DMA_MODEL_channel_registers_t*) (((unsigned char*) &(dma_model_ctx.dma -> CCR1)) + (channel_index * DMA_MODEL_CHANNEL_STRIDE));
+}
+
+/* UPDATE DMA INTERRUPT LINES.
+ * @param:	None.
+ * @return:	None.
+ */
+static void DMA_MODEL_update_irq(void) {
+	// Local variables.
+	unsigned char channel_index = 0;
+	unsigned int flags = 0;
+	for (channel_index=0 ; channel_index<DMA_MODEL_CHANNEL_NUMBER ; channel_index++) {
+		flags = ((dma_model_ctx.dma -> ISR) >> (4 * channel_index));
+		if ((flags & (DMA_MODEL_get_registers(channel_index) -> CCR) & DMA_MODEL_FLAGS_MASK) == 0) continue;
+		HOST_set_irq_pending((channel_index == 0) ? NVIC_IT_DMA1_CHA1 : ((channel_index < 3) ? NVIC_IT_DMA1_CH_2_3 : NVIC_IT_DMA1_CH_4_7));
+	}
+}
+
+/* CHECK IF A CHANNEL HAS A PENDING REQUEST.
+ * @param channel_index:	Channel index.
+ * @return:					1 if the channel is enabled, not complete and requested by its selected peripheral, 0 otherwise.
+ */
+static unsigned char DMA_MODEL_is_requested(unsigned char channel_index) {
+	// Local variables.
+	DMA_MODEL_channel_registers_t* registers = DMA_MODEL_get_registers(channel_index);
+	unsigned char selection = (((dma_model_ctx.dma -> CSELR) >> (4 * channel_index)) & 0b1111);
+	unsigned char request = 0;
+	if ((((registers -> CCR) & (0b1 << 0)) == 0) || (((registers -> CNDTR) & 0xFFFF) == 0)) return 0;
+	for (request=0 ; request<DMA_MODEL_REQUEST_LAST ; request++) {
+		if ((DMA_MODEL_REQUEST_MAPPING[request].channel_index == channel_index) && (DMA_MODEL_REQUEST_MAPPING[request].selection == selection) && (dma_model_ctx.request[request] != 0)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* TRANSFER ONE DATA ON A CHANNEL.
+ * @param channel_index:	Channel index.
+ * @return:					None.
+ */
+static void DMA_MODEL_transfer(unsigned char channel_index) {
+	// Local variables.
+	DMA_MODEL_channel_registers_t* registers = DMA_MODEL_get_registers(channel_index);
+	DMA_MODEL_channel_t* channel = &(dma_model_ctx.channel[channel_index]);
+	unsigned int ccr = (registers -> CCR);
+	unsigned char peripheral_size = (0b1 << ((ccr >> 8) & 0b11));
+	unsigned char memory_size = (0b1 << ((ccr >> 10) & 0b11));
+	unsigned int remaining = 0;
+	unsigned int data = 0;
+	if ((ccr & (0b1 << 4)) != 0) {
+		// Memory to peripheral (DIR='1').
+		data = BUS_read((channel -> memory_address), memory_size);
+		BUS_write((channel -> peripheral_address), data, peripheral_size);
+	}
+	else {
+		data = BUS_read((channel -> peripheral_address), peripheral_size);
+		BUS_write((channel -> memory_address), data, memory_size);
+	}
+	if ((ccr & (0b1 << 7)) != 0) channel -> memory_address += memory_size; // MINC.
+	if ((ccr & (0b1 << 6)) != 0) channel -> peripheral_address += peripheral_size; // PINC.
+	remaining = (((registers -> CNDTR) & 0xFFFF) - 1);
+	registers -> CNDTR = remaining;
+	// Half transfer and transfer complete flags (global flag is set with each of them).
+	if (remaining == ((channel -> number_of_data) / 2)) {
+		dma_model_ctx.dma -> ISR |= (0b0101 << (4 * channel_index));
+	}
+	if (remaining == 0) {
+		dma_model_ctx.dma -> ISR |= (0b0011 << (4 * channel_index));
+		if ((ccr & (0b1 << 5)) != 0) {
+			// Circular mode.
+			registers -> CNDTR = (channel -> number_of_data);
+			channel -> memory_address = (registers -> CMAR);
+			channel -> peripheral_address = (registers -> CPAR);
+		}
+	}
+}
+
+/* SERVE ALL PENDING REQUESTS (PERIPHERALS MAY RAISE NEW REQUESTS WHILE BEING ACCESSED).
+ * @param:	None.
+ * @return:	None.
+ */
+static void DMA_MODEL_service(void) {
+	// Local variables.
+	unsigned char channel_index = 0;
+	unsigned char selected_index = 0;
+	unsigned char selected_priority = 0;
+	unsigned char priority = 0;
+	unsigned char selected = 0;
+	if (dma_model_ctx.servicing != 0) return;
+	dma_model_ctx.servicing = 1;
+	while (1) {
+		// Arbitration: highest software priority level, then lowest channel number.
+		selected = 0;
+		for (channel_index=0 ; channel_index<DMA_MODEL_CHANNEL_NUMBER ; channel_index++) {
+			if (DMA_MODEL_is_requested(channel_index) == 0) continue;
+			priority = (((DMA_MODEL_get_registers(channel_index) -> CCR) >> 12) & 0b11);
+			if ((selected == 0) || (priority > selected_priority)) {
+				selected = 1;
+				selected_index = channel_index;
+				selected_priority = priority;
+			}
+		}
+		if (selected == 0) break;
+		DMA_MODEL_transfer(selected_index);
+	}
+	dma_model_ctx.servicing = 0;
+	DMA_MODEL_update_irq();
+}
+
+/* DMA REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void DMA_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned char channel_index = 0;
+	DMA_MODEL_channel_registers_t* registers = 0;
+	unsigned int flags = 0;
+	switch (offset) {
+	case offsetof(DMA_base_address_t, ISR):
+		// Read-only.
+		dma_model_ctx.dma -> ISR = previous_value;
+		break;
+	case offsetof(DMA_base_address_t, IFCR):
+		// Clearing a flag of a channel also clears its global flag when no other flag remains.
+		dma_model_ctx.dma -> ISR &= ~(dma_model_ctx.dma -> IFCR);
+		dma_model_ctx.dma -> IFCR = 0;
+		for (channel_index=0 ; channel_index<DMA_MODEL_CHANNEL_NUMBER ; channel_index++) {
+			flags = ((dma_model_ctx.dma -> ISR) >> (4 * channel_index));
+			if ((flags & DMA_MODEL_FLAGS_MASK) == 0) {
+				dma_model_ctx.dma -> ISR &= ~(0b1 << (4 * channel_index));
+			}
+		}
+		break;
+	default:
+		if ((offset < offsetof(DMA_base_address_t, CCR1)) || (offset >= offsetof(DMA_base_address_t, CSELR))) break;
+		channel_index = ((offset - offsetof(DMA_base_address_t, CCR1)) / DMA_MODEL_CHANNEL_STRIDE);
+		registers = DMA_MODEL_get_registers(channel_index);
+		switch ((offset - offsetof(DMA_base_address_t, CCR1)) % DMA_MODEL_CHANNEL_STRIDE) {
+		case offsetof(DMA_MODEL_channel_registers_t, CCR):
+			// Addresses and number of data are latched when the channel is enabled.
+			if ((((registers -> CCR) & ~previous_value) & (0b1 << 0)) != 0) {
+				dma_model_ctx.channel[channel_index].peripheral_address = (registers -> CPAR);
+				dma_model_ctx.channel[channel_index].memory_address = (registers -> CMAR);
+				dma_model_ctx.channel[channel_index].number_of_data = ((registers -> CNDTR) & 0xFFFF);
+			}
+			break;
+		case offsetof(DMA_MODEL_channel_registers_t, CNDTR):
+		case offsetof(DMA_MODEL_channel_registers_t, CPAR):
+		case offsetof(DMA_MODEL_channel_registers_t, CMAR):
+			// Configuration is locked while the channel is enabled.
+			if (((registers -> CCR) & (0b1 << 0)) != 0) {
+				*((unsigned int*) (((unsigned char*) dma_model_ctx.dma) + offset)) = previous_value;
+			}
+			break;
+		default:
+			break;
+		}
+		break;
+	}
+	// Interrupt lines are updated after servicing.
+	DMA_MODEL_service();
+}
+
+/* INIT DMA MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) DMA_MODEL_init(void) {
+	dma_model_ctx.dma = BUS_map_peripheral((unsigned long) DMA1, sizeof(DMA_base_address_t), 0, &DMA_MODEL_write_callback);
+}
+
+/*** DMA MODEL functions ***/
+
+/* SET THE LEVEL OF A PERIPHERAL REQUEST LINE.
+ * @param request:	Request line.
+ * @param level:	Request level (transfers are performed immediately while the line is high).
+ * @return:			None.
+ */
+void DMA_MODEL_set_request(DMA_MODEL_request_t request, unsigned char level) {
+	if (request >= DMA_MODEL_REQUEST_LAST) return;
+	dma_model_ctx.request[request] = (level != 0) ? 1 : 0;
+	if (level != 0) {
+		DMA_MODEL_service();
+	}
+}
+
+#endif /* HOST */
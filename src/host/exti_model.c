@@ -0,0 +1,129 @@
+/*
+ * exti_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "exti_model.h"
+
+#include "bus.h"
+#include "exti_reg.h"
+#include "host.h"
+#include "nvic.h"
+#include "syscfg_reg.h"
+#include <stddef.h>
+
+/*** EXTI MODEL local macros ***/
+
+#define EXTI_MODEL_CONFIGURABLE_LINES_MASK	0x007BFFFF // Lines with a pending bit (direct lines are wired to the NVIC by their peripheral).
+
+/*** EXTI MODEL local structures ***/
+
+typedef struct {
+	unsigned int lines_mask;
+	NVIC_interrupt_t it_num;
+} EXTI_MODEL_interrupt_t;
+
+typedef struct {
+	EXTI_base_address_t* exti;
+	SYSCFG_base_address_t* syscfg;
+} EXTI_MODEL_context_t;
+
+/*** EXTI MODEL local global variables ***/
+
+static EXTI_MODEL_context_t exti_model_ctx;
+static const EXTI_MODEL_interrupt_t EXTI_MODEL_INTERRUPTS[] = {
+	{0x00000003, NVIC_IT_EXTI_0_1},
+	{0x0000000C, NVIC_IT_EXTI_2_3},
+	{0x0000FFF0, NVIC_IT_EXTI_4_15},
+	{0x00010000, NVIC_IT_PVD},
+	{0x001A0000, NVIC_IT_RTC},
+	{0x00600000, NVIC_IT_ADC_COMP},
+};
+
+/*** EXTI MODEL local functions ***/
+
+/* SET NVIC INTERRUPTS OF UNMASKED PENDING LINES.
+ * @param:	None.
+ * @return:	None.
+ */
+static void EXTI_MODEL_update_irq(void) {
+	// Local variables.
+	unsigned int pending = ((exti_model_ctx.exti -> PR) & (exti_model_ctx.exti -> IMR));
+	unsigned char idx = 0;
+	for (idx=0 ; idx<(sizeof(EXTI_MODEL_INTERRUPTS) / sizeof(EXTI_MODEL_interrupt_t)) ; idx++) {
+		if ((pending & EXTI_MODEL_INTERRUPTS[idx].lines_mask) != 0) {
+			HOST_set_irq_pending(EXTI_MODEL_INTERRUPTS[idx].it_num);
+		}
+	}
+}
+
+/* EXTI REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void EXTI_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	switch (offset) {
+	case offsetof(EXTI_base_address_t, PR):
+		// Pending bits are cleared by writing '1'.
+		exti_model_ctx.exti -> PR = (previous_value & ~(exti_model_ctx.exti -> PR));
+		break;
+	case offsetof(EXTI_base_address_t, SWIER):
+		// Software trigger sets the pending bit, register is cleared with the flag.
+		exti_model_ctx.exti -> PR |= ((exti_model_ctx.exti -> SWIER) & EXTI_MODEL_CONFIGURABLE_LINES_MASK);
+		exti_model_ctx.exti -> SWIER = 0;
+		break;
+	default:
+		break;
+	}
+	EXTI_MODEL_update_irq();
+}
+
+/* INIT EXTI MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) EXTI_MODEL_init(void) {
+	// System configuration registers only hold the GPIO ports selection.
+	exti_model_ctx.syscfg = BUS_map_peripheral((unsigned long) SYSCFG, sizeof(SYSCFG_base_address_t), 0, 0);
+	exti_model_ctx.exti = BUS_map_peripheral((unsigned long) EXTI, sizeof(EXTI_base_address_t), 0, &EXTI_MODEL_write_callback);
+}
+
+/*** EXTI MODEL functions ***/
+
+/* APPLY AN EDGE ON AN EXTI LINE (CALLED BY PERIPHERALS MODELS).
+ * @param line:		EXTI line.
+ * @param rising:	1 for a rising edge, 0 for a falling edge.
+ * @return:			1 if the edge generated an interrupt request, 0 otherwise.
+ */
+unsigned char EXTI_MODEL_edge(unsigned char line, unsigned char rising) {
+	// Local variables.
+	unsigned int line_mask = (0b1 << line);
+	unsigned int trigger = (rising != 0) ? (exti_model_ctx.exti -> RTSR) : (exti_model_ctx.exti -> FTSR);
+	if (((line_mask & EXTI_MODEL_CONFIGURABLE_LINES_MASK) == 0) || ((trigger & line_mask) == 0)) return 0;
+	exti_model_ctx.exti -> PR |= line_mask;
+	EXTI_MODEL_update_irq();
+	return (((exti_model_ctx.exti -> IMR) & line_mask) != 0) ? 1 : 0;
+}
+
+/* APPLY AN EDGE ON A GPIO PIN.
+ * @param port_index:	GPIO port (0 for GPIOA, 1 for GPIOB, etc).
+ * @param pin_index:	GPIO pin.
+ * @param rising:		1 for a rising edge, 0 for a falling edge.
+ * @return:				1 if the edge generated an interrupt request, 0 otherwise.
+ */
+unsigned char EXTI_MODEL_gpio_edge(unsigned char port_index, unsigned char pin_index, unsigned char rising) {
+	// Local variables.
+	unsigned char selected_port = 0;
+	if (pin_index > EXTI_MODEL_LINE_GPIO_LAST) return 0;
+	// Each line is connected to a single port.
+	selected_port = ((exti_model_ctx.syscfg -> EXTICR[pin_index / 4]) >> (4 * (pin_index % 4))) & 0b1111;
+	if (selected_port != port_index) return 0;
+	return EXTI_MODEL_edge(pin_index, rising);
+}
+
+#endif /* HOST */
@@ -0,0 +1,170 @@
+/*
+ * flash_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "bus.h"
+#include "flash_reg.h"
+#include "host.h"
+#include "nvic.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** FLASH MODEL local macros ***/
+
+#define FLASH_MODEL_EEPROM_FILE_VARIABLE	"HOST_EEPROM_FILE"
+#define FLASH_MODEL_PECR_RESET				0x00000007 // PELOCK, PRGLOCK and OPTLOCK.
+#define FLASH_MODEL_SR_RESET				0x0000000C // Ready for low power mode and EEPROM programming.
+#define FLASH_MODEL_SR_FLAGS_MASK			0x00032F02 // EOP and error flags (rc_w1).
+#define FLASH_MODEL_SR_ERRORS_MASK			0x00032F00
+#define FLASH_MODEL_PEKEY1					0x89ABCDEF
+#define FLASH_MODEL_PEKEY2					0x02030405
+#define FLASH_MODEL_EEPROM_WRITE_US			3200 // Erase and program (datasheet tprog).
+
+/*** FLASH MODEL local structures ***/
+
+typedef struct {
+	FLASH_base_address_t* flash;
+	unsigned char* eeprom;
+	unsigned char pekey_count;
+	HOST_event_t program_event;
+	char* eeprom_file_name;
+} FLASH_MODEL_context_t;
+
+/*** FLASH MODEL local global variables ***/
+
+static FLASH_MODEL_context_t flash_model_ctx;
+
+/*** FLASH MODEL local functions ***/
+
+/* UPDATE FLASH INTERRUPT LINE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void FLASH_MODEL_update_irq(void) {
+	// Local variables.
+	unsigned int sr = (flash_model_ctx.flash -> SR);
+	unsigned int pecr = (flash_model_ctx.flash -> PECR);
+	if ((((sr & (0b1 << 1)) != 0) && ((pecr & (0b1 << 16)) != 0)) || (((sr & FLASH_MODEL_SR_ERRORS_MASK) != 0) && ((pecr & (0b1 << 17)) != 0))) {
+		HOST_set_irq_pending(NVIC_IT_FLASH);
+	}
+}
+
+/* EEPROM PROGRAMMING END.
+ * @param:	None.
+ * @return:	None.
+ */
+static void FLASH_MODEL_program_event_callback(void) {
+	flash_model_ctx.flash -> SR &= ~(0b1 << 0); // BSY='0'.
+	// EOP is only set when the end of operation interrupt is enabled.
+	if (((flash_model_ctx.flash -> PECR) & (0b1 << 16)) != 0) {
+		flash_model_ctx.flash -> SR |= (0b1 << 1);
+	}
+	FLASH_MODEL_update_irq();
+}
+
+/* FLASH REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void FLASH_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int value = 0;
+	switch (offset) {
+	case offsetof(FLASH_base_address_t, PECR):
+		// Register is locked while PELOCK is set, lock bits can only be set by software.
+		if ((previous_value & (0b1 << 0)) != 0) {
+			flash_model_ctx.flash -> PECR = previous_value;
+		}
+		else if (((flash_model_ctx.flash -> PECR) & (0b1 << 0)) != 0) {
+			flash_model_ctx.flash -> PECR |= (FLASH_MODEL_PECR_RESET);
+		}
+		break;
+	case offsetof(FLASH_base_address_t, PEKEYR):
+		// Unlock sequence.
+		value = (flash_model_ctx.flash -> PEKEYR);
+		flash_model_ctx.flash -> PEKEYR = 0;
+		if ((flash_model_ctx.pekey_count == 0) && (value == FLASH_MODEL_PEKEY1)) {
+			flash_model_ctx.pekey_count = 1;
+		}
+		else if ((flash_model_ctx.pekey_count == 1) && (value == FLASH_MODEL_PEKEY2)) {
+			flash_model_ctx.flash -> PECR &= ~(0b1 << 0); // PELOCK='0'.
+			flash_model_ctx.pekey_count = 0;
+		}
+		else {
+			flash_model_ctx.pekey_count = 0;
+		}
+		break;
+	case offsetof(FLASH_base_address_t, SR):
+		// Flags are cleared by writing '1', other bits are read-only.
+		value = (flash_model_ctx.flash -> SR);
+		flash_model_ctx.flash -> SR = previous_value & ~(value & FLASH_MODEL_SR_FLAGS_MASK);
+		break;
+	default:
+		break;
+	}
+	FLASH_MODEL_update_irq();
+}
+
+/* EEPROM WRITE CALLBACK.
+ * @param offset:			Word offset.
+ * @param previous_value:	Word value before write.
+ * @return:					None.
+ */
+static void FLASH_MODEL_eeprom_write_callback(unsigned int offset, unsigned int previous_value) {
+	if (((flash_model_ctx.flash -> PECR) & (0b1 << 0)) != 0) {
+		// Write protection error.
+		*((unsigned int*) (flash_model_ctx.eeprom + offset)) = previous_value;
+		flash_model_ctx.flash -> SR |= (0b1 << 8); // WRPERR='1'.
+		FLASH_MODEL_update_irq();
+		return;
+	}
+	flash_model_ctx.flash -> SR |= (0b1 << 0); // BSY='1'.
+	HOST_start_event(&flash_model_ctx.program_event, FLASH_MODEL_EEPROM_WRITE_US, &FLASH_MODEL_program_event_callback);
+}
+
+/* SAVE EEPROM CONTENT AT EXIT.
+ * @param:	None.
+ * @return:	None.
+ */
+static void FLASH_MODEL_save_eeprom(void) {
+	// Local variables.
+	FILE* eeprom_file = fopen(flash_model_ctx.eeprom_file_name, "wb");
+	if (eeprom_file == 0) return;
+	fwrite(flash_model_ctx.eeprom, 1, EEPROM_SIZE, eeprom_file);
+	fclose(eeprom_file);
+}
+
+/* INIT FLASH MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) FLASH_MODEL_init(void) {
+	// Local variables.
+	FILE* eeprom_file = 0;
+	// Reset values.
+	flash_model_ctx.flash = BUS_map_peripheral((unsigned long) FLASH, sizeof(FLASH_base_address_t), 0, &FLASH_MODEL_write_callback);
+	flash_model_ctx.flash -> PECR = FLASH_MODEL_PECR_RESET;
+	flash_model_ctx.flash -> SR = FLASH_MODEL_SR_RESET;
+	// Data EEPROM is read directly by the firmware, writes start programming.
+	flash_model_ctx.eeprom = BUS_map_peripheral(EEPROM_START_ADDRESS, EEPROM_SIZE, 0, &FLASH_MODEL_eeprom_write_callback);
+	// Persistent content.
+	flash_model_ctx.eeprom_file_name = getenv(FLASH_MODEL_EEPROM_FILE_VARIABLE);
+	if (flash_model_ctx.eeprom_file_name == 0) return;
+	eeprom_file = fopen(flash_model_ctx.eeprom_file_name, "rb");
+	if (eeprom_file != 0) {
+		if (fread(flash_model_ctx.eeprom, 1, EEPROM_SIZE, eeprom_file) != EEPROM_SIZE) {
+			fprintf(stderr, "HOST: incomplete EEPROM file %s\n", flash_model_ctx.eeprom_file_name);
+		}
+		fclose(eeprom_file);
+	}
+	atexit(&FLASH_MODEL_save_eeprom);
+}
+
+#endif /* HOST */
@@ -0,0 +1,155 @@
+/*
+ * gpio_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "gpio_model.h"
+
+#include "bus.h"
+#include "exti_model.h"
+#include "gpio.h"
+#include "gpio_reg.h"
+#include "host.h"
+#include <stddef.h>
+
+/*** GPIO MODEL local macros ***/
+
+#define GPIO_MODEL_PORT_STRIDE		0x400
+#define GPIO_MODEL_PIN_NUMBER		16
+#define GPIO_MODEL_MODER_RESET_A	0xEBFFFCFF // SWD pins in alternate function mode.
+#define GPIO_MODEL_MODER_RESET		0xFFFFFFFF
+
+/*** GPIO MODEL local structures ***/
+
+typedef struct {
+	GPIO_base_address_t* port[GPIO_MODEL_PORT_NUMBER];
+	unsigned short input[GPIO_MODEL_PORT_NUMBER]; // Levels driven by external devices.
+	unsigned short output[GPIO_MODEL_PORT_NUMBER]; // Levels driven by the MCU.
+	GPIO_MODEL_callback_t callback[GPIO_MODEL_PORT_NUMBER][GPIO_MODEL_PIN_NUMBER];
+} GPIO_MODEL_context_t;
+
+/*** GPIO MODEL local global variables ***/
+
+static GPIO_MODEL_context_t gpio_model_ctx;
+
+/*** GPIO MODEL local functions ***/
+
+/* UPDATE INPUT REGISTER AND PINS LEVEL OF A PORT.
+ * @param port_index:	Port to update.
+ * @return:				None.
+ */
+static void GPIO_MODEL_update_port(unsigned char port_index) {
+	// Local variables.
+	GPIO_base_address_t* port = gpio_model_ctx.port[port_index];
+	unsigned short output_mask = 0;
+	unsigned short output = 0;
+	unsigned short changed = 0;
+	unsigned char pin_index = 0;
+	// Pins in output mode (MODERy='01').
+	for (pin_index=0 ; pin_index<GPIO_MODEL_PIN_NUMBER ; pin_index++) {
+		if ((((port -> MODER) >> (2 * pin_index)) & 0b11) == 0b01) {
+			output_mask |= (0b1 << pin_index);
+		}
+	}
+	port -> ODR &= 0x0000FFFF;
+	port -> IDR = (gpio_model_ctx.input[port_index] & ~output_mask) | ((port -> ODR) & output_mask);
+	// Pins which are not driven by the MCU are seen low by the external devices.
+	output = ((port -> ODR) & output_mask);
+	changed = (output ^ gpio_model_ctx.output[port_index]);
+	gpio_model_ctx.output[port_index] = output;
+	for (pin_index=0 ; pin_index<GPIO_MODEL_PIN_NUMBER ; pin_index++) {
+		if (((changed & (0b1 << pin_index)) != 0) && (gpio_model_ctx.callback[port_index][pin_index] != 0)) {
+			gpio_model_ctx.callback[port_index][pin_index]((output >> pin_index) & 0b1);
+		}
+	}
+}
+
+/* GPIO REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset from GPIOA.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void GPIO_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned char port_index = (offset / GPIO_MODEL_PORT_STRIDE);
+	GPIO_base_address_t* port = 0;
+	unsigned int value = 0;
+	if (port_index >= GPIO_MODEL_PORT_NUMBER) return;
+	port = gpio_model_ctx.port[port_index];
+	switch (offset % GPIO_MODEL_PORT_STRIDE) {
+	case offsetof(GPIO_base_address_t, BSRR):
+		// Set bits have priority over reset bits, register always reads 0.
+		value = (port -> BSRR);
+		port -> ODR = (((port -> ODR) & ~(value >> 16)) | (value & 0x0000FFFF));
+		port -> BSRR = 0;
+		break;
+	case offsetof(GPIO_base_address_t, BRR):
+		port -> ODR &= ~((port -> BRR) & 0x0000FFFF);
+		port -> BRR = 0;
+		break;
+	case offsetof(GPIO_base_address_t, IDR):
+		// Read-only.
+		port -> IDR = previous_value;
+		break;
+	default:
+		break;
+	}
+	GPIO_MODEL_update_port(port_index);
+}
+
+/* INIT GPIO MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) GPIO_MODEL_init(void) {
+	// Local variables.
+	unsigned char* ports = BUS_map_peripheral((unsigned long) GPIOA, (GPIO_MODEL_PORT_NUMBER * GPIO_MODEL_PORT_STRIDE), 0, &GPIO_MODEL_write_callback);
+	unsigned char port_index = 0;
+	// Reset values.
+	for (port_index=0 ; port_index<GPIO_MODEL_PORT_NUMBER ; port_index++) {
+		gpio_model_ctx.port[port_index] = (GPIO_base_address_t*) (ports + (port_index * GPIO_MODEL_PORT_STRIDE));
+		gpio_model_ctx.port[port_index] -> MODER = (port_index == 0) ? GPIO_MODEL_MODER_RESET_A : GPIO_MODEL_MODER_RESET;
+	}
+}
+
+/*** GPIO MODEL functions ***/
+
+/* ATTACH AN EXTERNAL DEVICE TO A PIN DRIVEN BY THE MCU.
+ * @param gpio:		Pin to watch.
+ * @param callback:	Function called on each level change.
+ * @return:			None.
+ */
+void GPIO_MODEL_set_callback(const GPIO_pin_t* gpio, GPIO_MODEL_callback_t callback) {
+	if ((gpio -> port_index) >= GPIO_MODEL_PORT_NUMBER) return;
+	gpio_model_ctx.callback[gpio -> port_index][gpio -> pin_index] = callback;
+}
+
+/* DRIVE A MCU INPUT PIN FROM AN EXTERNAL DEVICE.
+ * @param gpio:		Pin to drive.
+ * @param level:	New pin level.
+ * @return:			1 if the edge triggered an external interrupt, 0 otherwise.
+ */
+unsigned char GPIO_MODEL_set_input(const GPIO_pin_t* gpio, unsigned char level) {
+	// Local variables.
+	unsigned short pin_mask = (0b1 << (gpio -> pin_index));
+	unsigned char previous_level = 0;
+	if ((gpio -> port_index) >= GPIO_MODEL_PORT_NUMBER) return 0;
+	previous_level = ((gpio_model_ctx.input[gpio -> port_index] & pin_mask) != 0) ? 1 : 0;
+	level = (level != 0) ? 1 : 0;
+	if (level == previous_level) return 0;
+	if (level != 0) {
+		gpio_model_ctx.input[gpio -> port_index] |= pin_mask;
+	}
+	else {
+		gpio_model_ctx.input[gpio -> port_index] &= ~pin_mask;
+	}
+	GPIO_MODEL_update_port(gpio -> port_index);
+	// Edge detection is done on the pad, whatever the pin mode.
+	return EXTI_MODEL_gpio_edge((gpio -> port_index), (gpio -> pin_index), level);
+}
+
+#endif /* HOST */
@@ -0,0 +1,603 @@
+/*
+ * host.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "host.h"
+
+#include "bus.h"
+#include "nvic.h"
+#include "nvic_reg.h"
+#include "scb_reg.h"
+#include "systick_reg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+/*** HOST local macros ***/
+
+#define HOST_TIME_INFINITE				0xFFFFFFFFFFFFFFFFULL
+#define HOST_SYSCLK_RESET_KHZ			2097 // MSI range 5.
+#define HOST_PRIORITY_THREAD			(NVIC_PRIORITY_MIN + 1) // Execution priority of the main context.
+#define HOST_VECTOR_TABLE_IRQ_OFFSET	16 // Number of core exceptions before interrupts in vector table.
+
+#define HOST_NVIC_ADDRESS				0xE000E100
+#define HOST_SCB_ADDRESS				0xE000ED00
+#define HOST_SYSTICK_ADDRESS			0xE000E010
+#define HOST_NVIC_OFFSET_ISER			0x000
+#define HOST_NVIC_OFFSET_ICER			0x080
+#define HOST_NVIC_OFFSET_ISPR			0x100
+#define HOST_NVIC_OFFSET_ICPR			0x180
+#define HOST_NVIC_OFFSET_IPR			0x300
+#define HOST_SCB_OFFSET_AIRCR			0x0C
+#define HOST_SCB_CPUID					0x410CC601 // Cortex-M0+ r0p1.
+#define HOST_SCB_AIRCR_RESET			0xFA050000
+#define HOST_SYSTICK_OFFSET_CSR			0x00
+#define HOST_SYSTICK_OFFSET_CVR			0x08
+
+/*** HOST local structures ***/
+
+typedef void (*HOST_vector_t)(void);
+
+typedef struct {
+	// Virtual time.
+	unsigned long long time_ns;
+	unsigned int sysclk_khz;
+	unsigned long long cycle_count;
+	unsigned int cycle_remainder; // Fraction of ns not yet added to time (in cycles x 10^6 / kHz unit).
+	HOST_event_t* event_list;
+	HOST_event_callback_t wake_up_callback;
+	// Interrupt controller.
+	NVIC_base_address_t* nvic;
+	unsigned int irq_enabled;
+	unsigned int irq_pending;
+	unsigned char irq_priority[NVIC_IT_LAST];
+	unsigned char execution_priority;
+	unsigned char primask;
+	// System control block and system timer.
+	SCB_base_address_t* scb;
+	SYSTICK_base_address_t* systick;
+	unsigned long long systick_reference_cycles;
+	unsigned int systick_reference_position;
+	unsigned long long systick_zero_count;
+	// UART input (stdin).
+	HOST_rx_callback_t rx_callback;
+	unsigned int rx_byte_duration_us;
+	HOST_event_t rx_event;
+	unsigned char rx_enabled;
+	unsigned char rx_eof;
+	unsigned long long rx_eof_time_ns;
+	unsigned char realtime;
+} HOST_context_t;
+
+/*** HOST local global variables ***/
+
+static HOST_context_t host_ctx;
+
+extern const HOST_vector_t __Vectors[];
+
+/*** HOST local functions ***/
+
+/* GET EARLIEST ARMED EVENT.
+ * @param:	None.
+ * @return:	Pointer to event, 0 if no event is armed.
+ */
+static HOST_event_t* HOST_get_next_event(void) {
+	// Local variables.
+	HOST_event_t* event = host_ctx.event_list;
+	HOST_event_t* next_event = 0;
+	while (event != 0) {
+		if ((next_event == 0) || ((event -> deadline_ns) < (next_event -> deadline_ns))) {
+			next_event = event;
+		}
+		event = (event -> next);
+	}
+	return next_event;
+}
+
+/* ADVANCE VIRTUAL TIME AND EXECUTE ALL EVENTS EXPIRING ON THE WAY.
+ * @param time_ns:	New virtual time.
+ * @return:			None.
+ */
+static void HOST_advance_time(unsigned long long time_ns) {
+	// Local variables.
+	HOST_event_t* event = 0;
+	while (1) {
+		event = HOST_get_next_event();
+		if ((event == 0) || ((event -> deadline_ns) > time_ns)) break;
+		if ((event -> deadline_ns) > host_ctx.time_ns) {
+			host_ctx.time_ns = (event -> deadline_ns);
+		}
+		HOST_stop_event(event);
+		event -> callback();
+	}
+	if (time_ns > host_ctx.time_ns) {
+		host_ctx.time_ns = time_ns;
+	}
+}
+
+/* UPDATE NVIC REGISTERS FROM INTERNAL STATE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void HOST_update_nvic(void) {
+	// Set and clear registers both read the current state.
+	host_ctx.nvic -> ISER = host_ctx.irq_enabled;
+	host_ctx.nvic -> ICER = host_ctx.irq_enabled;
+	host_ctx.nvic -> ISPR = host_ctx.irq_pending;
+	host_ctx.nvic -> ICPR = host_ctx.irq_pending;
+}
+
+/* GET THE HIGHEST PRIORITY INTERRUPT ABLE TO PREEMPT CURRENT EXECUTION PRIORITY.
+ * @param:	None.
+ * @return:	Interrupt number, NVIC_IT_LAST if none.
+ */
+static NVIC_interrupt_t HOST_get_ready_irq(void) {
+	// Local variables.
+	NVIC_interrupt_t it_num = 0;
+	NVIC_interrupt_t ready_it = NVIC_IT_LAST;
+	unsigned int ready = (host_ctx.irq_pending & host_ctx.irq_enabled);
+	for (it_num=0 ; it_num<NVIC_IT_LAST ; it_num++) {
+		if ((ready & (0b1 << it_num)) == 0) continue;
+		if (host_ctx.irq_priority[it_num] >= host_ctx.execution_priority) continue;
+		if ((ready_it == NVIC_IT_LAST) || (host_ctx.irq_priority[it_num] < host_ctx.irq_priority[ready_it])) {
+			ready_it = it_num;
+		}
+	}
+	return ready_it;
+}
+
+/* NVIC REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void HOST_nvic_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int value = *((unsigned int*) (((unsigned char*) host_ctx.nvic) + offset));
+	unsigned char it_num = 0;
+	(void) previous_value;
+	switch (offset) {
+	case HOST_NVIC_OFFSET_ISER:
+		host_ctx.irq_enabled |= value;
+		break;
+	case HOST_NVIC_OFFSET_ICER:
+		host_ctx.irq_enabled &= ~value;
+		break;
+	case HOST_NVIC_OFFSET_ISPR:
+		host_ctx.irq_pending |= value;
+		break;
+	case HOST_NVIC_OFFSET_ICPR:
+		host_ctx.irq_pending &= ~value;
+		break;
+	default:
+		if ((offset >= HOST_NVIC_OFFSET_IPR) && (offset < (HOST_NVIC_OFFSET_IPR + sizeof(host_ctx.nvic -> IPR)))) {
+			// Only the 2 most significant bits of each priority field are implemented.
+			for (it_num=0 ; it_num<NVIC_IT_LAST ; it_num++) {
+				host_ctx.irq_priority[it_num] = (((host_ctx.nvic -> IPR[it_num >> 2]) >> (8 * (it_num % 4))) & 0xFF) >> 6;
+			}
+		}
+		break;
+	}
+	host_ctx.irq_enabled &= ((0b1 << NVIC_IT_LAST) - 1);
+	host_ctx.irq_pending &= ((0b1 << NVIC_IT_LAST) - 1);
+	HOST_update_nvic();
+}
+
+/* SCB REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void HOST_scb_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int value = 0;
+	// Read-only identification.
+	host_ctx.scb -> CPUID = HOST_SCB_CPUID;
+	if (offset != HOST_SCB_OFFSET_AIRCR) return;
+	// Register always reads the key status.
+	value = (host_ctx.scb -> AIRCR);
+	host_ctx.scb -> AIRCR = previous_value;
+	// Writes without key are ignored.
+	if ((value >> 16) != 0x05FA) return;
+	if ((value & (0b1 << 2)) != 0) {
+		// SYSRESETREQ='1'.
+		fprintf(stderr, "HOST: software reset at %llu ms\n", (host_ctx.time_ns / 1000000));
+		exit(EXIT_FAILURE);
+	}
+}
+
+/* GET SYSTEM TIMER STATE.
+ * @param position:		Pointer to the number of cycles since last reload (RVR - CVR).
+ * @param zero_count:	Pointer to the number of times the counter reached 0 since start.
+ * @return:				None.
+ */
+static void HOST_get_systick_state(unsigned int* position, unsigned long long* zero_count) {
+	// Local variables.
+	unsigned long long period = ((host_ctx.systick -> RVR) & 0x00FFFFFF) + 1ULL;
+	unsigned long long elapsed = (host_ctx.cycle_count - host_ctx.systick_reference_cycles) + host_ctx.systick_reference_position;
+	(*position) = (unsigned int) (elapsed % period);
+	(*zero_count) = ((elapsed + 1) / period) - ((host_ctx.systick_reference_position + 1) / period);
+}
+
+/* SYSTEM TIMER READ CALLBACK.
+ * @param offset:	Register offset.
+ * @return:			None.
+ */
+static void HOST_systick_read_callback(unsigned int offset) {
+	// Local variables.
+	unsigned int position = 0;
+	unsigned long long zero_count = 0;
+	// Counter is frozen while disabled.
+	if (((host_ctx.systick -> CSR) & (0b1 << 0)) == 0) return;
+	HOST_get_systick_state(&position, &zero_count);
+	host_ctx.systick -> CVR = (((host_ctx.systick -> RVR) & 0x00FFFFFF) - position);
+	if (offset == HOST_SYSTICK_OFFSET_CSR) {
+		// COUNTFLAG is cleared by read.
+		host_ctx.systick -> CSR &= ~(0b1 << 16);
+		if (zero_count > host_ctx.systick_zero_count) {
+			host_ctx.systick -> CSR |= (0b1 << 16);
+		}
+		host_ctx.systick_zero_count = zero_count;
+	}
+}
+
+/* SYSTEM TIMER WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void HOST_systick_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int rvr = ((host_ctx.systick -> RVR) & 0x00FFFFFF);
+	unsigned int cvr = 0;
+	if (offset == HOST_SYSTICK_OFFSET_CVR) {
+		// Any write clears the counter and COUNTFLAG.
+		host_ctx.systick -> CVR = 0;
+		host_ctx.systick -> CSR &= ~(0b1 << 16);
+		if (((host_ctx.systick -> CSR) & (0b1 << 0)) == 0) return;
+	}
+	else {
+		if ((offset != HOST_SYSTICK_OFFSET_CSR) || ((((host_ctx.systick -> CSR) ^ previous_value) & (0b1 << 0)) == 0)) return;
+		if (((host_ctx.systick -> CSR) & (0b1 << 0)) == 0) {
+			// Counter disabled: freeze current value.
+			host_ctx.systick -> CSR |= (0b1 << 0);
+			HOST_systick_read_callback(HOST_SYSTICK_OFFSET_CVR);
+			host_ctx.systick -> CSR &= ~(0b1 << 0);
+			return;
+		}
+	}
+	// Count from current value (the counter reloads RVR on the cycle following 0).
+	cvr = (host_ctx.systick -> CVR);
+	host_ctx.systick_reference_cycles = host_ctx.cycle_count;
+	host_ctx.systick_reference_position = (cvr <= rvr) ? (rvr - cvr) : 0;
+	host_ctx.systick_zero_count = 0;
+}
+
+/* RECEIVE NEXT INPUT BYTE (BYTES ARE SPACED BY THE UART CHARACTER DURATION).
+ * @param:	None.
+ * @return:	None.
+ */
+static void HOST_rx_event_callback(void) {
+	// Local variables.
+	unsigned char rx_byte = 0;
+	ssize_t rx_length = 0;
+	fd_set read_set;
+	struct timeval timeout = {0, 0};
+	// Input is kept in the pipe while the receiver is disabled.
+	if (host_ctx.rx_enabled == 0) return;
+	// Check if a byte is available without blocking (piped input is read in blocking mode so that virtual time does not depend on the writer scheduling).
+	if (host_ctx.realtime != 0) {
+		FD_ZERO(&read_set);
+		FD_SET(STDIN_FILENO, &read_set);
+		if (select((STDIN_FILENO + 1), &read_set, 0, 0, &timeout) <= 0) return;
+	}
+	rx_length = read(STDIN_FILENO, &rx_byte, 1);
+	if (rx_length <= 0) {
+		host_ctx.rx_eof = 1;
+		host_ctx.rx_eof_time_ns = host_ctx.time_ns;
+		return;
+	}
+	if (host_ctx.rx_callback != 0) {
+		host_ctx.rx_callback(rx_byte);
+	}
+	// Next byte cannot be received before the end of the current character.
+	HOST_start_event(&host_ctx.rx_event, host_ctx.rx_byte_duration_us, &HOST_rx_event_callback);
+}
+
+/* WAIT FOR INPUT DATA.
+ * @param timeout_ns:	Maximum waiting time (HOST_TIME_INFINITE to block).
+ * @return:				1 if data is available, 0 otherwise.
+ */
+static unsigned char HOST_wait_for_input(unsigned long long timeout_ns) {
+	// Local variables.
+	fd_set read_set;
+	struct timeval timeout;
+	FD_ZERO(&read_set);
+	FD_SET(STDIN_FILENO, &read_set);
+	timeout.tv_sec = (timeout_ns / 1000000000);
+	timeout.tv_usec = ((timeout_ns % 1000000000) / 1000);
+	return (select((STDIN_FILENO + 1), &read_set, 0, 0, (timeout_ns == HOST_TIME_INFINITE) ? 0 : &timeout) > 0) ? 1 : 0;
+}
+
+/* INIT HOST CORE BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) HOST_init(void) {
+	// Core clock after reset.
+	host_ctx.sysclk_khz = HOST_SYSCLK_RESET_KHZ;
+	host_ctx.execution_priority = HOST_PRIORITY_THREAD;
+	// Core peripherals.
+	host_ctx.nvic = BUS_map_peripheral(HOST_NVIC_ADDRESS, sizeof(NVIC_base_address_t), 0, &HOST_nvic_write_callback);
+	host_ctx.scb = BUS_map_peripheral(HOST_SCB_ADDRESS, sizeof(SCB_base_address_t), 0, &HOST_scb_write_callback);
+	host_ctx.systick = BUS_map_peripheral(HOST_SYSTICK_ADDRESS, sizeof(SYSTICK_base_address_t), &HOST_systick_read_callback, &HOST_systick_write_callback);
+	host_ctx.scb -> CPUID = HOST_SCB_CPUID;
+	host_ctx.scb -> AIRCR = HOST_SCB_AIRCR_RESET;
+	// Pace virtual time on wall clock when a user is typing, run as fast as possible otherwise.
+	host_ctx.realtime = isatty(STDIN_FILENO) ? 1 : 0;
+	// Unlike the MCU, the host output is buffered.
+	setvbuf(stdout, 0, _IONBF, 0);
+}
+
+/*** HOST functions ***/
+
+/* GET VIRTUAL TIME.
+ * @param:	None.
+ * @return:	Number of nanoseconds since program start.
+ */
+unsigned long long HOST_get_time_ns(void) {
+	return host_ctx.time_ns;
+}
+
+/* GET VIRTUAL TIME.
+ * @param:	None.
+ * @return:	Number of microseconds since program start.
+ */
+unsigned long long HOST_get_time_us(void) {
+	return (host_ctx.time_ns / 1000);
+}
+
+/* ARM A VIRTUAL HARDWARE EVENT (RE-ARM IF ALREADY RUNNING).
+ * @param event:	Event to arm.
+ * @param delay_us:	Delay from current virtual time.
+ * @param callback:	Function called when the event expires.
+ * @return:			None.
+ */
+void HOST_start_event(HOST_event_t* event, unsigned long long delay_us, HOST_event_callback_t callback) {
+	HOST_start_event_at(event, (host_ctx.time_ns + (delay_us * 1000)), callback);
+}
+
+/* ARM A VIRTUAL HARDWARE EVENT AT AN ABSOLUTE DEADLINE (RE-ARM IF ALREADY RUNNING).
+ * @param event:		Event to arm.
+ * @param deadline_ns:	Virtual time of the event.
+ * @param callback:		Function called when the event expires.
+ * @return:				None.
+ */
+void HOST_start_event_at(HOST_event_t* event, unsigned long long deadline_ns, HOST_event_callback_t callback) {
+	HOST_stop_event(event);
+	event -> deadline_ns = deadline_ns;
+	event -> callback = callback;
+	event -> armed = 1;
+	event -> next = host_ctx.event_list;
+	host_ctx.event_list = event;
+}
+
+/* DISARM A VIRTUAL HARDWARE EVENT.
+ * @param event:	Event to disarm.
+ * @return:			None.
+ */
+void HOST_stop_event(HOST_event_t* event) {
+	// Local variables.
+	HOST_event_t** link = &(host_ctx.event_list);
+	while ((*link) != 0) {
+		if ((*link) == event) {
+			(*link) = (event -> next);
+			break;
+		}
+		link = &((*link) -> next);
+	}
+	event -> next = 0;
+	event -> armed = 0;
+}
+
+/* SET CORE CLOCK FREQUENCY (CALLED BY RCC MODEL).
+ * @param sysclk_khz:	New frequency in kHz.
+ * @return:				None.
+ */
+void HOST_set_sysclk_khz(unsigned int sysclk_khz) {
+	host_ctx.sysclk_khz = sysclk_khz;
+	host_ctx.cycle_remainder = 0;
+}
+
+/* GET CORE CLOCK FREQUENCY.
+ * @param:	None.
+ * @return:	Frequency in kHz.
+ */
+unsigned int HOST_get_sysclk_khz(void) {
+	return host_ctx.sysclk_khz;
+}
+
+/* ADVANCE VIRTUAL TIME BY A NUMBER OF CORE CYCLES.
+ * @param cycles:	Number of cycles.
+ * @return:			None.
+ */
+void HOST_consume_cycles(unsigned int cycles) {
+	// Local variables.
+	unsigned long long numerator = ((cycles * 1000000ULL) + host_ctx.cycle_remainder);
+	host_ctx.cycle_count += cycles;
+	host_ctx.cycle_remainder = (unsigned int) (numerator % host_ctx.sysclk_khz);
+	HOST_advance_time(host_ctx.time_ns + (numerator / host_ctx.sysclk_khz));
+}
+
+/* REGISTER THE FUNCTION CALLED WHEN THE CORE EXITS STOP MODE (CLOCK TREE RESTORE).
+ * @param callback:	Function to call.
+ * @return:			None.
+ */
+void HOST_set_wake_up_callback(HOST_event_callback_t callback) {
+	host_ctx.wake_up_callback = callback;
+}
+
+/* SET AN INTERRUPT PENDING (CALLED BY PERIPHERALS MODELS).
+ * @param it_num:	Interrupt number.
+ * @return:			None.
+ */
+void HOST_set_irq_pending(NVIC_interrupt_t it_num) {
+	if (it_num >= NVIC_IT_LAST) return;
+	host_ctx.irq_pending |= (0b1 << it_num);
+	HOST_update_nvic();
+}
+
+/* CHECK IF AN INTERRUPT MUST BE TAKEN AT THE NEXT INSTRUCTION BOUNDARY.
+ * @param:	None.
+ * @return:	1 if an interrupt is pending, enabled, unmasked and has a sufficient priority, 0 otherwise.
+ */
+unsigned char HOST_is_irq_ready(void) {
+	if (host_ctx.primask != 0) return 0;
+	return (HOST_get_ready_irq() != NVIC_IT_LAST) ? 1 : 0;
+}
+
+/* SERVICE ALL READY INTERRUPTS (EXCEPTION ENTRY AND TAIL-CHAINING).
+ * @param:	None.
+ * @return:	None.
+ */
+void HOST_dispatch_interrupts(void) {
+	// Local variables.
+	unsigned char previous_priority = host_ctx.execution_priority;
+	NVIC_interrupt_t it_num = NVIC_IT_LAST;
+	const HOST_vector_t* vector_table = __Vectors;
+	while (host_ctx.primask == 0) {
+		it_num = HOST_get_ready_irq();
+		if (it_num == NVIC_IT_LAST) break;
+		// Exception entry.
+		host_ctx.irq_pending &= ~(0b1 << it_num);
+		HOST_update_nvic();
+		host_ctx.execution_priority = host_ctx.irq_priority[it_num];
+		if ((host_ctx.scb -> VTOR) != 0) {
+			vector_table = (const HOST_vector_t*) ((unsigned long) (host_ctx.scb -> VTOR));
+		}
+		if (vector_table[HOST_VECTOR_TABLE_IRQ_OFFSET + it_num] == 0) {
+			fprintf(stderr, "HOST: no handler for interrupt %u\n", it_num);
+			abort();
+		}
+		vector_table[HOST_VECTOR_TABLE_IRQ_OFFSET + it_num]();
+		// Exception return.
+		host_ctx.execution_priority = previous_priority;
+	}
+}
+
+/* MASK ALL INTERRUPTS (CPSID I EQUIVALENT).
+ * @param:	None.
+ * @return:	None.
+ */
+void HOST_disable_interrupts(void) {
+	host_ctx.primask = 1;
+}
+
+/* UNMASK INTERRUPTS AND SERVICE PENDING ONES (CPSIE I EQUIVALENT).
+ * @param:	None.
+ * @return:	None.
+ */
+void HOST_enable_interrupts(void) {
+	host_ctx.primask = 0;
+	HOST_dispatch_interrupts();
+}
+
+/* READ INTERRUPT MASK REGISTER (MRS PRIMASK EQUIVALENT).
+ * @param:	None.
+ * @return:	Current PRIMASK value.
+ */
+unsigned int HOST_get_primask(void) {
+	return host_ctx.primask;
+}
+
+/* WRITE INTERRUPT MASK REGISTER (MSR PRIMASK EQUIVALENT).
+ * @param primask:	New PRIMASK value.
+ * @return:			None.
+ */
+void HOST_set_primask(unsigned int primask) {
+	host_ctx.primask = (primask & 0b1);
+	HOST_dispatch_interrupts();
+}
+
+/* WAIT FOR INTERRUPT (WFI EQUIVALENT): VIRTUAL TIME JUMPS TO THE NEXT EVENT.
+ * @param:	None.
+ * @return:	None.
+ * Note: as on the MCU, a pending interrupt wakes the core up while interrupts are masked but it is serviced after unmasking.
+ */
+void HOST_wait_for_interrupt(void) {
+	// Local variables.
+	unsigned char stop_mode = (((host_ctx.scb -> SCR) & (0b1 << 2)) != 0) ? 1 : 0; // SLEEPDEEP='1'.
+	HOST_event_t* event = 0;
+	unsigned long long next_time_ns = 0;
+	unsigned long long timeout_ns = 0;
+	unsigned long long start_time_ns = host_ctx.time_ns;
+	while (HOST_get_ready_irq() == NVIC_IT_LAST) {
+		event = HOST_get_next_event();
+		next_time_ns = (event != 0) ? (event -> deadline_ns) : HOST_TIME_INFINITE;
+		if (host_ctx.rx_eof != 0) {
+			// End of simulation.
+			if ((host_ctx.rx_eof_time_ns + (HOST_EOF_EXIT_DELAY_MS * 1000000ULL)) < next_time_ns) {
+				exit(EXIT_SUCCESS);
+			}
+		}
+		else if ((host_ctx.rx_enabled != 0) && (host_ctx.rx_event.armed == 0)) {
+			// Input is idle: wait for new data before jumping to the next event.
+			// Piped input is always consumed before virtual time advances (until end of file), so that runs are reproducible.
+			timeout_ns = HOST_TIME_INFINITE;
+			if ((event != 0) && (host_ctx.realtime != 0)) {
+				timeout_ns = (next_time_ns > host_ctx.time_ns) ? (next_time_ns - host_ctx.time_ns) : 0;
+			}
+			if (HOST_wait_for_input(timeout_ns) != 0) {
+				HOST_start_event(&host_ctx.rx_event, 0, &HOST_rx_event_callback);
+				next_time_ns = host_ctx.time_ns;
+			}
+		}
+		if (next_time_ns != HOST_TIME_INFINITE) {
+			HOST_advance_time(next_time_ns);
+		}
+		else if (host_ctx.rx_enabled == 0) {
+			// No event nor input can wake-up the core.
+			fprintf(stderr, "HOST: wait for interrupt without wake-up source at %llu ms\n", (host_ctx.time_ns / 1000000));
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (stop_mode == 0) {
+		// Core clock is running in sleep mode.
+		host_ctx.cycle_count += (((host_ctx.time_ns - start_time_ns) * host_ctx.sysclk_khz) / 1000000);
+	}
+	else if (host_ctx.wake_up_callback != 0) {
+		// Clock tree is reconfigured by hardware when exiting stop mode.
+		host_ctx.wake_up_callback();
+	}
+	HOST_dispatch_interrupts();
+}
+
+/* ATTACH UART MODEL TO STANDARD INPUT.
+ * @param callback:				Function called for each received byte.
+ * @param byte_duration_us:		Duration of one character on the line.
+ * @return:						None.
+ */
+void HOST_set_rx_callback(HOST_rx_callback_t callback, unsigned int byte_duration_us) {
+	host_ctx.rx_callback = callback;
+	host_ctx.rx_byte_duration_us = byte_duration_us;
+}
+
+/* ENABLE OR DISABLE STANDARD INPUT READING.
+ * @param enable:	Enable reading if non zero, disable otherwise.
+ * @return:			None.
+ * Note: input is not consumed while disabled, the host behaves as a master waiting for the response before sending the next command.
+ */
+void HOST_set_rx_enable(unsigned char enable) {
+	host_ctx.rx_enabled = enable;
+	if (enable == 0) {
+		HOST_stop_event(&host_ctx.rx_event);
+	}
+}
+
+#endif /* HOST */
@@ -0,0 +1,138 @@
+/*
+ * iwdg_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "bus.h"
+#include "host.h"
+#include "iwdg_reg.h"
+#include "rcc.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** IWDG MODEL local macros ***/
+
+#define IWDG_MODEL_KEY_START		0x0000CCCC
+#define IWDG_MODEL_KEY_RELOAD		0x0000AAAA
+#define IWDG_MODEL_KEY_ACCESS		0x00005555
+#define IWDG_MODEL_RLR_RESET		0x00000FFF
+
+/*** IWDG MODEL local structures ***/
+
+typedef struct {
+	IWDG_base_address_t* iwdg;
+	unsigned char access_enabled;
+	unsigned char running;
+	// Counter state when the prescaler was last changed or the counter reloaded.
+	unsigned long long reference_ns;
+	unsigned long long reference_ticks;
+	HOST_event_t timeout_event;
+} IWDG_MODEL_context_t;
+
+/*** IWDG MODEL local global variables ***/
+
+static IWDG_MODEL_context_t iwdg_model_ctx;
+
+/*** IWDG MODEL local functions ***/
+
+/* GET WATCHDOG COUNTER CLOCK PERIOD.
+ * @param pr:	Prescaler register value.
+ * @return:		Period in ns x LSI frequency (exact).
+ */
+static unsigned long long IWDG_MODEL_get_period(unsigned int pr) {
+	// Prescaler is 4 * 2^PR, saturated at 256.
+	pr &= 0b111;
+	if (pr > 6) pr = 6;
+	return ((4000000000ULL) << pr);
+}
+
+/* GET NUMBER OF WATCHDOG CLOCK TICKS ELAPSED SINCE LAST RELOAD.
+ * @param pr:	Prescaler register value used since reference.
+ * @return:		Number of ticks.
+ */
+static unsigned long long IWDG_MODEL_get_ticks(unsigned int pr) {
+	return (iwdg_model_ctx.reference_ticks + (((HOST_get_time_ns() - iwdg_model_ctx.reference_ns) * RCC_LSI_FREQUENCY_HZ) / IWDG_MODEL_get_period(pr)));
+}
+
+/* WATCHDOG COUNTER REACHED 0.
+ * @param:	None.
+ * @return:	None.
+ */
+static void IWDG_MODEL_timeout_event_callback(void) {
+	fprintf(stderr, "HOST: independent watchdog reset at %llu ms\n", (HOST_get_time_ns() / 1000000));
+	exit(EXIT_FAILURE);
+}
+
+/* PROGRAM WATCHDOG EXPIRY FROM CURRENT STATE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void IWDG_MODEL_schedule(void) {
+	// Local variables.
+	unsigned long long reload_ticks = (((iwdg_model_ctx.iwdg -> RLR) & 0x0FFF) + 1ULL);
+	unsigned long long remaining_ticks = 0;
+	if (iwdg_model_ctx.running == 0) return;
+	remaining_ticks = (iwdg_model_ctx.reference_ticks < reload_ticks) ? (reload_ticks - iwdg_model_ctx.reference_ticks) : 0;
+	HOST_start_event_at(&iwdg_model_ctx.timeout_event, (iwdg_model_ctx.reference_ns + ((remaining_ticks * IWDG_MODEL_get_period(iwdg_model_ctx.iwdg -> PR)) / RCC_LSI_FREQUENCY_HZ)), &IWDG_MODEL_timeout_event_callback);
+}
+
+/* IWDG REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void IWDG_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int key = 0;
+	switch (offset) {
+	case offsetof(IWDG_base_address_t, KR):
+		key = ((iwdg_model_ctx.iwdg -> KR) & 0xFFFF);
+		iwdg_model_ctx.iwdg -> KR = 0;
+		// Any key write protects registers again.
+		iwdg_model_ctx.access_enabled = (key == IWDG_MODEL_KEY_ACCESS) ? 1 : 0;
+		if ((key == IWDG_MODEL_KEY_START) || ((key == IWDG_MODEL_KEY_RELOAD) && (iwdg_model_ctx.running != 0))) {
+			iwdg_model_ctx.running = 1;
+			iwdg_model_ctx.reference_ns = HOST_get_time_ns();
+			iwdg_model_ctx.reference_ticks = 0;
+			IWDG_MODEL_schedule();
+		}
+		break;
+	case offsetof(IWDG_base_address_t, PR):
+	case offsetof(IWDG_base_address_t, RLR):
+		if (iwdg_model_ctx.access_enabled == 0) {
+			*((unsigned int*) (((unsigned char*) iwdg_model_ctx.iwdg) + offset)) = previous_value;
+			break;
+		}
+		if ((offset == offsetof(IWDG_base_address_t, PR)) && (iwdg_model_ctx.running != 0)) {
+			// Counter continues at the new prescaler.
+			iwdg_model_ctx.reference_ticks = IWDG_MODEL_get_ticks(previous_value);
+			iwdg_model_ctx.reference_ns = HOST_get_time_ns();
+		}
+		IWDG_MODEL_schedule();
+		break;
+	case offsetof(IWDG_base_address_t, SR):
+		// Read-only (registers are updated immediately).
+		iwdg_model_ctx.iwdg -> SR = previous_value;
+		break;
+	default:
+		break;
+	}
+}
+
+/* INIT IWDG MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) IWDG_MODEL_init(void) {
+	// Reset values.
+	iwdg_model_ctx.iwdg = BUS_map_peripheral((unsigned long) IWDG, sizeof(IWDG_base_address_t), 0, &IWDG_MODEL_write_callback);
+	iwdg_model_ctx.iwdg -> RLR = IWDG_MODEL_RLR_RESET;
+	iwdg_model_ctx.iwdg -> WINR = IWDG_MODEL_RLR_RESET;
+}
+
+#endif /* HOST */
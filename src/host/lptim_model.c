@@ -0,0 +1,239 @@
+/*
+ * lptim_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "bus.h"
+#include "host.h"
+#include "lptim_reg.h"
+#include "nvic.h"
+#include "rcc.h"
+#include <stddef.h>
+
+/*** LPTIM MODEL local macros ***/
+
+#define LPTIM_MODEL_ARR_RESET			0x00000001
+#define LPTIM_MODEL_REGISTER_UPDATE_US	92 // 3 LSE periods between APB write and LPTIM clock domain.
+#define LPTIM_MODEL_TICK_NONE			0xFFFFFFFFFFFFFFFFULL
+
+/*** LPTIM MODEL callbacks declaration ***/
+
+static void LPTIM_MODEL_match_event_callback(void);
+
+/*** LPTIM MODEL local structures ***/
+
+typedef struct {
+	LPTIM_base_address_t* lptim;
+	// Counter is computed from a reference tick (virtual time and value).
+	unsigned char running;
+	unsigned long long reference_ns;
+	unsigned int reference_cnt;
+	HOST_event_t match_event;
+	HOST_event_t cmp_ok_event;
+	HOST_event_t arr_ok_event;
+} LPTIM_MODEL_context_t;
+
+/*** LPTIM MODEL local global variables ***/
+
+static LPTIM_MODEL_context_t lptim_model_ctx;
+
+/*** LPTIM MODEL local functions ***/
+
+/* GET COUNTER CLOCK PERIOD.
+ * @param:	None.
+ * @return:	Tick period in ns x 32768 (exact).
+ */
+static unsigned long long LPTIM_MODEL_get_period(void) {
+	return (1000000000ULL << (((lptim_model_ctx.lptim -> CFGR) >> 9) & 0b111));
+}
+
+/* GET NUMBER OF TICKS SINCE REFERENCE.
+ * @param time_ns:	Virtual time.
+ * @return:			Number of ticks.
+ */
+static unsigned long long LPTIM_MODEL_get_ticks(unsigned long long time_ns) {
+	return (((time_ns - lptim_model_ctx.reference_ns) * RCC_LSE_FREQUENCY_HZ) / LPTIM_MODEL_get_period());
+}
+
+/* GET VIRTUAL TIME OF A TICK.
+ * @param ticks:	Number of ticks since reference.
+ * @return:			Virtual time of the tick.
+ */
+static unsigned long long LPTIM_MODEL_get_tick_time(unsigned long long ticks) {
+	return (lptim_model_ctx.reference_ns + (((ticks * LPTIM_MODEL_get_period()) + (RCC_LSE_FREQUENCY_HZ - 1)) / RCC_LSE_FREQUENCY_HZ));
+}
+
+/* GET COUNTER VALUE.
+ * @param ticks:	Number of ticks since reference.
+ * @return:			Counter value.
+ */
+static unsigned int LPTIM_MODEL_get_cnt(unsigned long long ticks) {
+	return (unsigned int) ((lptim_model_ctx.reference_cnt + ticks) % (((lptim_model_ctx.lptim -> ARR) & 0xFFFF) + 1ULL));
+}
+
+/* GET THE NEXT TICK WHERE THE COUNTER REACHES A VALUE.
+ * @param ticks:	Current number of ticks since reference.
+ * @param value:	Counter value.
+ * @return:			Number of ticks since reference, LPTIM_MODEL_TICK_NONE if the value is never reached.
+ */
+static unsigned long long LPTIM_MODEL_get_next_match(unsigned long long ticks, unsigned int value) {
+	// Local variables.
+	unsigned int modulo = (((lptim_model_ctx.lptim -> ARR) & 0xFFFF) + 1);
+	unsigned int cnt = LPTIM_MODEL_get_cnt(ticks);
+	unsigned int delta = 0;
+	if (value >= modulo) return LPTIM_MODEL_TICK_NONE;
+	delta = ((value + modulo - cnt) % modulo);
+	return (ticks + ((delta == 0) ? modulo : delta));
+}
+
+/* UPDATE LPTIM INTERRUPT LINE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPTIM_MODEL_update_irq(void) {
+	if (((lptim_model_ctx.lptim -> ISR) & (lptim_model_ctx.lptim -> IER) & 0x7F) != 0) {
+		HOST_set_irq_pending(NVIC_IT_LPTIM1);
+	}
+}
+
+/* PROGRAM NEXT COMPARE OR AUTORELOAD MATCH.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPTIM_MODEL_schedule(void) {
+	// Local variables.
+	unsigned long long ticks = 0;
+	unsigned long long arr_ticks = 0;
+	unsigned long long cmp_ticks = 0;
+	if (lptim_model_ctx.running == 0) {
+		HOST_stop_event(&lptim_model_ctx.match_event);
+		return;
+	}
+	ticks = LPTIM_MODEL_get_ticks(HOST_get_time_ns());
+	arr_ticks = LPTIM_MODEL_get_next_match(ticks, ((lptim_model_ctx.lptim -> ARR) & 0xFFFF));
+	cmp_ticks = LPTIM_MODEL_get_next_match(ticks, ((lptim_model_ctx.lptim -> CMP) & 0xFFFF));
+	HOST_start_event_at(&lptim_model_ctx.match_event, LPTIM_MODEL_get_tick_time((cmp_ticks < arr_ticks) ? cmp_ticks : arr_ticks), &LPTIM_MODEL_match_event_callback);
+}
+
+/* COMPARE OR AUTORELOAD MATCH.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPTIM_MODEL_match_event_callback(void) {
+	// Local variables.
+	unsigned long long ticks = LPTIM_MODEL_get_ticks(HOST_get_time_ns());
+	unsigned int cnt = LPTIM_MODEL_get_cnt(ticks);
+	// Flags are set when the counter reaches the register value (the counter goes back to 0 on the next tick after ARR).
+	if (cnt == ((lptim_model_ctx.lptim -> CMP) & 0xFFFF)) {
+		lptim_model_ctx.lptim -> ISR |= (0b1 << 0); // CMPM='1'.
+	}
+	if (cnt == ((lptim_model_ctx.lptim -> ARR) & 0xFFFF)) {
+		lptim_model_ctx.lptim -> ISR |= (0b1 << 1); // ARRM='1'.
+		// Move reference to keep computations in range.
+		lptim_model_ctx.reference_ns = LPTIM_MODEL_get_tick_time(ticks);
+		lptim_model_ctx.reference_cnt = cnt;
+	}
+	LPTIM_MODEL_schedule();
+	LPTIM_MODEL_update_irq();
+}
+
+/* COMPARE REGISTER UPDATE END.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPTIM_MODEL_cmp_ok_event_callback(void) {
+	lptim_model_ctx.lptim -> ISR |= (0b1 << 3); // CMPOK='1'.
+	LPTIM_MODEL_update_irq();
+}
+
+/* AUTORELOAD REGISTER UPDATE END.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPTIM_MODEL_arr_ok_event_callback(void) {
+	lptim_model_ctx.lptim -> ISR |= (0b1 << 4); // ARROK='1'.
+	LPTIM_MODEL_update_irq();
+}
+
+/* LPTIM REGISTERS READ CALLBACK.
+ * @param offset:	Register offset.
+ * @return:			None.
+ */
+static void LPTIM_MODEL_read_callback(unsigned int offset) {
+	if (offset != offsetof(LPTIM_base_address_t, CNT)) return;
+	lptim_model_ctx.lptim -> CNT = (lptim_model_ctx.running != 0) ? LPTIM_MODEL_get_cnt(LPTIM_MODEL_get_ticks(HOST_get_time_ns())) : 0;
+}
+
+/* LPTIM REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void LPTIM_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned long long ticks = 0;
+	unsigned int arr = 0;
+	switch (offset) {
+	case offsetof(LPTIM_base_address_t, ISR):
+	case offsetof(LPTIM_base_address_t, CNT):
+		// Read-only.
+		*((unsigned int*) (((unsigned char*) lptim_model_ctx.lptim) + offset)) = previous_value;
+		break;
+	case offsetof(LPTIM_base_address_t, ICR):
+		lptim_model_ctx.lptim -> ISR &= ~(lptim_model_ctx.lptim -> ICR);
+		lptim_model_ctx.lptim -> ICR = 0;
+		break;
+	case offsetof(LPTIM_base_address_t, CR):
+		if (((lptim_model_ctx.lptim -> CR) & (0b1 << 0)) == 0) {
+			// Disabling the timer stops and resets the counter.
+			lptim_model_ctx.running = 0;
+			HOST_stop_event(&lptim_model_ctx.cmp_ok_event);
+			HOST_stop_event(&lptim_model_ctx.arr_ok_event);
+		}
+		else if (((lptim_model_ctx.lptim -> CR) & (0b11 << 1)) != 0) {
+			// Counter starts from 0 (single and continuous modes are not distinguished).
+			lptim_model_ctx.running = 1;
+			lptim_model_ctx.reference_ns = HOST_get_time_ns();
+			lptim_model_ctx.reference_cnt = 0;
+		}
+		lptim_model_ctx.lptim -> CR &= ~(0b11 << 1);
+		LPTIM_MODEL_schedule();
+		break;
+	case offsetof(LPTIM_base_address_t, CMP):
+		HOST_start_event(&lptim_model_ctx.cmp_ok_event, LPTIM_MODEL_REGISTER_UPDATE_US, &LPTIM_MODEL_cmp_ok_event_callback);
+		LPTIM_MODEL_schedule();
+		break;
+	case offsetof(LPTIM_base_address_t, ARR):
+		// Counter value is kept when the period changes.
+		if (lptim_model_ctx.running != 0) {
+			arr = (lptim_model_ctx.lptim -> ARR);
+			lptim_model_ctx.lptim -> ARR = previous_value;
+			ticks = LPTIM_MODEL_get_ticks(HOST_get_time_ns());
+			lptim_model_ctx.reference_cnt = LPTIM_MODEL_get_cnt(ticks);
+			lptim_model_ctx.reference_ns = LPTIM_MODEL_get_tick_time(ticks);
+			lptim_model_ctx.lptim -> ARR = arr;
+		}
+		HOST_start_event(&lptim_model_ctx.arr_ok_event, LPTIM_MODEL_REGISTER_UPDATE_US, &LPTIM_MODEL_arr_ok_event_callback);
+		LPTIM_MODEL_schedule();
+		break;
+	default:
+		break;
+	}
+	LPTIM_MODEL_update_irq();
+}
+
+/* INIT LPTIM MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) LPTIM_MODEL_init(void) {
+	// Reset values.
+	lptim_model_ctx.lptim = BUS_map_peripheral((unsigned long) LPTIM1, sizeof(LPTIM_base_address_t), &LPTIM_MODEL_read_callback, &LPTIM_MODEL_write_callback);
+	lptim_model_ctx.lptim -> ARR = LPTIM_MODEL_ARR_RESET;
+}
+
+#endif /* HOST */
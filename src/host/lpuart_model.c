@@ -0,0 +1,153 @@
+/*
+ * lpuart_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "bus.h"
+#include "host.h"
+#include "lpuart_reg.h"
+#include "nvic.h"
+#include "rcc.h"
+#include <stddef.h>
+#include <stdio.h>
+
+/*** LPUART MODEL local macros ***/
+
+#define LPUART_MODEL_ISR_RESET				((0b1 << 7) | (0b1 << 6)) // TXE and TC.
+#define LPUART_MODEL_ISR_IT_MASK			((0b1 << 7) | (0b1 << 6) | (0b1 << 5)) // TXE, TC and RXNE (same position in CR1).
+#define LPUART_MODEL_BYTE_DURATION_US		1041 // 9600 bauds (start bit, 8 data bits and stop bit).
+#define LPUART_MODEL_BITS_PER_BYTE			10
+
+/*** LPUART MODEL local structures ***/
+
+typedef struct {
+	LPUART_base_address_t* lpuart;
+	unsigned int byte_duration_us;
+	HOST_event_t tx_event;
+} LPUART_MODEL_context_t;
+
+/*** LPUART MODEL local global variables ***/
+
+static LPUART_MODEL_context_t lpuart_model_ctx;
+
+/*** LPUART MODEL local functions ***/
+
+/* UPDATE LPUART INTERRUPT LINE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPUART_MODEL_update_irq(void) {
+	// Local variables.
+	unsigned int isr = (lpuart_model_ctx.lpuart -> ISR);
+	unsigned int cr1 = (lpuart_model_ctx.lpuart -> CR1);
+	// Overrun error shares the reception interrupt enable.
+	if (((isr & cr1 & LPUART_MODEL_ISR_IT_MASK) != 0) || (((isr & (0b1 << 3)) != 0) && ((cr1 & (0b1 << 5)) != 0))) {
+		HOST_set_irq_pending(NVIC_IT_LPUART1);
+	}
+}
+
+/* END OF CHARACTER TRANSMISSION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void LPUART_MODEL_tx_event_callback(void) {
+	lpuart_model_ctx.lpuart -> ISR |= (0b11 << 6); // TXE='1' and TC='1'.
+	LPUART_MODEL_update_irq();
+}
+
+/* RECEPTION OF A BYTE FROM STANDARD INPUT.
+ * @param rx_byte:	Incoming byte.
+ * @return:			None.
+ */
+static void LPUART_MODEL_rx_callback(unsigned char rx_byte) {
+	if (((lpuart_model_ctx.lpuart -> ISR) & (0b1 << 5)) != 0) {
+		// Previous byte was not read: new one is lost.
+		lpuart_model_ctx.lpuart -> ISR |= (0b1 << 3); // ORE='1'.
+	}
+	else {
+		lpuart_model_ctx.lpuart -> RDR = rx_byte;
+		lpuart_model_ctx.lpuart -> ISR |= (0b1 << 5); // RXNE='1'.
+	}
+	LPUART_MODEL_update_irq();
+}
+
+/* LPUART REGISTERS READ CALLBACK.
+ * @param offset:	Register offset.
+ * @return:			None.
+ */
+static void LPUART_MODEL_read_callback(unsigned int offset) {
+	// Reading the data register clears the reception flag.
+	if (offset != offsetof(LPUART_base_address_t, RDR)) return;
+	lpuart_model_ctx.lpuart -> ISR &= ~(0b1 << 5);
+}
+
+/* LPUART REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void LPUART_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int cr1 = 0;
+	unsigned int brr = 0;
+	switch (offset) {
+	case offsetof(LPUART_base_address_t, CR1):
+		// Standard input is read only when the receiver is enabled.
+		cr1 = (lpuart_model_ctx.lpuart -> CR1);
+		HOST_set_rx_enable((((cr1 & (0b1 << 0)) != 0) && ((cr1 & (0b1 << 2)) != 0)) ? 1 : 0);
+		break;
+	case offsetof(LPUART_base_address_t, BRR):
+		// Baud rate = (256 * fCK) / BRR.
+		brr = ((lpuart_model_ctx.lpuart -> BRR) & 0x000FFFFF);
+		if (brr != 0) {
+			lpuart_model_ctx.byte_duration_us = (unsigned int) ((LPUART_MODEL_BITS_PER_BYTE * 1000000ULL * brr) / (256ULL * RCC_LSE_FREQUENCY_HZ));
+			HOST_set_rx_callback(&LPUART_MODEL_rx_callback, lpuart_model_ctx.byte_duration_us);
+		}
+		break;
+	case offsetof(LPUART_base_address_t, RQR):
+		if (((lpuart_model_ctx.lpuart -> RQR) & (0b1 << 3)) != 0) {
+			lpuart_model_ctx.lpuart -> ISR &= ~(0b1 << 5); // RXFRQ: RXNE='0'.
+		}
+		lpuart_model_ctx.lpuart -> RQR = 0;
+		break;
+	case offsetof(LPUART_base_address_t, ICR):
+		lpuart_model_ctx.lpuart -> ISR &= ~(lpuart_model_ctx.lpuart -> ICR);
+		lpuart_model_ctx.lpuart -> ICR = 0;
+		break;
+	case offsetof(LPUART_base_address_t, ISR):
+	case offsetof(LPUART_base_address_t, RDR):
+		// Read-only.
+		*((unsigned int*) (((unsigned char*) lpuart_model_ctx.lpuart) + offset)) = previous_value;
+		break;
+	case offsetof(LPUART_base_address_t, TDR):
+		// Transmitted characters are printed on standard output.
+		if (((lpuart_model_ctx.lpuart -> CR1) & ((0b1 << 3) | (0b1 << 0))) == ((0b1 << 3) | (0b1 << 0))) {
+			putchar((int) ((lpuart_model_ctx.lpuart -> TDR) & 0xFF));
+			lpuart_model_ctx.lpuart -> ISR &= ~(0b11 << 6); // TXE='0' and TC='0'.
+			HOST_start_event(&lpuart_model_ctx.tx_event, lpuart_model_ctx.byte_duration_us, &LPUART_MODEL_tx_event_callback);
+		}
+		break;
+	default:
+		break;
+	}
+	LPUART_MODEL_update_irq();
+}
+
+/* INIT LPUART MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) LPUART_MODEL_init(void) {
+	// Reset values.
+	lpuart_model_ctx.lpuart = BUS_map_peripheral((unsigned long) LPUART1, sizeof(LPUART_base_address_t), &LPUART_MODEL_read_callback, &LPUART_MODEL_write_callback);
+	lpuart_model_ctx.lpuart -> ISR = LPUART_MODEL_ISR_RESET;
+	lpuart_model_ctx.byte_duration_us = LPUART_MODEL_BYTE_DURATION_US;
+	// Attach standard input.
+	HOST_set_rx_callback(&LPUART_MODEL_rx_callback, lpuart_model_ctx.byte_duration_us);
+}
+
+#endif /* HOST */
@@ -0,0 +1,71 @@
+/*
+ * mem.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "mem.h"
+
+/*** MEM local macros ***/
+
+#define MEM_STACK_MARGIN_WORDS			16 // Not painted below the painting function frame.
+#define MEM_STACK_PAINT_LENGTH_WORDS	1024 // No stack limit symbol on host: fixed window below the painting function frame.
+
+/*** MEM local global variables ***/
+
+static unsigned int* mem_stack_reference = 0; // Frame of the last painting function.
+static unsigned int* mem_stack_paint_start = 0;
+
+/*** MEM functions ***/
+
+/* GET STACK DEPTH REACHED SINCE LAST PAINTING.
+ * @param:	None.
+ * @return:	Number of bytes used from the last painting function frame.
+ */
+unsigned int MEM_get_stack_used(void) {
+	// Local variables.
+	volatile unsigned int* stack_word = mem_stack_paint_start;
+	// Search first word overwritten since stack painting (stack grows downwards).
+	while ((stack_word < mem_stack_reference) && ((*stack_word) == MEM_STACK_PATTERN)) {
+		stack_word++;
+	}
+	return (unsigned int) ((mem_stack_reference - stack_word) * sizeof(unsigned int));
+}
+
+/* GET STATIC MEMORY USAGE AND STACK HIGH-WATER MARK.
+ * @param statistics:	Pointer to the structure that will contain the sizes in bytes.
+ * @return:				None.
+ */
+void MEM_get_statistics(MEM_statistics_t* statistics) {
+	// Target linker symbols do not exist in the host executable.
+	statistics -> flash_bytes = 0;
+	statistics -> ramfunc_bytes = 0;
+	statistics -> data_bytes = 0;
+	statistics -> bss_bytes = 0;
+	statistics -> heap_bytes = 0;
+	statistics -> stack_bytes = 0;
+	statistics -> stack_used_bytes = 0;
+}
+
+/* REPAINT UNUSED STACK TO MEASURE THE DEPTH OF A CODE SECTION.
+ * @param:	None.
+ * @return:	None.
+ */
+void __attribute__((noinline)) MEM_paint_stack(void) {
+	// Local variables.
+	volatile unsigned int* stack_word = 0;
+	unsigned int* paint_end = 0;
+	mem_stack_reference = (unsigned int*) __builtin_frame_address(0);
+	paint_end = (mem_stack_reference - MEM_STACK_MARGIN_WORDS);
+	mem_stack_paint_start = (paint_end - MEM_STACK_PAINT_LENGTH_WORDS);
+	stack_word = mem_stack_paint_start;
+	while (stack_word < paint_end) {
+		(*stack_word) = MEM_STACK_PATTERN;
+		stack_word++;
+	}
+}
+
+#endif /* HOST */
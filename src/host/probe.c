@@ -0,0 +1,73 @@
+/*
+ * probe.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#if (defined HOST) && (defined PROBE)
+
+#include "probe.h"
+
+#include "gpio_model.h"
+#include "host.h"
+#include "mapping.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** PROBE local macros ***/
+
+#define PROBE_LOG_FILE_VARIABLE	"HOST_PROBE_LOG_FILE"
+
+/*** PROBE local structures ***/
+
+typedef struct {
+	FILE* log_file;
+} PROBE_context_t;
+
+/*** PROBE local global variables ***/
+
+static PROBE_context_t probe_ctx;
+
+/*** PROBE local functions ***/
+
+/* LOG A TEST POINT EDGE.
+ * @param tp:		Test point number (1 to 3).
+ * @param state:	New test point level.
+ * @return:			None.
+ */
+static void PROBE_log(unsigned char tp, unsigned char state) {
+	if (probe_ctx.log_file == 0) return;
+	fprintf(probe_ctx.log_file, "%llu TP%u %u\n", HOST_get_time_us(), tp, state);
+	fflush(probe_ctx.log_file);
+}
+
+/* TEST POINTS PINS WRITE (GPIO CALLBACKS).
+ * @param state:	New pin level.
+ * @return:			None.
+ */
+static void PROBE_tp1_callback(unsigned char state) {
+	PROBE_log(1, state);
+}
+static void PROBE_tp2_callback(unsigned char state) {
+	PROBE_log(2, state);
+}
+static void PROBE_tp3_callback(unsigned char state) {
+	PROBE_log(3, state);
+}
+
+/* ATTACH LOG FILE TO TEST POINTS BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor)) PROBE_init(void) {
+	// Local variables.
+	char* file_name = getenv(PROBE_LOG_FILE_VARIABLE);
+	probe_ctx.log_file = (file_name != 0) ? fopen(file_name, "w") : 0;
+	// Edges are reported by the GPIO model when the driven level changes.
+	GPIO_MODEL_set_callback(&GPIO_TP1, &PROBE_tp1_callback);
+	GPIO_MODEL_set_callback(&GPIO_TP2, &PROBE_tp2_callback);
+	GPIO_MODEL_set_callback(&GPIO_TP3, &PROBE_tp3_callback);
+}
+
+#endif /* HOST && PROBE */
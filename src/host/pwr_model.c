@@ -0,0 +1,80 @@
+/*
+ * pwr_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "bus.h"
+#include "host.h"
+#include "pwr_reg.h"
+#include <stddef.h>
+
+/*** PWR MODEL local macros ***/
+
+#define PWR_MODEL_CR_RESET				0x00001000 // Voltage range 2.
+#define PWR_MODEL_CSR_RESET				0x00000008 // Internal voltage reference ready.
+#define PWR_MODEL_CSR_WRITABLE_MASK		0x00000700 // Wake-up pins enable bits.
+#define PWR_MODEL_VOS_SETTLING_US		10
+
+/*** PWR MODEL local structures ***/
+
+typedef struct {
+	PWR_base_address_t* pwr;
+	HOST_event_t vos_event;
+} PWR_MODEL_context_t;
+
+/*** PWR MODEL local global variables ***/
+
+static PWR_MODEL_context_t pwr_model_ctx;
+
+/*** PWR MODEL local functions ***/
+
+/* REGULATOR VOLTAGE SETTLING END.
+ * @param:	None.
+ * @return:	None.
+ */
+static void PWR_MODEL_vos_event_callback(void) {
+	pwr_model_ctx.pwr -> CSR &= ~(0b1 << 4); // VOSF='0'.
+}
+
+/* PWR REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void PWR_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	switch (offset) {
+	case offsetof(PWR_base_address_t, CR):
+		// Flags clear bits always read 0.
+		if (((pwr_model_ctx.pwr -> CR) & (0b1 << 2)) != 0) pwr_model_ctx.pwr -> CSR &= ~(0b1 << 0); // CWUF.
+		if (((pwr_model_ctx.pwr -> CR) & (0b1 << 3)) != 0) pwr_model_ctx.pwr -> CSR &= ~(0b1 << 1); // CSBF.
+		pwr_model_ctx.pwr -> CR &= ~(0b11 << 2);
+		// Regulator output changes when the voltage range is modified.
+		if ((((pwr_model_ctx.pwr -> CR) ^ previous_value) & (0b11 << 11)) != 0) {
+			pwr_model_ctx.pwr -> CSR |= (0b1 << 4); // VOSF='1'.
+			HOST_start_event(&pwr_model_ctx.vos_event, PWR_MODEL_VOS_SETTLING_US, &PWR_MODEL_vos_event_callback);
+		}
+		break;
+	case offsetof(PWR_base_address_t, CSR):
+		pwr_model_ctx.pwr -> CSR = (previous_value & ~PWR_MODEL_CSR_WRITABLE_MASK) | ((pwr_model_ctx.pwr -> CSR) & PWR_MODEL_CSR_WRITABLE_MASK);
+		break;
+	default:
+		break;
+	}
+}
+
+/* INIT PWR MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) PWR_MODEL_init(void) {
+	// Reset values.
+	pwr_model_ctx.pwr = BUS_map_peripheral((unsigned long) PWR, sizeof(PWR_base_address_t), 0, &PWR_MODEL_write_callback);
+	pwr_model_ctx.pwr -> CR = PWR_MODEL_CR_RESET;
+	pwr_model_ctx.pwr -> CSR = PWR_MODEL_CSR_RESET;
+}
+
+#endif /* HOST */
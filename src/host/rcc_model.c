@@ -0,0 +1,245 @@
+/*
+ * rcc_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "bus.h"
+#include "host.h"
+#include "nvic.h"
+#include "rcc.h"
+#include "rcc_reg.h"
+#include <stddef.h>
+
+/*** RCC MODEL local macros ***/
+
+#define RCC_MODEL_CR_RESET				0x00000300 // MSI on and ready.
+#define RCC_MODEL_ICSCR_RESET			(0b101 << 13) // MSI range 5.
+#define RCC_MODEL_CSR_RESET				0x0C000000 // Power-on and pin reset flags.
+#define RCC_MODEL_CR_READ_ONLY_MASK		((0b1 << 2) | (0b1 << 4) | (0b1 << 9) | (0b1 << 17) | (0b1 << 25))
+#define RCC_MODEL_CSR_READ_ONLY_MASK	((0b1 << 1) | (0b1 << 9) | (0b1 << 14) | 0xFF000000)
+#define RCC_MODEL_CSR_RTC_DOMAIN_MASK	0x0007FF00 // LSE and RTC control bits cleared by RTCRST.
+
+#define RCC_MODEL_HSI_STARTUP_US		4
+#define RCC_MODEL_LSI_STARTUP_US		100
+#define RCC_MODEL_LSE_STARTUP_US		100000
+
+/*** RCC MODEL local structures ***/
+
+typedef struct {
+	RCC_base_address_t* rcc;
+	HOST_event_t hsi_event;
+	HOST_event_t lsi_event;
+	HOST_event_t lse_event;
+} RCC_MODEL_context_t;
+
+/*** RCC MODEL local global variables ***/
+
+static RCC_MODEL_context_t rcc_model_ctx;
+
+/*** RCC MODEL local functions ***/
+
+/* UPDATE CORE CLOCK FREQUENCY FROM SYSTEM CLOCK STATUS.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RCC_MODEL_update_sysclk(void) {
+	// Local variables.
+	unsigned int msi_range = (((rcc_model_ctx.rcc -> ICSCR) >> 13) & 0b111);
+	unsigned int sysclk_khz = 0;
+	switch (((rcc_model_ctx.rcc -> CFGR) >> 2) & 0b11) {
+	case 0b00:
+		sysclk_khz = ((65536 << msi_range) / 1000);
+		break;
+	default:
+		// HSE and PLL are not used.
+		sysclk_khz = RCC_HSI_FREQUENCY_KHZ;
+		break;
+	}
+	if (sysclk_khz != HOST_get_sysclk_khz()) {
+		HOST_set_sysclk_khz(sysclk_khz);
+	}
+}
+
+/* UPDATE RCC INTERRUPT LINE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RCC_MODEL_update_irq(void) {
+	if (((rcc_model_ctx.rcc -> CIFR) & (rcc_model_ctx.rcc -> CIER) & 0xFF) != 0) {
+		HOST_set_irq_pending(NVIC_IT_RCC_CRS);
+	}
+}
+
+/* HSI16 STARTUP END.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RCC_MODEL_hsi_event_callback(void) {
+	if (((rcc_model_ctx.rcc -> CR) & (0b1 << 0)) == 0) return;
+	rcc_model_ctx.rcc -> CR |= (0b1 << 2); // HSI16RDYF='1'.
+}
+
+/* LSI STARTUP END.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RCC_MODEL_lsi_event_callback(void) {
+	if (((rcc_model_ctx.rcc -> CSR) & (0b1 << 0)) == 0) return;
+	rcc_model_ctx.rcc -> CSR |= (0b1 << 1); // LSIRDY='1'.
+	if (((rcc_model_ctx.rcc -> CIER) & (0b1 << 0)) != 0) {
+		rcc_model_ctx.rcc -> CIFR |= (0b1 << 0); // LSIRDYF='1'.
+	}
+	RCC_MODEL_update_irq();
+}
+
+/* LSE STARTUP END.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RCC_MODEL_lse_event_callback(void) {
+	if (((rcc_model_ctx.rcc -> CSR) & (0b1 << 8)) == 0) return;
+	rcc_model_ctx.rcc -> CSR |= (0b1 << 9); // LSERDY='1'.
+	if (((rcc_model_ctx.rcc -> CIER) & (0b1 << 1)) != 0) {
+		rcc_model_ctx.rcc -> CIFR |= (0b1 << 1); // LSERDYF='1'.
+	}
+	RCC_MODEL_update_irq();
+}
+
+/* CONTROL REGISTER WRITE.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void RCC_MODEL_write_cr(unsigned int previous_value) {
+	// Local variables.
+	unsigned int cr = ((rcc_model_ctx.rcc -> CR) & ~RCC_MODEL_CR_READ_ONLY_MASK) | (previous_value & RCC_MODEL_CR_READ_ONLY_MASK);
+	unsigned int sws = (((rcc_model_ctx.rcc -> CFGR) >> 2) & 0b11);
+	// Oscillator used as system clock cannot be stopped.
+	if (sws == 0b00) cr |= (0b1 << 8);
+	if (sws == 0b01) cr |= (0b1 << 0);
+	// HSI16.
+	if ((cr & (0b1 << 0)) == 0) {
+		cr &= ~(0b1 << 2);
+		HOST_stop_event(&rcc_model_ctx.hsi_event);
+	}
+	else if (((cr & (0b1 << 2)) == 0) && (rcc_model_ctx.hsi_event.armed == 0)) {
+		HOST_start_event(&rcc_model_ctx.hsi_event, RCC_MODEL_HSI_STARTUP_US, &RCC_MODEL_hsi_event_callback);
+	}
+	// MSI is ready immediately.
+	cr &= ~(0b1 << 9);
+	cr |= (((cr >> 8) & 0b1) << 9);
+	rcc_model_ctx.rcc -> CR = cr;
+}
+
+/* CONTROL AND STATUS REGISTER WRITE.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void RCC_MODEL_write_csr(unsigned int previous_value) {
+	// Local variables.
+	unsigned int csr = ((rcc_model_ctx.rcc -> CSR) & ~RCC_MODEL_CSR_READ_ONLY_MASK) | (previous_value & RCC_MODEL_CSR_READ_ONLY_MASK);
+	// Remove reset flags.
+	if ((csr & (0b1 << 23)) != 0) {
+		csr &= ~(0xFF800000);
+	}
+	// RTC domain reset.
+	if ((csr & (0b1 << 19)) != 0) {
+		csr &= ~RCC_MODEL_CSR_RTC_DOMAIN_MASK;
+	}
+	// LSI.
+	if ((csr & (0b1 << 0)) == 0) {
+		csr &= ~(0b1 << 1);
+		HOST_stop_event(&rcc_model_ctx.lsi_event);
+	}
+	else if (((csr & (0b1 << 1)) == 0) && (rcc_model_ctx.lsi_event.armed == 0)) {
+		HOST_start_event(&rcc_model_ctx.lsi_event, RCC_MODEL_LSI_STARTUP_US, &RCC_MODEL_lsi_event_callback);
+	}
+	// LSE.
+	if ((csr & (0b1 << 8)) == 0) {
+		csr &= ~(0b1 << 9);
+		HOST_stop_event(&rcc_model_ctx.lse_event);
+	}
+	else if (((csr & (0b1 << 9)) == 0) && (rcc_model_ctx.lse_event.armed == 0)) {
+		HOST_start_event(&rcc_model_ctx.lse_event, RCC_MODEL_LSE_STARTUP_US, &RCC_MODEL_lse_event_callback);
+	}
+	rcc_model_ctx.rcc -> CSR = csr;
+}
+
+/* RCC REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void RCC_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int sw = 0;
+	switch (offset) {
+	case offsetof(RCC_base_address_t, CR):
+		RCC_MODEL_write_cr(previous_value);
+		break;
+	case offsetof(RCC_base_address_t, ICSCR):
+		RCC_MODEL_update_sysclk();
+		break;
+	case offsetof(RCC_base_address_t, CFGR):
+		// Switch is done immediately if the selected oscillator is ready.
+		sw = ((rcc_model_ctx.rcc -> CFGR) & 0b11);
+		if (((sw == 0b00) && (((rcc_model_ctx.rcc -> CR) & (0b1 << 9)) != 0)) || ((sw == 0b01) && (((rcc_model_ctx.rcc -> CR) & (0b1 << 2)) != 0))) {
+			rcc_model_ctx.rcc -> CFGR = ((rcc_model_ctx.rcc -> CFGR) & ~(0b11 << 2)) | (sw << 2);
+		}
+		else {
+			rcc_model_ctx.rcc -> CFGR = ((rcc_model_ctx.rcc -> CFGR) & ~(0b11 << 2)) | (previous_value & (0b11 << 2));
+		}
+		RCC_MODEL_update_sysclk();
+		break;
+	case offsetof(RCC_base_address_t, CIFR):
+		// Read-only.
+		rcc_model_ctx.rcc -> CIFR = previous_value;
+		break;
+	case offsetof(RCC_base_address_t, CICR):
+		rcc_model_ctx.rcc -> CIFR &= ~(rcc_model_ctx.rcc -> CICR);
+		rcc_model_ctx.rcc -> CICR = 0;
+		break;
+	case offsetof(RCC_base_address_t, CSR):
+		RCC_MODEL_write_csr(previous_value);
+		break;
+	default:
+		break;
+	}
+	RCC_MODEL_update_irq();
+}
+
+/* CLOCK TREE RESTORE WHEN EXITING STOP MODE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RCC_MODEL_wake_up_callback(void) {
+	if (((rcc_model_ctx.rcc -> CFGR) & (0b1 << 15)) != 0) {
+		// STOPWUCK='1': HSI16 oscillator selected as wake-up clock.
+		rcc_model_ctx.rcc -> CR |= ((0b1 << 0) | (0b1 << 2));
+		rcc_model_ctx.rcc -> CFGR = ((rcc_model_ctx.rcc -> CFGR) & ~(0b1111 << 0)) | (0b0101 << 0);
+	}
+	else {
+		rcc_model_ctx.rcc -> CR |= ((0b1 << 8) | (0b1 << 9));
+		rcc_model_ctx.rcc -> CFGR &= ~(0b1111 << 0);
+	}
+	RCC_MODEL_update_sysclk();
+}
+
+/* INIT RCC MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) RCC_MODEL_init(void) {
+	// Reset values.
+	rcc_model_ctx.rcc = BUS_map_peripheral((unsigned long) RCC, sizeof(RCC_base_address_t), 0, &RCC_MODEL_write_callback);
+	rcc_model_ctx.rcc -> CR = RCC_MODEL_CR_RESET;
+	rcc_model_ctx.rcc -> ICSCR = RCC_MODEL_ICSCR_RESET;
+	rcc_model_ctx.rcc -> CSR = RCC_MODEL_CSR_RESET;
+	HOST_set_wake_up_callback(&RCC_MODEL_wake_up_callback);
+	RCC_MODEL_update_sysclk();
+}
+
+#endif /* HOST */
@@ -0,0 +1,328 @@
+/*
+ * rtc_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "bus.h"
+#include "exti_model.h"
+#include "host.h"
+#include "rtc_reg.h"
+#include <stddef.h>
+
+/*** RTC MODEL local macros ***/
+
+#define RTC_MODEL_DR_RESET				0x00002101 // Monday 01/01/2000.
+#define RTC_MODEL_ISR_RESET				0x00000007 // Wake-up timer and alarms configuration allowed.
+#define RTC_MODEL_ISR_FLAGS_MASK		0x00007F20 // RSF, alarms, wake-up, timestamp and tamper flags (rc_w0).
+#define RTC_MODEL_KEY1					0xCA
+#define RTC_MODEL_KEY2					0x53
+#define RTC_MODEL_SECONDS_PER_DAY		86400
+#define RTC_MODEL_NS_PER_SECOND			1000000000ULL
+#define RTC_MODEL_BCD_TO_BINARY(bcd)	((((bcd) >> 4) * 10) + ((bcd) & 0x0F))
+#define RTC_MODEL_BINARY_TO_BCD(value)	((((value) / 10) << 4) | ((value) % 10))
+
+/*** RTC MODEL callbacks declaration ***/
+
+static void RTC_MODEL_alarm_event_callback(void);
+
+/*** RTC MODEL local structures ***/
+
+typedef struct {
+	RTC_base_address_t* rtc;
+	unsigned char key_count;
+	unsigned char unlocked;
+	// Calendar is computed from a reference (virtual time and number of seconds since 01/01/2000).
+	unsigned long long reference_ns;
+	unsigned int reference_seconds;
+	// Wake-up timer.
+	HOST_event_t wakeup_event;
+	unsigned long long wakeup_start_ns;
+	unsigned long long wakeup_count;
+	// Alarm A.
+	HOST_event_t alarm_event;
+} RTC_MODEL_context_t;
+
+/*** RTC MODEL local global variables ***/
+
+static RTC_MODEL_context_t rtc_model_ctx;
+static const unsigned char RTC_MODEL_DAYS_PER_MONTH[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+/*** RTC MODEL local functions ***/
+
+/* CONVERT CALENDAR REGISTERS TO SECONDS.
+ * @param tr:	Time register.
+ * @param dr:	Date register.
+ * @return:		Number of seconds since 01/01/2000 00:00:00.
+ */
+static unsigned int RTC_MODEL_get_seconds(unsigned int tr, unsigned int dr) {
+	// Local variables.
+	unsigned int year = RTC_MODEL_BCD_TO_BINARY((dr >> 16) & 0xFF);
+	unsigned int month = RTC_MODEL_BCD_TO_BINARY((dr >> 8) & 0x1F);
+	unsigned int days = 0;
+	unsigned int idx = 0;
+	if ((month < 1) || (month > 12)) month = 1;
+	days = (year * 365) + ((year + 3) / 4);
+	for (idx=0 ; idx<(month - 1) ; idx++) days += RTC_MODEL_DAYS_PER_MONTH[idx];
+	if ((month > 2) && ((year % 4) == 0)) days++;
+	days += RTC_MODEL_BCD_TO_BINARY(dr & 0x3F) - 1;
+	return (days * RTC_MODEL_SECONDS_PER_DAY) + (RTC_MODEL_BCD_TO_BINARY((tr >> 16) & 0x3F) * 3600) + (RTC_MODEL_BCD_TO_BINARY((tr >> 8) & 0x7F) * 60) + RTC_MODEL_BCD_TO_BINARY(tr & 0x7F);
+}
+
+/* CONVERT SECONDS TO CALENDAR REGISTERS.
+ * @param seconds:	Number of seconds since 01/01/2000 00:00:00.
+ * @param tr:		Pointer to the time register value.
+ * @param dr:		Pointer to the date register value.
+ * @return:			None.
+ */
+static void RTC_MODEL_set_calendar(unsigned int seconds, unsigned int* tr, unsigned int* dr) {
+	// Local variables.
+	unsigned int days = (seconds / RTC_MODEL_SECONDS_PER_DAY);
+	unsigned int time_of_day = (seconds % RTC_MODEL_SECONDS_PER_DAY);
+	unsigned int weekday = ((days + 5) % 7) + 1; // 01/01/2000 is a saturday.
+	unsigned int year = 0;
+	unsigned int month = 0;
+	unsigned int month_days = 0;
+	while (days >= (((year % 4) == 0) ? 366U : 365U)) {
+		days -= (((year % 4) == 0) ? 366 : 365);
+		year++;
+	}
+	for (month=0 ; month<12 ; month++) {
+		month_days = RTC_MODEL_DAYS_PER_MONTH[month] + (((month == 1) && ((year % 4) == 0)) ? 1 : 0);
+		if (days < month_days) break;
+		days -= month_days;
+	}
+	(*tr) = (RTC_MODEL_BINARY_TO_BCD(time_of_day / 3600) << 16) | (RTC_MODEL_BINARY_TO_BCD((time_of_day / 60) % 60) << 8) | RTC_MODEL_BINARY_TO_BCD(time_of_day % 60);
+	(*dr) = (RTC_MODEL_BINARY_TO_BCD(year % 100) << 16) | (weekday << 13) | (RTC_MODEL_BINARY_TO_BCD(month + 1) << 8) | RTC_MODEL_BINARY_TO_BCD(days + 1);
+}
+
+/* GET CURRENT CALENDAR VALUE.
+ * @param:	None.
+ * @return:	Number of seconds since 01/01/2000 00:00:00.
+ */
+static unsigned int RTC_MODEL_get_current_seconds(void) {
+	// Calendar is frozen in initialization mode.
+	if (((rtc_model_ctx.rtc -> ISR) & (0b1 << 7)) != 0) {
+		return RTC_MODEL_get_seconds((rtc_model_ctx.rtc -> TR), (rtc_model_ctx.rtc -> DR));
+	}
+	return rtc_model_ctx.reference_seconds + (unsigned int) ((HOST_get_time_ns() - rtc_model_ctx.reference_ns) / RTC_MODEL_NS_PER_SECOND);
+}
+
+/* UPDATE STATUS BITS WHICH REFLECT THE CONFIGURATION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RTC_MODEL_update_isr(void) {
+	// Local variables.
+	unsigned int isr = ((rtc_model_ctx.rtc -> ISR) & ~((0b1 << 6) | (0b111 << 0)));
+	unsigned int cr = (rtc_model_ctx.rtc -> CR);
+	if ((isr & (0b1 << 7)) != 0) isr |= (0b1 << 6); // INITF.
+	if ((cr & (0b1 << 10)) == 0) isr |= (0b1 << 2); // WUTWF.
+	if ((cr & (0b1 << 9)) == 0) isr |= (0b1 << 1); // ALRBWF.
+	if ((cr & (0b1 << 8)) == 0) isr |= (0b1 << 0); // ALRAWF.
+	rtc_model_ctx.rtc -> ISR = isr;
+}
+
+/* WAKE-UP TIMER EXPIRY.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RTC_MODEL_wakeup_event_callback(void) {
+	// Local variables.
+	unsigned int wucksel = ((rtc_model_ctx.rtc -> CR) & 0b111);
+	unsigned long long period_count = ((rtc_model_ctx.rtc -> WUTR) & 0xFFFF) + 1ULL;
+	unsigned long long frequency_hz = 1;
+	// Wake-up clock.
+	if (wucksel < 0b100) {
+		frequency_hz = (2048 << wucksel);
+	}
+	else if (wucksel >= 0b110) {
+		period_count += 65536;
+	}
+	// Periodic event (first call only arms the timer).
+	if (rtc_model_ctx.wakeup_count != 0) {
+		rtc_model_ctx.rtc -> ISR |= (0b1 << 10); // WUTF='1'.
+		if (((rtc_model_ctx.rtc -> CR) & (0b1 << 14)) != 0) {
+			EXTI_MODEL_edge(EXTI_MODEL_LINE_RTC_WAKEUP, 1);
+		}
+	}
+	rtc_model_ctx.wakeup_count++;
+	HOST_start_event_at(&rtc_model_ctx.wakeup_event, rtc_model_ctx.wakeup_start_ns + ((rtc_model_ctx.wakeup_count * period_count * RTC_MODEL_NS_PER_SECOND) / frequency_hz), &RTC_MODEL_wakeup_event_callback);
+}
+
+/* CHECK IF A TIME OF DAY MATCHES ALARM A.
+ * @param time_of_day:	Number of seconds since midnight.
+ * @return:				1 if the alarm matches, 0 otherwise.
+ * Note: date field is not compared.
+ */
+static unsigned char RTC_MODEL_alarm_a_match(unsigned int time_of_day) {
+	// Local variables.
+	unsigned int alrmar = (rtc_model_ctx.rtc -> ALRMAR);
+	if (((alrmar & (0b1 << 23)) == 0) && (RTC_MODEL_BCD_TO_BINARY((alrmar >> 16) & 0x3F) != (time_of_day / 3600))) return 0;
+	if (((alrmar & (0b1 << 15)) == 0) && (RTC_MODEL_BCD_TO_BINARY((alrmar >> 8) & 0x7F) != ((time_of_day / 60) % 60))) return 0;
+	if (((alrmar & (0b1 << 7)) == 0) && (RTC_MODEL_BCD_TO_BINARY(alrmar & 0x7F) != (time_of_day % 60))) return 0;
+	return 1;
+}
+
+/* ARM ALARM A ON THE NEXT MATCHING SECOND.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RTC_MODEL_schedule_alarm_a(void) {
+	// Local variables.
+	unsigned int seconds = RTC_MODEL_get_current_seconds();
+	unsigned int delay = 0;
+	HOST_stop_event(&rtc_model_ctx.alarm_event);
+	if ((((rtc_model_ctx.rtc -> CR) & (0b1 << 8)) == 0) || (((rtc_model_ctx.rtc -> ISR) & (0b1 << 7)) != 0)) return;
+	for (delay=1 ; delay<=RTC_MODEL_SECONDS_PER_DAY ; delay++) {
+		if (RTC_MODEL_alarm_a_match((seconds + delay) % RTC_MODEL_SECONDS_PER_DAY) != 0) break;
+	}
+	HOST_start_event_at(&rtc_model_ctx.alarm_event, rtc_model_ctx.reference_ns + ((seconds + delay - rtc_model_ctx.reference_seconds) * RTC_MODEL_NS_PER_SECOND), &RTC_MODEL_alarm_event_callback);
+}
+
+/* ALARM A MATCH.
+ * @param:	None.
+ * @return:	None.
+ */
+static void RTC_MODEL_alarm_event_callback(void) {
+	rtc_model_ctx.rtc -> ISR |= (0b1 << 8); // ALRAF='1'.
+	if (((rtc_model_ctx.rtc -> CR) & (0b1 << 12)) != 0) {
+		EXTI_MODEL_edge(EXTI_MODEL_LINE_RTC_ALARM, 1);
+	}
+	RTC_MODEL_schedule_alarm_a();
+}
+
+/* CONTROL REGISTER WRITE.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void RTC_MODEL_write_cr(unsigned int previous_value) {
+	// Local variables.
+	unsigned int changed = ((rtc_model_ctx.rtc -> CR) ^ previous_value);
+	// Wake-up timer.
+	if ((changed & (0b1 << 10)) != 0) {
+		HOST_stop_event(&rtc_model_ctx.wakeup_event);
+		if (((rtc_model_ctx.rtc -> CR) & (0b1 << 10)) != 0) {
+			rtc_model_ctx.wakeup_start_ns = HOST_get_time_ns();
+			rtc_model_ctx.wakeup_count = 0;
+			RTC_MODEL_wakeup_event_callback();
+		}
+	}
+	// Alarm A.
+	if ((changed & (0b1 << 8)) != 0) {
+		RTC_MODEL_schedule_alarm_a();
+	}
+}
+
+/* INTERRUPT AND STATUS REGISTER WRITE.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void RTC_MODEL_write_isr(unsigned int previous_value) {
+	// Local variables.
+	unsigned int value = (rtc_model_ctx.rtc -> ISR);
+	unsigned int isr = (previous_value & ~(RTC_MODEL_ISR_FLAGS_MASK | (0b1 << 7))) | (previous_value & value & RTC_MODEL_ISR_FLAGS_MASK);
+	// Initialization mode is protected.
+	isr |= (((rtc_model_ctx.unlocked != 0) ? value : previous_value) & (0b1 << 7));
+	rtc_model_ctx.rtc -> ISR = isr;
+	if (((isr ^ previous_value) & (0b1 << 7)) != 0) {
+		if ((isr & (0b1 << 7)) != 0) {
+			// Freeze calendar.
+			rtc_model_ctx.rtc -> ISR = previous_value;
+			RTC_MODEL_set_calendar(RTC_MODEL_get_current_seconds(), (unsigned int*) &(rtc_model_ctx.rtc -> TR), (unsigned int*) &(rtc_model_ctx.rtc -> DR));
+			rtc_model_ctx.rtc -> ISR = isr;
+		}
+		else {
+			// Restart calendar from the programmed value.
+			rtc_model_ctx.reference_seconds = RTC_MODEL_get_seconds((rtc_model_ctx.rtc -> TR), (rtc_model_ctx.rtc -> DR));
+			rtc_model_ctx.reference_ns = HOST_get_time_ns();
+		}
+		RTC_MODEL_schedule_alarm_a();
+	}
+}
+
+/* RTC REGISTERS READ CALLBACK.
+ * @param offset:	Register offset.
+ * @return:			None.
+ */
+static void RTC_MODEL_read_callback(unsigned int offset) {
+	if ((offset != offsetof(RTC_base_address_t, TR)) && (offset != offsetof(RTC_base_address_t, DR))) return;
+	if (((rtc_model_ctx.rtc -> ISR) & (0b1 << 7)) != 0) return;
+	RTC_MODEL_set_calendar(RTC_MODEL_get_current_seconds(), (unsigned int*) &(rtc_model_ctx.rtc -> TR), (unsigned int*) &(rtc_model_ctx.rtc -> DR));
+}
+
+/* RTC REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void RTC_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int* reg = (unsigned int*) (((unsigned char*) rtc_model_ctx.rtc) + offset);
+	unsigned int value = (*reg);
+	unsigned char init = (((rtc_model_ctx.rtc -> ISR) & (0b1 << 7)) != 0) ? 1 : 0;
+	switch (offset) {
+	case offsetof(RTC_base_address_t, WPR):
+		// Key sequence, any other value locks the registers again.
+		(*reg) = 0;
+		if ((rtc_model_ctx.key_count == 0) && (value == RTC_MODEL_KEY1)) {
+			rtc_model_ctx.key_count = 1;
+		}
+		else if ((rtc_model_ctx.key_count == 1) && (value == RTC_MODEL_KEY2)) {
+			rtc_model_ctx.key_count = 0;
+			rtc_model_ctx.unlocked = 1;
+		}
+		else {
+			rtc_model_ctx.key_count = 0;
+			rtc_model_ctx.unlocked = 0;
+		}
+		break;
+	case offsetof(RTC_base_address_t, ISR):
+		RTC_MODEL_write_isr(previous_value);
+		break;
+	case offsetof(RTC_base_address_t, TR):
+	case offsetof(RTC_base_address_t, DR):
+	case offsetof(RTC_base_address_t, PRER):
+		// Calendar and prescaler can only be written in initialization mode.
+		if ((rtc_model_ctx.unlocked == 0) || (init == 0)) (*reg) = previous_value;
+		break;
+	case offsetof(RTC_base_address_t, CR):
+		if (rtc_model_ctx.unlocked == 0) {
+			(*reg) = previous_value;
+			break;
+		}
+		RTC_MODEL_write_cr(previous_value);
+		break;
+	case offsetof(RTC_base_address_t, WUTR):
+		if ((rtc_model_ctx.unlocked == 0) || (((rtc_model_ctx.rtc -> CR) & (0b1 << 10)) != 0)) (*reg) = previous_value;
+		break;
+	case offsetof(RTC_base_address_t, ALRMAR):
+		if ((rtc_model_ctx.unlocked == 0) || (((rtc_model_ctx.rtc -> CR) & (0b1 << 8)) != 0)) (*reg) = previous_value;
+		break;
+	case offsetof(RTC_base_address_t, ALRMBR):
+		if ((rtc_model_ctx.unlocked == 0) || (((rtc_model_ctx.rtc -> CR) & (0b1 << 9)) != 0)) (*reg) = previous_value;
+		break;
+	default:
+		break;
+	}
+	RTC_MODEL_update_isr();
+}
+
+/* INIT RTC MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) RTC_MODEL_init(void) {
+	// Reset values.
+	rtc_model_ctx.rtc = BUS_map_peripheral((unsigned long) RTC, sizeof(RTC_base_address_t), &RTC_MODEL_read_callback, &RTC_MODEL_write_callback);
+	rtc_model_ctx.rtc -> DR = RTC_MODEL_DR_RESET;
+	rtc_model_ctx.rtc -> ISR = RTC_MODEL_ISR_RESET;
+	rtc_model_ctx.rtc -> PRER = (127 << 16) | (255 << 0);
+	rtc_model_ctx.rtc -> WUTR = 0xFFFF;
+	rtc_model_ctx.reference_seconds = RTC_MODEL_get_seconds(0, RTC_MODEL_DR_RESET);
+}
+
+#endif /* HOST */
@@ -0,0 +1,651 @@
+/*
+ * s2lp_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "s2lp_model.h"
+
+#include "gpio_model.h"
+#include "host.h"
+#include "mapping.h"
+#include "s2lp.h"
+#include "s2lp_reg.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** S2LP MODEL local macros ***/
+
+#define S2LP_MODEL_HEADER_BYTE_WRITE		0x00
+#define S2LP_MODEL_HEADER_BYTE_READ			0x01
+#define S2LP_MODEL_HEADER_BYTE_COMMAND		0x80
+
+#define S2LP_MODEL_REGISTERS_SIZE			256
+#define S2LP_MODEL_REG_READ_ONLY_START		S2LP_REG_MC_STATE1 // Status registers.
+#define S2LP_MODEL_DEVICE_PARTNUM			0x03
+#define S2LP_MODEL_DEVICE_VERSION			0xC1
+
+#define S2LP_MODEL_DIGITAL_CLOCK_HZ			24576000ULL // fXO / 2 (49.152MHz TCXO with digital divider).
+#define S2LP_MODEL_POLAR_SAMPLES_PER_BIT	8 // Each sample is made of 2 FIFO bytes (deviation and PA level).
+#define S2LP_MODEL_RSSI_OFFSET_DB			158 // Inverse of the offsets applied by S2LP_get_rssi().
+#define S2LP_MODEL_DOWNLINK_BITRATE_BPS		600
+
+// State transition latencies (approximate S2-LP datasheet values).
+#define S2LP_MODEL_POR_LATENCY_US			650
+#define S2LP_MODEL_STANDBY_TO_READY_US		300
+#define S2LP_MODEL_READY_TO_STANDBY_US		10
+#define S2LP_MODEL_LOCK_LATENCY_US			60 // Synthesizer calibration and lock before TX or RX.
+#define S2LP_MODEL_ABORT_LATENCY_US			10
+
+#define S2LP_MODEL_MODULATION_POLAR			0x06
+#define S2LP_MODEL_MODULATION_NONE			0x07
+#define S2LP_MODEL_TX_SOURCE_FIFO			0x01
+
+/*** S2LP MODEL local structures ***/
+
+typedef struct {
+	unsigned char data[S2LP_MODEL_RX_FRAME_LENGTH_MAX];
+	unsigned char length;
+	signed short rssi_dbm;
+	unsigned int delay_ms;
+} S2LP_MODEL_rx_frame_t;
+
+typedef struct {
+	// Chip interface.
+	unsigned char powered;
+	unsigned char cs;
+	unsigned char spi_byte_idx;
+	unsigned char spi_header;
+	unsigned char spi_addr;
+	unsigned char gpio0;
+	// Digital core.
+	unsigned char reg[S2LP_MODEL_REGISTERS_SIZE];
+	unsigned int irq_status;
+	S2LP_state_t state;
+	S2LP_state_t next_state;
+	HOST_event_t state_event;
+	// TX path.
+	unsigned char tx_fifo[S2LP_FIFO_SIZE_BYTES];
+	unsigned char tx_fifo_read_idx;
+	unsigned char tx_fifo_level;
+	unsigned int tx_byte_period_us;
+	HOST_event_t tx_event;
+	unsigned long long tx_start_time_us;
+	S2LP_MODEL_tx_statistics_t tx_statistics;
+	unsigned char tx_capture[S2LP_MODEL_TX_CAPTURE_LENGTH_MAX]; // Modulator input (bytes popped from TX FIFO).
+	unsigned int tx_capture_length;
+	FILE* tx_capture_file;
+	// RX path.
+	unsigned char rx_fifo[S2LP_FIFO_SIZE_BYTES];
+	unsigned char rx_fifo_read_idx;
+	unsigned char rx_fifo_level;
+	S2LP_MODEL_rx_frame_t rx_queue[S2LP_MODEL_RX_QUEUE_LENGTH];
+	unsigned char rx_queue_read_idx;
+	unsigned char rx_queue_count;
+	HOST_event_t rx_event;
+	// Debug.
+	S2LP_MODEL_activity_t activity;
+	unsigned char trace;
+} S2LP_MODEL_context_t;
+
+/*** S2LP MODEL local global variables ***/
+
+static S2LP_MODEL_context_t s2lp_model_ctx;
+
+/*** S2LP MODEL local functions ***/
+
+/* COMPUTE THE CURRENT LEVEL OF GPIO0 OUTPUT AND GENERATE MCU EXTERNAL INTERRUPT ON EDGES.
+ * @param:	None.
+ * @return:	None.
+ */
+static void S2LP_MODEL_update_gpio0(void) {
+	// Local variables.
+	unsigned char gpio_function = (s2lp_model_ctx.reg[S2LP_REG_GPIO0_CONF] >> 3) & 0x1F;
+	unsigned char rx_fifo_flags = (s2lp_model_ctx.reg[S2LP_REG_PROTOCOL2] >> 2) & 0x01;
+	unsigned int irq_mask = 0;
+	unsigned char level = 0;
+	if (s2lp_model_ctx.powered == 0) return;
+	switch (gpio_function) {
+	case S2LP_GPIO_OUTPUT_FUNCTION_NIRQ:
+		// Active low.
+		irq_mask = (s2lp_model_ctx.reg[S2LP_REG_IRQ_MASK3] << 24) | (s2lp_model_ctx.reg[S2LP_REG_IRQ_MASK2] << 16) | (s2lp_model_ctx.reg[S2LP_REG_IRQ_MASK1] << 8) | (s2lp_model_ctx.reg[S2LP_REG_IRQ_MASK0] << 0);
+		level = ((s2lp_model_ctx.irq_status & irq_mask) != 0) ? 0 : 1;
+		break;
+	case S2LP_GPIO_OUTPUT_FUNCTION_FIFO_EMPTY:
+		// FIFO almost empty flag.
+		if (rx_fifo_flags == 0) {
+			level = (s2lp_model_ctx.tx_fifo_level <= s2lp_model_ctx.reg[S2LP_FIFO_THRESHOLD_TX_EMPTY]) ? 1 : 0;
+		}
+		else {
+			level = (s2lp_model_ctx.rx_fifo_level <= s2lp_model_ctx.reg[S2LP_FIFO_THRESHOLD_RX_EMPTY]) ? 1 : 0;
+		}
+		break;
+	case S2LP_GPIO_OUTPUT_FUNCTION_VDD:
+		level = 1;
+		break;
+	default:
+		level = 0;
+		break;
+	}
+	if (level == s2lp_model_ctx.gpio0) return;
+	s2lp_model_ctx.gpio0 = level;
+	// Drive MCU input (interrupt is generated according to EXTI configuration).
+	if (GPIO_MODEL_set_input(&GPIO_S2LP_GPIO0, level) != 0) {
+		s2lp_model_ctx.activity.gpio0_interrupt_count++;
+	}
+}
+
+/* SET INTERRUPT STATUS BIT.
+ * @param irq_idx:	Interrupt index.
+ * @return:			None.
+ */
+static void S2LP_MODEL_set_irq(S2LP_irq_index_t irq_idx) {
+	s2lp_model_ctx.irq_status |= (0b1 << irq_idx);
+	S2LP_MODEL_update_gpio0();
+}
+
+/* COMPUTE FIFO BYTE PERIOD FROM MODULATION AND DATA RATE REGISTERS.
+ * @param:	None.
+ * @return:	Duration of one FIFO byte in microseconds.
+ */
+static unsigned int S2LP_MODEL_get_byte_period_us(void) {
+	// Local variables.
+	unsigned long long mantissa = (s2lp_model_ctx.reg[S2LP_REG_MOD4] << 8) + s2lp_model_ctx.reg[S2LP_REG_MOD3];
+	unsigned char exponent = (s2lp_model_ctx.reg[S2LP_REG_MOD2] & 0x0F);
+	unsigned char modulation = (s2lp_model_ctx.reg[S2LP_REG_MOD2] >> 4);
+	unsigned long long datarate_numerator = 0; // Data rate is (numerator / 2^33) bps.
+	unsigned long long bits_per_byte = 8;
+	// See data rate equation of S2LP datasheet.
+	if (exponent == 0) {
+		datarate_numerator = (S2LP_MODEL_DIGITAL_CLOCK_HZ * mantissa * 2);
+	}
+	else {
+		datarate_numerator = (S2LP_MODEL_DIGITAL_CLOCK_HZ * (65536 + mantissa)) << exponent;
+	}
+	if (datarate_numerator == 0) return 1;
+	// In polar mode, each FIFO byte pair is one sample and samples are clocked at 8 times the data rate.
+	if (modulation == S2LP_MODEL_MODULATION_POLAR) {
+		bits_per_byte = 1;
+		datarate_numerator *= (2 * S2LP_MODEL_POLAR_SAMPLES_PER_BIT);
+	}
+	return (unsigned int) (((bits_per_byte * 1000000ULL) << 33) / datarate_numerator);
+}
+
+/* PRINT STATISTICS OF THE TRANSMISSION WHICH JUST ENDED.
+ * @param:	None.
+ * @return:	None.
+ */
+static void S2LP_MODEL_end_tx(void) {
+	// Local variables.
+	S2LP_MODEL_tx_statistics_t* tx_statistics = &s2lp_model_ctx.tx_statistics;
+	unsigned int idx = 0;
+	HOST_stop_event(&s2lp_model_ctx.tx_event);
+	if ((tx_statistics -> fifo_bytes_sent) == 0) return;
+	// Dump modulator input (one hexadecimal line per transmission).
+	if (s2lp_model_ctx.tx_capture_file != 0) {
+		for (idx=0 ; idx<s2lp_model_ctx.tx_capture_length ; idx++) fprintf(s2lp_model_ctx.tx_capture_file, "%02X", s2lp_model_ctx.tx_capture[idx]);
+		fprintf(s2lp_model_ctx.tx_capture_file, "\n");
+		fflush(s2lp_model_ctx.tx_capture_file);
+	}
+	tx_statistics -> duration_us = (unsigned int) (HOST_get_time_us() - s2lp_model_ctx.tx_start_time_us);
+	fprintf(stderr, "HOST: S2LP TX %u bytes in %u ms, FIFO margin %u bytes (%u us), %u underflow(s), %u overflow(s)\n",
+		tx_statistics -> fifo_bytes_sent, ((tx_statistics -> duration_us) / 1000),
+		tx_statistics -> fifo_level_min, ((tx_statistics -> fifo_level_min) * s2lp_model_ctx.tx_byte_period_us),
+		tx_statistics -> fifo_underflow_count, tx_statistics -> fifo_overflow_count);
+}
+
+/* TX FIFO DRAIN (EVENT CALLBACK, ONE BYTE PER PERIOD).
+ * @param:	None.
+ * @return:	None.
+ */
+static void S2LP_MODEL_tx_event_callback(void) {
+	// Re-arm for next byte.
+	HOST_start_event(&s2lp_model_ctx.tx_event, s2lp_model_ctx.tx_byte_period_us, &S2LP_MODEL_tx_event_callback);
+	if (s2lp_model_ctx.tx_fifo_level == 0) return;
+	if (s2lp_model_ctx.tx_capture_length < S2LP_MODEL_TX_CAPTURE_LENGTH_MAX) {
+		s2lp_model_ctx.tx_capture[s2lp_model_ctx.tx_capture_length++] = s2lp_model_ctx.tx_fifo[s2lp_model_ctx.tx_fifo_read_idx];
+	}
+	s2lp_model_ctx.tx_fifo_read_idx = (s2lp_model_ctx.tx_fifo_read_idx + 1) % S2LP_FIFO_SIZE_BYTES;
+	s2lp_model_ctx.tx_fifo_level--;
+	s2lp_model_ctx.tx_statistics.fifo_bytes_sent++;
+	if (s2lp_model_ctx.tx_fifo_level == 0) {
+		// Modulator starved.
+		s2lp_model_ctx.tx_statistics.fifo_underflow_count++;
+		S2LP_MODEL_set_irq(S2LP_IRQ_TX_FIFO_ERROR_IDX);
+	}
+	S2LP_MODEL_update_gpio0();
+}
+
+/* END OF DOWNLINK FRAME RECEPTION (EVENT CALLBACK).
+ * @param:	None.
+ * @return:	None.
+ */
+static void S2LP_MODEL_rx_event_callback(void) {
+	// Local variables.
+	S2LP_MODEL_rx_frame_t* frame = &(s2lp_model_ctx.rx_queue[s2lp_model_ctx.rx_queue_read_idx]);
+	unsigned char packet_length = s2lp_model_ctx.reg[S2LP_REG_PCKTLEN0];
+	signed short rssi_level = ((frame -> rssi_dbm) + S2LP_MODEL_RSSI_OFFSET_DB);
+	unsigned char idx = 0;
+	// Fill RX FIFO (missing bytes are zero).
+	for (idx=0 ; idx<packet_length ; idx++) {
+		if (s2lp_model_ctx.rx_fifo_level >= S2LP_FIFO_SIZE_BYTES) break;
+		s2lp_model_ctx.rx_fifo[(s2lp_model_ctx.rx_fifo_read_idx + s2lp_model_ctx.rx_fifo_level) % S2LP_FIFO_SIZE_BYTES] = (idx < (frame -> length)) ? (frame -> data)[idx] : 0x00;
+		s2lp_model_ctx.rx_fifo_level++;
+	}
+	s2lp_model_ctx.reg[S2LP_REG_RSSI_LEVEL] = (rssi_level < 0) ? 0 : ((rssi_level > 0xFF) ? 0xFF : rssi_level);
+	s2lp_model_ctx.rx_queue_read_idx = (s2lp_model_ctx.rx_queue_read_idx + 1) % S2LP_MODEL_RX_QUEUE_LENGTH;
+	s2lp_model_ctx.rx_queue_count--;
+	// Chip goes back to ready state after packet reception.
+	s2lp_model_ctx.state = S2LP_STATE_READY;
+	S2LP_MODEL_set_irq(S2LP_IRQ_RX_DATA_READY_IDX);
+}
+
+/* STATE TRANSITION COMPLETION (EVENT CALLBACK).
+ * @param:	None.
+ * @return:	None.
+ */
+static void S2LP_MODEL_state_event_callback(void) {
+	// Local variables.
+	unsigned char modulation = (s2lp_model_ctx.reg[S2LP_REG_MOD2] >> 4);
+	unsigned char tx_source = (s2lp_model_ctx.reg[S2LP_REG_PCKTCTRL1] >> 2) & 0x03;
+	unsigned int rx_delay_us = 0;
+	unsigned int frame_duration_us = 0;
+	s2lp_model_ctx.state = s2lp_model_ctx.next_state;
+	switch (s2lp_model_ctx.state) {
+	case S2LP_STATE_TX:
+		// Start modulator.
+		if ((modulation == S2LP_MODEL_MODULATION_NONE) || (tx_source != S2LP_MODEL_TX_SOURCE_FIFO)) break;
+		s2lp_model_ctx.tx_byte_period_us = S2LP_MODEL_get_byte_period_us();
+		s2lp_model_ctx.tx_start_time_us = HOST_get_time_us();
+		HOST_start_event(&s2lp_model_ctx.tx_event, s2lp_model_ctx.tx_byte_period_us, &S2LP_MODEL_tx_event_callback);
+		break;
+	case S2LP_STATE_RX:
+		// Schedule next injected frame if any.
+		if (s2lp_model_ctx.rx_queue_count == 0) break;
+		frame_duration_us = ((s2lp_model_ctx.reg[S2LP_REG_PCKTLEN0] * 8 + 48) * 1000000) / S2LP_MODEL_DOWNLINK_BITRATE_BPS; // Preamble and sync word included.
+		rx_delay_us = s2lp_model_ctx.rx_queue[s2lp_model_ctx.rx_queue_read_idx].delay_ms * 1000;
+		HOST_start_event(&s2lp_model_ctx.rx_event, ((rx_delay_us > frame_duration_us) ? rx_delay_us : frame_duration_us), &S2LP_MODEL_rx_event_callback);
+		break;
+	default:
+		break;
+	}
+}
+
+/* START A STATE TRANSITION.
+ * @param new_state:		Final state.
+ * @param transient_state:	State reported during transition.
+ * @param latency_us:		Transition duration.
+ * @return:					None.
+ */
+static void S2LP_MODEL_set_state(S2LP_state_t new_state, S2LP_state_t transient_state, unsigned int latency_us) {
+	// Leaving TX or RX stops radio activity.
+	if (s2lp_model_ctx.state == S2LP_STATE_TX) {
+		S2LP_MODEL_end_tx();
+	}
+	HOST_stop_event(&s2lp_model_ctx.rx_event);
+	s2lp_model_ctx.state = transient_state;
+	s2lp_model_ctx.next_state = new_state;
+	HOST_start_event(&s2lp_model_ctx.state_event, latency_us, &S2LP_MODEL_state_event_callback);
+}
+
+/* RESET DIGITAL CORE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void S2LP_MODEL_reset(void) {
+	// Local variables.
+	unsigned int idx = 0;
+	HOST_stop_event(&s2lp_model_ctx.tx_event);
+	HOST_stop_event(&s2lp_model_ctx.rx_event);
+	for (idx=0 ; idx<S2LP_MODEL_REGISTERS_SIZE ; idx++) s2lp_model_ctx.reg[idx] = 0;
+	s2lp_model_ctx.reg[S2LP_REG_DEVICE_INFO1] = S2LP_MODEL_DEVICE_PARTNUM;
+	s2lp_model_ctx.reg[S2LP_REG_DEVICE_INFO0] = S2LP_MODEL_DEVICE_VERSION;
+	s2lp_model_ctx.irq_status = 0;
+	s2lp_model_ctx.tx_fifo_level = 0;
+	s2lp_model_ctx.rx_fifo_level = 0;
+	s2lp_model_ctx.state = S2LP_STATE_STANDBY;
+	S2LP_MODEL_set_state(S2LP_STATE_READY, S2LP_STATE_STANDBY, S2LP_MODEL_POR_LATENCY_US);
+}
+
+/* EXECUTE A COMMAND.
+ * @param command:	Command byte.
+ * @return:			None.
+ */
+static void S2LP_MODEL_execute_command(unsigned char command) {
+	if (s2lp_model_ctx.trace != 0) {
+		fprintf(stderr, "S2LP %llu us: command 0x%02X\n", HOST_get_time_us(), command);
+	}
+	switch (command) {
+	case S2LP_CMD_TX:
+		S2LP_MODEL_set_state(S2LP_STATE_TX, S2LP_STATE_SYNTH_SETUP, S2LP_MODEL_LOCK_LATENCY_US);
+		s2lp_model_ctx.tx_statistics.fifo_bytes_sent = 0;
+		s2lp_model_ctx.tx_statistics.fifo_level_min = S2LP_FIFO_SIZE_BYTES;
+		s2lp_model_ctx.tx_statistics.fifo_underflow_count = 0;
+		s2lp_model_ctx.tx_statistics.fifo_overflow_count = 0;
+		s2lp_model_ctx.tx_capture_length = 0;
+		break;
+	case S2LP_CMD_RX:
+		S2LP_MODEL_set_state(S2LP_STATE_RX, S2LP_STATE_SYNTH_SETUP, S2LP_MODEL_LOCK_LATENCY_US);
+		break;
+	case S2LP_CMD_READY:
+		if ((s2lp_model_ctx.state == S2LP_STATE_STANDBY) || (s2lp_model_ctx.state == S2LP_STATE_SLEEP_A) || (s2lp_model_ctx.state == S2LP_STATE_SLEEP_B)) {
+			S2LP_MODEL_set_state(S2LP_STATE_READY, s2lp_model_ctx.state, S2LP_MODEL_STANDBY_TO_READY_US);
+		}
+		else {
+			S2LP_MODEL_set_state(S2LP_STATE_READY, s2lp_model_ctx.state, S2LP_MODEL_ABORT_LATENCY_US);
+		}
+		break;
+	case S2LP_CMD_STANDBY:
+		S2LP_MODEL_set_state(S2LP_STATE_STANDBY, s2lp_model_ctx.state, S2LP_MODEL_READY_TO_STANDBY_US);
+		break;
+	case S2LP_CMD_SLEEP:
+		S2LP_MODEL_set_state(S2LP_STATE_SLEEP_A, s2lp_model_ctx.state, S2LP_MODEL_READY_TO_STANDBY_US);
+		break;
+	case S2LP_CMD_LOCKRX:
+	case S2LP_CMD_LOCKTX:
+		S2LP_MODEL_set_state(S2LP_STATE_LOCK, S2LP_STATE_SYNTH_SETUP, S2LP_MODEL_LOCK_LATENCY_US);
+		break;
+	case S2LP_CMD_SABORT:
+		S2LP_MODEL_set_state(S2LP_STATE_READY, s2lp_model_ctx.state, S2LP_MODEL_ABORT_LATENCY_US);
+		break;
+	case S2LP_CMD_SRES:
+		S2LP_MODEL_reset();
+		break;
+	case S2LP_CMD_FLUSHRXFIFO:
+		s2lp_model_ctx.rx_fifo_level = 0;
+		break;
+	case S2LP_CMD_FLUSHTXFIFO:
+		s2lp_model_ctx.tx_fifo_level = 0;
+		break;
+	default:
+		break;
+	}
+	S2LP_MODEL_update_gpio0();
+}
+
+/* READ A REGISTER (STATUS REGISTERS ARE COMPUTED, IRQ STATUS REGISTERS ARE CLEARED ON READ).
+ * @param addr:	Register address.
+ * @return:		Register value.
+ */
+static unsigned char S2LP_MODEL_read_register(unsigned char addr) {
+	// Local variables.
+	unsigned char value = 0;
+	unsigned char irq_shift = 0;
+	switch (addr) {
+	case S2LP_REG_MC_STATE0:
+		value = (s2lp_model_ctx.state << 1);
+		if ((s2lp_model_ctx.state != S2LP_STATE_STANDBY) && (s2lp_model_ctx.state != S2LP_STATE_SLEEP_A) && (s2lp_model_ctx.state != S2LP_STATE_SLEEP_B)) {
+			value |= 0x01; // XO_ON.
+		}
+		break;
+	case S2LP_REG_TX_FIFO_STATUS:
+		value = s2lp_model_ctx.tx_fifo_level;
+		break;
+	case S2LP_REG_RX_FIFO_STATUS:
+		value = s2lp_model_ctx.rx_fifo_level;
+		break;
+	case S2LP_REG_IRQ_STATUS3:
+	case S2LP_REG_IRQ_STATUS2:
+	case S2LP_REG_IRQ_STATUS1:
+	case S2LP_REG_IRQ_STATUS0:
+		irq_shift = 8 * (S2LP_REG_IRQ_STATUS0 - addr);
+		value = (s2lp_model_ctx.irq_status >> irq_shift) & 0xFF;
+		s2lp_model_ctx.irq_status &= ~(0xFF << irq_shift);
+		S2LP_MODEL_update_gpio0();
+		break;
+	default:
+		value = s2lp_model_ctx.reg[addr];
+		break;
+	}
+	return value;
+}
+
+/* WRITE A REGISTER.
+ * @param addr:		Register address.
+ * @param value:	Value to write.
+ * @return:			None.
+ */
+static void S2LP_MODEL_write_register(unsigned char addr, unsigned char value) {
+	if (addr >= S2LP_MODEL_REG_READ_ONLY_START) return;
+	if (s2lp_model_ctx.trace != 0) {
+		fprintf(stderr, "S2LP %llu us: register 0x%02X=0x%02X\n", HOST_get_time_us(), addr, value);
+	}
+	s2lp_model_ctx.reg[addr] = value;
+	S2LP_MODEL_update_gpio0();
+}
+
+/* PUSH A BYTE IN TX FIFO.
+ * @param data:	Byte to push.
+ * @return:		None.
+ */
+static void S2LP_MODEL_write_tx_fifo(unsigned char data) {
+	if (s2lp_model_ctx.tx_fifo_level >= S2LP_FIFO_SIZE_BYTES) {
+		s2lp_model_ctx.tx_statistics.fifo_overflow_count++;
+		S2LP_MODEL_set_irq(S2LP_IRQ_TX_FIFO_ERROR_IDX);
+		return;
+	}
+	s2lp_model_ctx.tx_fifo[(s2lp_model_ctx.tx_fifo_read_idx + s2lp_model_ctx.tx_fifo_level) % S2LP_FIFO_SIZE_BYTES] = data;
+	s2lp_model_ctx.tx_fifo_level++;
+	S2LP_MODEL_update_gpio0();
+}
+
+/* POP A BYTE FROM RX FIFO.
+ * @param:	None.
+ * @return:	FIFO byte (0 if empty).
+ */
+static unsigned char S2LP_MODEL_read_rx_fifo(void) {
+	// Local variables.
+	unsigned char data = 0;
+	if (s2lp_model_ctx.rx_fifo_level == 0) {
+		S2LP_MODEL_set_irq(S2LP_IRQ_RX_FIFO_ERROR_IDX);
+		return 0;
+	}
+	data = s2lp_model_ctx.rx_fifo[s2lp_model_ctx.rx_fifo_read_idx];
+	s2lp_model_ctx.rx_fifo_read_idx = (s2lp_model_ctx.rx_fifo_read_idx + 1) % S2LP_FIFO_SIZE_BYTES;
+	s2lp_model_ctx.rx_fifo_level--;
+	S2LP_MODEL_update_gpio0();
+	return data;
+}
+
+/* CHIP SELECT PIN WRITE (GPIO CALLBACK).
+ * @param state:	New CS level.
+ * @return:			None.
+ */
+static void S2LP_MODEL_cs_callback(unsigned char state) {
+	s2lp_model_ctx.cs = state;
+	// A new SPI transaction starts on falling edge.
+	if (state == 0) {
+		s2lp_model_ctx.spi_byte_idx = 0;
+	}
+}
+
+/* RF POWER SUPPLY PIN WRITE (GPIO CALLBACK).
+ * @param state:	New supply control level.
+ * @return:			None.
+ */
+static void S2LP_MODEL_power_callback(unsigned char state) {
+	if ((state != 0) && (s2lp_model_ctx.powered == 0)) {
+		// Power on reset (shutdown pin is not modelled: the chip is active as long as it is supplied).
+		s2lp_model_ctx.powered = 1;
+		s2lp_model_ctx.gpio0 = 0;
+		S2LP_MODEL_reset();
+	}
+	if ((state == 0) && (s2lp_model_ctx.powered != 0)) {
+		if (s2lp_model_ctx.state == S2LP_STATE_TX) {
+			S2LP_MODEL_end_tx();
+		}
+		s2lp_model_ctx.powered = 0;
+		HOST_stop_event(&s2lp_model_ctx.state_event);
+		HOST_stop_event(&s2lp_model_ctx.tx_event);
+		HOST_stop_event(&s2lp_model_ctx.rx_event);
+	}
+}
+
+/* PARSE HEXADECIMAL FRAMES LIST GIVEN AS ENVIRONMENT VARIABLE.
+ * @param frames:	Comma separated hexadecimal frames.
+ * @param rssi_dbm:	RSSI associated to each frame.
+ * @param delay_ms:	Reception delay of each frame.
+ * @return:			None.
+ */
+static void S2LP_MODEL_parse_rx_frames(char* frames, signed short rssi_dbm, unsigned int delay_ms) {
+	// Local variables.
+	unsigned char frame[S2LP_MODEL_RX_FRAME_LENGTH_MAX];
+	unsigned char length = 0;
+	char digits[3] = {0};
+	char* current = frames;
+	while (1) {
+		if (((*current) == ',') || ((*current) == '\0')) {
+			if (length > 0) {
+				S2LP_MODEL_inject_rx_frame(frame, length, rssi_dbm, delay_ms);
+			}
+			length = 0;
+			if ((*current) == '\0') break;
+			current++;
+			continue;
+		}
+		if ((current[1] == '\0') || (length >= S2LP_MODEL_RX_FRAME_LENGTH_MAX)) break;
+		digits[0] = current[0];
+		digits[1] = current[1];
+		frame[length++] = (unsigned char) strtoul(digits, 0, 16);
+		current += 2;
+	}
+}
+
+/* INIT S2LP MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor)) S2LP_MODEL_init(void) {
+	// Local variables.
+	char* frames = getenv("HOST_S2LP_RX_FRAMES");
+	char* rssi = getenv("HOST_S2LP_RX_RSSI_DBM");
+	char* delay = getenv("HOST_S2LP_RX_DELAY_MS");
+	char* capture = getenv("HOST_S2LP_TX_CAPTURE_FILE");
+	// Attach to MCU pins.
+	s2lp_model_ctx.cs = 1;
+	GPIO_MODEL_set_callback(&GPIO_S2LP_CS, &S2LP_MODEL_cs_callback);
+	GPIO_MODEL_set_callback(&GPIO_RF_POWER_ENABLE, &S2LP_MODEL_power_callback);
+	s2lp_model_ctx.trace = (getenv("HOST_S2LP_TRACE") != 0) ? 1 : 0;
+	s2lp_model_ctx.tx_capture_file = (capture != 0) ? fopen(capture, "w") : 0;
+	// Downlink frames given by environment.
+	if (frames != 0) {
+		S2LP_MODEL_parse_rx_frames(frames, ((rssi != 0) ? atoi(rssi) : S2LP_MODEL_RX_RSSI_DEFAULT_DBM), ((delay != 0) ? atoi(delay) : S2LP_MODEL_RX_DELAY_DEFAULT_MS));
+	}
+}
+
+/*** S2LP MODEL functions ***/
+
+/* EXCHANGE ONE BYTE ON SPI BUS (CALLED BY SPI1 MODEL).
+ * @param mosi:	Byte sent by the MCU.
+ * @return:		Byte sent by the S2LP.
+ */
+unsigned char S2LP_MODEL_spi_transfer(unsigned char mosi) {
+	// Local variables.
+	unsigned char miso = 0;
+	// Chip must be supplied and selected.
+	if ((s2lp_model_ctx.powered == 0) || (s2lp_model_ctx.cs != 0)) return 0;
+	s2lp_model_ctx.activity.spi_byte_count++;
+	switch (s2lp_model_ctx.spi_byte_idx) {
+	case 0:
+		// Header byte, status bytes are shifted out meanwhile.
+		s2lp_model_ctx.spi_header = mosi;
+		miso = S2LP_MODEL_read_register(S2LP_REG_MC_STATE1);
+		break;
+	case 1:
+		// Address or command byte.
+		s2lp_model_ctx.spi_addr = mosi;
+		miso = S2LP_MODEL_read_register(S2LP_REG_MC_STATE0);
+		if (s2lp_model_ctx.spi_header == S2LP_MODEL_HEADER_BYTE_COMMAND) {
+			S2LP_MODEL_execute_command(mosi);
+		}
+		if ((s2lp_model_ctx.spi_header == S2LP_MODEL_HEADER_BYTE_WRITE) && (mosi == S2LP_REG_FIFO) && (s2lp_model_ctx.state == S2LP_STATE_TX)) {
+			// FIFO refill during transmission: remaining level is the timing margin.
+			if (s2lp_model_ctx.tx_fifo_level < s2lp_model_ctx.tx_statistics.fifo_level_min) {
+				s2lp_model_ctx.tx_statistics.fifo_level_min = s2lp_model_ctx.tx_fifo_level;
+			}
+		}
+		break;
+	default:
+		// Data bytes (address is auto-incremented except for FIFO).
+		if (s2lp_model_ctx.spi_header == S2LP_MODEL_HEADER_BYTE_WRITE) {
+			if (s2lp_model_ctx.spi_addr == S2LP_REG_FIFO) {
+				S2LP_MODEL_write_tx_fifo(mosi);
+			}
+			else {
+				S2LP_MODEL_write_register(s2lp_model_ctx.spi_addr++, mosi);
+			}
+		}
+		if (s2lp_model_ctx.spi_header == S2LP_MODEL_HEADER_BYTE_READ) {
+			if (s2lp_model_ctx.spi_addr == S2LP_REG_FIFO) {
+				miso = S2LP_MODEL_read_rx_fifo();
+			}
+			else {
+				miso = S2LP_MODEL_read_register(s2lp_model_ctx.spi_addr++);
+			}
+		}
+		break;
+	}
+	if (s2lp_model_ctx.spi_byte_idx < 0xFF) {
+		s2lp_model_ctx.spi_byte_idx++;
+	}
+	return miso;
+}
+
+/* QUEUE A DOWNLINK FRAME, RECEIVED DURING THE NEXT RX WINDOW.
+ * @param frame:				Frame bytes (after sync word).
+ * @param frame_length_bytes:	Number of bytes.
+ * @param rssi_dbm:				RSSI reported for this frame.
+ * @param delay_ms:				Delay between start of RX and end of frame reception.
+ * @return:						None.
+ */
+void S2LP_MODEL_inject_rx_frame(unsigned char* frame, unsigned char frame_length_bytes, signed short rssi_dbm, unsigned int delay_ms) {
+	// Local variables.
+	S2LP_MODEL_rx_frame_t* rx_frame = 0;
+	unsigned char idx = 0;
+	if (s2lp_model_ctx.rx_queue_count >= S2LP_MODEL_RX_QUEUE_LENGTH) return;
+	rx_frame = &(s2lp_model_ctx.rx_queue[(s2lp_model_ctx.rx_queue_read_idx + s2lp_model_ctx.rx_queue_count) % S2LP_MODEL_RX_QUEUE_LENGTH]);
+	rx_frame -> length = (frame_length_bytes > S2LP_MODEL_RX_FRAME_LENGTH_MAX) ? S2LP_MODEL_RX_FRAME_LENGTH_MAX : frame_length_bytes;
+	for (idx=0 ; idx<(rx_frame -> length) ; idx++) (rx_frame -> data)[idx] = frame[idx];
+	rx_frame -> rssi_dbm = rssi_dbm;
+	rx_frame -> delay_ms = delay_ms;
+	s2lp_model_ctx.rx_queue_count++;
+}
+
+/* READ A REGISTER WITHOUT SIDE EFFECT (CONFIGURATION CHECKS).
+ * @param addr:	Register address.
+ * @return:		Register value.
+ */
+unsigned char S2LP_MODEL_get_register(unsigned char addr) {
+	return s2lp_model_ctx.reg[addr];
+}
+
+/* GET STATISTICS OF THE LAST TRANSMISSION.
+ * @param tx_statistics:	Pointer to structure that will contain the statistics.
+ * @return:					None.
+ */
+void S2LP_MODEL_get_tx_statistics(S2LP_MODEL_tx_statistics_t* tx_statistics) {
+	(*tx_statistics) = s2lp_model_ctx.tx_statistics;
+}
+
+/* GET MODULATOR INPUT CAPTURED DURING THE LAST TRANSMISSION.
+ * @param capture:			Pointer that will point to the captured FIFO bytes.
+ * @param capture_length:	Pointer to the number of captured bytes.
+ * @return:					None.
+ */
+void S2LP_MODEL_get_tx_capture(unsigned char** capture, unsigned int* capture_length) {
+	(*capture) = s2lp_model_ctx.tx_capture;
+	(*capture_length) = s2lp_model_ctx.tx_capture_length;
+}
+
+/* GET CUMULATED SPI AND INTERRUPT ACTIVITY.
+ * @param activity:	Pointer to structure that will contain the counters.
+ * @return:			None.
+ */
+void S2LP_MODEL_get_activity(S2LP_MODEL_activity_t* activity) {
+	(*activity) = s2lp_model_ctx.activity;
+}
+
+#endif /* HOST */
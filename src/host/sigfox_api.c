@@ -0,0 +1,719 @@
+/*
+ * sigfox_api.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "sigfox_api.h"
+
+#include "addon_sigfox_rf_protocol_api.h"
+#include "dbpsk_model.h"
+#include "host.h"
+#include "mcu_api.h"
+#include "rf_api.h"
+#include "sigfox_types.h"
+#include <stdio.h>
+
+/*** SIGFOX API local macros ***/
+
+// The Sigfox library is only provided for the target: this module emulates its sequencing on host.
+// Frames are built with the public uplink format (preamble, frame type, header, ID, payload, MAC, CRC) but
+// repetitions reuse the first frame content (no convolutional encoding) and downlink frames are not scrambled.
+#define SIGFOX_API_UPLINK_PREAMBLE_LENGTH_BYTES		4 // 0xAAAAA preamble (20 bits) and frame type (12 bits).
+#define SIGFOX_API_UPLINK_HEADER_LENGTH_BYTES		2
+#define SIGFOX_API_UPLINK_CRC_LENGTH_BYTES			2
+#define SIGFOX_API_UPLINK_BODY_LENGTH_MAX_BYTES		20
+#define SIGFOX_API_UPLINK_FRAME_LENGTH_MAX_BYTES	(SIGFOX_API_UPLINK_PREAMBLE_LENGTH_BYTES + SIGFOX_API_UPLINK_BODY_LENGTH_MAX_BYTES + SIGFOX_API_UPLINK_CRC_LENGTH_BYTES)
+#define SIGFOX_API_UPLINK_CLASS_NUMBER				5
+#define SIGFOX_API_UPLINK_REPETITION_NUMBER			3
+#define SIGFOX_API_UPLINK_OOB_PAYLOAD_LENGTH_BYTES	8
+#define SIGFOX_API_UPLINK_GUARD_HZ					1000 // Margin between uplink channels and macro channel edges.
+
+#define SIGFOX_API_FH_CHANNEL_SPACING_HZ			300000
+#define SIGFOX_API_FH_TIMER_SECONDS					20 // FCC delay between frames when timer is enabled.
+
+#define SIGFOX_API_LBT_CS_MIN_MS					5
+
+#define SIGFOX_API_DOWNLINK_FRAME_LENGTH_BYTES		15
+#define SIGFOX_API_DOWNLINK_MAC_LENGTH_BYTES		2 // Host downlink frame: payload (8 bytes), MAC (2 bytes) and padding.
+#define SIGFOX_API_DOWNLINK_DELAY_SECONDS			20 // Start of reception window after first frame.
+#define SIGFOX_API_DOWNLINK_WINDOW_US				25000000
+
+#define SIGFOX_API_AES_BLOCK_SIZE					16
+#define SIGFOX_API_TEST_DEVICE_ID					0xFEDCBA98
+
+/*** SIGFOX API local structures ***/
+
+// Session data allocated through MCU_API_malloc.
+typedef struct {
+	sfx_rc_t rc;
+	sfx_u32 config_words[SIGFOX_RC_STD_CONFIG_SIZE];
+	sfx_bool timer_enable;
+	sfx_u8 nv_mem[SFX_NVMEM_BLOCK_SIZE];
+	sfx_u8 device_id[ID_LENGTH];
+	sfx_u16 sequence_number;
+	sfx_u16 pn;
+	sfx_u8 fh_channel_idx;
+	sfx_u8 frame[SIGFOX_API_UPLINK_FRAME_LENGTH_MAX_BYTES];
+	sfx_u8 frame_length;
+	sfx_u8 dl_frame[SIGFOX_API_DOWNLINK_FRAME_LENGTH_BYTES];
+} SIGFOX_API_session_t;
+
+typedef struct {
+	sfx_state_t state;
+	SIGFOX_API_session_t* session;
+	sfx_u8 test_mode;
+} SIGFOX_API_context_t;
+
+/*** SIGFOX API local global variables ***/
+
+static SIGFOX_API_context_t sigfox_api_ctx = {.state = SFX_STATE_IDLE};
+// Frame types of the 3 repetitions for each uplink class (1 bit, 1 byte, 2-4 bytes, 5-8 bytes and 9-12 bytes).
+static const sfx_u16 sigfox_api_frame_type[SIGFOX_API_UPLINK_CLASS_NUMBER][SIGFOX_API_UPLINK_REPETITION_NUMBER] = {
+	{0x06B, 0x6E0, 0x034},
+	{0x08D, 0x0D2, 0x302},
+	{0x35F, 0x598, 0x5A3},
+	{0x611, 0x6BF, 0x72C},
+	{0x94C, 0x971, 0x997}
+};
+// Header, ID, payload and MAC length of each uplink class.
+static const sfx_u8 sigfox_api_body_length[SIGFOX_API_UPLINK_CLASS_NUMBER] = {8, 9, 12, 16, 20};
+static const sfx_rc_t sigfox_api_rc_list[SFX_RC_LIST_MAX_SIZE] = {RC1, RC2, RC3A, RC3C, RC4, RC5, RC6, RC7, RC101};
+static const sfx_u8 sigfox_api_test_key[SIGFOX_API_AES_BLOCK_SIZE] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+
+/*** SIGFOX API local functions ***/
+
+/* BUILD SIGFOX ERROR CODE.
+ * @param manuf_error:	MCU_API or RF_API error code.
+ * @param sigfox_error:	Library error code.
+ * @return:				Composed error code.
+ */
+static sfx_error_t SIGFOX_API_error(sfx_u8 manuf_error, sfx_u8 sigfox_error) {
+	return (sfx_error_t) ((manuf_error << 8) | sigfox_error);
+}
+
+/* COMPUTE NEXT PSEUDO-RANDOM VALUE (16-BITS GALOIS LFSR).
+ * @param pn:	Current value.
+ * @return:		Next value.
+ */
+static sfx_u16 SIGFOX_API_next_pn(sfx_u16 pn) {
+	// Avoid locked state.
+	if (pn == 0) pn = 0x1FF;
+	return (pn & 0x0001) ? ((pn >> 1) ^ 0xB400) : (pn >> 1);
+}
+
+/* COMPUTE UPLINK CRC (CRC16-CCITT, INVERTED OUTPUT).
+ * @param data:			Input bytes.
+ * @param data_length:	Number of bytes.
+ * @return:				CRC value.
+ */
+static sfx_u16 SIGFOX_API_compute_crc(sfx_u8* data, sfx_u8 data_length) {
+	// Local variables.
+	sfx_u16 crc = 0;
+	sfx_u8 byte_idx = 0;
+	sfx_u8 bit_idx = 0;
+	// Polynomial division.
+	for (byte_idx=0 ; byte_idx<data_length ; byte_idx++) {
+		crc ^= (data[byte_idx] << 8);
+		for (bit_idx=0 ; bit_idx<8 ; bit_idx++) {
+			crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+		}
+	}
+	return (crc ^ 0xFFFF);
+}
+
+/* COMPUTE A MAC WITH MCU_API AES (CBC-MAC OF THE INPUT REPEATED UP TO A BLOCK BOUNDARY).
+ * @param data:			Input bytes.
+ * @param data_length:	Number of bytes.
+ * @param mac:			Output MAC.
+ * @param mac_length:	Number of MAC bytes.
+ * @return sfx_err:		MCU_API error code.
+ */
+static sfx_u8 SIGFOX_API_compute_mac(sfx_u8* data, sfx_u8 data_length, sfx_u8* mac, sfx_u8 mac_length) {
+	// Local variables.
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	sfx_u8 mac_input[2 * SIGFOX_API_AES_BLOCK_SIZE];
+	sfx_u8 mac_output[2 * SIGFOX_API_AES_BLOCK_SIZE];
+	sfx_u8 mac_input_length = (data_length > SIGFOX_API_AES_BLOCK_SIZE) ? (2 * SIGFOX_API_AES_BLOCK_SIZE) : SIGFOX_API_AES_BLOCK_SIZE;
+	sfx_u8 byte_idx = 0;
+	// Pad by repeating input data.
+	for (byte_idx=0 ; byte_idx<mac_input_length ; byte_idx++) mac_input[byte_idx] = data[byte_idx % data_length];
+	// Test modes use the public key.
+	if (sigfox_api_ctx.test_mode != 0) {
+		sfx_err = MCU_API_aes_128_cbc_encrypt(mac_output, mac_input, mac_input_length, (sfx_u8*) sigfox_api_test_key, CREDENTIALS_KEY_IN_ARGUMENT);
+	}
+	else {
+		sfx_err = MCU_API_aes_128_cbc_encrypt(mac_output, mac_input, mac_input_length, (sfx_u8*) sigfox_api_test_key, CREDENTIALS_PRIVATE_KEY);
+	}
+	// MAC is the beginning of the last block.
+	for (byte_idx=0 ; byte_idx<mac_length ; byte_idx++) mac[byte_idx] = mac_output[mac_input_length - SIGFOX_API_AES_BLOCK_SIZE + byte_idx];
+	return sfx_err;
+}
+
+/* UPDATE SEQUENCE NUMBER AND DEVICE ID BEFORE A NEW MESSAGE.
+ * @param:			None.
+ * @return sfx_err:	Error code.
+ */
+static sfx_error_t SIGFOX_API_start_message(void) {
+	// Local variables.
+	SIGFOX_API_session_t* session = sigfox_api_ctx.session;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	sfx_bool payload_encryption_enabled = SFX_FALSE;
+	e_sfx_msg_counter_rollover rollover = SFX_MSG_COUNTER_ROLLOVER_4096;
+	sfx_u8 byte_idx = 0;
+	// Device ID.
+	sfx_err = MCU_API_get_device_id_and_payload_encryption_flag(session -> device_id, &payload_encryption_enabled);
+	if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_GET_DEVICE_ID);
+	if (sigfox_api_ctx.test_mode != 0) {
+		for (byte_idx=0 ; byte_idx<ID_LENGTH ; byte_idx++) session -> device_id[byte_idx] = (sfx_u8) (SIGFOX_API_TEST_DEVICE_ID >> (8 * byte_idx));
+	}
+	// Sequence number.
+	sfx_err = MCU_API_get_msg_counter_rollover(&rollover);
+	if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_GET_MSG_COUNTER_ROLLOVER);
+	session -> sequence_number = (session -> sequence_number + 1) % (64 << rollover);
+	session -> pn = SIGFOX_API_next_pn(session -> pn);
+	// Store counters before transmission (test modes do not affect device counters).
+	if (sigfox_api_ctx.test_mode == 0) {
+		session -> nv_mem[SFX_NVMEM_PN] = (sfx_u8) (session -> pn >> 0);
+		session -> nv_mem[SFX_NVMEM_PN + 1] = (sfx_u8) (session -> pn >> 8);
+		session -> nv_mem[SFX_NVMEM_MSG_COUNTER] = (sfx_u8) (session -> sequence_number >> 0);
+		session -> nv_mem[SFX_NVMEM_MSG_COUNTER + 1] = (sfx_u8) (session -> sequence_number >> 8);
+		session -> nv_mem[SFX_NVMEM_FH] = session -> fh_channel_idx;
+		sfx_err = MCU_API_set_nv_mem(session -> nv_mem);
+		if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_EXECUTE_COM_SEQUENCE_NVM_STORAGE_MESSAGE);
+	}
+	return SFX_ERR_NONE;
+}
+
+/* BUILD UPLINK FRAME BODY (HEADER, ID, PAYLOAD, MAC AND CRC).
+ * @param payload:			Customer data.
+ * @param payload_length:	Customer data length in bytes (0 for single bit frames).
+ * @param bit_value:		Value of single bit frames.
+ * @param downlink_flag:	Downlink request.
+ * @param oob_flag:			Out of band frame.
+ * @param frame_class:		Pointer to uplink class of the frame.
+ * @return sfx_err:			Error code.
+ */
+static sfx_error_t SIGFOX_API_build_frame(sfx_u8* payload, sfx_u8 payload_length, sfx_bool bit_value, sfx_bool downlink_flag, sfx_bool oob_flag, sfx_u8* frame_class) {
+	// Local variables.
+	SIGFOX_API_session_t* session = sigfox_api_ctx.session;
+	sfx_u8* body = &(session -> frame[SIGFOX_API_UPLINK_PREAMBLE_LENGTH_BYTES]);
+	sfx_u8 body_idx = 0;
+	sfx_u8 mac_length = 0;
+	sfx_u8 length_indicator = 0;
+	sfx_u8 byte_idx = 0;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	sfx_u16 crc = 0;
+	// Select class.
+	if (payload_length == 0) (*frame_class) = 0;
+	else if (payload_length == 1) (*frame_class) = 1;
+	else if (payload_length <= 4) (*frame_class) = 2;
+	else if (payload_length <= 8) (*frame_class) = 3;
+	else (*frame_class) = 4;
+	mac_length = sigfox_api_body_length[(*frame_class)] - SIGFOX_API_UPLINK_HEADER_LENGTH_BYTES - ID_LENGTH - payload_length;
+	// Length indicator gives the MAC length (or the bit value for single bit frames).
+	length_indicator = (payload_length == 0) ? (0b10 | (bit_value & 0b1)) : (mac_length - 2);
+	// Header.
+	body[body_idx++] = (length_indicator << 6) | ((downlink_flag & 0b1) << 5) | ((oob_flag & 0b1) << 4) | ((session -> sequence_number >> 8) & 0x0F);
+	body[body_idx++] = (sfx_u8) (session -> sequence_number);
+	// Device ID (little endian).
+	for (byte_idx=0 ; byte_idx<ID_LENGTH ; byte_idx++) body[body_idx++] = session -> device_id[byte_idx];
+	// Payload.
+	for (byte_idx=0 ; byte_idx<payload_length ; byte_idx++) body[body_idx++] = payload[byte_idx];
+	// MAC.
+	sfx_err = SIGFOX_API_compute_mac(body, body_idx, &(body[body_idx]), mac_length);
+	if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_BUILD_FRAME);
+	body_idx += mac_length;
+	// CRC.
+	crc = SIGFOX_API_compute_crc(body, body_idx);
+	body[body_idx++] = (sfx_u8) (crc >> 8);
+	body[body_idx++] = (sfx_u8) (crc >> 0);
+	session -> frame_length = SIGFOX_API_UPLINK_PREAMBLE_LENGTH_BYTES + body_idx;
+	return SFX_ERR_NONE;
+}
+
+/* COMPUTE UPLINK FREQUENCY OF A REPETITION.
+ * @param:	None.
+ * @return:	Frequency in Hz.
+ */
+static sfx_u32 SIGFOX_API_get_uplink_frequency(void) {
+	// Local variables.
+	SIGFOX_API_session_t* session = sigfox_api_ctx.session;
+	sfx_u32 center_frequency = session -> rc.open_tx_frequency;
+	sfx_u32 span = session -> rc.macro_channel_width - (2 * SIGFOX_API_UPLINK_GUARD_HZ);
+	sfx_u8 channel_idx = 0;
+	// Frequency hopping: next enabled macro channel.
+	if (session -> rc.spectrum_access == SFX_FH) {
+		for (channel_idx=0 ; channel_idx<(32 * SIGFOX_RC_STD_CONFIG_SIZE) ; channel_idx++) {
+			session -> fh_channel_idx = (session -> fh_channel_idx + 1) % (32 * SIGFOX_RC_STD_CONFIG_SIZE);
+			if ((session -> config_words[session -> fh_channel_idx / 32] & (0b1 << (session -> fh_channel_idx % 32))) != 0) break;
+		}
+		center_frequency += (session -> fh_channel_idx * SIGFOX_API_FH_CHANNEL_SPACING_HZ);
+	}
+	// Random channel in macro channel.
+	session -> pn = SIGFOX_API_next_pn(session -> pn);
+	return (center_frequency - (span / 2) + ((session -> pn * span) / 0xFFFF));
+}
+
+/* PERFORM LISTEN BEFORE TALK BEFORE FIRST FRAME.
+ * @param:			None.
+ * @return sfx_err:	Error code.
+ */
+static sfx_error_t SIGFOX_API_carrier_sense(void) {
+	// Local variables.
+	SIGFOX_API_session_t* session = sigfox_api_ctx.session;
+	sfx_rx_state_enum_t cs_state = DL_PASSED;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	sfx_u32 attempt_idx = 0;
+	// Attempts loop (config word 0 gives the number of retries and config word 1 the carrier sense window).
+	for (attempt_idx=0 ; attempt_idx<=(session -> config_words[0]) ; attempt_idx++) {
+		if (attempt_idx > 0) {
+			sfx_err = MCU_API_delay(SFX_DLY_CS_SLEEP);
+			if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_CS_RETRY_DELAY_ATTEMPT);
+		}
+		sfx_err = RF_API_init(SFX_RF_MODE_CS200K_RX);
+		if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_CS_RETRY);
+		sfx_err = RF_API_change_frequency(session -> rc.specific_rc.open_cs_frequency);
+		if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_CS_RETRY);
+		sfx_err = MCU_API_timer_start_carrier_sense((sfx_u16) session -> config_words[1]);
+		if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_CS_RETRY_START_TIMER);
+		cs_state = DL_PASSED;
+		sfx_err = RF_API_wait_for_clear_channel(SIGFOX_API_LBT_CS_MIN_MS, session -> rc.specific_rc.cs_threshold, &cs_state);
+		if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_CS_RETRY);
+		sfx_err = MCU_API_timer_stop_carrier_sense();
+		if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_CS_RETRY_STOP_TIMER);
+		sfx_err = RF_API_stop();
+		if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_CS_RETRY);
+		if (cs_state == DL_PASSED) return SFX_ERR_NONE;
+	}
+	return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_INT_PROCESS_UPLINK_CS_TIMEOUT);
+}
+
+/* SEND ONE FRAME (RADIO INIT, FREQUENCY, MODULATION AND STOP).
+ * @param frequency:	Uplink frequency in Hz.
+ * @return sfx_err:		Error code.
+ */
+static sfx_error_t SIGFOX_API_send_single_frame(sfx_u32 frequency) {
+	// Local variables.
+	SIGFOX_API_session_t* session = sigfox_api_ctx.session;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	sfx_u8 byte_idx = 0;
+	// Trace frame.
+	fprintf(stderr, "HOST: SIGFOX uplink %lu Hz ", (unsigned long) frequency);
+	for (byte_idx=0 ; byte_idx<(session -> frame_length) ; byte_idx++) fprintf(stderr, "%02X", session -> frame[byte_idx]);
+	fprintf(stderr, "\n");
+	// Radio sequence.
+	sfx_err = RF_API_init(SFX_RF_MODE_TX);
+	if (sfx_err != SFX_ERR_NONE) goto errors;
+	sfx_err = RF_API_change_frequency(frequency);
+	if (sfx_err != SFX_ERR_NONE) goto errors;
+	DBPSK_MODEL_start_frame();
+	sfx_err = RF_API_send(session -> frame, session -> rc.modulation, session -> frame_length);
+	if (sfx_err != SFX_ERR_NONE) goto errors;
+	// Check modulator input against golden model.
+	DBPSK_MODEL_check_frame(session -> frame, session -> frame_length);
+	sfx_err = RF_API_stop();
+	if (sfx_err != SFX_ERR_NONE) goto errors;
+	return SFX_ERR_NONE;
+errors:
+	RF_API_stop();
+	return SIGFOX_API_error(sfx_err, SFX_ERR_INT_SEND_SINGLE_FRAME);
+}
+
+/* SEND THE REPETITIONS OF THE CURRENT FRAME BODY.
+ * @param frame_class:			Uplink class of the frame.
+ * @param number_of_frames:		Number of repetitions (1 or 3).
+ * @param downlink_flag:		Downlink request (starts the downlink timer).
+ * @return sfx_err:				Error code.
+ */
+static sfx_error_t SIGFOX_API_send_repetitions(sfx_u8 frame_class, sfx_u8 number_of_frames, sfx_bool downlink_flag) {
+	// Local variables.
+	SIGFOX_API_session_t* session = sigfox_api_ctx.session;
+	sfx_error_t sfx_status = SFX_ERR_NONE;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	sfx_u8 repetition_idx = 0;
+	// Preamble.
+	session -> frame[0] = 0xAA;
+	session -> frame[1] = 0xAA;
+	// Listen before talk.
+	if (session -> rc.spectrum_access == SFX_LBT) {
+		sfx_status = SIGFOX_API_carrier_sense();
+		if (sfx_status != SFX_ERR_NONE) return sfx_status;
+	}
+	// Downlink window is referenced to the first frame.
+	if (downlink_flag != SFX_FALSE) {
+		sfx_err = MCU_API_timer_start(SIGFOX_API_DOWNLINK_DELAY_SECONDS);
+		if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_TIMER_DOWNLINK);
+	}
+	for (repetition_idx=0 ; repetition_idx<number_of_frames ; repetition_idx++) {
+		// Inter-frame delay.
+		if (repetition_idx > 0) {
+			if ((session -> rc.spectrum_access == SFX_FH) && (session -> timer_enable != SFX_FALSE) && (downlink_flag == SFX_FALSE)) {
+				sfx_err = MCU_API_timer_start(SIGFOX_API_FH_TIMER_SECONDS);
+				if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_TIMER_FH);
+				sfx_err = MCU_API_timer_wait_for_end();
+				if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_WAIT_FOR_END_TIMER_FH);
+			}
+			else {
+				sfx_err = MCU_API_delay((downlink_flag != SFX_FALSE) ? SFX_DLY_INTER_FRAME_TRX : SFX_DLY_INTER_FRAME_TX);
+				if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_UPLINK_DELAY_INTERFRAME);
+			}
+		}
+		// Frame type.
+		session -> frame[2] = 0xA0 | (sigfox_api_frame_type[frame_class][repetition_idx] >> 8);
+		session -> frame[3] = (sfx_u8) (sigfox_api_frame_type[frame_class][repetition_idx]);
+		sfx_status = SIGFOX_API_send_single_frame(SIGFOX_API_get_uplink_frequency());
+		if (sfx_status != SFX_ERR_NONE) return sfx_status;
+	}
+	return SFX_ERR_NONE;
+}
+
+/* CHECK THE MAC OF A HOST DOWNLINK FRAME.
+ * @param dl_frame:	Received frame.
+ * @param valid:	Pointer to authentication result.
+ * @return sfx_err:	MCU_API error code.
+ */
+static sfx_u8 SIGFOX_API_authenticate_downlink(sfx_u8* dl_frame, sfx_u8* valid) {
+	// Local variables.
+	SIGFOX_API_session_t* session = sigfox_api_ctx.session;
+	sfx_u8 mac_input[SIGFOX_API_AES_BLOCK_SIZE] = {0};
+	sfx_u8 mac[SIGFOX_API_DOWNLINK_MAC_LENGTH_BYTES];
+	sfx_u8 byte_idx = 0;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	// MAC input: payload, device ID and sequence number.
+	for (byte_idx=0 ; byte_idx<SIGFOX_DOWNLINK_DATA_SIZE_BYTES ; byte_idx++) mac_input[byte_idx] = dl_frame[byte_idx];
+	for (byte_idx=0 ; byte_idx<ID_LENGTH ; byte_idx++) mac_input[SIGFOX_DOWNLINK_DATA_SIZE_BYTES + byte_idx] = session -> device_id[byte_idx];
+	mac_input[SIGFOX_DOWNLINK_DATA_SIZE_BYTES + ID_LENGTH + 0] = (sfx_u8) (session -> sequence_number >> 0);
+	mac_input[SIGFOX_DOWNLINK_DATA_SIZE_BYTES + ID_LENGTH + 1] = (sfx_u8) (session -> sequence_number >> 8);
+	sfx_err = SIGFOX_API_compute_mac(mac_input, SIGFOX_API_AES_BLOCK_SIZE, mac, SIGFOX_API_DOWNLINK_MAC_LENGTH_BYTES);
+	// Compare.
+	(*valid) = 1;
+	for (byte_idx=0 ; byte_idx<SIGFOX_API_DOWNLINK_MAC_LENGTH_BYTES ; byte_idx++) {
+		if (dl_frame[SIGFOX_DOWNLINK_DATA_SIZE_BYTES + byte_idx] != mac[byte_idx]) (*valid) = 0;
+	}
+	if ((*valid) == 0) {
+		fprintf(stderr, "HOST: SIGFOX downlink frame rejected (expected MAC %02X%02X)\n", mac[0], mac[1]);
+	}
+	return sfx_err;
+}
+
+/* WAIT FOR DOWNLINK FRAME AND SEND OUT OF BAND ACKNOWLEDGE.
+ * @param customer_response:	Downlink payload.
+ * @return sfx_err:				Error code.
+ */
+static sfx_error_t SIGFOX_API_process_downlink(sfx_u8* customer_response) {
+	// Local variables.
+	SIGFOX_API_session_t* session = sigfox_api_ctx.session;
+	sfx_error_t sfx_status = SFX_ERR_NONE;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	sfx_rx_state_enum_t rx_state = DL_TIMEOUT;
+	sfx_s16 rssi = 0;
+	sfx_u8 dl_valid = 0;
+	sfx_u8 oob_payload[SIGFOX_API_UPLINK_OOB_PAYLOAD_LENGTH_BYTES];
+	sfx_u16 voltage_idle = 0;
+	sfx_u16 voltage_tx = 0;
+	sfx_s16 temperature = 0;
+	sfx_u8 frame_class = 0;
+	sfx_u8 byte_idx = 0;
+	unsigned long long window_start_us = 0;
+	// Wait for reception window.
+	sigfox_api_ctx.state = SFX_STATE_DOWNLINK;
+	sfx_err = MCU_API_timer_wait_for_end();
+	if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_PROCESS_DOWNLINK);
+	// Reception.
+	sfx_err = RF_API_init(SFX_RF_MODE_RX);
+	if (sfx_err != SFX_ERR_NONE) goto rf_errors;
+	sfx_err = RF_API_change_frequency(session -> rc.open_rx_frequency);
+	if (sfx_err != SFX_ERR_NONE) goto rf_errors;
+	window_start_us = HOST_get_time_us();
+	while ((HOST_get_time_us() - window_start_us) < SIGFOX_API_DOWNLINK_WINDOW_US) {
+		RF_API_wait_frame(session -> dl_frame, &rssi, &rx_state);
+		if (rx_state != DL_PASSED) break;
+		sfx_err = SIGFOX_API_authenticate_downlink(session -> dl_frame, &dl_valid);
+		if (sfx_err != SFX_ERR_NONE) goto rf_errors;
+		if (dl_valid != 0) break;
+	}
+	RF_API_stop();
+	if (dl_valid == 0) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_INT_GET_RECEIVED_FRAMES_TIMEOUT);
+	for (byte_idx=0 ; byte_idx<SIGFOX_DOWNLINK_DATA_SIZE_BYTES ; byte_idx++) customer_response[byte_idx] = session -> dl_frame[byte_idx];
+	// Out of band acknowledge.
+	sfx_err = MCU_API_delay(SFX_DLY_OOB_ACK);
+	if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_EXECUTE_COM_SEQUENCE_DELAY_OOB_ACK);
+	sfx_err = MCU_API_get_voltage_temperature(&voltage_idle, &voltage_tx, &temperature);
+	if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_BUILD_FRAME_OOB_DOWNLINK_ACK);
+	oob_payload[0] = (sfx_u8) (voltage_idle >> 0);
+	oob_payload[1] = (sfx_u8) (voltage_idle >> 8);
+	oob_payload[2] = (sfx_u8) (voltage_tx >> 0);
+	oob_payload[3] = (sfx_u8) (voltage_tx >> 8);
+	oob_payload[4] = (sfx_u8) (temperature >> 0);
+	oob_payload[5] = (sfx_u8) (temperature >> 8);
+	oob_payload[6] = (sfx_u8) (rssi);
+	oob_payload[7] = 0;
+	sigfox_api_ctx.state = SFX_STATE_UPLINK;
+	sfx_status = SIGFOX_API_start_message();
+	if (sfx_status != SFX_ERR_NONE) return sfx_status;
+	sfx_status = SIGFOX_API_build_frame(oob_payload, SIGFOX_API_UPLINK_OOB_PAYLOAD_LENGTH_BYTES, SFX_FALSE, SFX_FALSE, SFX_TRUE, &frame_class);
+	if (sfx_status != SFX_ERR_NONE) return sfx_status;
+	return SIGFOX_API_send_repetitions(frame_class, 1, SFX_FALSE);
+rf_errors:
+	RF_API_stop();
+	return SIGFOX_API_error(sfx_err, SFX_ERR_INT_GET_RECEIVED_FRAMES);
+}
+
+/* EXECUTE A COMPLETE UPLINK (AND OPTIONAL DOWNLINK) SEQUENCE.
+ * @param payload:				Customer data.
+ * @param payload_length:		Customer data length in bytes (0 for single bit frames).
+ * @param bit_value:			Value of single bit frames.
+ * @param customer_response:	Downlink payload.
+ * @param tx_mode:				Number of repetitions (0 for a single frame).
+ * @param downlink_flag:		Downlink request.
+ * @param oob_flag:				Out of band frame.
+ * @return sfx_err:				Error code.
+ */
+static sfx_error_t SIGFOX_API_execute_sequence(sfx_u8* payload, sfx_u8 payload_length, sfx_bool bit_value, sfx_u8* customer_response, sfx_u8 tx_mode, sfx_bool downlink_flag, sfx_bool oob_flag) {
+	// Local variables.
+	sfx_error_t sfx_status = SFX_ERR_NONE;
+	sfx_u8 frame_class = 0;
+	sfx_u8 number_of_frames = ((tx_mode == 0) && (downlink_flag == SFX_FALSE)) ? 1 : SIGFOX_API_UPLINK_REPETITION_NUMBER;
+	// Check state.
+	if (sigfox_api_ctx.state != SFX_STATE_READY) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_INT_EXECUTE_COM_SEQUENCE_STATE);
+	sigfox_api_ctx.state = SFX_STATE_UPLINK;
+	// Uplink.
+	sfx_status = SIGFOX_API_start_message();
+	if (sfx_status != SFX_ERR_NONE) goto end;
+	sfx_status = SIGFOX_API_build_frame(payload, payload_length, bit_value, downlink_flag, oob_flag, &frame_class);
+	if (sfx_status != SFX_ERR_NONE) goto end;
+	sfx_status = SIGFOX_API_send_repetitions(frame_class, number_of_frames, downlink_flag);
+	if (sfx_status != SFX_ERR_NONE) goto end;
+	// Downlink.
+	if (downlink_flag != SFX_FALSE) {
+		sfx_status = SIGFOX_API_process_downlink(customer_response);
+	}
+end:
+	MCU_API_timer_stop();
+	sigfox_api_ctx.state = SFX_STATE_READY;
+	return sfx_status;
+}
+
+/*** SIGFOX API functions ***/
+
+sfx_error_t SIGFOX_API_open(sfx_rc_t* rc) {
+	// Local variables.
+	SIGFOX_API_session_t* session = 0;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	sfx_u8 word_idx = 0;
+	// Check parameters.
+	if (sigfox_api_ctx.state != SFX_STATE_IDLE) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_API_OPEN_STATE);
+	if (rc == 0) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_API_OPEN_RC_PTR);
+	// Allocate session.
+	sfx_err = MCU_API_malloc(sizeof(SIGFOX_API_session_t), (sfx_u8**) &session);
+	if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_API_OPEN);
+	session -> rc = (*rc);
+	session -> timer_enable = SFX_FALSE;
+	for (word_idx=0 ; word_idx<SIGFOX_RC_STD_CONFIG_SIZE ; word_idx++) session -> config_words[word_idx] = 0;
+	// Read counters.
+	sfx_err = MCU_API_get_nv_mem(session -> nv_mem);
+	if (sfx_err != SFX_ERR_NONE) {
+		MCU_API_free((sfx_u8*) session);
+		return SIGFOX_API_error(sfx_err, SFX_ERR_API_OPEN);
+	}
+	session -> pn = (session -> nv_mem[SFX_NVMEM_PN + 1] << 8) | (session -> nv_mem[SFX_NVMEM_PN]);
+	session -> sequence_number = (session -> nv_mem[SFX_NVMEM_MSG_COUNTER + 1] << 8) | (session -> nv_mem[SFX_NVMEM_MSG_COUNTER]);
+	session -> fh_channel_idx = session -> nv_mem[SFX_NVMEM_FH];
+	sigfox_api_ctx.session = session;
+	// FH and LBT configurations require config words.
+	sigfox_api_ctx.state = (rc -> spectrum_access == SFX_DC) ? SFX_STATE_READY : SFX_STATE_NOT_CONFIGURED;
+	return SFX_ERR_NONE;
+}
+
+sfx_error_t SIGFOX_API_close(void) {
+	// Local variables.
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	// Check state.
+	if ((sigfox_api_ctx.state != SFX_STATE_READY) && (sigfox_api_ctx.state != SFX_STATE_NOT_CONFIGURED)) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_API_CLOSE_STATE);
+	// Release session.
+	sfx_err = MCU_API_free((sfx_u8*) sigfox_api_ctx.session);
+	sigfox_api_ctx.session = 0;
+	sigfox_api_ctx.state = SFX_STATE_IDLE;
+	return (sfx_err == SFX_ERR_NONE) ? SFX_ERR_NONE : SIGFOX_API_error(sfx_err, SFX_ERR_API_CLOSE_FREE);
+}
+
+sfx_error_t SIGFOX_API_set_std_config(sfx_u32 config_words[3], sfx_bool timer_enable) {
+	// Local variables.
+	sfx_u8 word_idx = 0;
+	sfx_u32 config_or = 0;
+	// Check state.
+	if ((sigfox_api_ctx.state != SFX_STATE_READY) && (sigfox_api_ctx.state != SFX_STATE_NOT_CONFIGURED)) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_INT_EXECUTE_COM_SEQUENCE_STATE);
+	for (word_idx=0 ; word_idx<SIGFOX_RC_STD_CONFIG_SIZE ; word_idx++) {
+		sigfox_api_ctx.session -> config_words[word_idx] = config_words[word_idx];
+		config_or |= config_words[word_idx];
+	}
+	sigfox_api_ctx.session -> timer_enable = timer_enable;
+	// At least one macro channel is required for frequency hopping.
+	if ((sigfox_api_ctx.session -> rc.spectrum_access == SFX_FH) && (config_or == 0)) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_API_SET_STD_CONFIG_FH_CHANNELS);
+	sigfox_api_ctx.state = SFX_STATE_READY;
+	return SFX_ERR_NONE;
+}
+
+sfx_error_t SIGFOX_API_send_frame(sfx_u8* customer_data, sfx_u8 customer_data_length, sfx_u8* customer_response, sfx_u8 tx_mode, sfx_bool initiate_downlink_flag) {
+	// Check parameters.
+	if (customer_data_length > SIGFOX_UPLINK_DATA_MAX_SIZE_BYTES) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_API_SEND_FRAME_DATA_LENGTH);
+	if ((customer_data == 0) && (customer_data_length != 0)) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_API_SEND_FRAME_DATA_PTR);
+	if ((initiate_downlink_flag != SFX_FALSE) && (customer_response == 0)) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_API_SEND_FRAME_RESPONSE_PTR);
+	// Empty frames are sent as a single bit.
+	return SIGFOX_API_execute_sequence(customer_data, customer_data_length, SFX_FALSE, customer_response, tx_mode, initiate_downlink_flag, SFX_FALSE);
+}
+
+sfx_error_t SIGFOX_API_send_bit(sfx_bool bit_value, sfx_u8* customer_response, sfx_u8 tx_mode, sfx_bool initiate_downlink_flag) {
+	// Check parameters.
+	if ((initiate_downlink_flag != SFX_FALSE) && (customer_response == 0)) return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_API_SEND_BIT_RESPONSE_PTR);
+	return SIGFOX_API_execute_sequence(0, 0, bit_value, customer_response, tx_mode, initiate_downlink_flag, SFX_FALSE);
+}
+
+sfx_error_t SIGFOX_API_send_outofband(sfx_oob_enum_t oob_type) {
+	// Local variables.
+	sfx_u8 oob_payload[SIGFOX_API_UPLINK_OOB_PAYLOAD_LENGTH_BYTES] = {0};
+	sfx_u16 voltage_idle = 0;
+	sfx_u16 voltage_tx = 0;
+	sfx_s16 temperature = 0;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	// Check type.
+	switch (oob_type) {
+	case SFX_OOB_SERVICE:
+		// Voltages and temperature.
+		sfx_err = MCU_API_get_voltage_temperature(&voltage_idle, &voltage_tx, &temperature);
+		if (sfx_err != SFX_ERR_NONE) return SIGFOX_API_error(sfx_err, SFX_ERR_INT_BUILD_FRAME_OOB_SERVICE);
+		oob_payload[0] = (sfx_u8) (voltage_idle >> 0);
+		oob_payload[1] = (sfx_u8) (voltage_idle >> 8);
+		oob_payload[2] = (sfx_u8) (voltage_tx >> 0);
+		oob_payload[3] = (sfx_u8) (voltage_tx >> 8);
+		oob_payload[4] = (sfx_u8) (temperature >> 0);
+		oob_payload[5] = (sfx_u8) (temperature >> 8);
+		break;
+	case SFX_OOB_RC_SYNC:
+		// Empty payload.
+		break;
+	default:
+		return SIGFOX_API_error(SFX_ERR_NONE, SFX_ERR_API_SEND_OOB_TYPE);
+	}
+	return SIGFOX_API_execute_sequence(oob_payload, SIGFOX_API_UPLINK_OOB_PAYLOAD_LENGTH_BYTES, SFX_FALSE, 0, 2, SFX_FALSE, SFX_TRUE);
+}
+
+/*** SIGFOX ADDON functions ***/
+
+sfx_error_t ADDON_SIGFOX_RF_PROTOCOL_API_test_mode(sfx_rc_enum_t rc_enum, sfx_test_mode_t test_mode) {
+	// Local variables.
+	sfx_rc_t rc;
+	sfx_u32 config_words[SIGFOX_RC_STD_CONFIG_SIZE] = {0};
+	sfx_error_t sfx_status = SFX_ERR_NONE;
+	sfx_u8 sfx_err = SFX_ERR_NONE;
+	sfx_u8 payload[SIGFOX_UPLINK_DATA_MAX_SIZE_BYTES];
+	sfx_u8 dl_payload[SIGFOX_DOWNLINK_DATA_SIZE_BYTES];
+	sfx_u8 dl_frame[SIGFOX_API_DOWNLINK_FRAME_LENGTH_BYTES];
+	sfx_rx_state_enum_t rx_state = DL_TIMEOUT;
+	sfx_s16 rssi = 0;
+	sfx_u8 test_result = 0;
+	sfx_u8 payload_length = 0;
+	sfx_u8 byte_idx = 0;
+	sfx_u16 pn = 0x1FF;
+	// Check RC.
+	if (rc_enum >= SFX_RC_LIST_MAX_SIZE) return SIGFOX_API_error(SFX_ERR_NONE, SFX_RF_PROTOCOL_ERR_API_WRONG_RC_ENUM);
+	rc = sigfox_api_rc_list[rc_enum];
+	// Default configuration words.
+	if (rc.spectrum_access == SFX_FH) {
+		config_words[0] = (rc_enum == SFX_RC2) ? RC2_SET_STD_CONFIG_SM_WORD_0 : RC4_SET_STD_CONFIG_SM_WORD_0;
+		config_words[1] = (rc_enum == SFX_RC2) ? RC2_SET_STD_CONFIG_SM_WORD_1 : RC4_SET_STD_CONFIG_SM_WORD_1;
+		config_words[2] = (rc_enum == SFX_RC2) ? RC2_SET_STD_CONFIG_SM_WORD_2 : RC4_SET_STD_CONFIG_SM_WORD_2;
+	}
+	if (rc.spectrum_access == SFX_LBT) {
+		config_words[0] = 3;
+		config_words[1] = 5000;
+	}
+	// Open library with test credentials.
+	sfx_status = SIGFOX_API_open(&rc);
+	if (sfx_status != SFX_ERR_NONE) return sfx_status;
+	SIGFOX_API_set_std_config(config_words, SFX_FALSE);
+	sigfox_api_ctx.test_mode = 1;
+	switch (test_mode) {
+	case SFX_TEST_MODE_TX_BPSK:
+		// Single frame with PN sequence payload.
+		for (byte_idx=0 ; byte_idx<SIGFOX_UPLINK_DATA_MAX_SIZE_BYTES ; byte_idx++) {
+			pn = SIGFOX_API_next_pn(pn);
+			payload[byte_idx] = (sfx_u8) pn;
+		}
+		sfx_status = SIGFOX_API_send_frame(payload, SIGFOX_UPLINK_DATA_MAX_SIZE_BYTES, 0, 0, SFX_FALSE);
+		break;
+	case SFX_TEST_MODE_TX_PROTOCOL:
+		// All frame classes.
+		sfx_status = SIGFOX_API_send_bit(SFX_FALSE, 0, 2, SFX_FALSE);
+		if (sfx_status != SFX_ERR_NONE) break;
+		sfx_status = SIGFOX_API_send_bit(SFX_TRUE, 0, 2, SFX_FALSE);
+		if (sfx_status != SFX_ERR_NONE) break;
+		for (payload_length=1 ; payload_length<=SIGFOX_UPLINK_DATA_MAX_SIZE_BYTES ; payload_length++) {
+			payload[payload_length - 1] = payload_length;
+			sfx_status = SIGFOX_API_send_frame(payload, payload_length, 0, 2, SFX_FALSE);
+			if (sfx_status != SFX_ERR_NONE) break;
+		}
+		if (sfx_status != SFX_ERR_NONE) break;
+		sfx_status = SIGFOX_API_send_outofband(SFX_OOB_SERVICE);
+		break;
+	case SFX_TEST_MODE_RX_PROTOCOL:
+	case SFX_TEST_MODE_RX_SENSI:
+		// Uplink with downlink request.
+		for (byte_idx=0 ; byte_idx<SIGFOX_UPLINK_DATA_MAX_SIZE_BYTES ; byte_idx++) payload[byte_idx] = byte_idx;
+		sfx_status = SIGFOX_API_send_frame(payload, SIGFOX_UPLINK_DATA_MAX_SIZE_BYTES, dl_payload, 2, SFX_TRUE);
+		break;
+	case SFX_TEST_MODE_RX_GFSK:
+		// Compare received frames with PN sequence until timeout.
+		sfx_err = RF_API_init(SFX_RF_MODE_RX);
+		if (sfx_err != SFX_ERR_NONE) goto rf_errors;
+		sfx_err = RF_API_change_frequency(rc.open_rx_frequency);
+		if (sfx_err != SFX_ERR_NONE) goto rf_errors;
+		while (1) {
+			RF_API_wait_frame(dl_frame, &rssi, &rx_state);
+			if (rx_state != DL_PASSED) break;
+			pn = 0x1FF;
+			test_result = 1;
+			for (byte_idx=0 ; byte_idx<SIGFOX_API_DOWNLINK_FRAME_LENGTH_BYTES ; byte_idx++) {
+				pn = SIGFOX_API_next_pn(pn);
+				if (dl_frame[byte_idx] != (sfx_u8) pn) test_result = 0;
+			}
+			sfx_err = MCU_API_report_test_result(test_result, rssi);
+			if (sfx_err != SFX_ERR_NONE) {
+				sfx_status = SIGFOX_API_error(sfx_err, SFX_RF_PROTOCOL_ERR_API_REPORT_TEST);
+				break;
+			}
+		}
+		RF_API_stop();
+		break;
+	case SFX_TEST_MODE_TX_SYNTH:
+		// Single frames over the macro channel.
+		for (byte_idx=0 ; byte_idx<9 ; byte_idx++) {
+			sfx_status = SIGFOX_API_send_bit(SFX_FALSE, 0, 0, SFX_FALSE);
+			if (sfx_status != SFX_ERR_NONE) break;
+		}
+		break;
+	case SFX_TEST_MODE_TX_BIT:
+		// Two single bit messages.
+		sfx_status = SIGFOX_API_send_bit(SFX_FALSE, 0, 2, SFX_FALSE);
+		if (sfx_status != SFX_ERR_NONE) break;
+		sfx_status = SIGFOX_API_send_bit(SFX_TRUE, 0, 2, SFX_FALSE);
+		break;
+	default:
+		sfx_status = SIGFOX_API_error(SFX_ERR_NONE, SFX_RF_PROTOCOL_ERR_API_TEST_MODE_UNKNOWN);
+		break;
+	}
+	goto end;
+rf_errors:
+	RF_API_stop();
+	sfx_status = SIGFOX_API_error(sfx_err, SFX_RF_PROTOCOL_ERR_API_TX_DBPSK);
+end:
+	sigfox_api_ctx.test_mode = 0;
+	SIGFOX_API_close();
+	return sfx_status;
+}
+
+#endif /* HOST */
@@ -0,0 +1,124 @@
+/*
+ * spi_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "bus.h"
+#include "dma_model.h"
+#include "host.h"
+#include "s2lp_model.h"
+#include "spi_reg.h"
+#include <stddef.h>
+
+/*** SPI MODEL local macros ***/
+
+#define SPI_MODEL_SR_RESET		0x00000002 // TXE.
+#define SPI_MODEL_BITS_PER_BYTE	8
+
+/*** SPI MODEL callbacks declaration ***/
+
+static void SPI_MODEL_transfer_event_callback(void);
+
+/*** SPI MODEL local structures ***/
+
+typedef struct {
+	SPI_base_address_t* spi;
+	unsigned char miso;
+	HOST_event_t transfer_event;
+} SPI_MODEL_context_t;
+
+/*** SPI MODEL local global variables ***/
+
+static SPI_MODEL_context_t spi_model_ctx;
+
+/*** SPI MODEL local functions ***/
+
+/* UPDATE SPI1 TX DMA REQUEST.
+ * @param:	None.
+ * @return:	None.
+ */
+static void SPI_MODEL_update_dma_request(void) {
+	// Local variables.
+	unsigned char request = 0;
+	if ((((spi_model_ctx.spi -> SR) & (0b1 << 1)) != 0) && (((spi_model_ctx.spi -> CR2) & (0b1 << 1)) != 0) && (((spi_model_ctx.spi -> CR1) & (0b1 << 6)) != 0)) {
+		request = 1; // TXE='1', TXDMAEN='1' and SPE='1'.
+	}
+	DMA_MODEL_set_request(DMA_MODEL_REQUEST_SPI1_TX, request);
+}
+
+/* END OF BYTE TRANSFER.
+ * @param:	None.
+ * @return:	None.
+ */
+static void SPI_MODEL_transfer_event_callback(void) {
+	spi_model_ctx.spi -> DR = spi_model_ctx.miso;
+	if (((spi_model_ctx.spi -> SR) & (0b1 << 0)) != 0) {
+		spi_model_ctx.spi -> SR |= (0b1 << 6); // OVR='1'.
+	}
+	spi_model_ctx.spi -> SR |= (0b1 << 0) | (0b1 << 1); // RXNE='1' and TXE='1'.
+	spi_model_ctx.spi -> SR &= ~(0b1 << 7); // BSY='0'.
+	SPI_MODEL_update_dma_request();
+}
+
+/* SPI REGISTERS READ CALLBACK.
+ * @param offset:	Register offset.
+ * @return:			None.
+ */
+static void SPI_MODEL_read_callback(unsigned int offset) {
+	// Reading the data register clears the reception flag.
+	if (offset != offsetof(SPI_base_address_t, DR)) return;
+	spi_model_ctx.spi -> SR &= ~(0b1 << 0);
+}
+
+/* SPI REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void SPI_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	// Local variables.
+	unsigned int byte_cycles = 0;
+	switch (offset) {
+	case offsetof(SPI_base_address_t, DR):
+		if (((spi_model_ctx.spi -> CR1) & (0b1 << 6)) == 0) break;
+		// Slave samples MOSI when the byte is written (chip select may be released right after the last write).
+		spi_model_ctx.miso = S2LP_MODEL_spi_transfer((unsigned char) ((spi_model_ctx.spi -> DR) & 0xFF));
+		// Received byte is available after 8 SCK periods (SCK = PCLK2 / 2^(BR+1)).
+		byte_cycles = (SPI_MODEL_BITS_PER_BYTE << ((((spi_model_ctx.spi -> CR1) >> 3) & 0b111) + 1));
+		spi_model_ctx.spi -> DR = previous_value;
+		spi_model_ctx.spi -> SR &= ~(0b1 << 1); // TXE='0'.
+		spi_model_ctx.spi -> SR |= (0b1 << 7); // BSY='1'.
+		HOST_start_event_at(&spi_model_ctx.transfer_event, (HOST_get_time_ns() + ((byte_cycles * 1000000ULL) / HOST_get_sysclk_khz())), &SPI_MODEL_transfer_event_callback);
+		break;
+	case offsetof(SPI_base_address_t, SR):
+		// CRCERR is cleared by writing '0', other bits are read-only.
+		spi_model_ctx.spi -> SR = previous_value & ((spi_model_ctx.spi -> SR) | ~(0b1 << 4));
+		break;
+	case offsetof(SPI_base_address_t, CR1):
+		if (((spi_model_ctx.spi -> CR1) & (0b1 << 6)) == 0) {
+			// Disabling the peripheral aborts the current byte.
+			HOST_stop_event(&spi_model_ctx.transfer_event);
+			spi_model_ctx.spi -> SR = SPI_MODEL_SR_RESET | ((spi_model_ctx.spi -> SR) & (0b1 << 0));
+		}
+		break;
+	default:
+		break;
+	}
+	SPI_MODEL_update_dma_request();
+}
+
+/* INIT SPI MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) SPI_MODEL_init(void) {
+	// Reset values.
+	spi_model_ctx.spi = BUS_map_peripheral((unsigned long) SPI1, sizeof(SPI_base_address_t), &SPI_MODEL_read_callback, &SPI_MODEL_write_callback);
+	spi_model_ctx.spi -> SR = SPI_MODEL_SR_RESET;
+}
+
+#endif /* HOST */
@@ -0,0 +1,152 @@
+/*
+ * startup.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** STARTUP local macros ***/
+
+#define STARTUP_STACK_SIZE	(1024 * 1024) // Larger than the MCU stack since host frames are bigger and models run on it.
+
+/*** STARTUP local structures ***/
+
+typedef void (*pFunc)(void);
+
+/*** STARTUP local global variables ***/
+
+// Firmware stack is located in the executable data segment: like any RAM buffer, its addresses fit in 32-bits DMA registers.
+static unsigned char startup_stack[STARTUP_STACK_SIZE] __attribute__((aligned(16)));
+
+/*** STARTUP local functions ***/
+
+int __real_main(void);
+
+/* DEFAULT INTERRUPT HANDLER.
+ * @param:	None.
+ * @return:	None.
+ */
+void Default_Handler(void) {
+	fprintf(stderr, "HOST: unexpected interrupt\n");
+	abort();
+}
+
+/* Cortex-M0+ Processor Exceptions */
+void NMI_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void HardFault_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SVC_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void PendSV_Handler(void) __attribute__((weak, alias("Default_Handler")));
+void SysTick_Handler(void) __attribute__((weak, alias("Default_Handler")));
+
+/* STM32L0 Specific Interrupts */
+void WWDG_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void PVD_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void RTC_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void FLASH_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void RCC_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void EXTI0_1_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void EXTI2_3_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void EXTI4_15_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void DMA1_Channel1_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void DMA1_Channel2_3_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void DMA1_Channel4_5_6_7_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void ADC1_COMP_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void LPTIM1_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void USART4_5_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void TIM2_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void TIM3_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void TIM6_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void TIM7_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void TIM21_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void I2C3_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void TIM22_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void I2C1_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void I2C2_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void SPI1_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void SPI2_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void USART1_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void USART2_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+void LPUART1_IRQHandler(void) __attribute__((weak, alias("Default_Handler")));
+
+/*** STARTUP global variables ***/
+
+// Same layout as the MCU vector table (read by the host core through SCB VTOR).
+const pFunc __Vectors[] = {
+	/* Cortex-M0+ Exceptions Handler */
+	0,									/* Initial Stack Pointer */
+	0,									/* Reset Handler */
+	NMI_Handler,						/* NMI Handler */
+	HardFault_Handler,					/* Hard Fault Handler */
+	0,									/* Reserved */
+	0,									/* Reserved */
+	0,									/* Reserved */
+	0,									/* Reserved */
+	0,									/* Reserved */
+	0,									/* Reserved */
+	0,									/* Reserved */
+	SVC_Handler,						/* SVCall Handler */
+	0,									/* Reserved */
+	0,									/* Reserved */
+	PendSV_Handler,						/* PendSV Handler */
+	SysTick_Handler,					/* SysTick Handler */
+	/* External interrupts */
+	WWDG_IRQHandler,					/* Window WatchDog */
+	PVD_IRQHandler,						/* PVD through EXTI Line detection */
+	RTC_IRQHandler,						/* RTC through the EXTI line */
+	FLASH_IRQHandler,					/* FLASH */
+	RCC_IRQHandler,						/* RCC */
+	EXTI0_1_IRQHandler,					/* EXTI Line 0 and 1 */
+	EXTI2_3_IRQHandler,					/* EXTI Line 2 and 3 */
+	EXTI4_15_IRQHandler,				/* EXTI Line 4 to 15 */
+	0,									/* Reserved */
+	DMA1_Channel1_IRQHandler,			/* DMA1 Channel 1 */
+	DMA1_Channel2_3_IRQHandler,			/* DMA1 Channel 2 and Channel 3 */
+	DMA1_Channel4_5_6_7_IRQHandler,		/* DMA1 Channel 4, Channel 5, Channel 6 and Channel 7 */
+	ADC1_COMP_IRQHandler,				/* ADC1, COMP1 and COMP2 */
+	LPTIM1_IRQHandler,					/* LPTIM1 */
+	USART4_5_IRQHandler,				/* USART4 and USART 5 */
+	TIM2_IRQHandler,					/* TIM2 */
+	TIM3_IRQHandler,					/* TIM3 */
+	TIM6_IRQHandler,					/* TIM6 and DAC */
+	TIM7_IRQHandler,					/* TIM7 */
+	0,									/* Reserved */
+	TIM21_IRQHandler,					/* TIM21 */
+	I2C3_IRQHandler,					/* I2C3 */
+	TIM22_IRQHandler,					/* TIM22 */
+	I2C1_IRQHandler,					/* I2C1 */
+	I2C2_IRQHandler,					/* I2C2 */
+	SPI1_IRQHandler,					/* SPI1 */
+	SPI2_IRQHandler,					/* SPI2 */
+	USART1_IRQHandler,					/* USART1 */
+	USART2_IRQHandler,					/* USART2 */
+	LPUART1_IRQHandler,					/* LPUART1 */
+	0,									/* Reserved */
+	0									/* Reserved */
+};
+
+/*** STARTUP functions ***/
+
+/* HOST RESET HANDLER (EXECUTABLE IS LINKED WITH --wrap=main).
+ * @param:	None.
+ * @return:	Never returns.
+ */
+int __wrap_main(void) {
+	// Switch to firmware stack and run main.
+	__asm__ volatile (
+		"movq %0, %%rsp\n"
+		"call __real_main\n"
+		"movl %%eax, %%edi\n"
+		"call exit\n"
+		:
+		: "r" (startup_stack + STARTUP_STACK_SIZE)
+		: "memory"
+	);
+	return 0;
+}
+
+#endif /* HOST */
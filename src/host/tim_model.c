@@ -0,0 +1,142 @@
+/*
+ * tim_model.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "adc_model.h"
+#include "bus.h"
+#include "host.h"
+#include "nvic.h"
+#include "tim_reg.h"
+#include <stddef.h>
+
+/*** TIM MODEL local macros ***/
+
+#define TIM_MODEL_ARR_RESET		0xFFFFFFFF
+
+/*** TIM MODEL callbacks declaration ***/
+
+static void TIM_MODEL_update_event_callback(void);
+
+/*** TIM MODEL local structures ***/
+
+typedef struct {
+	TIM_base_address_t* tim;
+	unsigned long long period_start_ns;
+	HOST_event_t update_event;
+} TIM_MODEL_context_t;
+
+/*** TIM MODEL local global variables ***/
+
+static TIM_MODEL_context_t tim_model_ctx;
+
+/*** TIM MODEL local functions ***/
+
+/* UPDATE TIM2 INTERRUPT LINE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void TIM_MODEL_update_irq(void) {
+	if ((((tim_model_ctx.tim -> SR) & (tim_model_ctx.tim -> DIER)) & (0b1 << 0)) != 0) {
+		HOST_set_irq_pending(NVIC_IT_TIM2);
+	}
+}
+
+/* GET COUNTER PERIOD.
+ * @param:	None.
+ * @return:	Duration between two update events in ns.
+ */
+static unsigned long long TIM_MODEL_get_period_ns(void) {
+	// Counter is clocked by PCLK1 = SYSCLK.
+	unsigned long long cycles = (((unsigned long long) (tim_model_ctx.tim -> ARR)) + 1) * (((tim_model_ctx.tim -> PSC) & 0xFFFF) + 1);
+	return ((cycles * 1000000ULL) / HOST_get_sysclk_khz());
+}
+
+/* PROGRAM NEXT COUNTER OVERFLOW.
+ * @param:	None.
+ * @return:	None.
+ */
+static void TIM_MODEL_schedule(void) {
+	// Local variables.
+	unsigned long long deadline_ns = 0;
+	if (((tim_model_ctx.tim -> CR1) & (0b1 << 0)) == 0) {
+		HOST_stop_event(&tim_model_ctx.update_event);
+		return;
+	}
+	deadline_ns = tim_model_ctx.period_start_ns + TIM_MODEL_get_period_ns();
+	if (deadline_ns < HOST_get_time_ns()) {
+		deadline_ns = HOST_get_time_ns();
+	}
+	HOST_start_event_at(&tim_model_ctx.update_event, deadline_ns, &TIM_MODEL_update_event_callback);
+}
+
+/* COUNTER OVERFLOW.
+ * @param:	None.
+ * @return:	None.
+ */
+static void TIM_MODEL_update_event_callback(void) {
+	tim_model_ctx.tim -> SR |= (0b1 << 0); // UIF='1'.
+	// Update event used as trigger output (MMS='010').
+	if ((((tim_model_ctx.tim -> CR2) >> 4) & 0b111) == 0b010) {
+		ADC_MODEL_trigger();
+	}
+	tim_model_ctx.period_start_ns = HOST_get_time_ns();
+	TIM_MODEL_schedule();
+	TIM_MODEL_update_irq();
+}
+
+/* TIM REGISTERS WRITE CALLBACK.
+ * @param offset:			Register offset.
+ * @param previous_value:	Register value before write.
+ * @return:					None.
+ */
+static void TIM_MODEL_write_callback(unsigned int offset, unsigned int previous_value) {
+	switch (offset) {
+	case offsetof(TIM_base_address_t, CR1):
+		// Counter starts from its current value (period restarts).
+		if ((((tim_model_ctx.tim -> CR1) & ~previous_value) & (0b1 << 0)) != 0) {
+			tim_model_ctx.period_start_ns = HOST_get_time_ns();
+		}
+		TIM_MODEL_schedule();
+		break;
+	case offsetof(TIM_base_address_t, SR):
+		// Flags are cleared by writing '0'.
+		tim_model_ctx.tim -> SR = (previous_value & (tim_model_ctx.tim -> SR));
+		break;
+	case offsetof(TIM_base_address_t, EGR):
+		if (((tim_model_ctx.tim -> EGR) & (0b1 << 0)) != 0) {
+			// UG: counter and prescaler are reinitialized, UIF is only set if URS='0'.
+			tim_model_ctx.period_start_ns = HOST_get_time_ns();
+			if (((tim_model_ctx.tim -> CR1) & (0b1 << 2)) == 0) {
+				tim_model_ctx.tim -> SR |= (0b1 << 0);
+			}
+			TIM_MODEL_schedule();
+		}
+		tim_model_ctx.tim -> EGR = 0;
+		break;
+	case offsetof(TIM_base_address_t, ARR):
+	case offsetof(TIM_base_address_t, PSC):
+		// Preload is not modeled: new period applies to the current one.
+		TIM_MODEL_schedule();
+		break;
+	default:
+		break;
+	}
+	TIM_MODEL_update_irq();
+}
+
+/* INIT TIM MODEL BEFORE MAIN FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((constructor(HOST_CONSTRUCTOR_PRIORITY_MODEL))) TIM_MODEL_init(void) {
+	// Reset values.
+	tim_model_ctx.tim = BUS_map_peripheral((unsigned long) TIM2, sizeof(TIM_base_address_t), 0, &TIM_MODEL_write_callback);
+	tim_model_ctx.tim -> ARR = TIM_MODEL_ARR_RESET;
+}
+
+#endif /* HOST */
@@ -27,6 +27,10 @@
 #include "sigfox_api.h"
 // Applicative.
 #include "at.h"
+#include "at_bench.h"
+#include "scheduler.h"
+#include "telemetry.h"
+#include "timer.h"
 #include "mode.h"
 #include "sigfox_api.h"
 
@@ -53,20 +57,28 @@ int main (void) {
 	RCC_enable_lse();
 	RTC_init();
 	// Init peripherals.
+	NVM_init();
 	LPTIM1_init();
 	LPUART1_init();
 	ADC1_init();
 	SPI1_init();
+	// Init scheduler and timer service (requires LPTIM1 monotonic clock).
+	SCHEDULER_init();
+	TIMER_init();
 	// Init components.
 	S2LP_init();
+	// Init telemetry service.
+	TELEMETRY_init();
 	// Init AT interface.
 	AT_init();
-	// Main loop.
-	while (1) {
-		IWDG_reload();
-		// Enter stop mode.
-		PWR_enter_stop_mode();
-		// Wake-up: perform AT task.
-		AT_task();
-	}
+#ifdef AT_BENCH
+	// Replay synthetic AT traffic before nominal operation.
+	AT_BENCH_run();
+#endif
+	// Register tasks and run scheduler.
+	SCHEDULER_register_task(SCHEDULER_EVENT_TIMER, &TIMER_task);
+	SCHEDULER_register_task(SCHEDULER_EVENT_AT, &AT_task);
+	SCHEDULER_register_task(SCHEDULER_EVENT_TELEMETRY, &TELEMETRY_task);
+	SCHEDULER_run();
+	return 0;
 }
@@ -8,26 +8,42 @@
 #include "adc.h"
 
 #include "adc_reg.h"
+#include "dma.h"
 #include "gpio.h"
 #include "lptim.h"
 #include "mapping.h"
-#include "math.h"
+#include "nvic.h"
+#include "pwr.h"
+#include "rcc.h"
 #include "rcc_reg.h"
+#include "tim.h"
 
 /*** ADC local macros ***/
 
 #define ADC_TIMEOUT_COUNT					1000000
 
 #define ADC_CHANNEL_VRF						7
+#define ADC_CHANNEL_VREFINT					17
 #define ADC_CHANNEL_TMCU					18
 
-#define ADC_MEDIAN_FILTER_LENGTH			9
-#define ADC_CENTER_AVERAGE_LENGTH			3
-
+#define ADC_OVERSAMPLING_RATIO_LOG2			4 // 16 samples accumulated by hardware for each channel.
 #define ADC_FULL_SCALE_12BITS				4095
+#define ADC_FULL_SCALE_OVERSAMPLED			(ADC_FULL_SCALE_12BITS << ADC_OVERSAMPLING_RATIO_LOG2) // 16-bits result (12.4 fixed point).
 
-#define ADC_LM4040_VOLTAGE_MV				2048
 #define ADC_VMCU_DEFAULT_MV					3000
+#define ADC_VMCU_MIN_MV						1650
+#define ADC_VMCU_MAX_MV						3600
+
+#define ADC_VMCU_LUT_LENGTH_LOG2			5 // 32 segments.
+#define ADC_VMCU_LUT_LENGTH					(0b1 << ADC_VMCU_LUT_LENGTH_LOG2)
+#define ADC_VMCU_LUT_STEP_LOG2				10 // 32 * 1024 covers the oversampled VREFINT range between VMCU_MAX and VMCU_MIN.
+
+#define ADC_TMCU_PRODUCT_SHIFT				10 // (TS * VMCU) is scaled down to keep products on 32 bits.
+#define ADC_TMCU_GAIN_SHIFT					18 // Q18 temperature computation.
+
+#define ADC_SAMPLING_TIME_MIN_NS			10000 // Temperature sensor and internal reference requirement.
+
+#define ADC_WATCHDOG_PERIOD_US				1000 // Supply watchdog sequence rate (ADC is powered off between triggers).
 
 #define ADC_VOLTAGE_DIVIDER_RATIO_VPV		10
 #define ADC_VOLTAGE_DIVIDER_RATIO_VOUT		2
@@ -38,65 +54,117 @@
 
 /*** ADC local structures ***/
 
+typedef enum {
+	ADC_SCAN_IDX_VRF = 0, // Channels are converted by ascending number.
+	ADC_SCAN_IDX_VREFINT,
+	ADC_SCAN_IDX_TMCU,
+	ADC_SCAN_IDX_LAST
+} ADC_scan_index_t;
+
 typedef struct {
-	unsigned int lm4040_voltage_12bits;
+	unsigned short scan_buf[ADC_SCAN_IDX_LAST]; // Oversampled raw results (12.4 fixed point).
+	volatile unsigned char supply_watchdog_flag;
 	unsigned int data[ADC_DATA_IDX_LAST];
 	unsigned char tmcu_degrees_comp1;
 	signed char tmcu_degrees_comp2;
 } ADC_context_t;
 
+typedef struct {
+	unsigned int vrefint_min; // Oversampled VREFINT value of the first LUT point (VMCU_MAX).
+	unsigned short vmcu_lut[ADC_VMCU_LUT_LENGTH + 1];
+	unsigned int tmcu_gain; // Q18 degrees per (TS * VMCU) LSB.
+	unsigned int tmcu_offset; // Q18.
+	unsigned char valid;
+} ADC_calibration_t;
+
 /*** ADC local global variables ***/
 
 static ADC_context_t adc_ctx;
+static ADC_calibration_t adc_calibration;
 
 /*** ADC local functions ***/
 
-/* PERFORM A SINGLE ADC CONVERSION.
- * @param adc_channel:			Channel to convert.
- * @param adc_result_12bits:	Pointer to int that will contain ADC raw result on 12 bits.
- * @return:						None.
+/* ADC INTERRUPT HANDLER.
+ * @param:	None.
+ * @return:	None.
  */
-static void ADC1_single_conversion(unsigned char adc_channel, unsigned int* adc_result_12bits) {
-	// Select input channel.
-	ADC1 -> CHSELR &= 0xFFF80000; // Reset all bits.
-	ADC1 -> CHSELR |= (0b1 << adc_channel);
-	// Read raw supply voltage.
-	ADC1 -> CR |= (0b1 << 2); // ADSTART='1'.
+void __attribute__((optimize("-O0"))) ADC1_COMP_IRQHandler(void) {
+	// Analog watchdog interrupt.
+	if (((ADC1 -> ISR) & (0b1 << 7)) != 0) {
+		// Set local flag.
+		if (((ADC1 -> IER) & (0b1 << 7)) != 0) {
+			adc_ctx.supply_watchdog_flag = 1;
+		}
+		// Disable interrupt (it would trigger again on every sequence until the supply recovers).
+		ADC1 -> IER &= ~(0b1 << 7); // AWDIE='0'.
+		// Clear flag.
+		ADC1 -> ISR |= (0b1 << 7); // AWD='1'.
+	}
+}
+
+/* ENABLE ADC AND WAIT FOR READY FLAG.
+ * @param:	None.
+ * @return:	1 if ADC is ready, 0 in case of timeout.
+ */
+static unsigned char ADC1_enable(void) {
+	// Enable ADC peripheral.
+	ADC1 -> CR |= (0b1 << 0); // ADEN='1'.
 	unsigned int loop_count = 0;
-	while (((ADC1 -> ISR) & (0b1 << 2)) == 0) {
-		// Wait end of conversion ('EOC='1') or timeout.
+	while (((ADC1 -> ISR) & (0b1 << 0)) == 0) {
+		// Wait for ADC to be ready (ADRDY='1') or timeout.
 		loop_count++;
-		if (loop_count > ADC_TIMEOUT_COUNT) return;
+		if (loop_count > ADC_TIMEOUT_COUNT) return 0;
 	}
-	(*adc_result_12bits) = (ADC1 -> DR);
+	return 1;
 }
 
-/* PERFORM SEVERAL CONVERSIONS FOLLOWED BY A MEDIAN FIILTER.
- * @param adc_channel:			Channel to convert.
- * @param adc_result_12bits:	Pointer to int that will contain ADC filtered result on 12 bits.
- * @return:						None.
+/* CONVERT ALL CHANNELS IN A SINGLE DMA SEQUENCE.
+ * @param:	None.
+ * @return:	None.
  */
-static void ADC1_filtered_conversion(unsigned char adc_channel, unsigned int* adc_result_12bits) {
-	// Perform all conversions.
-	unsigned int adc_sample_buf[ADC_MEDIAN_FILTER_LENGTH] = {0x00};
+static void ADC1_scan_conversion(void) {
+	// Local variables.
 	unsigned char idx = 0;
-	for (idx=0 ; idx<ADC_MEDIAN_FILTER_LENGTH ; idx++) {
-		ADC1_single_conversion(adc_channel, &(adc_sample_buf[idx]));
+	// Reset buffer.
+	for (idx=0 ; idx<ADC_SCAN_IDX_LAST ; idx++) adc_ctx.scan_buf[idx] = 0;
+	// Select input channels.
+	ADC1 -> CHSELR &= 0xFFF80000; // Reset all bits.
+	ADC1 -> CHSELR |= (0b1 << ADC_CHANNEL_VRF) | (0b1 << ADC_CHANNEL_VREFINT) | (0b1 << ADC_CHANNEL_TMCU);
+	// Configure DMA.
+	DMA1_init_channel1_adc();
+	DMA1_set_channel1_dest_addr((unsigned long) &(adc_ctx.scan_buf), ADC_SCAN_IDX_LAST);
+	DMA1_start_channel1();
+	// Start sequence.
+	ADC1 -> CR |= (0b1 << 2); // ADSTART='1'.
+	// Sleep until all results are transferred.
+	while (DMA1_get_channel1_status() == 0) {
+		PWR_enter_sleep_mode();
 	}
-	// Apply median filter.
-	(*adc_result_12bits) = MATH_median_filter(adc_sample_buf, ADC_MEDIAN_FILTER_LENGTH, ADC_CENTER_AVERAGE_LENGTH);
+	DMA1_stop_channel1();
 }
 
-/* COMPUTE INPUT VOLTAGE.
+/* FOLD FACTORY CALIBRATION VALUES INTO A LUT AND FIXED POINT MULTIPLIERS (DIVISIONS ARE ONLY PERFORMED HERE).
  * @param:	None.
  * @return:	None.
  */
-static void ADC1_compute_vrf(void) {
-	// Get raw result.
-	unsigned int vpv_12bits = 0;
-	ADC1_filtered_conversion(ADC_CHANNEL_VRF, &vpv_12bits);
-	// Convert to mV using bandgap result.
-	adc_ctx.data[ADC_DATA_IDX_VPV_MV] = (ADC_LM4040_VOLTAGE_MV * vpv_12bits * ADC_VOLTAGE_DIVIDER_RATIO_VPV) / (adc_ctx.lm4040_voltage_12bits);
+static void ADC1_compute_calibration(void) {
+	// Local variables.
+	unsigned int vrefint_cal_product = (VREFINT_VCC_CALIB_MV * VREFINT_CAL) << ADC_OVERSAMPLING_RATIO_LOG2;
+	unsigned int ts_cal_delta = (unsigned int) (TS_CAL2 - TS_CAL1);
+	unsigned int cal1_gain = 0;
+	unsigned char idx = 0;
+	// VMCU = (VREFINT_VCC_CALIB * VREFINT_CAL) / VREFINT: tabulated on the supply range.
+	adc_calibration.vrefint_min = vrefint_cal_product / ADC_VMCU_MAX_MV;
+	for (idx=0 ; idx<=ADC_VMCU_LUT_LENGTH ; idx++) {
+		adc_calibration.vmcu_lut[idx] = (unsigned short) (vrefint_cal_product / (adc_calibration.vrefint_min + (idx << ADC_VMCU_LUT_STEP_LOG2)));
+	}
+	// T = ((TS * VMCU / TS_VCC_CALIB) - TS_CAL1) * (TS_CAL2_TEMP - TS_CAL1_TEMP) / (TS_CAL2 - TS_CAL1) + TS_CAL1_TEMP.
+	// With P = (TS * VMCU) >> 10, T = P * gain - offset + TS_CAL1_TEMP where 1024 / (16 * TS_VCC_CALIB) = 8 / 375.
+	if (ts_cal_delta == 0) ts_cal_delta = 1;
+	adc_calibration.tmcu_gain = ((((unsigned int) (TS_CAL2_TEMP - TS_CAL1_TEMP)) << ADC_TMCU_GAIN_SHIFT) * 8) / (375 * ts_cal_delta);
+	cal1_gain = ((unsigned int) TS_CAL1) * adc_calibration.tmcu_gain;
+	adc_calibration.tmcu_offset = ((cal1_gain >> 3) * 375) + (((cal1_gain & 0x07) * 375) >> 3);
+	adc_calibration.valid = 1;
 }
 
 /* COMPUTE MCU SUPPLY VOLTAGE.
@@ -104,8 +172,30 @@ static void ADC1_compute_vrf(void) {
  * @return:	None.
  */
 static void ADC1_compute_vmcu(void) {
-	// Retrieve supply voltage from bandgap result.
-	adc_ctx.data[ADC_DATA_IDX_VMCU_MV] = (ADC_LM4040_VOLTAGE_MV * ADC_FULL_SCALE_12BITS) / (adc_ctx.lm4040_voltage_12bits);
+	// Local variables.
+	unsigned int vrefint = adc_ctx.scan_buf[ADC_SCAN_IDX_VREFINT];
+	unsigned int lut_idx = 0;
+	unsigned int lut_remainder = 0;
+	// Clamp to LUT range.
+	if (vrefint < adc_calibration.vrefint_min) vrefint = adc_calibration.vrefint_min;
+	lut_idx = (vrefint - adc_calibration.vrefint_min) >> ADC_VMCU_LUT_STEP_LOG2;
+	if (lut_idx >= ADC_VMCU_LUT_LENGTH) {
+		adc_ctx.data[ADC_DATA_IDX_VMCU_MV] = adc_calibration.vmcu_lut[ADC_VMCU_LUT_LENGTH];
+		return;
+	}
+	// Linear interpolation between LUT points.
+	lut_remainder = (vrefint - adc_calibration.vrefint_min) & ((0b1 << ADC_VMCU_LUT_STEP_LOG2) - 1);
+	adc_ctx.data[ADC_DATA_IDX_VMCU_MV] = adc_calibration.vmcu_lut[lut_idx] - (((adc_calibration.vmcu_lut[lut_idx] - adc_calibration.vmcu_lut[lut_idx + 1]) * lut_remainder) >> ADC_VMCU_LUT_STEP_LOG2);
+}
+
+/* COMPUTE INPUT VOLTAGE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void ADC1_compute_vrf(void) {
+	// Convert to mV using supply voltage (x / 65520 = (x + x / 4096) / 65536 with a relative error below 2^-24).
+	unsigned int vrf_product = adc_ctx.scan_buf[ADC_SCAN_IDX_VRF] * adc_ctx.data[ADC_DATA_IDX_VMCU_MV] * ADC_VOLTAGE_DIVIDER_RATIO_VPV;
+	adc_ctx.data[ADC_DATA_IDX_VPV_MV] = (vrf_product + (vrf_product >> 12)) >> 16;
 }
 
 /* COMPUTE MCU TEMPERATURE THANKS TO INTERNAL VOLTAGE REFERENCE.
@@ -113,21 +203,10 @@ static void ADC1_compute_vmcu(void) {
  * @return:	None.
  */
 static void ADC1_compute_tmcu(void) {
-	// Set sampling time (see p.88 of STM32L031x4/6 datasheet).
-	ADC1 -> SMPR |= (0b111 << 0); // Sampling time for temperature sensor must be greater than 10us, 160.5*(1/ADCCLK) = 20us for ADCCLK = SYSCLK/2 = 8MHz;
-	// Wake-up VREFINT and temperature sensor.
-	ADC1 -> CCR |= (0b11 << 22); // TSEN='1' and VREFEF='1'.
-	LPTIM1_delay_milliseconds(10, 0); // Wait internal reference stabilization (max 3ms).
-	// Read raw temperature.
-	int raw_temp_sensor_12bits = 0;
-	ADC1_filtered_conversion(ADC_CHANNEL_TMCU, (unsigned int*) &raw_temp_sensor_12bits);
 	// Compute temperature according to MCU factory calibration (see p.301 and p.847 of RM0377 datasheet).
-	int raw_temp_calib_mv = (raw_temp_sensor_12bits * adc_ctx.data[ADC_DATA_IDX_VMCU_MV]) / (TS_VCC_CALIB_MV) - TS_CAL1; // Equivalent raw measure for calibration power supply (VCC_CALIB).
-	int temp_calib_degrees = raw_temp_calib_mv * ((int)(TS_CAL2_TEMP-TS_CAL1_TEMP));
-	temp_calib_degrees = (temp_calib_degrees) / ((int)(TS_CAL2 - TS_CAL1));
-	adc_ctx.tmcu_degrees_comp2 = temp_calib_degrees + TS_CAL1_TEMP;
-	// Switch temperature sensor off.
-	ADC1 -> CCR &= ~(0b1 << 23); // TSEN='0'.
+	unsigned int ts_vmcu_product = (adc_ctx.scan_buf[ADC_SCAN_IDX_TMCU] * adc_ctx.data[ADC_DATA_IDX_VMCU_MV]) >> ADC_TMCU_PRODUCT_SHIFT;
+	int temp_q18 = (int) (ts_vmcu_product * adc_calibration.tmcu_gain) - (int) adc_calibration.tmcu_offset + (TS_CAL1_TEMP << ADC_TMCU_GAIN_SHIFT);
+	adc_ctx.tmcu_degrees_comp2 = (temp_q18 + (0b1 << (ADC_TMCU_GAIN_SHIFT - 1))) >> ADC_TMCU_GAIN_SHIFT;
 	// Convert to 1-complement value.
 	adc_ctx.tmcu_degrees_comp1 = 0;
 	if (adc_ctx.tmcu_degrees_comp2 < 0) {
@@ -140,6 +219,26 @@ static void ADC1_compute_tmcu(void) {
 	}
 }
 
+/* SET ADC SAMPLING TIME ACCORDING TO THE SYSTEM CLOCK IN USE (TO BE CALLED BEFORE EACH CONVERSION START).
+ * @param:	None.
+ * @return:	None.
+ */
+static void ADC1_set_sampling_time(void) {
+	// Local variables.
+	// Sampling times in half ADC clock cycles for each SMP value.
+	static const unsigned short ADC_SMP_HALF_CYCLES[8] = {3, 7, 15, 25, 39, 79, 159, 321};
+	unsigned int sysclk_khz = RCC_get_sysclk_khz();
+	unsigned int min_half_cycles = 0;
+	unsigned int smp = 0;
+	// ADCCLK = SYSCLK/2: minimum sampling time in half cycles is (t_min * SYSCLK).
+	min_half_cycles = ((ADC_SAMPLING_TIME_MIN_NS / 1000) * sysclk_khz) / 1000;
+	while ((smp < 7) && (ADC_SMP_HALF_CYCLES[smp] < min_half_cycles)) {
+		smp++;
+	}
+	// SMPR can only be written when no conversion is running (ADSTART='0').
+	ADC1 -> SMPR = (smp << 0);
+}
+
 /*** ADC functions ***/
 
 /* INIT ADC1 PERIPHERAL.
@@ -150,28 +249,41 @@ void ADC1_init(void) {
 	// Init GPIOs.
 	GPIO_configure(&GPIO_ADC1_IN7, GPIO_MODE_ANALOG, GPIO_TYPE_OPEN_DRAIN, GPIO_SPEED_LOW, GPIO_PULL_NONE);
 	// Init context.
-	adc_ctx.lm4040_voltage_12bits = 0;
 	unsigned char data_idx = 0;
+	for (data_idx=0 ; data_idx<ADC_SCAN_IDX_LAST ; data_idx++) adc_ctx.scan_buf[data_idx] = 0;
 	for (data_idx=0 ; data_idx<ADC_DATA_IDX_LAST ; data_idx++) adc_ctx.data[data_idx] = 0;
 	adc_ctx.data[ADC_DATA_IDX_VMCU_MV] = ADC_VMCU_DEFAULT_MV;
 	adc_ctx.tmcu_degrees_comp2 = 0;
 	adc_ctx.tmcu_degrees_comp1 = 0;
+	adc_ctx.supply_watchdog_flag = 0;
+	// Compute calibration tables once.
+	if (adc_calibration.valid == 0) {
+		ADC1_compute_calibration();
+	}
 	// Enable peripheral clock.
 	RCC -> APB2ENR |= (0b1 << 9); // ADCEN='1'.
 	// Ensure ADC is disabled.
 	if (((ADC1 -> CR) & (0b1 << 0)) != 0) {
 		ADC1 -> CR |= (0b1 << 1); // ADDIS='1'.
 	}
+	// Wake-up VREFINT and temperature sensor (started in parallel with ADC regulator).
+	ADC1 -> CCR |= (0b11 << 22); // TSEN='1' and VREFEF='1'.
 	// Enable ADC voltage regulator.
 	ADC1 -> CR |= (0b1 << 28);
-	LPTIM1_delay_milliseconds(5, 0);
+	LPTIM1_delay_milliseconds(5, 0); // Also covers internal reference stabilization (max 3ms).
 	// ADC configuration.
 	ADC1 -> CFGR2 &= ~(0b11 << 30); // Reset bits 30-31.
-	ADC1 -> CFGR2 |= (0b01 << 30); // Use (PCLK2/2) as ADCCLK = SYSCLK/2 (see RCC_init() function).
-	ADC1 -> CFGR1 &= (0b1 << 13); // Single conversion mode.
+	ADC1 -> CFGR2 |= (0b01 << 30); // Use (PCLK2/2) as ADCCLK = SYSCLK/2 (see RCC_switch_sysclk() function).
+	ADC1 -> CFGR2 &= ~(0b1111111 << 2); // Reset bits 2-8.
+	ADC1 -> CFGR2 |= ((ADC_OVERSAMPLING_RATIO_LOG2 - 1) << 2); // Oversampling ratio (OVSR='011' for 16x), no shift (OVSS='0000').
+	ADC1 -> CFGR2 |= (0b1 << 0); // Enable hardware oversampler (OVSE='1').
+	ADC1 -> CFGR1 &= ~(0b1 << 13); // Single conversion mode (CONT='0').
 	ADC1 -> CFGR1 &= ~(0b11 << 0); // Data resolution = 12 bits (RES='00').
-	ADC1 -> CCR &= 0xFC03FFFF; // No prescaler.
-	ADC1 -> SMPR |= (0b111 << 0); // Maximum sampling time.
+	ADC1 -> CFGR1 &= ~(0b111 << 1); // Forward scan (SCANDIR='0'), DMA one shot mode (DMACFG='0').
+	ADC1 -> CFGR1 |= (0b1 << 0); // Enable DMA requests (DMAEN='1').
+	ADC1 -> CCR &= ~(0b1111 << 18); // No prescaler (PRESC='0000').
+	// Sampling time for temperature sensor must be greater than 10us (depends on system clock).
+	ADC1_set_sampling_time();
 	// ADC calibration.
 	ADC1 -> CR |= (0b1 << 31); // ADCAL='1'.
 	unsigned int loop_count = 0;
@@ -193,6 +305,8 @@ void ADC1_disable(void) {
 	if (((ADC1 -> CR) & (0b1 << 0)) != 0) {
 		ADC1 -> CR |= (0b1 << 1); // ADDIS='1'.
 	}
+	// Switch internal reference and temperature sensor off.
+	ADC1 -> CCR &= ~(0b11 << 22); // TSEN='0' and VREFEN='0'.
 	// Clear all flags.
 	ADC1 -> ISR |= 0x0000089F;
 	// Disable peripheral clock.
@@ -204,18 +318,14 @@ void ADC1_disable(void) {
  * @return:	None.
  */
 void ADC1_perform_measurements(void) {
+	// System clock may have changed since last conversion.
+	ADC1_set_sampling_time();
 	// Enable ADC peripheral.
-	ADC1 -> CR |= (0b1 << 0); // ADEN='1'.
-	unsigned int loop_count = 0;
-	while (((ADC1 -> ISR) & (0b1 << 0)) == 0) {
-		// Wait for ADC to be ready (ADRDY='1') or timeout.
-		loop_count++;
-		if (loop_count > ADC_TIMEOUT_COUNT) return;
-	}
+	if (ADC1_enable() == 0) return;
 	// Perform measurements.
-	//ADC1_filtered_conversion(ADC_CHANNEL_LM4040, &adc_ctx.lm4040_voltage_12bits);
-	ADC1_compute_vrf();
+	ADC1_scan_conversion();
 	ADC1_compute_vmcu();
+	ADC1_compute_vrf();
 	ADC1_compute_tmcu();
 	// Clear all flags.
 	ADC1 -> ISR |= 0x0000089F; // Clear all flags.
@@ -225,6 +335,121 @@ void ADC1_perform_measurements(void) {
 	}
 }
 
+/* START SUPPLY MONITORING WITH ANALOG WATCHDOG ON TIMER TRIGGERED SEQUENCES (ADC MUST BE INITIALIZED).
+ * @param vrf_threshold_mv:		RF supply low threshold in mV (0 to disable).
+ * @param vmcu_threshold_mv:	MCU supply low threshold in mV (0 to disable).
+ * @return:						None.
+ * Note: VRF and VREFINT are converted every ADC_WATCHDOG_PERIOD_US and checked against a single window: VRF must stay above the low
+ * threshold and VREFINT below the high threshold (VREFINT raw value increases when VMCU drops).
+ */
+void ADC1_start_supply_watchdog(unsigned int vrf_threshold_mv, unsigned int vmcu_threshold_mv) {
+	// Local variables.
+	unsigned int low_threshold_12bits = 0;
+	unsigned int high_threshold_12bits = ADC_FULL_SCALE_12BITS;
+	unsigned int channels = (0b1 << ADC_CHANNEL_VRF);
+	unsigned int loop_count = 0;
+	// Convert thresholds to raw values with last MCU supply voltage measurement.
+	if (vrf_threshold_mv != 0) {
+		low_threshold_12bits = (vrf_threshold_mv * ADC_FULL_SCALE_12BITS) / (adc_ctx.data[ADC_DATA_IDX_VMCU_MV] * ADC_VOLTAGE_DIVIDER_RATIO_VPV);
+		if (low_threshold_12bits > ADC_FULL_SCALE_12BITS) {
+			low_threshold_12bits = ADC_FULL_SCALE_12BITS;
+		}
+	}
+	if (vmcu_threshold_mv != 0) {
+		high_threshold_12bits = (VREFINT_VCC_CALIB_MV * VREFINT_CAL) / vmcu_threshold_mv;
+		if (high_threshold_12bits > ADC_FULL_SCALE_12BITS) {
+			high_threshold_12bits = ADC_FULL_SCALE_12BITS;
+		}
+		// VMCU is only monitored if both channels fit in the window (always the case with realistic limits).
+		if (high_threshold_12bits > low_threshold_12bits) {
+			channels |= (0b1 << ADC_CHANNEL_VREFINT);
+		}
+		else {
+			high_threshold_12bits = ADC_FULL_SCALE_12BITS;
+		}
+	}
+	// Wait for end of previous disable (configuration registers are only writable when ADEN='0').
+	while (((ADC1 -> CR) & (0b1 << 0)) != 0) {
+		// Wait for ADEN='0' or timeout.
+		loop_count++;
+		if (loop_count > ADC_TIMEOUT_COUNT) return;
+	}
+	ADC1_set_sampling_time();
+	// Sequence without oversampling nor DMA.
+	ADC1 -> CHSELR &= 0xFFF80000; // Reset all bits.
+	ADC1 -> CHSELR |= channels;
+	ADC1 -> CFGR2 &= ~(0b1 << 0); // OVSE='0'.
+	ADC1 -> CFGR1 &= ~(0b1 << 0); // DMAEN='0'.
+	ADC1 -> CFGR1 |= (0b1 << 12); // Overwrite data register (OVRMOD='1').
+	// Convert on TIM2 trigger and power ADC off between sequences.
+	ADC1 -> CFGR1 &= ~((0b11 << 10) | (0b111 << 6));
+	ADC1 -> CFGR1 |= (0b01 << 10) | (0b010 << 6); // Rising edge (EXTEN='01') of TIM2_TRGO (EXTSEL='010').
+	ADC1 -> CFGR1 |= (0b1 << 15); // AUTOFF='1'.
+	// Configure analog watchdog on all channels of the sequence.
+	ADC1 -> TR = (high_threshold_12bits << 16) | (low_threshold_12bits << 0);
+	ADC1 -> CFGR1 &= ~((0b11111 << 26) | (0b1 << 22));
+	ADC1 -> CFGR1 |= (0b1 << 23); // AWDEN='1' and AWDSGL='0'.
+	// Enable interrupt.
+	adc_ctx.supply_watchdog_flag = 0;
+	ADC1 -> ISR |= (0b1 << 7); // Clear AWD flag.
+	ADC1 -> IER |= (0b1 << 7); // AWDIE='1'.
+	NVIC_set_priority(NVIC_IT_ADC_COMP, 2);
+	NVIC_enable_interrupt(NVIC_IT_ADC_COMP);
+	// Arm conversions and start trigger.
+	if (ADC1_enable() == 0) return;
+	ADC1 -> CR |= (0b1 << 2); // ADSTART='1'.
+	TIM2_start_trigger(ADC_WATCHDOG_PERIOD_US);
+	// Timer and ADC require the APB clock: forbid stop mode.
+	PWR_set_mode_vote(PWR_REQUESTER_ADC, PWR_MODE_SLEEP);
+}
+
+/* STOP SUPPLY MONITORING.
+ * @param:	None.
+ * @return:	None.
+ */
+void ADC1_stop_supply_watchdog(void) {
+	// Local variables.
+	unsigned int loop_count = 0;
+	// Stop trigger and conversions.
+	TIM2_stop();
+	if (((ADC1 -> CR) & (0b1 << 2)) != 0) {
+		ADC1 -> CR |= (0b1 << 4); // ADSTP='1'.
+		while (((ADC1 -> CR) & (0b1 << 4)) != 0) {
+			// Wait for ADSTP='0' or timeout.
+			loop_count++;
+			if (loop_count > ADC_TIMEOUT_COUNT) break;
+		}
+	}
+	// Disable interrupt.
+	ADC1 -> IER &= ~(0b1 << 7); // AWDIE='0'.
+	NVIC_disable_interrupt(NVIC_IT_ADC_COMP);
+	PWR_set_mode_vote(PWR_REQUESTER_ADC, PWR_MODE_STOP);
+	// Disable ADC peripheral.
+	if (((ADC1 -> CR) & (0b1 << 0)) != 0) {
+		ADC1 -> CR |= (0b1 << 1); // ADDIS='1'.
+		loop_count = 0;
+		while (((ADC1 -> CR) & (0b1 << 0)) != 0) {
+			// Wait for ADEN='0' or timeout.
+			loop_count++;
+			if (loop_count > ADC_TIMEOUT_COUNT) break;
+		}
+	}
+	// Restore scan configuration.
+	ADC1 -> CFGR1 &= ~((0b1 << 23) | (0b1 << 15) | (0b1 << 12) | (0b11 << 10) | (0b111 << 6)); // AWDEN='0', AUTOFF='0', OVRMOD='0', EXTEN='00' and EXTSEL='000'.
+	ADC1 -> CFGR1 |= (0b1 << 0); // DMAEN='1'.
+	ADC1 -> CFGR2 |= (0b1 << 0); // OVSE='1'.
+	// Clear all flags.
+	ADC1 -> ISR |= 0x0000089F;
+}
+
+/* GET SUPPLY MONITORING STATUS.
+ * @param:	None.
+ * @return:	1 if a supply dropped below its threshold since monitoring start, 0 otherwise.
+ */
+unsigned char ADC1_get_supply_watchdog_flag(void) {
+	return adc_ctx.supply_watchdog_flag;
+}
+
 /* GET ADC DATA.
  * @param data_idx:		Index of the data to retrieve.
  * @param data:				Pointer that will contain ADC data.
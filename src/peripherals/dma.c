@@ -7,22 +7,55 @@
 
 #include "dma.h"
 
+#include "adc_reg.h"
+#include "aes_reg.h"
 #include "dma_reg.h"
 #include "nvic.h"
+#include "probe.h"
+#include "pwr.h"
 #include "rcc_reg.h"
 #include "spi_reg.h"
+#include "trace.h"
 
 /*** DMA local global variables ***/
 
+static volatile unsigned char dma1_channel1_tcif = 0;
+static volatile unsigned char dma1_channel2_tcif = 0;
 static volatile unsigned char dma1_channel3_tcif = 0;
 
 /*** DMA local functions ***/
 
+/* DMA1 CHANNEL 1 INTERRUPT HANDLER.
+ * @param:	None.
+ * @return:	None.
+ */
+void __attribute__((optimize("-O0"))) DMA1_Channel1_IRQHandler(void) {
+	// Transfer complete interrupt (TCIF1='1').
+	if (((DMA1 -> ISR) & (0b1 << 1)) != 0) {
+		// Set local flag.
+		if (((DMA1 -> CCR1) & (0b1 << 1)) != 0) {
+			dma1_channel1_tcif = 1;
+		}
+		// Clear flag.
+		DMA1 -> IFCR |= (0b1 << 1); // CTCIF1='1'.
+	}
+}
+
 /* DMA1 CHANNEL 3 INTERRUPT HANDLER.
  * @param:	None.
  * @return:	None.
  */
-void __attribute__((optimize("-O0"))) DMA1_Channel2_3_IRQHandler(void) {
+void __attribute__((optimize("-O0"), section(".ramfunc"))) DMA1_Channel2_3_IRQHandler(void) {
+	TRACE_event(TRACE_EVENT_DMA1_CHANNEL2_3_IRQ, DMA1 -> ISR);
+	// Transfer complete interrupt (TCIF2='1').
+	if (((DMA1 -> ISR) & (0b1 << 5)) != 0) {
+		// Set local flag.
+		if (((DMA1 -> CCR2) & (0b1 << 1)) != 0) {
+			dma1_channel2_tcif = 1;
+		}
+		// Clear flag.
+		DMA1 -> IFCR |= (0b1 << 5); // CTCIF2='1'.
+	}
 	// Transfer complete interrupt (TCIF3='1').
 	if (((DMA1 -> ISR) & (0b1 << 9)) != 0) {
 		// Set local flag.
@@ -31,6 +64,7 @@ void __attribute__((optimize("-O0"))) DMA1_Channel2_3_IRQHandler(void) {
 		}
 		// Clear flag.
 		DMA1 -> IFCR |= (0b1 << 9); // CTCIF3='1'.
+		PROBE_low(PROBE_UPLINK_REFILL_TP);
 	}
 }
 
@@ -52,7 +86,7 @@ void DMA1_init_channel3(void) {
 	DMA1 -> CCR3 |= (0b1 << 1); // Enable transfer complete interrupt (TCIE='1').
 	DMA1 -> CCR3 |= (0b1 << 4); // Read from memory.
 	// Configure peripheral address.
-	DMA1 -> CPAR3 = (unsigned int) &(SPI1 -> DR); // Peripheral address = SPI1 TX register.
+	DMA1 -> CPAR3 = (unsigned long) &(SPI1 -> DR); // Peripheral address = SPI1 TX register.
 	// Configure channel 3 for SPI1 TX (request number 1).
 	DMA1 -> CSELR &= ~(0b1111 << 8); // Reset bits 8-11.
 	DMA1 -> CSELR |= (0b0001 << 8); // DMA channel mapped on SPI1_TX (C3S='0001').
@@ -66,11 +100,13 @@ void DMA1_init_channel3(void) {
  * @param:	None.
  * @return:	None.
  */
-void DMA1_start_channel3(void) {
+void __attribute__((section(".ramfunc"))) DMA1_start_channel3(void) {
 	// Clear all flags.
 	dma1_channel3_tcif = 0;
 	DMA1 -> IFCR |= 0x00000F00;
 	NVIC_enable_interrupt(NVIC_IT_DMA1_CH_2_3);
+	// DMA requires bus clock.
+	PWR_set_mode_vote(PWR_REQUESTER_DMA1_CHANNEL3, PWR_MODE_SLEEP);
 	// Start transfer.
 	DMA1 -> CCR3 |= (0b1 << 0); // EN='1'.
 }
@@ -79,10 +115,11 @@ void DMA1_start_channel3(void) {
  * @param:	None.
  * @return:	None.
  */
-void DMA1_stop_channel3(void) {
+void __attribute__((section(".ramfunc"))) DMA1_stop_channel3(void) {
 	// Stop transfer.
 	dma1_channel3_tcif = 0;
 	DMA1 -> CCR3 &= ~(0b1 << 0); // EN='0'.
+	PWR_set_mode_vote(PWR_REQUESTER_DMA1_CHANNEL3, PWR_MODE_STOP);
 	NVIC_disable_interrupt(NVIC_IT_DMA1_CH_2_3);
 }
 
@@ -91,7 +128,7 @@ void DMA1_stop_channel3(void) {
  * @param dest_buf_size:	Size of destination buffer.
  * @return:					None.
  */
-void DMA1_set_channel3_source_addr(unsigned int source_buf_addr, unsigned short source_buf_size) {
+void __attribute__((section(".ramfunc"))) DMA1_set_channel3_source_addr(unsigned int source_buf_addr, unsigned short source_buf_size) {
 	// Set address.
 	DMA1 -> CMAR3 = source_buf_addr;
 	// Set buffer size.
@@ -104,16 +141,212 @@ void DMA1_set_channel3_source_addr(unsigned int source_buf_addr, unsigned short
  * @param:	None.
  * @return:	'1' if the transfer is complete, '0' otherwise.
  */
-unsigned char DMA1_get_channel3_status(void) {
+unsigned char __attribute__((section(".ramfunc"))) DMA1_get_channel3_status(void) {
 	return dma1_channel3_tcif;
 }
 
+/* CONFIGURE DMA1 CHANNEL1 FOR AES INPUT TRANSFER.
+ * @param:	None.
+ * @return:	None.
+ */
+void DMA1_init_channel1(void) {
+	// Enable peripheral clock.
+	RCC -> AHBENR |= (0b1 << 0); // DMAEN='1'.
+	// Disable DMA channel before configuration (EN='0').
+	// Disable memory to memory mode (MEM2MEM='0').
+	// Peripheral increment mode disabled (PINC='0').
+	// Circular mode disabled (CIRC='0').
+	DMA1 -> CCR1 &= 0xFFFF8000;
+	DMA1 -> CCR1 |= (0b10 << 12); // High priority (PL='10').
+	DMA1 -> CCR1 |= (0b10 << 10) | (0b10 << 8); // Memory and peripheral data size are 32 bits (MSIZE='10' and PSIZE='10').
+	DMA1 -> CCR1 |= (0b1 << 7); // Memory increment mode enabled (MINC='1').
+	DMA1 -> CCR1 |= (0b1 << 4); // Read from memory (DIR='1').
+	// Configure peripheral address.
+	DMA1 -> CPAR1 = (unsigned long) &(AES -> DINR); // Peripheral address = AES input data register.
+	// Configure channel 1 for AES input (request number 11).
+	DMA1 -> CSELR &= ~(0b1111 << 0); // Reset bits 0-3.
+	DMA1 -> CSELR |= (0b1011 << 0); // DMA channel mapped on AES_IN (C1S='1011').
+	// Clear all flags.
+	DMA1 -> IFCR |= 0x0000000F;
+}
+
+/* CONFIGURE DMA1 CHANNEL1 FOR ADC SCAN TRANSFER.
+ * @param:	None.
+ * @return:	None.
+ */
+void DMA1_init_channel1_adc(void) {
+	// Enable peripheral clock.
+	RCC -> AHBENR |= (0b1 << 0); // DMAEN='1'.
+	// Disable DMA channel before configuration (EN='0').
+	// Disable memory to memory mode (MEM2MEM='0').
+	// Peripheral increment mode disabled (PINC='0').
+	// Circular mode disabled (CIRC='0').
+	// Read from peripheral (DIR='0').
+	DMA1 -> CCR1 &= 0xFFFF8000;
+	DMA1 -> CCR1 |= (0b01 << 12); // Medium priority (PL='01').
+	DMA1 -> CCR1 |= (0b01 << 10) | (0b01 << 8); // Memory and peripheral data size are 16 bits (MSIZE='01' and PSIZE='01').
+	DMA1 -> CCR1 |= (0b1 << 7); // Memory increment mode enabled (MINC='1').
+	DMA1 -> CCR1 |= (0b1 << 1); // Enable transfer complete interrupt (TCIE='1').
+	// Configure peripheral address.
+	DMA1 -> CPAR1 = (unsigned long) &(ADC1 -> DR); // Peripheral address = ADC data register.
+	// Configure channel 1 for ADC (request number 0).
+	DMA1 -> CSELR &= ~(0b1111 << 0); // DMA channel mapped on ADC (C1S='0000').
+	// Clear all flags.
+	DMA1 -> IFCR |= 0x0000000F;
+	// Set interrupt priority.
+	NVIC_set_priority(NVIC_IT_DMA1_CHA1, 2);
+}
+
+/* START DMA1 CHANNEL 1 TRANSFER.
+ * @param:	None.
+ * @return:	None.
+ */
+void DMA1_start_channel1(void) {
+	// Clear all flags.
+	dma1_channel1_tcif = 0;
+	DMA1 -> IFCR |= 0x0000000F;
+	// Enable interrupt if required by current configuration.
+	if (((DMA1 -> CCR1) & (0b1 << 1)) != 0) {
+		NVIC_enable_interrupt(NVIC_IT_DMA1_CHA1);
+	}
+	// DMA requires bus clock.
+	PWR_set_mode_vote(PWR_REQUESTER_DMA1_CHANNEL1, PWR_MODE_SLEEP);
+	// Start transfer.
+	DMA1 -> CCR1 |= (0b1 << 0); // EN='1'.
+}
+
+/* STOP DMA1 CHANNEL 1 TRANSFER.
+ * @param:	None.
+ * @return:	None.
+ */
+void DMA1_stop_channel1(void) {
+	// Stop transfer.
+	dma1_channel1_tcif = 0;
+	DMA1 -> CCR1 &= ~(0b1 << 0); // EN='0'.
+	PWR_set_mode_vote(PWR_REQUESTER_DMA1_CHANNEL1, PWR_MODE_STOP);
+	NVIC_disable_interrupt(NVIC_IT_DMA1_CHA1);
+}
+
+/* SET DMA1 CHANNEL 1 SOURCE BUFFER ADDRESS.
+ * @param source_buf_addr:	Address of source buffer (32-bits aligned).
+ * @param source_buf_size:	Number of 32-bits words to transfer.
+ * @return:					None.
+ */
+void DMA1_set_channel1_source_addr(unsigned int source_buf_addr, unsigned short source_buf_size) {
+	// Set address.
+	DMA1 -> CMAR1 = source_buf_addr;
+	// Set buffer size.
+	DMA1 -> CNDTR1 = source_buf_size;
+	// Clear all flags.
+	DMA1 -> IFCR |= 0x0000000F;
+}
+
+/* SET DMA1 CHANNEL 1 DESTINATION BUFFER ADDRESS.
+ * @param dest_buf_addr:	Address of destination buffer (16-bits aligned).
+ * @param dest_buf_size:	Number of 16-bits words to transfer.
+ * @return:					None.
+ */
+void DMA1_set_channel1_dest_addr(unsigned int dest_buf_addr, unsigned short dest_buf_size) {
+	// Set address.
+	DMA1 -> CMAR1 = dest_buf_addr;
+	// Set buffer size.
+	DMA1 -> CNDTR1 = dest_buf_size;
+	// Clear all flags.
+	DMA1 -> IFCR |= 0x0000000F;
+}
+
+/* GET DMA1 CHANNEL 1 TRANSFER STATUS.
+ * @param:	None.
+ * @return:	'1' if the transfer is complete, '0' otherwise.
+ */
+unsigned char DMA1_get_channel1_status(void) {
+	return dma1_channel1_tcif;
+}
+
+/* CONFIGURE DMA1 CHANNEL2 FOR AES OUTPUT TRANSFER.
+ * @param:	None.
+ * @return:	None.
+ */
+void DMA1_init_channel2(void) {
+	// Enable peripheral clock.
+	RCC -> AHBENR |= (0b1 << 0); // DMAEN='1'.
+	// Disable DMA channel before configuration (EN='0').
+	// Disable memory to memory mode (MEM2MEM='0').
+	// Peripheral increment mode disabled (PINC='0').
+	// Circular mode disabled (CIRC='0').
+	// Read from peripheral (DIR='0').
+	DMA1 -> CCR2 &= 0xFFFF8000;
+	DMA1 -> CCR2 |= (0b10 << 12); // High priority (PL='10').
+	DMA1 -> CCR2 |= (0b10 << 10) | (0b10 << 8); // Memory and peripheral data size are 32 bits (MSIZE='10' and PSIZE='10').
+	DMA1 -> CCR2 |= (0b1 << 7); // Memory increment mode enabled (MINC='1').
+	DMA1 -> CCR2 |= (0b1 << 1); // Enable transfer complete interrupt (TCIE='1').
+	// Configure peripheral address.
+	DMA1 -> CPAR2 = (unsigned long) &(AES -> DOUTR); // Peripheral address = AES output data register.
+	// Configure channel 2 for AES output (request number 11).
+	DMA1 -> CSELR &= ~(0b1111 << 4); // Reset bits 4-7.
+	DMA1 -> CSELR |= (0b1011 << 4); // DMA channel mapped on AES_OUT (C2S='1011').
+	// Clear all flags.
+	DMA1 -> IFCR |= 0x000000F0;
+	// Set interrupt priority.
+	NVIC_set_priority(NVIC_IT_DMA1_CH_2_3, 1);
+}
+
+/* START DMA1 CHANNEL 2 TRANSFER.
+ * @param:	None.
+ * @return:	None.
+ */
+void DMA1_start_channel2(void) {
+	// Clear all flags.
+	dma1_channel2_tcif = 0;
+	DMA1 -> IFCR |= 0x000000F0;
+	NVIC_enable_interrupt(NVIC_IT_DMA1_CH_2_3);
+	// DMA requires bus clock.
+	PWR_set_mode_vote(PWR_REQUESTER_DMA1_CHANNEL2, PWR_MODE_SLEEP);
+	// Start transfer.
+	DMA1 -> CCR2 |= (0b1 << 0); // EN='1'.
+}
+
+/* STOP DMA1 CHANNEL 2 TRANSFER.
+ * @param:	None.
+ * @return:	None.
+ */
+void DMA1_stop_channel2(void) {
+	// Stop transfer.
+	dma1_channel2_tcif = 0;
+	DMA1 -> CCR2 &= ~(0b1 << 0); // EN='0'.
+	PWR_set_mode_vote(PWR_REQUESTER_DMA1_CHANNEL2, PWR_MODE_STOP);
+	NVIC_disable_interrupt(NVIC_IT_DMA1_CH_2_3);
+}
+
+/* SET DMA1 CHANNEL 2 DESTINATION BUFFER ADDRESS.
+ * @param dest_buf_addr:	Address of destination buffer (32-bits aligned).
+ * @param dest_buf_size:	Number of 32-bits words to transfer.
+ * @return:					None.
+ */
+void DMA1_set_channel2_dest_addr(unsigned int dest_buf_addr, unsigned short dest_buf_size) {
+	// Set address.
+	DMA1 -> CMAR2 = dest_buf_addr;
+	// Set buffer size.
+	DMA1 -> CNDTR2 = dest_buf_size;
+	// Clear all flags.
+	DMA1 -> IFCR |= 0x000000F0;
+}
+
+/* GET DMA1 CHANNEL 2 TRANSFER STATUS.
+ * @param:	None.
+ * @return:	'1' if the transfer is complete, '0' otherwise.
+ */
+unsigned char DMA1_get_channel2_status(void) {
+	return dma1_channel2_tcif;
+}
+
 /* DISABLE DMA1 PERIPHERAL.
  * @param:	None.
  * @return:	None.
  */
 void DMA1_disable(void) {
 	// Disable interrupts.
+	NVIC_disable_interrupt(NVIC_IT_DMA1_CHA1);
 	NVIC_disable_interrupt(NVIC_IT_DMA1_CH_2_3);
 	// Clear all flags.
 	DMA1 -> IFCR |= 0x0FFFFFFF;
@@ -10,29 +10,37 @@
 #include "exti_reg.h"
 #include "mapping.h"
 #include "nvic.h"
+#include "probe.h"
 #include "rcc_reg.h"
 #include "rf_api.h"
 #include "syscfg_reg.h"
+#include "trace.h"
 
 /*** EXTI local macros ***/
 
 #define EXTI_RTSR_FTSR_MAX_INDEX	22
 
+/*** EXTI local global variables ***/
+
+static unsigned int exti_s2lp_gpio0_mask = 0; // Copy of S2LP GPIO0 pin mask (mapping constants are located in flash).
+
 /*** EXTI local functions ***/
 
 /* EXTI LINES 4-15 INTERRUPT HANDLER.
  * @param:	None.
  * @return:	None.
  */
-void __attribute__((optimize("-O0"))) EXTI4_15_IRQHandler(void) {
+void __attribute__((optimize("-O0"), section(".ramfunc"))) EXTI4_15_IRQHandler(void) {
+	PROBE_high(PROBE_UPLINK_REFILL_TP);
+	TRACE_event(TRACE_EVENT_EXTI4_15_IRQ, EXTI -> PR);
 	// S2LP GPIO0 (PA11).
-	if (((EXTI -> PR) & (0b1 << (GPIO_S2LP_GPIO0.pin_index))) != 0) {
+	if (((EXTI -> PR) & exti_s2lp_gpio0_mask) != 0) {
 		// Set applicative flag.
-		if (((EXTI -> IMR) & (0b1 << (GPIO_S2LP_GPIO0.pin_index))) != 0) {
+		if (((EXTI -> IMR) & exti_s2lp_gpio0_mask) != 0) {
 			RF_API_SetIrqFlag();
 		}
 		// Clear flag.
-		EXTI -> PR |= (0b1 << (GPIO_S2LP_GPIO0.pin_index)); // PIFx='1' (writing '1' clears the bit).
+		EXTI -> PR |= exti_s2lp_gpio0_mask; // PIFx='1' (writing '1' clears the bit).
 	}
 }
 
@@ -47,6 +55,7 @@ void EXTI_init(void) {
 	RCC -> APB2ENR |= (0b1 << 0); // SYSCFEN='1'.
 	// Mask all sources by default.
 	EXTI -> IMR = 0;
+	exti_s2lp_gpio0_mask = (0b1 << (GPIO_S2LP_GPIO0.pin_index));
 	// Clear all flags.
 	EXTI -> PR |= 0x007BFFFF; // PIFx='1'.
 	// Set interrupts priority.
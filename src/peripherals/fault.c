@@ -5,6 +5,7 @@
  *      Author: Ludo
  */
 
+#include "nvm.h"
 #include "scb_reg.h"
 
 /* NON MASKABLE INTERRUPT HANDLER.
@@ -12,6 +13,8 @@
  * @return:	None.
  */
 void __attribute__((optimize("-O0"))) NMI_Handler(void) {
+	// Complete pending NVM writes.
+	NVM_flush();
 	// Trigger software reset.
 	SCB -> AIRCR = 0x05FA0000 | ((SCB -> AIRCR) & 0x0000FFFF) | (0b1 << 2);
 }
@@ -21,6 +24,8 @@ void __attribute__((optimize("-O0"))) NMI_Handler(void) {
  * @return:	None.
  */
 void __attribute__((optimize("-O0"))) HardFault_Handler(void) {
+	// Complete pending NVM writes.
+	NVM_flush();
 	// Trigger software reset.
 	SCB -> AIRCR = 0x05FA0000 | ((SCB -> AIRCR) & 0x0000FFFF) | (0b1 << 2);
 }
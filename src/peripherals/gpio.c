@@ -186,6 +186,12 @@ void GPIO_init(void) {
 	GPIO_configure(&GPIO_SWDIO, GPIO_MODE_ANALOG, GPIO_TYPE_OPEN_DRAIN, GPIO_SPEED_LOW, GPIO_PULL_NONE);
 	GPIO_configure(&GPIO_SWCLK, GPIO_MODE_ANALOG, GPIO_TYPE_OPEN_DRAIN, GPIO_SPEED_LOW, GPIO_PULL_NONE);
 #endif
+#ifdef PROBE
+	// Timing probes.
+	GPIO_configure(&GPIO_TP1, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_VERY_HIGH, GPIO_PULL_NONE);
+	GPIO_configure(&GPIO_TP2, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_VERY_HIGH, GPIO_PULL_NONE);
+	GPIO_configure(&GPIO_TP3, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_VERY_HIGH, GPIO_PULL_NONE);
+#endif
 }
 
 /* SET THE STATE OF A GPIO.
@@ -193,7 +199,7 @@ void GPIO_init(void) {
  * @param state: 	GPIO output state ('0' or '1').
  * @return: 		None.
  */
-void __attribute__((optimize("-O0"))) GPIO_write(const GPIO_pin_t* gpio, unsigned char state) {
+void __attribute__((optimize("-O0"), section(".ramfunc"))) GPIO_write(const GPIO_pin_t* gpio, unsigned char state) {
 	// Set bit.
 	if (state == 0) {
 		(gpio -> port_address) -> ODR &= ~(0b1 << (gpio -> pin_index));
@@ -7,23 +7,37 @@
 
 #include "lptim.h"
 
+#include "core.h"
 #include "exti.h"
 #include "lptim_reg.h"
 #include "nvic.h"
 #include "pwr.h"
 #include "rcc.h"
 #include "rcc_reg.h"
+#include "trace.h"
 
 /*** LPTIM local macros ***/
 
-#define LPTIM_TIMEOUT_COUNT		1000000
-#define LPTIM_DELAY_MS_MIN		1
-#define LPTIM_DELAY_MS_MAX		55000
+#define LPTIM_TIMEOUT_COUNT			1000000
+#define LPTIM_DELAY_MS_MIN			1
+#define LPTIM_DELAY_MS_MAX			55000
+#define LPTIM_CNT_MAX				0xFFFF
+#define LPTIM_CMP_MAX				(LPTIM_CNT_MAX - 1) // CMP must be strictly lower than ARR.
+#define LPTIM_CMP_IDLE				LPTIM_CMP_MAX
+#define LPTIM_DELAY_STEP_TICKS_MAX	0x8000 // Half a counter period to keep compare match unambiguous.
+#define LPTIM_DELAY_STEP_TICKS_MIN	4 // Below this value, compare register write latency is too long: poll counter.
+
+/*** LPTIM local structures ***/
+
+typedef struct {
+	volatile unsigned int overflow_count;
+	volatile unsigned char compare_armed;
+	volatile unsigned char wake_up;
+} LPTIM_context_t;
 
 /*** LPTIM local global variables ***/
 
-static unsigned int lptim_clock_frequency_hz = 0;
-static volatile unsigned char lptim_wake_up = 0;
+static LPTIM_context_t lptim_ctx;
 
 /*** LPTIM local functions ***/
 
@@ -32,14 +46,21 @@ static volatile unsigned char lptim_wake_up = 0;
  * @return:	None.
  */
 void __attribute__((optimize("-O0"))) LPTIM1_IRQHandler(void) {
-	// Check flag.
+	TRACE_event(TRACE_EVENT_LPTIM1_IRQ, LPTIM1 -> ISR);
+	// Autoreload match: extend counter.
 	if (((LPTIM1 -> ISR) & (0b1 << 1)) != 0) {
+		lptim_ctx.overflow_count++;
+		// Clear flag.
+		LPTIM1 -> ICR |= (0b1 << 1);
+	}
+	// Compare match: end of delay step.
+	if (((LPTIM1 -> ISR) & (0b1 << 0)) != 0) {
 		// Set local flag.
-		if (((LPTIM1 -> IER) & (0b1 << 1)) != 0) {
-			lptim_wake_up = 1;
+		if (lptim_ctx.compare_armed != 0) {
+			lptim_ctx.wake_up = 1;
 		}
 		// Clear flag.
-		LPTIM1 -> ICR |= (0b1 << 1);
+		LPTIM1 -> ICR |= (0b1 << 0);
 	}
 }
 
@@ -49,45 +70,78 @@ void __attribute__((optimize("-O0"))) LPTIM1_IRQHandler(void) {
  */
 static void LPTIM1_write_arr(unsigned int arr_value) {
 	unsigned int loop_count = 0;
-	// Reset bits.
+	// Write new value.
 	LPTIM1 -> ICR |= (0b1 << 4);
-	LPTIM1 -> ARR = 0;
+	LPTIM1 -> ARR = arr_value;
 	while (((LPTIM1 -> ISR) & (0b1 << 4)) == 0) {
 		// Wait for ARROK='1' or timeout.
 		loop_count++;
 		if (loop_count > LPTIM_TIMEOUT_COUNT) break;
 	}
+}
+
+/* WRITE CMP REGISTER.
+ * @param cmp_value:	CMP register value to write.
+ * @return:				None.
+ */
+static void LPTIM1_write_cmp(unsigned int cmp_value) {
+	unsigned int loop_count = 0;
 	// Write new value.
-	LPTIM1 -> ICR |= (0b1 << 4);
-	LPTIM1 -> ARR |= arr_value;
-	loop_count = 0;
-	while (((LPTIM1 -> ISR) & (0b1 << 4)) == 0) {
-		// Wait for ARROK='1' or timeout.
+	LPTIM1 -> ICR |= (0b1 << 3);
+	LPTIM1 -> CMP = cmp_value;
+	while (((LPTIM1 -> ISR) & (0b1 << 3)) == 0) {
+		// Wait for CMPOK='1' or timeout.
 		loop_count++;
 		if (loop_count > LPTIM_TIMEOUT_COUNT) break;
 	}
 }
 
+/* READ COUNTER REGISTER.
+ * @param:	None.
+ * @return:	Current counter value.
+ */
+static unsigned int __attribute__((section(".ramfunc"))) LPTIM1_read_cnt(void) {
+	// Local variables.
+	unsigned int cnt = 0;
+	// Counter is clocked asynchronously: read until two consecutive values match.
+	do {
+		cnt = (LPTIM1 -> CNT);
+	}
+	while (cnt != (LPTIM1 -> CNT));
+	return cnt;
+}
+
 /*** LPTIM functions ***/
 
-/* INIT LPTIM FOR DELAY OPERATION.
+/* INIT LPTIM AS FREE RUNNING MONOTONIC CLOCK.
  * @param:	None.
  * @return:	None.
  */
 void LPTIM1_init(void) {
+	// Init context.
+	lptim_ctx.overflow_count = 0;
+	lptim_ctx.compare_armed = 0;
+	lptim_ctx.wake_up = 0;
 	// Select LSE as clock source.
 	RCC -> CCIPR |= (0b11 << 18); // LPTIMSEL='11'.
-	lptim_clock_frequency_hz = (RCC_LSE_FREQUENCY_HZ >> 5);
 	// Enable peripheral clock.
 	RCC -> APB1ENR |= (0b1 << 31); // LPTIM1EN='1'.
 	// Configure peripheral.
-	LPTIM1 -> CR &= ~(0b1 << 0); // Disable LPTIM1 (ENABLE='0'), needed to write CFGR.
-	LPTIM1 -> CFGR |= (0b101 << 9); // Prescaler = 32.
+	LPTIM1 -> CR &= ~(0b1 << 0); // Disable LPTIM1 (ENABLE='0'), needed to write CFGR and IER.
+	LPTIM1 -> CFGR &= ~(0b111 << 9);
+	LPTIM1 -> CFGR |= (LPTIM_PRESCALER_LOG2 << 9); // Prescaler = 8.
+	LPTIM1 -> IER |= (0b11 << 0); // CMPMIE='1' and ARRMIE='1'.
+	// Enable timer and start continuous counting (counter survives stop mode).
+	LPTIM1 -> CR |= (0b1 << 0); // Enable LPTIM1 (ENABLE='1').
+	LPTIM1_write_arr(LPTIM_CNT_MAX);
+	LPTIM1_write_cmp(LPTIM_CMP_IDLE);
+	LPTIM1 -> ICR |= (0b1111111 << 0);
+	LPTIM1 -> CR |= (0b1 << 2); // CNTSTRT='1'.
 	// Enable LPTIM EXTI line.
-	LPTIM1 -> IER |= (0b1 << 1); // ARRMIE='1'.
 	EXTI_configure_line(EXTI_LINE_LPTIM1, EXTI_TRIGGER_RISING_EDGE);
 	// Set interrupt priority.
 	NVIC_set_priority(NVIC_IT_LPTIM1, 2);
+	NVIC_enable_interrupt(NVIC_IT_LPTIM1);
 }
 
 /* ENABLE LPTIM1 PERIPHERAL.
@@ -102,48 +156,118 @@ void LPTIM1_enable(void) {
 /* DISABLE LPTIM1 PERIPHERAL.
  * @param:	None.
  * @return:	None.
+ * Warning: this stops the monotonic clock, LPTIM1_init() must be called again to restart it.
  */
 void LPTIM1_disable(void) {
+	// Disable interrupt.
+	NVIC_disable_interrupt(NVIC_IT_LPTIM1);
 	// Disable timer.
 	LPTIM1 -> CR &= ~(0b1 << 0); // Disable LPTIM1 (ENABLE='0').
 	// Disable peripheral clock.
 	RCC -> APB1ENR &= ~(0b1 << 31); // LPTIM1EN='0'.
 }
 
+/* GET MONOTONIC TIMESTAMP IN TICKS (64-BITS EXTENDED COUNTER).
+ * @param:	None.
+ * @return:	Number of LPTIM_TICK_FREQUENCY_HZ ticks since LPTIM1_init() (never wraps around).
+ */
+unsigned long long __attribute__((section(".ramfunc"))) LPTIM1_get_timestamp_ticks_64(void) {
+	// Local variables.
+	unsigned int overflow_count = 0;
+	unsigned int cnt = 0;
+	// Retry if an overflow interrupt occured during the read.
+	do {
+		overflow_count = lptim_ctx.overflow_count;
+		cnt = LPTIM1_read_cnt();
+		// Take into account an autoreload match which is not serviced yet (interrupts masked).
+		// Match occurs when CNT reaches ARR: a flag read after a counter value of the lower half period belongs to the last match.
+		if ((((LPTIM1 -> ISR) & (0b1 << 1)) != 0) && ((cnt == LPTIM_CNT_MAX) || (cnt < LPTIM_DELAY_STEP_TICKS_MAX))) {
+			overflow_count++;
+		}
+	}
+	while (overflow_count < lptim_ctx.overflow_count);
+	// ARRM is set one tick before the counter rolls over: while CNT=ARR, the match of the current period is already counted.
+	return ((((unsigned long long) overflow_count) << 16) + ((cnt + 1) & LPTIM_CNT_MAX) - 1);
+}
+
+/* GET MONOTONIC TIMESTAMP IN TICKS.
+ * @param:	None.
+ * @return:	Number of LPTIM_TICK_FREQUENCY_HZ ticks since LPTIM1_init() (wraps around after ~12 days).
+ */
+unsigned int __attribute__((section(".ramfunc"))) LPTIM1_get_timestamp_ticks(void) {
+	return (unsigned int) LPTIM1_get_timestamp_ticks_64();
+}
+
+/* GET MONOTONIC TIMESTAMP IN MICROSECONDS.
+ * @param:	None.
+ * @return:	Number of microseconds since LPTIM1_init() (wraps around after ~71 minutes, resolution 244us).
+ */
+unsigned int LPTIM1_get_timestamp_us(void) {
+	// us = ticks * 10^6 / 2^12 = ticks * 15625 / 2^6.
+	return (unsigned int) ((LPTIM1_get_timestamp_ticks_64() * 15625) >> (LPTIM_TICK_FREQUENCY_LOG2 - 6));
+}
+
+/* GET MONOTONIC TIMESTAMP IN MILLISECONDS.
+ * @param:	None.
+ * @return:	Number of milliseconds since LPTIM1_init() (wraps around after ~49 days).
+ */
+unsigned int LPTIM1_get_timestamp_ms(void) {
+	// ms = ticks * 10^3 / 2^12 = ticks * 125 / 2^9.
+	return (unsigned int) ((LPTIM1_get_timestamp_ticks_64() * 125) >> (LPTIM_TICK_FREQUENCY_LOG2 - 3));
+}
+
 /* DELAY FUNCTION.
  * @param delay_ms:		Number of milliseconds to wait.
- * @param stop_mode:	Enter stop mode during delay if non zero.
+ * @param stop_mode:	Enter low power mode (deepest allowed by PWR votes) during delay if non zero.
  * @return:				None.
  */
 void LPTIM1_delay_milliseconds(unsigned int delay_ms, unsigned char stop_mode) {
-	// Clamp value if required.
+	// Local variables.
 	unsigned int local_delay_ms = delay_ms;
+	unsigned int delay_ticks = 0;
+	unsigned int start_ticks = 0;
+	unsigned int elapsed_ticks = 0;
+	unsigned int step_ticks = 0;
+	// Clamp value if required.
 	if (local_delay_ms > LPTIM_DELAY_MS_MAX) {
 		local_delay_ms = LPTIM_DELAY_MS_MAX;
 	}
 	if (local_delay_ms < LPTIM_DELAY_MS_MIN) {
 		local_delay_ms = LPTIM_DELAY_MS_MIN;
 	}
-	// Enable timer.
-	LPTIM1 -> CR |= (0b1 << 0); // Enable LPTIM1 (ENABLE='1').
-	// Reset counter.
-	LPTIM1 -> CNT = 0;
-	// Compute ARR value.
-	unsigned int arr = ((local_delay_ms * lptim_clock_frequency_hz) / (1000)) & 0x0000FFFF;
-	LPTIM1_write_arr(arr);
-	// Clear all flags.
-	LPTIM1 -> ICR |= (0b1111111 << 0);
-	NVIC_enable_interrupt(NVIC_IT_LPTIM1);
-	lptim_wake_up = 0;
-	// Start timer.
-	LPTIM1 -> CR |= (0b1 << 1); // SNGSTRT='1'.
-	// Wait for interrupt.
-	while (lptim_wake_up == 0) {
-		if (stop_mode != 0) {
-			PWR_enter_stop_mode();
+	// Convert to ticks (rounded up).
+	delay_ticks = ((local_delay_ms << LPTIM_TICK_FREQUENCY_LOG2) + 999) / 1000;
+	start_ticks = LPTIM1_get_timestamp_ticks();
+	while (1) {
+		elapsed_ticks = LPTIM1_get_timestamp_ticks() - start_ticks;
+		if (elapsed_ticks >= delay_ticks) break;
+		step_ticks = delay_ticks - elapsed_ticks;
+		if (step_ticks > LPTIM_DELAY_STEP_TICKS_MAX) {
+			step_ticks = LPTIM_DELAY_STEP_TICKS_MAX;
+		}
+		// Poll counter for very short steps.
+		if (step_ticks < LPTIM_DELAY_STEP_TICKS_MIN) continue;
+		// Program compare match at the end of the step.
+		lptim_ctx.wake_up = 0;
+		lptim_ctx.compare_armed = 1;
+		LPTIM1_write_cmp(((LPTIM1_read_cnt() + step_ticks) & LPTIM_CNT_MAX) % LPTIM_CNT_MAX);
+		// Wait for interrupt (flag is checked with interrupts masked so that a match occuring before WFI is not missed).
+		while (1) {
+			CORE_disable_interrupts();
+			if (lptim_ctx.wake_up != 0) {
+				CORE_enable_interrupts();
+				break;
+			}
+			if (stop_mode != 0) {
+				PWR_enter_low_power_mode();
+			}
+			else {
+				PWR_enter_sleep_mode();
+			}
+			CORE_enable_interrupts();
 		}
 	}
-	// Disable timer.
-	LPTIM1 -> CR &= ~(0b1 << 0); // Disable LPTIM1 (ENABLE='0').
-	NVIC_disable_interrupt(NVIC_IT_LPTIM1);
+	// Restore idle compare value.
+	lptim_ctx.compare_armed = 0;
+	LPTIM1_write_cmp(LPTIM_CMP_IDLE);
 }
@@ -0,0 +1,85 @@
+/*
+ * mem.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "mem.h"
+
+/*** MEM linker generated symbols ***/
+
+extern unsigned int __etext;
+extern unsigned int __data_start__;
+extern unsigned int __ramfunc_start__;
+extern unsigned int __ramfunc_end__;
+extern unsigned int __data_end__;
+extern unsigned int __bss_start__;
+extern unsigned int __bss_end__;
+extern unsigned int __HeapBase;
+extern unsigned int __HeapLimit;
+extern unsigned int __StackLimit;
+extern unsigned int __StackTop;
+
+/*** MEM local macros ***/
+
+#define MEM_FLASH_ORIGIN			0x08000000
+#define MEM_STACK_MARGIN_WORDS		16 // Not painted below the painting function frame.
+
+/*** MEM local global variables ***/
+
+static unsigned int mem_stack_used_max_bytes = 0; // High-water mark before last repainting.
+
+/*** MEM functions ***/
+
+/* GET STACK DEPTH REACHED SINCE LAST PAINTING.
+ * @param:	None.
+ * @return:	Number of bytes used from the top of stack.
+ */
+unsigned int MEM_get_stack_used(void) {
+	// Local variables.
+	unsigned int* stack_word = &__StackLimit;
+	// Search first word overwritten since stack painting (stack grows downwards).
+	while ((stack_word < &__StackTop) && ((*stack_word) == MEM_STACK_PATTERN)) {
+		stack_word++;
+	}
+	return (unsigned int) ((&__StackTop - stack_word) * sizeof(unsigned int));
+}
+
+/* GET STATIC MEMORY USAGE AND STACK HIGH-WATER MARK.
+ * @param statistics:	Pointer to the structure that will contain the sizes in bytes.
+ * @return:				None.
+ */
+void MEM_get_statistics(MEM_statistics_t* statistics) {
+	// Local variables.
+	unsigned int stack_used_bytes = MEM_get_stack_used();
+	// Static usage.
+	statistics -> data_bytes = (unsigned int) ((&__data_end__ - &__data_start__) * sizeof(unsigned int));
+	statistics -> ramfunc_bytes = (unsigned int) ((&__ramfunc_end__ - &__ramfunc_start__) * sizeof(unsigned int));
+	statistics -> flash_bytes = ((unsigned int) &__etext - MEM_FLASH_ORIGIN) + (statistics -> data_bytes);
+	statistics -> bss_bytes = (unsigned int) ((&__bss_end__ - &__bss_start__) * sizeof(unsigned int));
+	statistics -> heap_bytes = (unsigned int) ((&__HeapLimit - &__HeapBase) * sizeof(unsigned int));
+	statistics -> stack_bytes = (unsigned int) ((&__StackTop - &__StackLimit) * sizeof(unsigned int));
+	// Stack high-water mark is kept over repaintings.
+	statistics -> stack_used_bytes = (stack_used_bytes > mem_stack_used_max_bytes) ? stack_used_bytes : mem_stack_used_max_bytes;
+}
+
+/* REPAINT UNUSED STACK TO MEASURE THE DEPTH OF A CODE SECTION (HIGH-WATER MARK SINCE RESET IS KEPT).
+ * @param:	None.
+ * @return:	None.
+ */
+void __attribute__((noinline)) MEM_paint_stack(void) {
+	// Local variables.
+	volatile unsigned int marker = 0;
+	unsigned int* paint_end = ((unsigned int*) &marker) - MEM_STACK_MARGIN_WORDS;
+	unsigned int* stack_word = &__StackLimit;
+	unsigned int stack_used_bytes = MEM_get_stack_used();
+	// Save high-water mark before erasing it.
+	if (stack_used_bytes > mem_stack_used_max_bytes) {
+		mem_stack_used_max_bytes = stack_used_bytes;
+	}
+	while (stack_word < paint_end) {
+		(*stack_word) = MEM_STACK_PATTERN;
+		stack_word++;
+	}
+}
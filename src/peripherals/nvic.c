@@ -10,25 +10,39 @@
 #include "nvic_reg.h"
 #include "scb_reg.h"
 
+/*** NVIC local macros ***/
+
+#define NVIC_VECTOR_TABLE_LENGTH	48 // 16 core exceptions and 32 external interrupts.
+
+/*** NVIC local structures ***/
+
+typedef void (*NVIC_vector_t)(void);
+
 /*** NVIC local global variables ***/
 
-extern unsigned int __Vectors;
+extern const NVIC_vector_t __Vectors[];
+// Vector table copy (exception entries do not fetch vectors from flash, which is powered down in sleep mode).
+static NVIC_vector_t nvic_vector_table[NVIC_VECTOR_TABLE_LENGTH] __attribute__((section("vtable"), aligned(256)));
 
 /*** NVIC functions ***/
 
-/* INIT VECTOR TABLE ADDRESS.
+/* COPY VECTOR TABLE TO RAM AND INIT VECTOR TABLE ADDRESS.
  * @param:	None.
  * @return:	None.
  */
 void NVIC_init(void) {
-	SCB -> VTOR = (unsigned int) &__Vectors;
+	// Local variables.
+	unsigned char idx = 0;
+	// Copy vectors.
+	for (idx=0 ; idx<NVIC_VECTOR_TABLE_LENGTH ; idx++) nvic_vector_table[idx] = __Vectors[idx];
+	SCB -> VTOR = (unsigned long) nvic_vector_table;
 }
 
 /* ENABLE AN INTERRUPT LINE.
  * @param it_num: 	Interrupt number (use enum defined in 'nvic.h').
  * @return: 		None.
  */
-void NVIC_enable_interrupt(NVIC_interrupt_t it_num) {
+void __attribute__((section(".ramfunc"))) NVIC_enable_interrupt(NVIC_interrupt_t it_num) {
 	NVIC -> ISER = (0b1 << (it_num & 0x1F));
 }
 
@@ -36,7 +50,7 @@ void NVIC_enable_interrupt(NVIC_interrupt_t it_num) {
  * @param it_num: 	Interrupt number (use enum defined in 'nvic.h').
  * @return:			None.
  */
-void NVIC_disable_interrupt(NVIC_interrupt_t it_num) {
+void __attribute__((section(".ramfunc"))) NVIC_disable_interrupt(NVIC_interrupt_t it_num) {
 	NVIC -> ICER = (0b1 << (it_num & 0x1F));
 }
 
@@ -8,8 +8,35 @@
 #include "nvm.h"
 
 #include "flash_reg.h"
+#include "nvic.h"
+#include "pwr.h"
 #include "rcc_reg.h"
 
+/*** NVM local macros ***/
+
+#define NVM_WRITE_QUEUE_LENGTH		16
+#define NVM_FLASH_SR_EOP			(0b1 << 1)
+#define NVM_FLASH_SR_ERRORS			0x00032F00 // WRPERR, PGAERR, SIZERR, OPTVERR, RDERR, NOTZEROERR and FWWERR.
+
+/*** NVM local structures ***/
+
+typedef struct {
+	unsigned short address_offset;
+	unsigned char data;
+} NVM_write_request_t;
+
+typedef struct {
+	NVM_write_request_t write_queue[NVM_WRITE_QUEUE_LENGTH];
+	volatile unsigned char write_queue_read_idx;
+	volatile unsigned char write_queue_count;
+	volatile unsigned char write_running;
+	volatile unsigned char disable_request;
+} NVM_context_t;
+
+/*** NVM local global variables ***/
+
+static NVM_context_t nvm_ctx;
+
 /*** NVM local functions ***/
 
 /* UNLOCK NVM.
@@ -38,13 +65,74 @@ static void NVM_lock(void) {
 	FLASH -> PECR |= (0b1 << 0); // PELOCK='1'.
 }
 
+/* START PROGRAMMING THE NEXT QUEUED BYTE (CALLED WITH FLASH INTERRUPT MASKED OR FROM FLASH INTERRUPT).
+ * @param:	None.
+ * @return:	None.
+ */
+static void NVM_program_next(void) {
+	// Local variables.
+	NVM_write_request_t request;
+	volatile unsigned char* eeprom_byte = 0;
+	// Pop requests until one actually needs programming.
+	while (nvm_ctx.write_queue_count > 0) {
+		request = nvm_ctx.write_queue[nvm_ctx.write_queue_read_idx];
+		nvm_ctx.write_queue_read_idx = (nvm_ctx.write_queue_read_idx + 1) % NVM_WRITE_QUEUE_LENGTH;
+		nvm_ctx.write_queue_count--;
+		// Skip write if EEPROM already contains the value.
+		eeprom_byte = (volatile unsigned char*) (EEPROM_START_ADDRESS + request.address_offset);
+		if ((*eeprom_byte) == request.data) continue;
+		// Start programming (end of operation is signaled by EOP flag).
+		(*eeprom_byte) = request.data;
+		return;
+	}
+	// Queue is empty: disable interrupt and lock NVM.
+	FLASH -> PECR &= ~(0b11 << 16); // EOPIE='0' and ERRIE='0'.
+	NVM_lock();
+	nvm_ctx.write_running = 0;
+	PWR_set_mode_vote(PWR_REQUESTER_NVM, PWR_MODE_STOP);
+	// Perform pending disable request.
+	if (nvm_ctx.disable_request != 0) {
+		RCC -> AHBENR &= ~(0b1 << 8); // MIFEN='0'.
+		nvm_ctx.disable_request = 0;
+	}
+}
+
+/* FLASH INTERRUPT HANDLER.
+ * @param:	None.
+ * @return:	None.
+ */
+void __attribute__((optimize("-O0"))) FLASH_IRQHandler(void) {
+	// Clear end of operation and error flags (rc_w1 bits).
+	FLASH -> SR = (NVM_FLASH_SR_EOP | NVM_FLASH_SR_ERRORS);
+	// Program next byte.
+	if (nvm_ctx.write_running != 0) {
+		NVM_program_next();
+	}
+}
+
 /*** NVM functions ***/
 
+/* INIT NVM WRITE QUEUE.
+ * @param:	None.
+ * @return:	None.
+ */
+void NVM_init(void) {
+	// Init context.
+	nvm_ctx.write_queue_read_idx = 0;
+	nvm_ctx.write_queue_count = 0;
+	nvm_ctx.write_running = 0;
+	nvm_ctx.disable_request = 0;
+	// Set interrupt priority.
+	NVIC_set_priority(NVIC_IT_FLASH, 3);
+}
+
 /* ENABLE NVM INTERFACE.
  * @param:	None.
  * @return:	None.
  */
 void NVM_enable(void) {
+	// Cancel pending disable request.
+	nvm_ctx.disable_request = 0;
 	// Enable NVM peripheral.
 	RCC -> AHBENR |= (0b1 << 8); // MIFEN='1'.
 }
@@ -54,8 +142,16 @@ void NVM_enable(void) {
  * @return:	None.
  */
 void NVM_disable(void) {
-	// Disable NVM peripheral.
-	RCC -> AHBENR &= ~(0b1 << 8); // MIFEN='1'.
+	// Postpone disable until write queue is empty.
+	NVIC_disable_interrupt(NVIC_IT_FLASH);
+	if (nvm_ctx.write_running != 0) {
+		nvm_ctx.disable_request = 1;
+		NVIC_enable_interrupt(NVIC_IT_FLASH);
+	}
+	else {
+		// Disable NVM peripheral.
+		RCC -> AHBENR &= ~(0b1 << 8); // MIFEN='0'.
+	}
 }
 
 /* READ A BYTE STORED IN NVM.
@@ -64,14 +160,71 @@ void NVM_disable(void) {
  * @return:					None.
  */
 void NVM_read_byte(unsigned short address_offset, unsigned char* byte_to_read) {
-	// Unlock NVM.
-	NVM_unlock();
+	// Local variables.
+	unsigned char idx = 0;
+	unsigned char queue_idx = 0;
 	// Check if address is in EEPROM range.
 	if (address_offset < EEPROM_SIZE) {
-		(*byte_to_read) = *((unsigned char*) (EEPROM_START_ADDRESS+address_offset)); // Read byte at requested address.
+		// Read byte at requested address (no unlock required for read access).
+		(*byte_to_read) = *((unsigned char*) (EEPROM_START_ADDRESS+address_offset));
+		// Overwrite with latest queued value if any (read-after-write coherence).
+		NVIC_disable_interrupt(NVIC_IT_FLASH);
+		for (idx=0 ; idx<nvm_ctx.write_queue_count ; idx++) {
+			queue_idx = (nvm_ctx.write_queue_read_idx + idx) % NVM_WRITE_QUEUE_LENGTH;
+			if (nvm_ctx.write_queue[queue_idx].address_offset == address_offset) {
+				(*byte_to_read) = nvm_ctx.write_queue[queue_idx].data;
+			}
+		}
+		if (nvm_ctx.write_running != 0) {
+			NVIC_enable_interrupt(NVIC_IT_FLASH);
+		}
+	}
+}
+
+/* QUEUE A BYTE WRITE TO NVM (PROGRAMMED IN BACKGROUND UNDER FLASH INTERRUPT).
+ * @param address_offset:	Address offset starting from NVM start address (expressed in bytes).
+ * @param byte_to_store:	Byte to store in NVM.
+ * @return:					None.
+ */
+void NVM_write_byte_deferred(unsigned short address_offset, unsigned char byte_to_store) {
+	// Local variables.
+	unsigned char idx = 0;
+	unsigned char queue_idx = 0;
+	// Check if address is in EEPROM range.
+	if (address_offset >= EEPROM_SIZE) return;
+	// Mask FLASH interrupt while updating queue.
+	NVIC_disable_interrupt(NVIC_IT_FLASH);
+	// Coalesce with a pending request on the same address.
+	for (idx=0 ; idx<nvm_ctx.write_queue_count ; idx++) {
+		queue_idx = (nvm_ctx.write_queue_read_idx + idx) % NVM_WRITE_QUEUE_LENGTH;
+		if (nvm_ctx.write_queue[queue_idx].address_offset == address_offset) {
+			nvm_ctx.write_queue[queue_idx].data = byte_to_store;
+			goto end;
+		}
+	}
+	// Make room if queue is full.
+	if (nvm_ctx.write_queue_count >= NVM_WRITE_QUEUE_LENGTH) {
+		NVM_flush();
+	}
+	// Append request.
+	queue_idx = (nvm_ctx.write_queue_read_idx + nvm_ctx.write_queue_count) % NVM_WRITE_QUEUE_LENGTH;
+	nvm_ctx.write_queue[queue_idx].address_offset = address_offset;
+	nvm_ctx.write_queue[queue_idx].data = byte_to_store;
+	nvm_ctx.write_queue_count++;
+	// Start programming if NVM is idle.
+	if (nvm_ctx.write_running == 0) {
+		nvm_ctx.write_running = 1;
+		// Stop mode is not allowed while programming (FLASH interrupt will wake-up the core from sleep mode).
+		PWR_set_mode_vote(PWR_REQUESTER_NVM, PWR_MODE_SLEEP);
+		NVM_unlock();
+		FLASH -> SR = (NVM_FLASH_SR_EOP | NVM_FLASH_SR_ERRORS);
+		FLASH -> PECR |= (0b11 << 16); // EOPIE='1' and ERRIE='1'.
+		NVM_program_next();
+	}
+end:
+	if (nvm_ctx.write_running != 0) {
+		NVIC_enable_interrupt(NVIC_IT_FLASH);
 	}
-	// Lock NVM.
-	NVM_lock();
 }
 
 /* WRITE A BYTE TO NVM.
@@ -80,16 +233,32 @@ void NVM_read_byte(unsigned short address_offset, unsigned char* byte_to_read) {
  * @return:					None.
  */
 void NVM_write_byte(unsigned short address_offset, unsigned char byte_to_store) {
-	// Unlock NVM.
-	NVM_unlock();
-	// Check if address is in EEPROM range.
-	if (address_offset < EEPROM_SIZE) {
-		(*((unsigned char*) (EEPROM_START_ADDRESS+address_offset))) = byte_to_store; // Write byte to requested address.
+	// Queue byte and wait for completion.
+	NVM_write_byte_deferred(address_offset, byte_to_store);
+	NVM_flush();
+}
+
+/* WAIT FOR ALL QUEUED WRITES TO BE PROGRAMMED (POLLING, USABLE FROM ANY CONTEXT).
+ * @param:	None.
+ * @return:	None.
+ */
+void NVM_flush(void) {
+	// Drive queue by polling.
+	NVIC_disable_interrupt(NVIC_IT_FLASH);
+	while (nvm_ctx.write_running != 0) {
+		// Wait end of current operation.
+		while (((FLASH -> SR) & (0b1 << 0)) != 0); // Wait till BSY='1'.
+		FLASH -> SR = (NVM_FLASH_SR_EOP | NVM_FLASH_SR_ERRORS);
+		NVM_program_next();
 	}
-	// Wait end of operation.
-	while (((FLASH -> SR) & (0b1 << 0)) != 0); // Wait till BSY='1'.
-	// Lock NVM.
-	NVM_lock();
+}
+
+/* GET NVM WRITE QUEUE STATUS.
+ * @param:	None.
+ * @return:	1 if a write operation is pending or running, 0 otherwise.
+ */
+unsigned char NVM_is_busy(void) {
+	return nvm_ctx.write_running;
 }
 
 /* RESET ALL NVM FIELDS TO DEFAULT VALUE.
@@ -105,4 +274,10 @@ void NVM_reset_default(void) {
 	NVM_write_byte((NVM_ADDRESS_FH + 0), 0x00);
 	NVM_write_byte((NVM_ADDRESS_FH + 1), 0x00);
 	NVM_write_byte(NVM_ADDRESS_SIGFOX_FH, 0x00);
+	NVM_write_byte(NVM_ADDRESS_SIGFOX_PAYLOAD_ENCRYPTION, 0x00);
+	// Supply monitoring (disabled).
+	NVM_write_byte((NVM_ADDRESS_VRF_LIMIT_MV + 0), 0x00);
+	NVM_write_byte((NVM_ADDRESS_VRF_LIMIT_MV + 1), 0x00);
+	NVM_write_byte((NVM_ADDRESS_VMCU_LIMIT_MV + 0), 0x00);
+	NVM_write_byte((NVM_ADDRESS_VMCU_LIMIT_MV + 1), 0x00);
 }
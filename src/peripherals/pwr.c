@@ -7,15 +7,81 @@
 
 #include "pwr.h"
 
+#include "core.h"
 #include "exti_reg.h"
 #include "flash_reg.h"
+#include "lptim.h"
 #include "nvic_reg.h"
+#include "probe.h"
 #include "pwr_reg.h"
 #include "rcc_reg.h"
 #include "rcc.h"
 #include "rtc_reg.h"
 #include "scb_reg.h"
 
+/*** PWR local macros ***/
+
+#define PWR_EXTI_PR_MASK		0x007BFFFF
+#define PWR_RTC_ISR_FLAGS_MASK	0x0000FFA0 // RSF, INIT, alarms, wake-up, tamper and timestamp flags.
+
+/*** PWR local structures ***/
+
+typedef struct {
+	// Deepest mode tolerated by each requester (byte access is atomic between thread and interrupt contexts).
+	volatile unsigned char mode_vote[PWR_REQUESTER_LAST];
+	// Residency accounting.
+	unsigned long long reference_ticks;
+	unsigned long long sleep_ticks;
+	unsigned long long stop_ticks;
+} PWR_context_t;
+
+/*** PWR local global variables ***/
+
+static PWR_context_t pwr_ctx;
+
+/*** PWR local functions ***/
+
+/* CONVERT LPTIM TICKS TO MILLISECONDS.
+ * @param ticks:	Number of ticks.
+ * @return:			Duration in ms (clamped to PWR_STATISTICS_MS_MAX).
+ */
+static unsigned int PWR_ticks_to_ms(unsigned long long ticks) {
+	// Local variables.
+	unsigned long long duration_ms = ((ticks * 1000) >> LPTIM_TICK_FREQUENCY_LOG2);
+	return (duration_ms > PWR_STATISTICS_MS_MAX) ? PWR_STATISTICS_MS_MAX : (unsigned int) duration_ms;
+}
+
+/* FUNCTION TO ENTER STOP MODE.
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((section(".ramfunc"))) PWR_enter_stop_mode(void) {
+	// Local variables.
+	unsigned int rtc_isr_flags = PWR_RTC_ISR_FLAGS_MASK;
+	unsigned int start_ticks = LPTIM1_get_timestamp_ticks();
+	// Regulator in low power mode.
+	PWR -> CR |= (0b1 << 0); // LPSDSR='1'.
+	// Clear WUF flag.
+	PWR -> CR |= (0b1 << 2); // CWUF='1'.
+	// Enter stop mode when CPU enters deepsleep.
+	PWR -> CR &= ~(0b1 << 1); // PDDS='0'.
+	// Clear stale pending bits of disabled sources only: an enabled interrupt which is pending must wake-up the core.
+	if (((RTC -> CR) & (0b1 << 12)) != 0) rtc_isr_flags &= ~(0b1 << 8); // Keep ALRAF.
+	if (((RTC -> CR) & (0b1 << 13)) != 0) rtc_isr_flags &= ~(0b1 << 9); // Keep ALRBF.
+	if (((RTC -> CR) & (0b1 << 14)) != 0) rtc_isr_flags &= ~(0b1 << 10); // Keep WUTF.
+	RCC -> CICR |= 0x000001BF;
+	EXTI -> PR = (PWR_EXTI_PR_MASK & ~(EXTI -> IMR)); // PIFx='1'.
+	RTC -> ISR &= ~rtc_isr_flags;
+	NVIC -> ICPR = ~(NVIC -> ISER); // CLEARPENDx='1'.
+	// Enter stop mode.
+	SCB -> SCR |= (0b1 << 2); // SLEEPDEEP='1'.
+	PROBE_high(PROBE_STOP_MODE_TP);
+	CORE_wait_for_interrupt();
+	PROBE_low(PROBE_STOP_MODE_TP);
+	// Update residency.
+	pwr_ctx.stop_ticks += (LPTIM1_get_timestamp_ticks() - start_ticks);
+}
+
 /*** PWR functions ***/
 
 /* INIT PWR INTERFACE.
@@ -23,53 +89,96 @@
  * @return:	None.
  */
 void PWR_init(void) {
+	// Local variables.
+	unsigned char idx = 0;
 	// Enable power interface clock.
 	RCC -> APB1ENR |= (0b1 << 28); // PWREN='1'.
 	// Unlock back-up registers (DBP bit).
 	PWR -> CR |= (0b1 << 8);
 	// Power memories down when entering sleep mode.
 	FLASH -> ACR |= (0b1 << 3); // SLEEP_PD='1'.
-	// Use HSI clock when waking-up from stop mode.
-	RCC -> CFGR |= (0b1 << 15);
+	// Stop mode wake-up clock (STOPWUCK) is managed by RCC according to current system clock.
 	// Switch internal voltage reference off in low power mode.
 	PWR -> CR |= (0b1 << 9); // ULP='1'.
 	// Ignore internal voltage reference startup time on wake-up.
 	PWR -> CR |= (0b1 << 10); // FWU='1'.
 	// Never return in low power sleep mode after wake-up.
 	SCB -> SCR &= ~(0b1 << 1); // SLEEPONEXIT='0'.
+	// Init context.
+	for (idx=0 ; idx<PWR_REQUESTER_LAST ; idx++) pwr_ctx.mode_vote[idx] = PWR_MODE_STOP;
+	PWR_reset_statistics();
+}
+
+/* SET THE DEEPEST LOW POWER MODE TOLERATED BY A REQUESTER.
+ * @param requester:	Subsystem which votes.
+ * @param deepest_mode:	Deepest mode tolerated by the subsystem (PWR_MODE_STOP when idle).
+ * @return:				None.
+ */
+void __attribute__((section(".ramfunc"))) PWR_set_mode_vote(PWR_requester_t requester, PWR_mode_t deepest_mode) {
+	// Check parameters.
+	if ((requester >= PWR_REQUESTER_LAST) || (deepest_mode >= PWR_MODE_LAST)) return;
+	pwr_ctx.mode_vote[requester] = (unsigned char) deepest_mode;
 }
 
 /* FUNCTION TO ENTER SLEEP MODE.
  * @param:	None.
  * @return:	None.
  */
-void PWR_enter_sleep_mode(void) {
+void __attribute__((section(".ramfunc"))) PWR_enter_sleep_mode(void) {
+	// Local variables.
+	unsigned int start_ticks = LPTIM1_get_timestamp_ticks();
 	// Regulator in normal mode.
 	PWR -> CR &= ~(0b1 << 0); // LPSDSR='0'.
 	// Enter low power sleep mode.
 	SCB -> SCR &= ~(0b1 << 2); // SLEEPDEEP='0'.
-	__asm volatile ("wfi"); // Wait For Interrupt core instruction.
+	CORE_wait_for_interrupt();
+	// Update residency.
+	pwr_ctx.sleep_ticks += (LPTIM1_get_timestamp_ticks() - start_ticks);
 }
 
-/* FUNCTION TO ENTER STOP MODE.
+/* ENTER THE DEEPEST LOW POWER MODE ALLOWED BY ALL REQUESTERS.
  * @param:	None.
  * @return:	None.
  */
-void PWR_enter_stop_mode(void) {
-	// Regulator in low power mode.
-	PWR -> CR |= (0b1 << 0); // LPSDSR='1'.
-	// Clear WUF flag.
-	PWR -> CR |= (0b1 << 2); // CWUF='1'.
-	// Enter stop mode when CPU enters deepsleep.
-	PWR -> CR &= ~(0b1 << 1); // PDDS='0'.
-	// Clear all EXTI line, RTC an peripherals interrupt pending bits.
-	RCC -> CICR |= 0x000001BF;
-	EXTI -> PR |= 0x007BFFFF; // PIFx='1'.
-	RTC -> ISR &= 0xFFFF005F; // Reset alarms, wake-up, tamper and timestamp flags.
-	NVIC -> ICPR = 0xFFFFFFFF; // CLEARPENDx='1'.
-	// Enter stop mode.
-	SCB -> SCR |= (0b1 << 2); // SLEEPDEEP='1'.
-	__asm volatile ("wfi"); // Wait For Interrupt core instruction.
+void __attribute__((section(".ramfunc"))) PWR_enter_low_power_mode(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	PWR_mode_t mode = PWR_MODE_STOP;
+	// Select shallowest vote.
+	for (idx=0 ; idx<PWR_REQUESTER_LAST ; idx++) {
+		if (pwr_ctx.mode_vote[idx] < mode) {
+			mode = pwr_ctx.mode_vote[idx];
+		}
+	}
+	// Enter mode.
+	if (mode == PWR_MODE_STOP) {
+		PWR_enter_stop_mode();
+	}
+	else {
+		PWR_enter_sleep_mode();
+	}
 }
 
+/* GET RUN, SLEEP AND STOP MODES RESIDENCY SINCE LAST RESET (DURATIONS ARE CLAMPED TO PWR_STATISTICS_MS_MAX).
+ * @param statistics:	Pointer to the structure that will contain the durations.
+ * @return:				None.
+ */
+void PWR_get_statistics(PWR_statistics_t* statistics) {
+	// Local variables.
+	unsigned long long total_ticks = (LPTIM1_get_timestamp_ticks_64() - pwr_ctx.reference_ticks);
+	unsigned long long low_power_ticks = (pwr_ctx.sleep_ticks + pwr_ctx.stop_ticks);
+	// Compute durations.
+	statistics -> sleep_ms = PWR_ticks_to_ms(pwr_ctx.sleep_ticks);
+	statistics -> stop_ms = PWR_ticks_to_ms(pwr_ctx.stop_ticks);
+	statistics -> run_ms = (total_ticks > low_power_ticks) ? PWR_ticks_to_ms(total_ticks - low_power_ticks) : 0;
+}
 
+/* RESET RESIDENCY ACCOUNTING.
+ * @param:	None.
+ * @return:	None.
+ */
+void PWR_reset_statistics(void) {
+	pwr_ctx.reference_ticks = LPTIM1_get_timestamp_ticks_64();
+	pwr_ctx.sleep_ticks = 0;
+	pwr_ctx.stop_ticks = 0;
+}
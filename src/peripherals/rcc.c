@@ -7,10 +7,102 @@
 
 #include "rcc.h"
 
+#include "flash.h"
 #include "nvic.h"
 #include "pwr.h"
+#include "pwr_reg.h"
 #include "rcc_reg.h"
 
+/*** RCC local macros ***/
+
+#define RCC_TIMEOUT_COUNT		1000000
+#define RCC_MSI_RANGE_2MHZ		0b101
+#define RCC_VOS_RANGE1			0b01 // 1.8V, up to 32MHz (16MHz with 0 wait state).
+#define RCC_VOS_RANGE2			0b10 // 1.5V, up to 16MHz (8MHz with 0 wait state).
+
+/*** RCC local structures ***/
+
+typedef struct {
+	RCC_sysclk_t sysclk;
+	unsigned char high_speed_request_count;
+	RCC_clock_callback_t callbacks[RCC_CLOCK_CALLBACK_MAX];
+	unsigned char callbacks_count;
+} RCC_context_t;
+
+/*** RCC local global variables ***/
+
+static RCC_context_t rcc_ctx;
+
+/*** RCC local functions ***/
+
+/* WAIT FOR A REGISTER BIT FIELD TO REACH A VALUE.
+ * @param reg:		Register to poll.
+ * @param mask:		Bit field mask.
+ * @param value:	Expected value (shifted).
+ * @return:			1 on success, 0 on timeout.
+ */
+static unsigned char RCC_wait_for_bits(volatile unsigned int* reg, unsigned int mask, unsigned int value) {
+	// Local variables.
+	unsigned int loop_count = 0;
+	while (((*reg) & mask) != value) {
+		loop_count++;
+		if (loop_count > RCC_TIMEOUT_COUNT) return 0;
+	}
+	return 1;
+}
+
+/* SET CORE VOLTAGE RANGE.
+ * @param vos:	Voltage scaling range.
+ * @return:		None.
+ */
+static void RCC_set_voltage_range(unsigned int vos) {
+	// Set range and wait for regulator to be ready.
+	PWR -> CR &= ~(0b11 << 11);
+	PWR -> CR |= (vos << 11);
+	RCC_wait_for_bits(&(PWR -> CSR), (0b1 << 4), 0); // Wait for VOSF='0'.
+}
+
+/* SWITCH SYSTEM CLOCK.
+ * @param sysclk:	New system clock source.
+ * @return:			None.
+ */
+static void RCC_switch_sysclk(RCC_sysclk_t sysclk) {
+	// Local variables.
+	unsigned char idx = 0;
+	if (sysclk == rcc_ctx.sysclk) return;
+	if (sysclk == RCC_SYSCLK_HSI) {
+		// Raise voltage first (16MHz with 0 wait state requires range 1).
+		RCC_set_voltage_range(RCC_VOS_RANGE1);
+		FLASH_set_latency(0);
+		// Start HSI16 and switch.
+		RCC -> CR |= (0b1 << 0); // HSI16ON='1'.
+		if (RCC_wait_for_bits(&(RCC -> CR), (0b1 << 2), (0b1 << 2)) == 0) return; // Wait for HSI16RDYF='1'.
+		RCC -> CFGR = ((RCC -> CFGR) & ~(0b11 << 0)) | (0b01 << 0); // SW='01'.
+		RCC_wait_for_bits(&(RCC -> CFGR), (0b11 << 2), (0b01 << 2)); // Wait for SWS='01'.
+		// Keep HSI16 after stop mode wake-up.
+		RCC -> CFGR |= (0b1 << 15); // STOPWUCK='1'.
+	}
+	else {
+		// Start MSI (2.1MHz range) and switch.
+		RCC -> ICSCR = ((RCC -> ICSCR) & ~(0b111 << 13)) | (RCC_MSI_RANGE_2MHZ << 13);
+		RCC -> CR |= (0b1 << 8); // MSION='1'.
+		if (RCC_wait_for_bits(&(RCC -> CR), (0b1 << 9), (0b1 << 9)) == 0) return; // Wait for MSIRDY='1'.
+		RCC -> CFGR &= ~(0b11 << 0); // SW='00'.
+		RCC_wait_for_bits(&(RCC -> CFGR), (0b11 << 2), 0); // Wait for SWS='00'.
+		// Wake-up from stop mode on MSI.
+		RCC -> CFGR &= ~(0b1 << 15); // STOPWUCK='0'.
+		// Turn HSI16 off and lower voltage.
+		RCC -> CR &= ~(0b1 << 0); // HSI16ON='0'.
+		FLASH_set_latency(0);
+		RCC_set_voltage_range(RCC_VOS_RANGE2); // Range 3 is not used to keep EEPROM programming and full ADC speed available.
+	}
+	rcc_ctx.sysclk = sysclk;
+	// Notify drivers.
+	for (idx=0 ; idx<rcc_ctx.callbacks_count ; idx++) {
+		rcc_ctx.callbacks[idx](RCC_get_sysclk_khz());
+	}
+}
+
 /*** RCC functions ***/
 
 /* RCC INTERRUPT HANDLER.
@@ -27,6 +119,12 @@ void RCC_IRQHandler(void) {
  * @return:	None.
  */
 void RCC_init(void) {
+	// Init context.
+	rcc_ctx.high_speed_request_count = 0;
+	rcc_ctx.callbacks_count = 0;
+	// Select MSI explicitly with matching voltage range and latency (context is forced to HSI to run the full switch sequence).
+	rcc_ctx.sysclk = RCC_SYSCLK_HSI;
+	RCC_switch_sysclk(RCC_SYSCLK_MSI);
 	// Enable LSI and LSE ready interrupts.
 	RCC -> CIER |= (0b11 << 0);
 }
@@ -62,3 +160,57 @@ void RCC_enable_lse(void) {
 	}
 	NVIC_disable_interrupt(NVIC_IT_RCC_CRS);
 }
+
+/* REGISTER A FUNCTION CALLED AFTER EACH SYSTEM CLOCK SWITCH.
+ * @param callback:	Function to call (baud rates and clock dependent settings recomputation).
+ * @return:			None.
+ */
+void RCC_register_clock_callback(RCC_clock_callback_t callback) {
+	// Local variables.
+	unsigned char idx = 0;
+	// Ignore duplicates (drivers can be initialized several times).
+	for (idx=0 ; idx<rcc_ctx.callbacks_count ; idx++) {
+		if (rcc_ctx.callbacks[idx] == callback) return;
+	}
+	if (rcc_ctx.callbacks_count < RCC_CLOCK_CALLBACK_MAX) {
+		rcc_ctx.callbacks[rcc_ctx.callbacks_count++] = callback;
+	}
+}
+
+/* REQUEST HSI16 AS SYSTEM CLOCK (RADIO, SPI AND AES HEAVY PHASES).
+ * @param:	None.
+ * @return:	None.
+ */
+void RCC_request_high_speed(void) {
+	rcc_ctx.high_speed_request_count++;
+	RCC_switch_sysclk(RCC_SYSCLK_HSI);
+}
+
+/* RELEASE HSI16 REQUEST (MSI IS SELECTED WHEN NO REQUEST REMAINS).
+ * @param:	None.
+ * @return:	None.
+ */
+void RCC_release_high_speed(void) {
+	if (rcc_ctx.high_speed_request_count > 0) {
+		rcc_ctx.high_speed_request_count--;
+	}
+	if (rcc_ctx.high_speed_request_count == 0) {
+		RCC_switch_sysclk(RCC_SYSCLK_MSI);
+	}
+}
+
+/* GET CURRENT SYSTEM CLOCK SOURCE.
+ * @param:	None.
+ * @return:	Current system clock.
+ */
+RCC_sysclk_t RCC_get_sysclk(void) {
+	return rcc_ctx.sysclk;
+}
+
+/* GET CURRENT SYSTEM CLOCK FREQUENCY.
+ * @param:	None.
+ * @return:	System clock frequency in kHz.
+ */
+unsigned int RCC_get_sysclk_khz(void) {
+	return (rcc_ctx.sysclk == RCC_SYSCLK_HSI) ? RCC_HSI_FREQUENCY_KHZ : RCC_MSI_FREQUENCY_KHZ;
+}
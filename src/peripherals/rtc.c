@@ -14,15 +14,25 @@
 #include "nvic.h"
 #include "rcc_reg.h"
 #include "rtc_reg.h"
+#include "scheduler.h"
 
 /*** RTC local macros ***/
 
 #define RTC_INIT_TIMEOUT_COUNT		1000
 #define RTC_WAKEUP_TIMER_DELAY_MAX	0xFFFF
+#define RTC_WAKEUP_TIMER_SUBSECOND_DELAY_MS_MAX	((RTC_WAKEUP_TIMER_DELAY_MAX + 1) / 2048 * 1000) // 32s with RTCCLK/16.
+#define RTC_WUCKSEL_RTCCLK_DIV2		0b011
+#define RTC_WUCKSEL_CK_SPRE			0b100
+#define RTC_SECONDS_PER_DAY			86400
+#define RTC_BCD_TO_BINARY(bcd)		((((bcd) >> 4) * 10) + ((bcd) & 0x0F))
 
 /*** RTC local global variables ***/
 
+// Number of days elapsed before the first day of each month (non leap year).
+static const unsigned short RTC_DAYS_BEFORE_MONTH[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
 static volatile unsigned char rtc_wakeup_timer_flag = 0;
+static volatile unsigned char rtc_alarm_a_flag = 0;
 
 /*** RTC local functions ***/
 
@@ -36,11 +46,22 @@ void __attribute__((optimize("-O0"))) RTC_IRQHandler(void) {
 		// Set local flag.
 		if (((RTC -> CR) & (0b1 << 14)) != 0) {
 			rtc_wakeup_timer_flag = 1;
+			SCHEDULER_post_event(SCHEDULER_EVENT_TIMER);
 		}
 		// Clear flags.
 		RTC -> ISR &= ~(0b1 << 10); // WUTF='0'.
 		EXTI -> PR |= (0b1 << EXTI_LINE_RTC_WAKEUP_TIMER);
 	}
+	// Alarm A interrupt.
+	if (((RTC -> ISR) & (0b1 << 8)) != 0) {
+		// Set local flag.
+		if (((RTC -> CR) & (0b1 << 12)) != 0) {
+			rtc_alarm_a_flag = 1;
+		}
+		// Clear flags.
+		RTC -> ISR &= ~(0b1 << 8); // ALRAF='0'.
+		EXTI -> PR |= (0b1 << EXTI_LINE_RTC_ALARM);
+	}
 }
 
 /* ENTER INITIALIZATION MODE TO ENABLE RTC REGISTERS UPDATE.
@@ -74,6 +95,39 @@ static void RTC_exit_initialization_mode(void) {
 	RTC -> ISR &= ~(0b1 << 7); // INIT='0'.
 }
 
+/* CONVERT A BINARY VALUE TO BCD.
+ * @param value:	Binary value (0 to 99).
+ * @return:			BCD value.
+ */
+static unsigned int RTC_binary_to_bcd(unsigned int value) {
+	// Local variables.
+	unsigned int tens = 0;
+	// Avoid division (no hardware divider).
+	while (value >= 10) {
+		value -= 10;
+		tens++;
+	}
+	return ((tens << 4) | value);
+}
+
+/* DISABLE WAKE-UP TIMER AND WAIT UNTIL ITS CONFIGURATION IS WRITABLE (CALENDAR IS NOT STOPPED).
+ * @param:	None.
+ * @return:	None.
+ */
+static void RTC_unlock_wakeup_timer(void) {
+	// Local variables.
+	unsigned int loop_count = 0;
+	// Enter key.
+	RTC -> WPR = 0xCA;
+	RTC -> WPR = 0x53;
+	RTC -> CR &= ~(0b1 << 10); // WUTE='0'.
+	while (((RTC -> ISR) & (0b1 << 2)) == 0) {
+		// Wait for WUTWF='1' or timeout.
+		loop_count++;
+		if (loop_count > RTC_INIT_TIMEOUT_COUNT) break;
+	}
+}
+
 /*** RTC functions ***/
 
 /* RESET RTC PERIPHERAL.
@@ -119,12 +173,15 @@ void RTC_init(void) {
 	RTC -> CR &= ~(0b111 << 0);
 	RTC -> CR |= (0b100 << 0); // Wake-up timer clocked by RTC clock (1Hz).
 	RTC_exit_initialization_mode();
-	// Configure EXTI line.
+	// Configure EXTI lines.
 	EXTI_configure_line(EXTI_LINE_RTC_WAKEUP_TIMER, EXTI_TRIGGER_RISING_EDGE);
+	EXTI_configure_line(EXTI_LINE_RTC_ALARM, EXTI_TRIGGER_RISING_EDGE);
 	// Disable interrupt and clear all flags.
 	RTC -> CR &= ~(0b1 << 14);
+	RTC -> CR &= ~(0b1 << 12);
 	RTC -> ISR &= 0xFFFE0000;
 	EXTI -> PR |= (0b1 << EXTI_LINE_RTC_WAKEUP_TIMER);
+	EXTI -> PR |= (0b1 << EXTI_LINE_RTC_ALARM);
 	// Set interrupt priority.
 	NVIC_set_priority(NVIC_IT_RTC, 2);
 	NVIC_enable_interrupt(NVIC_IT_RTC);
@@ -140,22 +197,52 @@ void RTC_start_wakeup_timer(unsigned int delay_seconds) {
 	if (local_delay_seconds > RTC_WAKEUP_TIMER_DELAY_MAX) {
 		local_delay_seconds = RTC_WAKEUP_TIMER_DELAY_MAX;
 	}
-	// Check if timer si not allready running.
-	if (((RTC -> CR) & (0b1 << 10)) == 0) {
-		// Enable RTC and register access.
-		RTC_enter_initialization_mode();
-		// Configure wake-up timer.
-		RTC -> CR &= ~(0b1 << 10); // Disable wake-up timer.
-		RTC -> WUTR = (local_delay_seconds - 1);
-		// Clear flags.
-		RTC -> ISR &= ~(0b1 << 10); // WUTF='0'.
-		EXTI -> PR |= (0b1 << EXTI_LINE_RTC_WAKEUP_TIMER);
-		// Enable interrupt.
-		RTC -> CR |= (0b1 << 14); // WUTE='1'.
-		// Start timer.
-		RTC -> CR |= (0b1 << 10); // Enable wake-up timer.
-		RTC_exit_initialization_mode();
+	RTC_start_wakeup_timer_milliseconds(local_delay_seconds * 1000);
+}
+
+/* START RTC WAKE-UP TIMER WITH SUB-SECOND RESOLUTION.
+ * @param delay_ms:	Delay in milliseconds (rounded up to the selected wake-up clock period).
+ * @return:			None.
+ * Note: the finest clock (RTCCLK/2 to RTCCLK/16) able to reach the delay is selected, 1Hz clock is used above 32s.
+ */
+void RTC_start_wakeup_timer_milliseconds(unsigned int delay_ms) {
+	// Local variables.
+	unsigned int wucksel = RTC_WUCKSEL_RTCCLK_DIV2;
+	unsigned int wutr = 0;
+	// Check if timer is not already running.
+	if (((RTC -> CR) & (0b1 << 10)) != 0) return;
+	// Select wake-up clock.
+	if (delay_ms == 0) {
+		delay_ms = 1;
 	}
+	if (delay_ms <= RTC_WAKEUP_TIMER_SUBSECOND_DELAY_MS_MAX) {
+		// RTCCLK/16 (wucksel=0) to RTCCLK/2 (wucksel=3): wake-up clock frequency is 2048 << wucksel.
+		while (1) {
+			wutr = ((delay_ms << (11 + wucksel)) + 999) / 1000;
+			if ((wutr <= (RTC_WAKEUP_TIMER_DELAY_MAX + 1)) || (wucksel == 0)) break;
+			wucksel--;
+		}
+	}
+	else {
+		// 1Hz clock.
+		wucksel = RTC_WUCKSEL_CK_SPRE;
+		wutr = (delay_ms + 999) / 1000;
+		if (wutr > (RTC_WAKEUP_TIMER_DELAY_MAX + 1)) {
+			wutr = (RTC_WAKEUP_TIMER_DELAY_MAX + 1);
+		}
+	}
+	// Configure wake-up timer.
+	RTC_unlock_wakeup_timer();
+	RTC -> CR &= ~(0b111 << 0);
+	RTC -> CR |= (wucksel << 0);
+	RTC -> WUTR = (wutr - 1);
+	// Clear flags.
+	RTC -> ISR &= ~(0b1 << 10); // WUTF='0'.
+	EXTI -> PR |= (0b1 << EXTI_LINE_RTC_WAKEUP_TIMER);
+	// Enable interrupt.
+	RTC -> CR |= (0b1 << 14); // WUTIE='1'.
+	// Start timer.
+	RTC -> CR |= (0b1 << 10); // Enable wake-up timer.
 }
 
 /* STOP RTC WAKE-UP TIMER.
@@ -163,15 +250,13 @@ void RTC_start_wakeup_timer(unsigned int delay_seconds) {
  * @return:	None.
  */
 void RTC_stop_wakeup_timer(void) {
-	// Enable RTC and register access.
-	RTC_enter_initialization_mode();
-	RTC -> CR &= ~(0b1 << 10); // Disable wake-up timer.
-	RTC_exit_initialization_mode();
+	// Disable timer.
+	RTC_unlock_wakeup_timer();
 	// Disable interrupt.
-	RTC -> CR &= ~(0b1 << 14); // WUTE='0'.
+	RTC -> CR &= ~(0b1 << 14); // WUTIE='0'.
 }
 
-/* RETURN THE CURRENT ALARM INTERRUPT STATUS.
+/* RETURN THE CURRENT WAKE-UP TIMER INTERRUPT STATUS.
  * @param:	None.
  * @return:	1 if the RTC interrupt occured, 0 otherwise.
  */
@@ -179,7 +264,7 @@ volatile unsigned char RTC_get_wakeup_timer_flag(void) {
 	return rtc_wakeup_timer_flag;
 }
 
-/* CLEAR ALARM A INTERRUPT FLAG.
+/* CLEAR WAKE-UP TIMER INTERRUPT FLAG.
  * @param:	None.
  * @return:	None.
  */
@@ -189,3 +274,104 @@ void RTC_clear_wakeup_timer_flag(void) {
 	EXTI -> PR |= (0b1 << EXTI_LINE_RTC_WAKEUP_TIMER);
 	rtc_wakeup_timer_flag = 0;
 }
+
+/* GET RTC TIMESTAMP.
+ * @param:	None.
+ * @return:	Number of seconds elapsed since RTC calendar origin (01/01/2000 00:00:00 after reset).
+ */
+unsigned int RTC_get_timestamp_seconds(void) {
+	// Local variables.
+	unsigned int tr = 0;
+	unsigned int dr = 0;
+	unsigned int year = 0;
+	unsigned int month = 0;
+	unsigned int days = 0;
+	// Read registers until consistent (shadow registers are bypassed).
+	do {
+		tr = (RTC -> TR);
+		dr = (RTC -> DR);
+	}
+	while ((tr != (RTC -> TR)) || (dr != (RTC -> DR)));
+	// Convert date to number of days.
+	year = RTC_BCD_TO_BINARY((dr >> 16) & 0xFF);
+	month = RTC_BCD_TO_BINARY((dr >> 8) & 0x1F);
+	if ((month < 1) || (month > 12)) month = 1;
+	days = (year * 365) + ((year + 3) >> 2); // Leap days of previous years (2000 is a leap year).
+	days += RTC_DAYS_BEFORE_MONTH[month - 1];
+	if ((month > 2) && ((year & 0x03) == 0)) days++;
+	days += RTC_BCD_TO_BINARY(dr & 0x3F) - 1;
+	// Add time.
+	return (days * RTC_SECONDS_PER_DAY) + (RTC_BCD_TO_BINARY((tr >> 16) & 0x3F) * 3600) + (RTC_BCD_TO_BINARY((tr >> 8) & 0x7F) * 60) + RTC_BCD_TO_BINARY(tr & 0x7F);
+}
+
+/* START RTC ALARM A.
+ * @param delay_seconds:	Delay in seconds (1 to 86399, the alarm matches the time of day).
+ * @return:					None.
+ */
+void RTC_start_alarm_a(unsigned int delay_seconds) {
+	// Local variables.
+	unsigned int time_of_day = 0;
+	unsigned int hours = 0;
+	unsigned int minutes = 0;
+	unsigned int loop_count = 0;
+	// Clamp parameter.
+	if (delay_seconds < 1) delay_seconds = 1;
+	if (delay_seconds >= RTC_SECONDS_PER_DAY) delay_seconds = (RTC_SECONDS_PER_DAY - 1);
+	// Compute alarm time of day.
+	time_of_day = (RTC_get_timestamp_seconds() % RTC_SECONDS_PER_DAY) + delay_seconds;
+	if (time_of_day >= RTC_SECONDS_PER_DAY) time_of_day -= RTC_SECONDS_PER_DAY;
+	hours = time_of_day / 3600;
+	time_of_day -= (hours * 3600);
+	minutes = time_of_day / 60;
+	time_of_day -= (minutes * 60);
+	// Disable alarm to unlock configuration.
+	RTC -> WPR = 0xCA;
+	RTC -> WPR = 0x53;
+	RTC -> CR &= ~(0b1 << 8); // ALRAE='0'.
+	while (((RTC -> ISR) & (0b1 << 0)) == 0) {
+		// Wait for ALRAWF='1' or timeout.
+		loop_count++;
+		if (loop_count > RTC_INIT_TIMEOUT_COUNT) break;
+	}
+	// Configure alarm (date is ignored, sub-seconds are ignored).
+	RTC -> ALRMAR = (0b1 << 31) | (RTC_binary_to_bcd(hours) << 16) | (RTC_binary_to_bcd(minutes) << 8) | (RTC_binary_to_bcd(time_of_day) << 0);
+	RTC -> ALRMASSR = 0;
+	// Clear flags.
+	RTC -> ISR &= ~(0b1 << 8); // ALRAF='0'.
+	EXTI -> PR |= (0b1 << EXTI_LINE_RTC_ALARM);
+	rtc_alarm_a_flag = 0;
+	// Enable interrupt and alarm.
+	RTC -> CR |= (0b1 << 12); // ALRAIE='1'.
+	RTC -> CR |= (0b1 << 8); // ALRAE='1'.
+}
+
+/* STOP RTC ALARM A.
+ * @param:	None.
+ * @return:	None.
+ */
+void RTC_stop_alarm_a(void) {
+	// Disable alarm and interrupt.
+	RTC -> WPR = 0xCA;
+	RTC -> WPR = 0x53;
+	RTC -> CR &= ~(0b1 << 8); // ALRAE='0'.
+	RTC -> CR &= ~(0b1 << 12); // ALRAIE='0'.
+}
+
+/* RETURN THE CURRENT ALARM A INTERRUPT STATUS.
+ * @param:	None.
+ * @return:	1 if the alarm A interrupt occured, 0 otherwise.
+ */
+volatile unsigned char RTC_get_alarm_a_flag(void) {
+	return rtc_alarm_a_flag;
+}
+
+/* CLEAR ALARM A INTERRUPT FLAG.
+ * @param:	None.
+ * @return:	None.
+ */
+void RTC_clear_alarm_a_flag(void) {
+	// Clear all flags.
+	RTC -> ISR &= ~(0b1 << 8); // ALRAF='0'.
+	EXTI -> PR |= (0b1 << EXTI_LINE_RTC_ALARM);
+	rtc_alarm_a_flag = 0;
+}
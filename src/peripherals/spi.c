@@ -10,12 +10,36 @@
 #include "gpio.h"
 #include "lptim.h"
 #include "mapping.h"
+#include "rcc.h"
 #include "rcc_reg.h"
 #include "spi_reg.h"
 
 /*** SPI local macros ***/
 
 #define SPI_ACCESS_TIMEOUT_COUNT	1000000
+#define SPI_SCK_FREQUENCY_MAX_KHZ	8000 // S2LP maximum SPI clock is 10MHz.
+
+/*** SPI local functions ***/
+
+/* UPDATE SPI1 BAUD RATE AFTER A SYSTEM CLOCK SWITCH.
+ * @param sysclk_khz:	New system clock frequency in kHz.
+ * @return:				None.
+ */
+static void SPI1_clock_callback(unsigned int sysclk_khz) {
+	// Local variables.
+	unsigned int br = 0;
+	// Select the lowest prescaler (PCLK2 / 2^(br+1)) compatible with S2LP maximum SPI clock.
+	while (((sysclk_khz >> (br + 1)) > SPI_SCK_FREQUENCY_MAX_KHZ) && (br < 0b111)) {
+		br++;
+	}
+	// Baud rate can only be changed when peripheral is disabled.
+	if (((RCC -> APB2ENR) & (0b1 << 12)) == 0) return;
+	while (((SPI1 -> SR) & (0b1 << 7)) != 0); // Wait for BSY='0'.
+	SPI1 -> CR1 &= ~(0b1 << 6); // SPE='0'.
+	SPI1 -> CR1 &= ~(0b111 << 3);
+	SPI1 -> CR1 |= (br << 3);
+	SPI1 -> CR1 |= (0b1 << 6); // SPE='1'.
+}
 
 /*** SPI functions ***/
 
@@ -37,7 +61,7 @@ void SPI1_init(void) {
 	// Configure peripheral.
 	SPI1 -> CR1 &= 0xFFFF0000; // Disable peripheral before configuration (SPE='0').
 	SPI1 -> CR1 |= (0b1 << 2); // Master mode (MSTR='1').
-	SPI1 -> CR1 &= ~(0b111 << 3); // Baud rate = PCLK2/2 = SYSCLK/2 = 8MHz.
+	SPI1 -> CR1 &= ~(0b111 << 3); // Baud rate = PCLK2/2 = SYSCLK/2 (updated on system clock switch).
 	SPI1 -> CR1 &= ~(0b1 << 11); // 8-bits format (DFF='0').
 	SPI1 -> CR1 &= ~(0b11 << 0); // CPOL='0' and CPHA='0'.
 	SPI1 -> CR2 &= 0xFFFFFF08;
@@ -45,6 +69,9 @@ void SPI1_init(void) {
 	SPI1 -> CR2 |= (0b1 << 1); // Enable TX DMA requests.
 	// Enable peripheral.
 	SPI1 -> CR1 |= (0b1 << 6); // SPE='1'.
+	// Adapt baud rate to system clock.
+	SPI1_clock_callback(RCC_get_sysclk_khz());
+	RCC_register_clock_callback(&SPI1_clock_callback);
 }
 
 /* ENABLE SPI1 PERIPHERAL.
@@ -115,7 +142,7 @@ void SPI1_power_off(void) {
  * @param tx_data:	Data to send (8-bits).
  * @return:			1 in case of success, 0 in case of failure.
  */
-unsigned char SPI1_write_byte(unsigned char tx_data) {
+unsigned char __attribute__((section(".ramfunc"))) SPI1_write_byte(unsigned char tx_data) {
 	// Wait for TXE flag.
 	unsigned int loop_count = 0;
 	while (((SPI1 -> SR) & (0b1 << 1)) == 0) {
@@ -0,0 +1,47 @@
+/*
+ * systick.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "systick.h"
+
+#include "systick_reg.h"
+
+/*** SYSTICK functions ***/
+
+/* START SYSTEM TIMER AS A FREE RUNNING CYCLE COUNTER.
+ * @param:	None.
+ * @return:	None.
+ */
+void SYSTICK_start(void) {
+	// Stop timer.
+	SYSTICK -> CSR = 0;
+	// Use full counter range.
+	SYSTICK -> RVR = SYSTICK_COUNTER_MAX;
+	SYSTICK -> CVR = 0; // Any write clears the counter and reload the RVR value.
+	// Start counting on processor clock (no interrupt).
+	SYSTICK -> CSR = (0b1 << 2) | (0b1 << 0); // CLKSOURCE='1' and ENABLE='1'.
+}
+
+/* GET NUMBER OF PROCESSOR CYCLES ELAPSED SINCE START.
+ * @param:	None.
+ * @return:	Number of cycles (saturated to 24-bits if counter wrapped).
+ */
+unsigned int SYSTICK_get_cycles(void) {
+	// Local variables.
+	unsigned int current_value = (SYSTICK -> CVR);
+	// Check overflow.
+	if (((SYSTICK -> CSR) & (0b1 << 16)) != 0) return SYSTICK_COUNTER_MAX; // COUNTFLAG='1'.
+	return (SYSTICK_COUNTER_MAX - current_value);
+}
+
+/* STOP SYSTEM TIMER.
+ * @param:	None.
+ * @return:	None.
+ */
+void SYSTICK_stop(void) {
+	// Disable counter.
+	SYSTICK -> CSR = 0;
+}
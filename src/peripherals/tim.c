@@ -0,0 +1,82 @@
+/*
+ * tim.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "tim.h"
+
+#include "rcc.h"
+#include "rcc_reg.h"
+#include "tim_reg.h"
+
+/*** TIM local macros ***/
+
+#define TIM_ARR_MAX		0xFFFF
+
+/*** TIM local structures ***/
+
+typedef struct {
+	unsigned int period_us;
+} TIM_context_t;
+
+/*** TIM local global variables ***/
+
+static TIM_context_t tim_ctx;
+
+/*** TIM local functions ***/
+
+/* UPDATE TIM2 PERIOD AFTER A SYSTEM CLOCK SWITCH.
+ * @param sysclk_khz:	New system clock frequency in kHz.
+ * @return:				None.
+ */
+static void TIM2_clock_callback(unsigned int sysclk_khz) {
+	// Local variables.
+	unsigned int arr = ((tim_ctx.period_us * sysclk_khz) / 1000);
+	// Check timer is running.
+	if (((RCC -> APB1ENR) & (0b1 << 0)) == 0) return;
+	// Timer is clocked by PCLK1 = SYSCLK without prescaler.
+	if (arr > 0) arr--;
+	if (arr > TIM_ARR_MAX) arr = TIM_ARR_MAX;
+	TIM2 -> ARR = arr;
+}
+
+/*** TIM functions ***/
+
+/* START TIM2 AS A PERIODIC TRIGGER OUTPUT (TRGO ON UPDATE EVENT).
+ * @param period_us:	Trigger period in us (maximum 4ms on HSI16).
+ * @return:				None.
+ */
+void TIM2_start_trigger(unsigned int period_us) {
+	// Init context.
+	tim_ctx.period_us = period_us;
+	// Enable peripheral clock.
+	RCC -> APB1ENR |= (0b1 << 0); // TIM2EN='1'.
+	// Configure peripheral.
+	TIM2 -> CR1 &= ~(0b1 << 0); // Disable counter (CEN='0').
+	TIM2 -> CR1 |= (0b1 << 2); // Only counter overflow generates an update event (URS='1').
+	TIM2 -> CR2 &= ~(0b111 << 4);
+	TIM2 -> CR2 |= (0b010 << 4); // Update event is used as trigger output (MMS='010').
+	TIM2 -> DIER = 0; // No interrupt.
+	TIM2 -> PSC = 0;
+	// Period depends on system clock.
+	TIM2_clock_callback(RCC_get_sysclk_khz());
+	RCC_register_clock_callback(&TIM2_clock_callback);
+	// Load prescaler and start counting.
+	TIM2 -> CNT = 0;
+	TIM2 -> EGR |= (0b1 << 0); // UG='1'.
+	TIM2 -> SR = 0;
+	TIM2 -> CR1 |= (0b1 << 0); // CEN='1'.
+}
+
+/* STOP TIM2.
+ * @param:	None.
+ * @return:	None.
+ */
+void TIM2_stop(void) {
+	// Disable counter.
+	TIM2 -> CR1 &= ~(0b1 << 0); // CEN='0'.
+	// Disable peripheral clock.
+	RCC -> APB1ENR &= ~(0b1 << 0); // TIM2EN='0'.
+}
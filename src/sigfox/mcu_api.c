@@ -6,9 +6,12 @@
  */
 
 #include "mcu_api.h"
+#include "mcu_api_ext.h"
 
 #include "adc.h"
 #include "aes.h"
+#include "aes_sw.h"
+#include "arena.h"
 #include "at.h"
 #include "exti.h"
 #include "iwdg.h"
@@ -16,23 +19,82 @@
 #include "mode.h"
 #include "nvm.h"
 #include "pwr.h"
+#include "rcc.h"
+#include "rf_api_ext.h"
 #include "rtc.h"
+#include "systick.h"
+#include "telemetry.h"
+#include "timer.h"
+#include "trace.h"
 
 /*** MCU API local macros ***/
 
-#define MCU_API_MALLOC_BUFFER_SIZE	200
+#define MCU_API_MALLOC_BUFFER_SIZE	200 // Maximum size of the Sigfox session block (allocated in arena).
+#define MCU_API_AES_BUFFER_BLOCKS	4 // Number of blocks processed in a single hardware pass.
+#define MCU_API_RUN_CURRENT_UA_PER_MHZ	100 // Typical run mode consumption used for energy estimation.
+#define MCU_API_DEFAULT_VDD_MV			3300 // Used for energy estimation if no supply measurement is available.
+
+// Software AES implementation is used when the device has no AES peripheral (can also be forced with -DMCU_API_AES_SOFTWARE).
+#if !(defined AES_PERIPHERAL_AVAILABLE) && !(defined MCU_API_AES_SOFTWARE)
+#define MCU_API_AES_SOFTWARE
+#endif
+
+// Sigfox session and uplink phases are nested in arena.
+#if ((ARENA_ALIGN(MCU_API_MALLOC_BUFFER_SIZE) + ARENA_ALIGN(RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES)) > ARENA_SIZE_BYTES)
+#error "ARENA_SIZE_BYTES is too small for Sigfox session and uplink phases."
+#endif
+// Test results are printed during the Sigfox session (outside uplink).
+#if ((ARENA_ALIGN(MCU_API_MALLOC_BUFFER_SIZE) + ARENA_ALIGN(AT_RESPONSE_BUFFER_LENGTH)) > ARENA_SIZE_BYTES)
+#error "ARENA_SIZE_BYTES is too small for Sigfox session and AT response phases."
+#endif
 
 /*** MCU API local structures ***/
 
+typedef enum {
+	MCU_API_AES_KEY_NONE,
+	MCU_API_AES_KEY_PRIVATE,
+	MCU_API_AES_KEY_ARGUMENT
+} MCU_API_aes_key_t;
+
 typedef struct {
-	sfx_u8 malloc_buf[MCU_API_MALLOC_BUFFER_SIZE];
-	sfx_u32 timer_duration_seconds;
+	TIMER_t timer;
+	TIMER_t carrier_sense_timer;
+	TIMER_t delay_timer;
+	// AES key currently loaded in hardware peripheral.
+	MCU_API_aes_key_t aes_key_loaded;
+	sfx_u8 aes_argument_key[AES_BLOCK_SIZE];
+	// AES cost of the current (or last) session.
+	unsigned int aes_number_of_blocks;
+	unsigned int aes_cycles;
+	unsigned int aes_duration_us;
 } MCU_API_context_t;
 
 /*** MCU API local global variables ***/
 
 static MCU_API_context_t mcu_api_ctx;
 
+/*** MCU API local functions ***/
+
+/* RELEASE AES PERIPHERAL AND FORGET CACHED KEY.
+ * @param:	None.
+ * @return:	None.
+ */
+static void MCU_API_aes_release(void) {
+	// Local variables.
+	unsigned char byte_idx = 0;
+	// Wipe key registers and cached argument key.
+	if (mcu_api_ctx.aes_key_loaded != MCU_API_AES_KEY_NONE) {
+		for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE ; byte_idx++) mcu_api_ctx.aes_argument_key[byte_idx] = 0;
+#ifdef MCU_API_AES_SOFTWARE
+		AES_SW_clear_key();
+#else
+		AES_set_key(mcu_api_ctx.aes_argument_key);
+		AES_disable();
+#endif
+	}
+	mcu_api_ctx.aes_key_loaded = MCU_API_AES_KEY_NONE;
+}
+
 /*** MCU API functions ***/
 
 /*!******************************************************************
@@ -56,13 +118,24 @@ static MCU_API_context_t mcu_api_ctx;
  *******************************************************************/
 sfx_u8 MCU_API_malloc(sfx_u16 size, sfx_u8** returned_pointer) {
 	sfx_u8 sfx_err = SFX_ERR_NONE;
+	TRACE_enter(TRACE_EVENT_MCU_API_MALLOC, size);
+	// New session: key will be loaded at first encryption.
+	MCU_API_aes_release();
+	mcu_api_ctx.aes_number_of_blocks = 0;
+	mcu_api_ctx.aes_cycles = 0;
+	mcu_api_ctx.aes_duration_us = 0;
 	// Check size.
-	if (size <= MCU_API_MALLOC_BUFFER_SIZE) {
-		(*returned_pointer) = &(mcu_api_ctx.malloc_buf[0]);
+	if (size > MCU_API_MALLOC_BUFFER_SIZE) {
+		sfx_err = MCU_ERR_API_MALLOC;
+		goto errors;
 	}
-	else {
+	// Allocate session block.
+	(*returned_pointer) = (sfx_u8*) ARENA_enter(ARENA_PHASE_SIGFOX_SESSION, size);
+	if ((*returned_pointer) == 0) {
 		sfx_err = MCU_ERR_API_MALLOC;
 	}
+errors:
+	TRACE_exit(TRACE_EVENT_MCU_API_MALLOC, sfx_err);
 	return sfx_err;
 }
 
@@ -77,6 +150,11 @@ sfx_u8 MCU_API_malloc(sfx_u16 size, sfx_u8** returned_pointer) {
  * \retval MCU_ERR_API_FREE:                     Free error
  *******************************************************************/
 sfx_u8 MCU_API_free(sfx_u8* ptr) {
+	TRACE_enter(TRACE_EVENT_MCU_API_FREE, 0);
+	// End of session.
+	MCU_API_aes_release();
+	ARENA_exit(ARENA_PHASE_SIGFOX_SESSION);
+	TRACE_exit(TRACE_EVENT_MCU_API_FREE, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -94,19 +172,17 @@ sfx_u8 MCU_API_free(sfx_u8* ptr) {
  * \retval MCU_ERR_API_VOLT_TEMP:                Get voltage/temperature error
  *******************************************************************/
 sfx_u8 MCU_API_get_voltage_temperature(sfx_u16* voltage_idle, sfx_u16* voltage_tx, sfx_s16* temperature) {
-	// Perform measurements.
-	ADC1_init();
-	ADC1_perform_measurements();
-	ADC1_disable();
-	// Get MCU supply voltage.
-	unsigned int mcu_supply_voltage_mv = 0;
-	ADC1_get_data(ADC_DATA_IDX_VMCU_MV, &mcu_supply_voltage_mv);
-	(*voltage_idle) = (sfx_u16) mcu_supply_voltage_mv;
-	(*voltage_tx) = (sfx_u16) mcu_supply_voltage_mv;
+	// Local variables.
+	TELEMETRY_data_t telemetry_data;
+	TRACE_enter(TRACE_EVENT_MCU_API_GET_VOLTAGE_TEMPERATURE, 0);
+	// Get cached measurements (refreshed only if too old).
+	TELEMETRY_get_data(&telemetry_data);
+	// Get MCU supply voltage (voltage_tx is measured during last RF_API_send).
+	(*voltage_idle) = (sfx_u16) telemetry_data.voltage_idle_mv;
+	(*voltage_tx) = (sfx_u16) telemetry_data.voltage_tx_mv;
 	// Get MCU internal temperature.
-	signed char mcu_temperature_degrees = 0;
-	ADC1_get_tmcu_comp2(&mcu_temperature_degrees);
-	(*temperature) = ((sfx_s16) mcu_temperature_degrees) * 10; // Unit = 1/10 of degrees.
+	(*temperature) = ((sfx_s16) telemetry_data.temperature_degrees) * 10; // Unit = 1/10 of degrees.
+	TRACE_exit(TRACE_EVENT_MCU_API_GET_VOLTAGE_TEMPERATURE, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -125,26 +201,35 @@ sfx_u8 MCU_API_get_voltage_temperature(sfx_u16* voltage_idle, sfx_u16* voltage_t
  * \retval MCU_ERR_API_DLY:                      Delay error
  *******************************************************************/
 sfx_u8 MCU_API_delay(sfx_delay_t delay_type) {
+	// Local variables.
+	unsigned int delay_ms = 0;
+	TRACE_enter(TRACE_EVENT_MCU_API_DELAY, delay_type);
 	switch (delay_type) {
 	case SFX_DLY_INTER_FRAME_TX:
 		// 0 to 2s in Uplink DC.
-		LPTIM1_delay_milliseconds(500, 1);
+		delay_ms = 500;
 		break;
 	case SFX_DLY_INTER_FRAME_TRX:
 		// 500 ms in Uplink/Downlink FH & Downlink DC.
-		LPTIM1_delay_milliseconds(500, 1);
+		delay_ms = 500;
 		break;
 	case SFX_DLY_OOB_ACK:
 		// 1.4s to 4s for Downlink OOB.
-		LPTIM1_delay_milliseconds(2000, 1);
+		delay_ms = 2000;
 		break;
 	case SFX_DLY_CS_SLEEP:
 		// Delay between several trials of Carrier Sense (for the first frame only).
-		LPTIM1_delay_milliseconds(1000, 1);
+		delay_ms = 1000;
 		break;
 	default:
 		break;
 	}
+	// Wait in stop mode (RTC sub-second wake-up).
+	if (delay_ms != 0) {
+		TIMER_start(&mcu_api_ctx.delay_timer, delay_ms, 0, 0);
+		TIMER_wait(&mcu_api_ctx.delay_timer, 0);
+	}
+	TRACE_exit(TRACE_EVENT_MCU_API_DELAY, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -169,43 +254,107 @@ sfx_u8 MCU_API_aes_128_cbc_encrypt(sfx_u8* encrypted_data, sfx_u8* data_to_encry
 	unsigned char byte_idx = 0;
 	unsigned char local_key[AES_BLOCK_SIZE] = {0};
 	unsigned char init_vector[AES_BLOCK_SIZE] = {0};
-	unsigned char data_in[AES_BLOCK_SIZE] = {0};
-	unsigned char data_out[AES_BLOCK_SIZE] = {0};
+#ifndef MCU_API_AES_SOFTWARE
+	unsigned int aes_buf[MCU_API_AES_BUFFER_BLOCKS * (AES_BLOCK_SIZE / 4)]; // 32-bits aligned buffer for DMA.
+	unsigned char* aes_buf_bytes = (unsigned char*) aes_buf;
+	unsigned char chunk_blocks = 0;
+#endif
 	unsigned char number_of_blocks = aes_block_len / AES_BLOCK_SIZE;
-	unsigned char block_idx;
-	unsigned char key_byte = 0;
-	// Get accurate key.
+	unsigned char data_idx = 0;
+	unsigned char key_reload = 0;
+	unsigned int cycles = 0;
+	unsigned int sysclk_khz = 0;
+	TRACE_enter(TRACE_EVENT_MCU_API_AES_128_CBC_ENCRYPT, aes_block_len);
+	// Run on high speed clock.
+	RCC_request_high_speed();
+	sysclk_khz = RCC_get_sysclk_khz();
+	// Start cost measurement.
+	SYSTICK_start();
+	mcu_api_ctx.aes_number_of_blocks += number_of_blocks;
+	// Check if the requested key is already loaded in peripheral.
 	switch (use_key) {
 		case CREDENTIALS_PRIVATE_KEY:
-			// Retrieve device key from NVM.
-			for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE ; byte_idx++) {
+			if (mcu_api_ctx.aes_key_loaded != MCU_API_AES_KEY_PRIVATE) {
+				// Retrieve device key from NVM.
 				NVM_enable();
-				NVM_read_byte(NVM_ADDRESS_SIGFOX_DEVICE_KEY+byte_idx, &key_byte);
+				for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE ; byte_idx++) {
+					NVM_read_byte(NVM_ADDRESS_SIGFOX_DEVICE_KEY+byte_idx, &(local_key[byte_idx]));
+				}
 				NVM_disable();
-				local_key[byte_idx] = key_byte;
+				mcu_api_ctx.aes_key_loaded = MCU_API_AES_KEY_PRIVATE;
+				key_reload = 1;
 			}
 			break;
 		case CREDENTIALS_KEY_IN_ARGUMENT:
 			// Use key in argument.
-			for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE ; byte_idx++) {
-				local_key[byte_idx] = key[byte_idx];
+			if (mcu_api_ctx.aes_key_loaded == MCU_API_AES_KEY_ARGUMENT) {
+				for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE ; byte_idx++) {
+					if (mcu_api_ctx.aes_argument_key[byte_idx] != key[byte_idx]) {
+						key_reload = 1;
+						break;
+					}
+				}
+			}
+			else {
+				key_reload = 1;
+			}
+			if (key_reload != 0) {
+				for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE ; byte_idx++) {
+					local_key[byte_idx] = key[byte_idx];
+					mcu_api_ctx.aes_argument_key[byte_idx] = key[byte_idx];
+				}
+				mcu_api_ctx.aes_key_loaded = MCU_API_AES_KEY_ARGUMENT;
 			}
 			break;
 		default:
 			break;
 	}
-	// Perform encryption.
-	AES_init();
-	for (block_idx=0; block_idx<number_of_blocks ; block_idx++) {
-		// Fill input data and initialization vector with previous result.
-		for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE; byte_idx++) data_in[byte_idx] = data_to_encrypt[(block_idx * AES_BLOCK_SIZE) + byte_idx];
-		for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE; byte_idx++) init_vector[byte_idx] = data_out[byte_idx];
-		// Run algorithme.
-		AES_encrypt(data_in, data_out, init_vector, local_key);
+	// Load key once per session.
+	if (key_reload != 0) {
+#ifdef MCU_API_AES_SOFTWARE
+		AES_SW_set_key(local_key);
+#else
+		AES_init();
+		AES_set_key(local_key);
+#endif
+		for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE ; byte_idx++) local_key[byte_idx] = 0;
+	}
+#ifdef MCU_API_AES_SOFTWARE
+	// Perform encryption block by block.
+	while (number_of_blocks > 0) {
+		AES_SW_encrypt_block(&(data_to_encrypt[data_idx]), &(encrypted_data[data_idx]), init_vector);
+		// Output block is the initialization vector of next block.
+		for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE ; byte_idx++) init_vector[byte_idx] = encrypted_data[data_idx + byte_idx];
+		data_idx += AES_BLOCK_SIZE;
+		number_of_blocks--;
+	}
+#else
+	// Perform encryption by chunks of blocks chained in hardware.
+	while (number_of_blocks > 0) {
+		chunk_blocks = (number_of_blocks > MCU_API_AES_BUFFER_BLOCKS) ? MCU_API_AES_BUFFER_BLOCKS : number_of_blocks;
+		// Fill aligned buffer.
+		for (byte_idx=0 ; byte_idx<(chunk_blocks * AES_BLOCK_SIZE) ; byte_idx++) aes_buf_bytes[byte_idx] = data_to_encrypt[data_idx + byte_idx];
+		// Run algorithme in place.
+		AES_start_cbc(aes_buf, aes_buf, chunk_blocks, init_vector);
+		while (AES_get_cbc_status() == 0) {
+			PWR_enter_sleep_mode();
+		}
+		AES_stop_cbc();
 		// Fill output data.
-		for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE; byte_idx++) encrypted_data[(block_idx * AES_BLOCK_SIZE) + byte_idx] = data_out[byte_idx];
+		for (byte_idx=0 ; byte_idx<(chunk_blocks * AES_BLOCK_SIZE) ; byte_idx++) encrypted_data[data_idx + byte_idx] = aes_buf_bytes[byte_idx];
+		// Last output block is the initialization vector of next chunk.
+		for (byte_idx=0 ; byte_idx<AES_BLOCK_SIZE ; byte_idx++) init_vector[byte_idx] = aes_buf_bytes[((chunk_blocks - 1) * AES_BLOCK_SIZE) + byte_idx];
+		data_idx += (chunk_blocks * AES_BLOCK_SIZE);
+		number_of_blocks -= chunk_blocks;
 	}
-	AES_disable();
+#endif
+	// Update cost measurement.
+	cycles = SYSTICK_get_cycles();
+	SYSTICK_stop();
+	mcu_api_ctx.aes_cycles += cycles;
+	mcu_api_ctx.aes_duration_us += ((cycles / sysclk_khz) * 1000) + (((cycles % sysclk_khz) * 1000) / sysclk_khz);
+	RCC_release_high_speed();
+	TRACE_exit(TRACE_EVENT_MCU_API_AES_128_CBC_ENCRYPT, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -233,6 +382,7 @@ sfx_u8 MCU_API_get_nv_mem(sfx_u8 read_data[SFX_NVMEM_BLOCK_SIZE]) {
 	// |  PN  |  SEQ  |  FH  |  RL  |
 	// |______|_______|______|______|
 
+	TRACE_enter(TRACE_EVENT_MCU_API_GET_NV_MEM, 0);
 	// PN.
 	NVM_enable();
 	NVM_read_byte(NVM_ADDRESS_SIGFOX_PN, &(read_data[SFX_NVMEM_PN]));
@@ -246,6 +396,7 @@ sfx_u8 MCU_API_get_nv_mem(sfx_u8 read_data[SFX_NVMEM_BLOCK_SIZE]) {
 	// RL.
 	NVM_read_byte(NVM_ADDRESS_SIGFOX_FH, &(read_data[SFX_NVMEM_RL]));
 	NVM_disable();
+	TRACE_exit(TRACE_EVENT_MCU_API_GET_NV_MEM, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -274,19 +425,22 @@ sfx_u8 MCU_API_set_nv_mem(sfx_u8 data_to_write[SFX_NVMEM_BLOCK_SIZE]) {
 	// |  PN  |  SEQ  |  FH  |  RL  |
 	// |______|_______|______|______|
 
+	TRACE_enter(TRACE_EVENT_MCU_API_SET_NV_MEM, 0);
+	// Writes are queued and programmed in background (flushed before any stop mode entry).
 	// PN.
 	NVM_enable();
-	NVM_write_byte(NVM_ADDRESS_SIGFOX_PN, data_to_write[SFX_NVMEM_PN]);
-	NVM_write_byte(NVM_ADDRESS_SIGFOX_PN+1, data_to_write[SFX_NVMEM_PN + 1]);
+	NVM_write_byte_deferred(NVM_ADDRESS_SIGFOX_PN, data_to_write[SFX_NVMEM_PN]);
+	NVM_write_byte_deferred(NVM_ADDRESS_SIGFOX_PN+1, data_to_write[SFX_NVMEM_PN + 1]);
 	// Sequence number.
-	NVM_write_byte(NVM_ADDRESS_SIGFOX_MESSAGE_COUNTER, data_to_write[SFX_NVMEM_MSG_COUNTER]);
-	NVM_write_byte(NVM_ADDRESS_SIGFOX_MESSAGE_COUNTER+1, data_to_write[SFX_NVMEM_MSG_COUNTER + 1]);
+	NVM_write_byte_deferred(NVM_ADDRESS_SIGFOX_MESSAGE_COUNTER, data_to_write[SFX_NVMEM_MSG_COUNTER]);
+	NVM_write_byte_deferred(NVM_ADDRESS_SIGFOX_MESSAGE_COUNTER+1, data_to_write[SFX_NVMEM_MSG_COUNTER + 1]);
 	// FH.
-	NVM_write_byte(NVM_ADDRESS_FH, data_to_write[SFX_NVMEM_FH]);
-	NVM_write_byte(NVM_ADDRESS_FH+1, data_to_write[SFX_NVMEM_FH + 1]);
+	NVM_write_byte_deferred(NVM_ADDRESS_FH, data_to_write[SFX_NVMEM_FH]);
+	NVM_write_byte_deferred(NVM_ADDRESS_FH+1, data_to_write[SFX_NVMEM_FH + 1]);
 	// RL.
-	NVM_write_byte(NVM_ADDRESS_SIGFOX_FH, data_to_write[SFX_NVMEM_RL]);
+	NVM_write_byte_deferred(NVM_ADDRESS_SIGFOX_FH, data_to_write[SFX_NVMEM_RL]);
 	NVM_disable();
+	TRACE_exit(TRACE_EVENT_MCU_API_SET_NV_MEM, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -302,6 +456,10 @@ sfx_u8 MCU_API_set_nv_mem(sfx_u8 data_to_write[SFX_NVMEM_BLOCK_SIZE]) {
  * \retval MCU_ERR_API_TIMER_START_CS:           Start CS timer error
  *******************************************************************/
 sfx_u8 MCU_API_timer_start_carrier_sense(sfx_u16 time_duration_in_ms) {
+	TRACE_enter(TRACE_EVENT_MCU_API_TIMER_START_CARRIER_SENSE, time_duration_in_ms);
+	// Start software timer (expiration is checked with MCU_API_timer_stop_carrier_sense).
+	TIMER_start(&mcu_api_ctx.carrier_sense_timer, time_duration_in_ms, 0, 0);
+	TRACE_exit(TRACE_EVENT_MCU_API_TIMER_START_CARRIER_SENSE, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -316,8 +474,10 @@ sfx_u8 MCU_API_timer_start_carrier_sense(sfx_u16 time_duration_in_ms) {
  * \retval MCU_ERR_API_TIMER_START:              Start timer error
  *******************************************************************/
 sfx_u8 MCU_API_timer_start(sfx_u32 time_duration_in_s) {
-	// Save duration.
-	mcu_api_ctx.timer_duration_seconds = time_duration_in_s;
+	TRACE_enter(TRACE_EVENT_MCU_API_TIMER_START, time_duration_in_s);
+	// Start software timer.
+	TIMER_start(&mcu_api_ctx.timer, (time_duration_in_s * 1000), 0, 0);
+	TRACE_exit(TRACE_EVENT_MCU_API_TIMER_START, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -332,8 +492,10 @@ sfx_u8 MCU_API_timer_start(sfx_u32 time_duration_in_s) {
  * \retval MCU_ERR_API_TIMER_STOP:               Stop timer error
  *******************************************************************/
 sfx_u8 MCU_API_timer_stop(void) {
-	// Stop wake-up timer.
-	RTC_stop_wakeup_timer();
+	TRACE_enter(TRACE_EVENT_MCU_API_TIMER_STOP, 0);
+	// Stop software timer.
+	TIMER_stop(&mcu_api_ctx.timer);
+	TRACE_exit(TRACE_EVENT_MCU_API_TIMER_STOP, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -348,6 +510,10 @@ sfx_u8 MCU_API_timer_stop(void) {
  * \retval MCU_ERR_API_TIMER_STOP_CS:            Stop timer error
  *******************************************************************/
 sfx_u8 MCU_API_timer_stop_carrier_sense(void) {
+	TRACE_enter(TRACE_EVENT_MCU_API_TIMER_STOP_CARRIER_SENSE, 0);
+	// Stop software timer.
+	TIMER_stop(&mcu_api_ctx.carrier_sense_timer);
+	TRACE_exit(TRACE_EVENT_MCU_API_TIMER_STOP_CARRIER_SENSE, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -364,23 +530,10 @@ sfx_u8 MCU_API_timer_stop_carrier_sense(void) {
  * \retval MCU_ERR_API_TIMER_END:                Wait end of timer error
  *******************************************************************/
 sfx_u8 MCU_API_timer_wait_for_end(void) {
-	// Clear watchdog.
-	IWDG_reload();
-	// Enter stop mode until GPIO interrupt or RTC wake-up.
-	unsigned int remaining_delay = mcu_api_ctx.timer_duration_seconds;
-	unsigned int sub_delay = 0;
-	while (remaining_delay > 0) {
-		// Compute sub-delay.
-		sub_delay = (remaining_delay > IWDG_REFRESH_PERIOD_SECONDS) ? (IWDG_REFRESH_PERIOD_SECONDS) : (remaining_delay);
-		remaining_delay -= sub_delay;
-		// Start wake-up timer.
-		RTC_start_wakeup_timer(sub_delay);
-		PWR_enter_stop_mode();
-		// Wake-up: clear watchdog and flags.
-		IWDG_reload();
-		RTC_clear_wakeup_timer_flag();
-		EXTI_clear_all_flags();
-	}
+	TRACE_enter(TRACE_EVENT_MCU_API_TIMER_WAIT_FOR_END, 0);
+	// Enter stop mode until timer expiration.
+	TIMER_wait(&mcu_api_ctx.timer, 0);
+	TRACE_exit(TRACE_EVENT_MCU_API_TIMER_WAIT_FOR_END, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -400,7 +553,9 @@ sfx_u8 MCU_API_timer_wait_for_end(void) {
  * \retval MCU_ERR_API_TEST_REPORT:              Report test result error
  *******************************************************************/
 sfx_u8 MCU_API_report_test_result(sfx_bool status, sfx_s16 rssi) {
+	TRACE_enter(TRACE_EVENT_MCU_API_REPORT_TEST_RESULT, status);
 	AT_print_test_result(status, rssi);
+	TRACE_exit(TRACE_EVENT_MCU_API_REPORT_TEST_RESULT, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -415,6 +570,8 @@ sfx_u8 MCU_API_report_test_result(sfx_bool status, sfx_s16 rssi) {
  * \retval MCU_ERR_API_GET_VERSION:              Get Version error
  *******************************************************************/
 sfx_u8 MCU_API_get_version(sfx_u8** version, sfx_u8* size) {
+	TRACE_enter(TRACE_EVENT_MCU_API_GET_VERSION, 0);
+	TRACE_exit(TRACE_EVENT_MCU_API_GET_VERSION, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -433,13 +590,15 @@ sfx_u8 MCU_API_get_version(sfx_u8** version, sfx_u8* size) {
 sfx_u8 MCU_API_get_device_id_and_payload_encryption_flag(sfx_u8 dev_id[ID_LENGTH], sfx_bool* payload_encryption_enabled) {
 	// Get device ID.
 	unsigned char byte_idx = 0;
+	TRACE_enter(TRACE_EVENT_MCU_API_GET_DEVICE_ID_AND_PAYLOAD_ENCRYPTION_FLAG, 0);
 	for (byte_idx=0 ; byte_idx<ID_LENGTH ; byte_idx++) {
 		NVM_enable();
 		NVM_read_byte(NVM_ADDRESS_SIGFOX_DEVICE_ID+byte_idx, &(dev_id[byte_idx]));
 		NVM_disable();
 	}
-	// No payload encryption.
-	(*payload_encryption_enabled) = SFX_FALSE;
+	// Get payload encryption flag (keystream is computed by the library through MCU_API_aes_128_cbc_encrypt).
+	(*payload_encryption_enabled) = (MCU_API_get_payload_encryption() != 0) ? SFX_TRUE : SFX_FALSE;
+	TRACE_exit(TRACE_EVENT_MCU_API_GET_DEVICE_ID_AND_PAYLOAD_ENCRYPTION_FLAG, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -454,7 +613,9 @@ sfx_u8 MCU_API_get_device_id_and_payload_encryption_flag(sfx_u8 dev_id[ID_LENGTH
  * \retval MCU_ERR_API_GET_MSG_COUNTER_ROLLOVER: Error when getting msg counter rollover
  *******************************************************************/
 sfx_u8 MCU_API_get_msg_counter_rollover(e_sfx_msg_counter_rollover* msgCounterRollover) {
+	TRACE_enter(TRACE_EVENT_MCU_API_GET_MSG_COUNTER_ROLLOVER, 0);
 	(*msgCounterRollover) = SFX_MSG_COUNTER_ROLLOVER_4096;
+	TRACE_exit(TRACE_EVENT_MCU_API_GET_MSG_COUNTER_ROLLOVER, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -471,5 +632,57 @@ sfx_u8 MCU_API_get_msg_counter_rollover(e_sfx_msg_counter_rollover* msgCounterRo
  * \retval MCU_ERR_API_GET_PAC:                  Error when getting initial PAC
  *******************************************************************/
 sfx_u8 MCU_API_get_initial_pac(sfx_u8 initial_pac[PAC_LENGTH]) {
+	TRACE_enter(TRACE_EVENT_MCU_API_GET_INITIAL_PAC, 0);
+	TRACE_exit(TRACE_EVENT_MCU_API_GET_INITIAL_PAC, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
+
+/*** MCU API extension functions ***/
+
+/* ENABLE OR DISABLE SIGFOX PAYLOAD ENCRYPTION.
+ * @param enable:	0 to disable payload encryption, enable otherwise.
+ * @return:			None.
+ */
+void MCU_API_set_payload_encryption(unsigned char enable) {
+	// Store flag in NVM.
+	NVM_enable();
+	NVM_write_byte(NVM_ADDRESS_SIGFOX_PAYLOAD_ENCRYPTION, ((enable != 0) ? 1 : 0));
+	NVM_disable();
+}
+
+/* GET SIGFOX PAYLOAD ENCRYPTION FLAG.
+ * @param:	None.
+ * @return:	1 if payload encryption is enabled, 0 otherwise.
+ */
+unsigned char MCU_API_get_payload_encryption(void) {
+	// Local variables.
+	unsigned char payload_encryption = 0;
+	// Read flag in NVM.
+	NVM_enable();
+	NVM_read_byte(NVM_ADDRESS_SIGFOX_PAYLOAD_ENCRYPTION, &payload_encryption);
+	NVM_disable();
+	return (payload_encryption == 1) ? 1 : 0;
+}
+
+/* GET AES COST OF THE LAST SIGFOX SESSION.
+ * @param aes_statistics:	Pointer to structure that will contain the statistics.
+ * @return:					None.
+ */
+void MCU_API_get_aes_statistics(MCU_API_aes_statistics_t* aes_statistics) {
+	// Local variables.
+	unsigned int vdd_mv = 0;
+	unsigned long long charge_pc = 0;
+	// Raw values.
+	aes_statistics -> number_of_blocks = mcu_api_ctx.aes_number_of_blocks;
+	aes_statistics -> cycles = mcu_api_ctx.aes_cycles;
+	// Duration is converted at each encryption with the system clock frequency in use.
+	aes_statistics -> duration_us = mcu_api_ctx.aes_duration_us;
+	// Estimate energy with last supply voltage measurement (cycles * uA/MHz gives pC).
+	ADC1_get_data(ADC_DATA_IDX_VMCU_MV, &vdd_mv);
+	if (vdd_mv == 0) {
+		vdd_mv = MCU_API_DEFAULT_VDD_MV;
+	}
+	// 64-bits intermediates: cycles * uA/MHz * mV overflows 32 bits after a few thousands cycles.
+	charge_pc = ((unsigned long long) mcu_api_ctx.aes_cycles) * MCU_API_RUN_CURRENT_UA_PER_MHZ;
+	aes_statistics -> energy_nj = (unsigned int) ((charge_pc * vdd_mv) / 1000000);
+}
@@ -6,13 +6,17 @@
  */
 
 #include "rf_api.h"
+#include "rf_api_ext.h"
 
+#include "arena.h"
+#include "core.h"
 #include "dma.h"
 #include "exti.h"
 #include "iwdg.h"
 #include "mapping.h"
 #include "mode.h"
 #include "nvic.h"
+#include "probe.h"
 #include "pwr.h"
 #include "rcc.h"
 #include "rtc.h"
@@ -20,25 +24,22 @@
 #include "sigfox_api.h"
 #include "sigfox_types.h"
 #include "spi.h"
+#include "telemetry.h"
+#include "timer.h"
+#include "trace.h"
 
 /*** RF API local macros ***/
 
 // Uplink parameters.
-#define RF_API_SYMBOL_PROFILE_LENGTH_BYTES		40
-#define RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES	(2 * RF_API_SYMBOL_PROFILE_LENGTH_BYTES) // Size is twice to store PA and FDEV values.
-
-#define RF_API_S2LP_FDEV_NEGATIVE				0x7F // fdev * (+1)
-#define RF_API_S2LP_FDEV_POSITIVE				0x81 // fdev * (-1)
-#define RF_API_S2LP_FIFO_BUFFER_FDEV_IDX		(RF_API_SYMBOL_PROFILE_LENGTH_BYTES / 2) // Index where deviation is performed to invert phase.
-
 #define RF_API_ETSI_UPLINK_OUTPUT_POWER_DBM		14
 #define RF_API_ESTI_UPLINK_DATARATE				S2LP_DATARATE_500BPS // 500*8 = 4kHz / 40 samples = 100bps.
 #define RF_API_ETSI_UPLINK_DEVIATION			S2LP_FDEV_2KHZ // 1 / (2 * Delta_f) = 1 / 4kHz.
 
+// Profiles are also used by the host DBPSK golden model (not constant to be read from RAM during uplink).
 // Ramp profile table is written for ramp-down direction (reverse table for ramp up).
-static const unsigned char rf_api_etsi_ramp_amplitude_profile[RF_API_SYMBOL_PROFILE_LENGTH_BYTES] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 4, 5, 6, 7, 8, 9, 11, 13, 15, 17, 20, 22, 24, 27, 30, 34, 39, 45, 54, 80, 120, 220};
+unsigned char rf_api_etsi_ramp_amplitude_profile[RF_API_SYMBOL_PROFILE_LENGTH_BYTES] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 4, 5, 6, 7, 8, 9, 11, 13, 15, 17, 20, 22, 24, 27, 30, 34, 39, 45, 54, 80, 120, 220};
 // Ampltude profile table for bit 0 transmission.
-static const unsigned char rf_api_etsi_bit0_amplitude_profile[RF_API_SYMBOL_PROFILE_LENGTH_BYTES] = {1, 1, 1, 1, 1, 1, 2, 2, 3, 4, 6, 8, 11, 15, 20, 24, 30, 39, 54, 220, 220, 54, 39, 30, 24, 20, 15, 11, 8, 6, 4, 3, 2, 2, 1, 1, 1, 1, 1, 1};
+unsigned char rf_api_etsi_bit0_amplitude_profile[RF_API_SYMBOL_PROFILE_LENGTH_BYTES] = {1, 1, 1, 1, 1, 1, 2, 2, 3, 4, 6, 8, 11, 15, 20, 24, 30, 39, 54, 220, 220, 54, 39, 30, 24, 20, 15, 11, 8, 6, 4, 3, 2, 2, 1, 1, 1, 1, 1, 1};
 
 // Downlink parameters.
 #define RF_API_DOWNLINK_FRAME_LENGTH_BYTES		15
@@ -52,8 +53,9 @@ static unsigned char downlink_sync_word[(RF_API_DOWNLINK_SYNC_WORD_LENGTH_BITS /
 /*** RF API local structures ***/
 
 typedef struct {
-	unsigned char rf_api_s2lp_fifo_buffer[RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES];
+	unsigned char* rf_api_s2lp_fifo_buffer; // Allocated in arena during uplink.
 	volatile unsigned char rf_api_s2lp_irq_flag;
+	TIMER_t downlink_timer;
 } RF_api_context_t;
 
 /*** RF API local global variables ***/
@@ -61,6 +63,55 @@ typedef struct {
 static RF_api_context_t rf_api_ctx;
 signed char rf_api_cw_output_power = S2LP_RF_OUTPUT_POWER_MAX;
 
+/*** RF API local functions ***/
+
+/* WAIT FOR S2LP FIFO EMPTY INTERRUPT (EXECUTED FROM RAM).
+ * @param:	None.
+ * @return:	None.
+ */
+static void __attribute__((noinline, section(".ramfunc"))) RF_API_wait_for_fifo_irq(void) {
+	// Flag is checked with interrupts masked so that an interrupt occuring before WFI is not missed (other wake-up sources are ignored).
+	while (1) {
+		CORE_disable_interrupts();
+		if (rf_api_ctx.rf_api_s2lp_irq_flag != 0) {
+			CORE_enable_interrupts();
+			break;
+		}
+		PWR_enter_low_power_mode();
+		CORE_enable_interrupts();
+	}
+	// Consume interrupt.
+	rf_api_ctx.rf_api_s2lp_irq_flag = 0;
+}
+
+/* BUILD THE SAMPLES OF A BIT AND TRANSFER THEM TO S2LP FIFO ON NEXT FIFO EMPTY INTERRUPT (EXECUTED FROM RAM).
+ * @param bit:			Bit to transmit.
+ * @param s2lp_fdev:	Pointer to the effective deviation (toggled by bit 0).
+ * @return:				None.
+ */
+static void __attribute__((noinline, section(".ramfunc"))) RF_API_refill_fifo(unsigned char bit, unsigned char* s2lp_fdev) {
+	// Local variables.
+	unsigned char s2lp_fifo_sample_idx = 0;
+	if (bit == 0) {
+		// Phase shift and amplitude shaping required.
+		(*s2lp_fdev) = ((*s2lp_fdev) == RF_API_S2LP_FDEV_NEGATIVE) ? RF_API_S2LP_FDEV_POSITIVE : RF_API_S2LP_FDEV_NEGATIVE; // Toggle deviation.
+		for (s2lp_fifo_sample_idx=0 ; s2lp_fifo_sample_idx<RF_API_SYMBOL_PROFILE_LENGTH_BYTES ; s2lp_fifo_sample_idx++) {
+			rf_api_ctx.rf_api_s2lp_fifo_buffer[(2 * s2lp_fifo_sample_idx)] = (s2lp_fifo_sample_idx == RF_API_S2LP_FIFO_BUFFER_FDEV_IDX) ? (*s2lp_fdev) : 0; // Deviation.
+			rf_api_ctx.rf_api_s2lp_fifo_buffer[(2 * s2lp_fifo_sample_idx) + 1] = rf_api_etsi_bit0_amplitude_profile[s2lp_fifo_sample_idx]; // PA output power.
+		}
+	}
+	else {
+		// Constant CW.
+		for (s2lp_fifo_sample_idx=0 ; s2lp_fifo_sample_idx<RF_API_SYMBOL_PROFILE_LENGTH_BYTES ; s2lp_fifo_sample_idx++) {
+			rf_api_ctx.rf_api_s2lp_fifo_buffer[(2 * s2lp_fifo_sample_idx)] = 0; // No deviation.
+			rf_api_ctx.rf_api_s2lp_fifo_buffer[(2 * s2lp_fifo_sample_idx) + 1] = 1; // Constant PA output power.
+		}
+	}
+	// Enter stop and wait for S2LP interrupt to transfer next bit buffer.
+	RF_API_wait_for_fifo_irq();
+	S2LP_write_fifo(rf_api_ctx.rf_api_s2lp_fifo_buffer, RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES);
+}
+
 /*** RF API functions ***/
 
 /*!******************************************************************
@@ -80,8 +131,11 @@ signed char rf_api_cw_output_power = S2LP_RF_OUTPUT_POWER_MAX;
  * \retval RF_ERR_API_INIT:          Init Radio link error
  *******************************************************************/
 sfx_u8 RF_API_init(sfx_rf_mode_t rf_mode) {
+	TRACE_enter(TRACE_EVENT_RF_API_INIT, rf_mode);
 	// Clear watchdog.
 	IWDG_reload();
+	// Radio phases run on high speed clock (SPI and FIFO refill timing).
+	RCC_request_high_speed();
 	// Init required peripherals.
 	DMA1_init_channel3();
 	SPI1_init();
@@ -146,6 +200,7 @@ sfx_u8 RF_API_init(sfx_rf_mode_t rf_mode) {
 		GPIO_write(&GPIO_RF_TX_ENABLE, 0);
 		break;
 	}
+	TRACE_exit(TRACE_EVENT_RF_API_INIT, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -160,6 +215,7 @@ sfx_u8 RF_API_init(sfx_rf_mode_t rf_mode) {
  * \retval RF_ERR_API_STOP:           Close Radio link error
  *******************************************************************/
 sfx_u8 RF_API_stop(void) {
+	TRACE_enter(TRACE_EVENT_RF_API_STOP, 0);
 	// Disable front-end.
 	GPIO_write(&GPIO_RF_RX_ENABLE, 0);
 	GPIO_write(&GPIO_RF_TX_ENABLE, 0);
@@ -171,6 +227,9 @@ sfx_u8 RF_API_stop(void) {
 	// Turn peripherals off.
 	DMA1_disable();
 	SPI1_disable();
+	// Back to low speed clock.
+	RCC_release_high_speed();
+	TRACE_exit(TRACE_EVENT_RF_API_STOP, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -197,6 +256,13 @@ sfx_u8 RF_API_send(sfx_u8 *stream, sfx_modulation_type_t type, sfx_u8 size) {
 	unsigned char stream_bit_idx = 0;
 	unsigned char s2lp_fifo_sample_idx = 0;
 	unsigned char s2lp_fdev = RF_API_S2LP_FDEV_NEGATIVE; // Effective deviation.
+	TRACE_enter(TRACE_EVENT_RF_API_SEND, size);
+	// Allocate samples buffer.
+	rf_api_ctx.rf_api_s2lp_fifo_buffer = (unsigned char*) ARENA_enter(ARENA_PHASE_UPLINK, RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES);
+	if (rf_api_ctx.rf_api_s2lp_fifo_buffer == 0) {
+		TRACE_exit(TRACE_EVENT_RF_API_SEND, RF_ERR_API_SEND);
+		return RF_ERR_API_SEND;
+	}
 	// Go to ready state.
 	S2LP_send_command(S2LP_CMD_READY);
 	S2LP_wait_for_state(S2LP_STATE_READY);
@@ -208,35 +274,22 @@ sfx_u8 RF_API_send(sfx_u8 *stream, sfx_modulation_type_t type, sfx_u8 size) {
 	// Transfer ramp-up buffer to S2LP FIFO.
 	S2LP_write_fifo(rf_api_ctx.rf_api_s2lp_fifo_buffer, RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES);
 	// Enable external GPIO interrupt.
+	rf_api_ctx.rf_api_s2lp_irq_flag = 0;
 	EXTI_clear_all_flags();
 	NVIC_enable_interrupt(NVIC_IT_EXTI_4_15);
+	// Prepare supply voltage measurement.
+	TELEMETRY_start_tx_capture();
 	// Start radio
 	S2LP_send_command(S2LP_CMD_TX);
 	// Byte loop.
 	for (stream_byte_idx=0 ; stream_byte_idx<size ; stream_byte_idx++) {
 		// Bit loop.
 		for (stream_bit_idx=0 ; stream_bit_idx<8 ; stream_bit_idx++) {
-			if ((stream[stream_byte_idx] & (0b1 << (7-stream_bit_idx))) == 0) {
-				// Phase shift and amplitude shaping required.
-				s2lp_fdev = (s2lp_fdev == RF_API_S2LP_FDEV_NEGATIVE) ? RF_API_S2LP_FDEV_POSITIVE : RF_API_S2LP_FDEV_NEGATIVE; // Toggle deviation.
-				for (s2lp_fifo_sample_idx=0 ; s2lp_fifo_sample_idx<RF_API_SYMBOL_PROFILE_LENGTH_BYTES ; s2lp_fifo_sample_idx++) {
-					rf_api_ctx.rf_api_s2lp_fifo_buffer[(2 * s2lp_fifo_sample_idx)] = (s2lp_fifo_sample_idx == RF_API_S2LP_FIFO_BUFFER_FDEV_IDX) ? s2lp_fdev : 0; // Deviation.
-					rf_api_ctx.rf_api_s2lp_fifo_buffer[(2 * s2lp_fifo_sample_idx) + 1] = rf_api_etsi_bit0_amplitude_profile[s2lp_fifo_sample_idx]; // PA output power.
-				}
-			}
-			else {
-				// Constant CW.
-				for (s2lp_fifo_sample_idx=0 ; s2lp_fifo_sample_idx<RF_API_SYMBOL_PROFILE_LENGTH_BYTES ; s2lp_fifo_sample_idx++) {
-					rf_api_ctx.rf_api_s2lp_fifo_buffer[(2 * s2lp_fifo_sample_idx)] = 0; // No deviation.
-					rf_api_ctx.rf_api_s2lp_fifo_buffer[(2 * s2lp_fifo_sample_idx) + 1] = 1; // Constant PA output power.
-				}
-			}
-			// Enter stop and wait for S2LP interrupt to transfer next bit buffer.
-			rf_api_ctx.rf_api_s2lp_irq_flag = 0;
-			while (rf_api_ctx.rf_api_s2lp_irq_flag == 0) {
-				PWR_enter_stop_mode();
+			RF_API_refill_fifo(((stream[stream_byte_idx] >> (7 - stream_bit_idx)) & 0b1), &s2lp_fdev);
+			// Measure supply voltage once PA is at full power (FIFO contains one symbol of margin).
+			if ((stream_byte_idx == 0) && (stream_bit_idx == 0)) {
+				TELEMETRY_capture_tx();
 			}
-			S2LP_write_fifo(rf_api_ctx.rf_api_s2lp_fifo_buffer, RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES);
 		}
 	}
 	// Last ramp down.
@@ -245,25 +298,31 @@ sfx_u8 RF_API_send(sfx_u8 *stream, sfx_modulation_type_t type, sfx_u8 size) {
 		rf_api_ctx.rf_api_s2lp_fifo_buffer[(2 * s2lp_fifo_sample_idx) + 1] = rf_api_etsi_ramp_amplitude_profile[s2lp_fifo_sample_idx]; // PA output power for ramp-down.
 	}
 	// Enter stop and wait for S2LP interrupt to transfer ramp-down buffer.
-	PWR_enter_stop_mode();
+	RF_API_wait_for_fifo_irq();
 	S2LP_write_fifo(rf_api_ctx.rf_api_s2lp_fifo_buffer, RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES);
 	// Padding bit to ensure ramp-down is completely transmitted.
 	for (s2lp_fifo_sample_idx=0 ; s2lp_fifo_sample_idx<RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES ; s2lp_fifo_sample_idx++) {
 		rf_api_ctx.rf_api_s2lp_fifo_buffer[s2lp_fifo_sample_idx] = 0;
 	}
 	// Enter stop and wait for S2LP interrupt to transfer padding buffer.
-	PWR_enter_stop_mode();
+	RF_API_wait_for_fifo_irq();
 	S2LP_write_fifo(rf_api_ctx.rf_api_s2lp_fifo_buffer, RF_API_S2LP_FIFO_BUFFER_LENGTH_BYTES);
 	// Enter stop and wait for S2LP interrupt.
-	PWR_enter_stop_mode();
+	RF_API_wait_for_fifo_irq();
 	// Disable external GPIO interrupt.
 	NVIC_disable_interrupt(NVIC_IT_EXTI_4_15);
+	PROBE_low(PROBE_UPLINK_REFILL_TP); // Last interrupt is not followed by any refill.
+	// Stop supply monitoring.
+	TELEMETRY_stop_tx_capture();
 	// Stop radio.
 	S2LP_send_command(S2LP_CMD_SABORT);
 	S2LP_wait_for_state(S2LP_STATE_READY);
 	S2LP_send_command(S2LP_CMD_STANDBY);
 	S2LP_wait_for_state(S2LP_STATE_STANDBY);
+	// Release samples buffer.
+	ARENA_exit(ARENA_PHASE_UPLINK);
 	// Return.
+	TRACE_exit(TRACE_EVENT_RF_API_SEND, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -278,6 +337,7 @@ sfx_u8 RF_API_send(sfx_u8 *stream, sfx_modulation_type_t type, sfx_u8 size) {
  * \retval RF_ERR_API_START_CONTINUOUS_TRANSMISSION:     Continuous Transmission Start error
  *******************************************************************/
 sfx_u8 RF_API_start_continuous_transmission (sfx_modulation_type_t type) {
+	TRACE_enter(TRACE_EVENT_RF_API_START_CONTINUOUS_TRANSMISSION, type);
 	// Disable modulation.
 	S2LP_set_modulation(S2LP_MODULATION_NONE);
 	S2LP_set_rf_output_power(rf_api_cw_output_power);
@@ -286,6 +346,7 @@ sfx_u8 RF_API_start_continuous_transmission (sfx_modulation_type_t type) {
 	S2LP_wait_for_state(S2LP_STATE_READY);
 	S2LP_send_command(S2LP_CMD_TX);
 	// Return.
+	TRACE_exit(TRACE_EVENT_RF_API_START_CONTINUOUS_TRANSMISSION, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -297,10 +358,12 @@ sfx_u8 RF_API_start_continuous_transmission (sfx_modulation_type_t type) {
  * \retval RF_ERR_API_STOP_CONTINUOUS_TRANSMISSION:      Continuous Transmission Stop error
  *******************************************************************/
 sfx_u8 RF_API_stop_continuous_transmission (void) {
+	TRACE_enter(TRACE_EVENT_RF_API_STOP_CONTINUOUS_TRANSMISSION, 0);
 	// Stop radio.
 	S2LP_send_command(S2LP_CMD_SABORT);
 	S2LP_wait_for_state(S2LP_STATE_READY);
 	// Return.
+	TRACE_exit(TRACE_EVENT_RF_API_STOP_CONTINUOUS_TRANSMISSION, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -315,8 +378,10 @@ sfx_u8 RF_API_stop_continuous_transmission (void) {
  * \retval RF_ERR_API_CHANGE_FREQ:          Change frequency error
  *******************************************************************/
 sfx_u8 RF_API_change_frequency(sfx_u32 frequency) {
+	TRACE_enter(TRACE_EVENT_RF_API_CHANGE_FREQUENCY, (frequency / 100));
 	// Set frequency.
 	S2LP_set_rf_frequency(frequency);
+	TRACE_exit(TRACE_EVENT_RF_API_CHANGE_FREQUENCY, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -349,6 +414,7 @@ sfx_u8 RF_API_wait_frame(sfx_u8 *frame, sfx_s16 *rssi, sfx_rx_state_enum_t * sta
 	// Init state.
 	(*state) = DL_TIMEOUT;
 	sfx_error_t sfx_err = RF_ERR_API_WAIT_FRAME;
+	TRACE_enter(TRACE_EVENT_RF_API_WAIT_FRAME, 0);
 	// Go to ready state.
 	S2LP_send_command(S2LP_CMD_READY);
 	S2LP_wait_for_state(S2LP_STATE_READY);
@@ -360,25 +426,11 @@ sfx_u8 RF_API_wait_frame(sfx_u8 *frame, sfx_s16 *rssi, sfx_rx_state_enum_t * sta
 	// Enable external GPIO.
 	EXTI_clear_all_flags();
 	NVIC_enable_interrupt(NVIC_IT_EXTI_4_15);
-	// Clear watchdog.
-	IWDG_reload();
-	// Enter stop mode until GPIO interrupt or RTC wake-up.
-	unsigned int remaining_delay = RF_API_DOWNLINK_TIMEOUT_SECONDS;
-	unsigned int sub_delay = 0;
-	while ((remaining_delay > 0) && (rf_api_ctx.rf_api_s2lp_irq_flag == 0)) {
-		// Compute sub-delay.
-		sub_delay = (remaining_delay > IWDG_REFRESH_PERIOD_SECONDS) ? (IWDG_REFRESH_PERIOD_SECONDS) : (remaining_delay);
-		remaining_delay -= sub_delay;
-		// Start wake-up timer.
-		RTC_start_wakeup_timer(sub_delay);
-		PWR_enter_stop_mode();
-		// Wake-up: clear watchdog and flags.
-		IWDG_reload();
-		RTC_clear_wakeup_timer_flag();
-		EXTI_clear_all_flags();
-	}
+	// Enter stop mode until GPIO interrupt or timeout.
+	TIMER_start(&rf_api_ctx.downlink_timer, (RF_API_DOWNLINK_TIMEOUT_SECONDS * 1000), 0, 0);
+	TIMER_wait(&rf_api_ctx.downlink_timer, &rf_api_ctx.rf_api_s2lp_irq_flag);
 	// Wake-up: disable interrupts.
-	RTC_stop_wakeup_timer();
+	TIMER_stop(&rf_api_ctx.downlink_timer);
 	NVIC_disable_interrupt(NVIC_IT_EXTI_4_15);
 	// Check flag.
 	if (rf_api_ctx.rf_api_s2lp_irq_flag != 0) {
@@ -394,6 +446,7 @@ sfx_u8 RF_API_wait_frame(sfx_u8 *frame, sfx_s16 *rssi, sfx_rx_state_enum_t * sta
 	S2LP_send_command(S2LP_CMD_STANDBY);
 	S2LP_wait_for_state(S2LP_STATE_STANDBY);
 	// Return.
+	TRACE_exit(TRACE_EVENT_RF_API_WAIT_FRAME, sfx_err);
 	return sfx_err;
 }
 
@@ -418,6 +471,8 @@ sfx_u8 RF_API_wait_frame(sfx_u8 *frame, sfx_s16 *rssi, sfx_rx_state_enum_t * sta
  * \retval SFX_ERR_NONE:                      No error
  *******************************************************************/
 sfx_u8 RF_API_wait_for_clear_channel(sfx_u8 cs_min, sfx_s8 cs_threshold, sfx_rx_state_enum_t * state) {
+	TRACE_enter(TRACE_EVENT_RF_API_WAIT_FOR_CLEAR_CHANNEL, cs_min);
+	TRACE_exit(TRACE_EVENT_RF_API_WAIT_FOR_CLEAR_CHANNEL, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -432,6 +487,8 @@ sfx_u8 RF_API_wait_for_clear_channel(sfx_u8 cs_min, sfx_s8 cs_threshold, sfx_rx_
  * \retval RF_ERR_API_GET_VERSION:      Get Version error
  *******************************************************************/
 sfx_u8 RF_API_get_version(sfx_u8 **version, sfx_u8 *size) {
+	TRACE_enter(TRACE_EVENT_RF_API_GET_VERSION, 0);
+	TRACE_exit(TRACE_EVENT_RF_API_GET_VERSION, SFX_ERR_NONE);
 	return SFX_ERR_NONE;
 }
 
@@ -444,7 +501,7 @@ sfx_u8 RF_API_get_version(sfx_u8 **version, sfx_u8 *size) {
  *
  * \retval none
  *******************************************************************/
-void RF_API_SetIrqFlag(void) {
+void __attribute__((section(".ramfunc"))) RF_API_SetIrqFlag(void) {
 	rf_api_ctx.rf_api_s2lp_irq_flag = 1;
 }
 
@@ -0,0 +1,98 @@
+/*
+ * arena.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "arena.h"
+
+/*** ARENA local macros ***/
+
+#if ((ARENA_SIZE_BYTES % 4) != 0)
+#error "ARENA_SIZE_BYTES must be a multiple of 4."
+#endif
+
+/*** ARENA local structures ***/
+
+typedef struct {
+	unsigned int buffer[ARENA_SIZE_BYTES / 4];
+	unsigned int top; // Offset of first free byte.
+	unsigned int phase_mark[ARENA_PHASE_LAST]; // Block offset plus one, 0 when the phase is not active.
+	unsigned int high_water;
+	unsigned int error_count;
+} ARENA_context_t;
+
+/*** ARENA local global variables ***/
+
+static ARENA_context_t arena_ctx;
+
+/*** ARENA local functions ***/
+
+/* RELEASE ALL BLOCKS LOCATED ABOVE AN OFFSET.
+ * @param offset:	New top of arena.
+ * @return:			None.
+ */
+static void ARENA_release(unsigned int offset) {
+	// Local variables.
+	unsigned char idx = 0;
+	for (idx=0 ; idx<ARENA_PHASE_LAST ; idx++) {
+		if (arena_ctx.phase_mark[idx] > offset) {
+			arena_ctx.phase_mark[idx] = 0;
+		}
+	}
+	arena_ctx.top = offset;
+}
+
+/*** ARENA functions ***/
+
+/* ENTER A PHASE AND ALLOCATE ITS BLOCK (AN ACTIVE PHASE IS RESTARTED).
+ * @param phase:		Phase to enter.
+ * @param size_bytes:	Block size.
+ * @return block:		Pointer to the block, 0 if the phase is invalid or if the block does not fit.
+ */
+void* ARENA_enter(ARENA_phase_t phase, unsigned int size_bytes) {
+	// Local variables.
+	void* block = 0;
+	// Check parameter.
+	if (phase >= ARENA_PHASE_LAST) goto errors;
+	// Restart phase if needed.
+	if (arena_ctx.phase_mark[phase] != 0) {
+		ARENA_release(arena_ctx.phase_mark[phase] - 1);
+	}
+	// Check remaining space.
+	if (ARENA_ALIGN(size_bytes) > (ARENA_SIZE_BYTES - arena_ctx.top)) {
+		arena_ctx.error_count++;
+		goto errors;
+	}
+	// Allocate block.
+	block = (void*) (((unsigned char*) arena_ctx.buffer) + arena_ctx.top);
+	arena_ctx.phase_mark[phase] = (arena_ctx.top + 1);
+	arena_ctx.top += ARENA_ALIGN(size_bytes);
+	if (arena_ctx.top > arena_ctx.high_water) {
+		arena_ctx.high_water = arena_ctx.top;
+	}
+errors:
+	return block;
+}
+
+/* LEAVE A PHASE (ITS BLOCK AND THE BLOCKS OF THE PHASES ENTERED AFTER IT ARE RELEASED).
+ * @param phase:	Phase to leave.
+ * @return:			None.
+ */
+void ARENA_exit(ARENA_phase_t phase) {
+	// Check parameter and state.
+	if ((phase >= ARENA_PHASE_LAST) || (arena_ctx.phase_mark[phase] == 0)) return;
+	ARENA_release(arena_ctx.phase_mark[phase] - 1);
+}
+
+/* GET ARENA USAGE.
+ * @param statistics:	Pointer to the structure that will contain the usage.
+ * @return:				None.
+ */
+void ARENA_get_statistics(ARENA_statistics_t* statistics) {
+	statistics -> size_bytes = ARENA_SIZE_BYTES;
+	statistics -> used_bytes = arena_ctx.top;
+	statistics -> high_water_bytes = arena_ctx.high_water;
+	statistics -> error_count = arena_ctx.error_count;
+}
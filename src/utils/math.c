@@ -9,7 +9,6 @@
 
 /*** MATH local macros ***/
 
-#define MATH_MEDIAN_FILTER_LENGTH_MAX	0xFF
 #define MATH_DECIMAL_MAX_DIGITS			10
 
 /*** MATH functions ***/
@@ -35,46 +34,74 @@ unsigned int MATH_pow_10(unsigned char power) {
 unsigned int MATH_average(unsigned int* data, unsigned char data_length) {
 	// Local variables.
 	unsigned char idx = 0;
-	unsigned int average = 0;
-	// Compute
+	unsigned long long sum = 0;
+	// Check parameter.
+	if (data_length == 0) return 0;
+	// Accumulate without division.
 	for (idx=0 ; idx<data_length ; idx++) {
-		average = ((average * idx) + data[idx]) / (idx + 1);
+		sum += data[idx];
+	}
+	return (unsigned int) (sum / data_length);
+}
+
+/* PARTITION BUFFER SO THAT THE ELEMENT OF RANK K IS AT INDEX K (QUICKSELECT, O(N) IN AVERAGE).
+ * @param data:		Buffer to partition (modified in place).
+ * @param left:		Index of first element of the search range.
+ * @param right:	Index of last element of the search range.
+ * @param k:		Rank to select.
+ * @return:			None.
+ */
+static void MATH_select(unsigned int* data, unsigned char left, unsigned char right, unsigned char k) {
+	// Local variables.
+	unsigned int pivot = 0;
+	unsigned int temp = 0;
+	unsigned char i = 0;
+	unsigned char j = 0;
+	// Iterative Hoare partition (no recursion to keep stack footprint bounded).
+	while (left < right) {
+		pivot = data[k];
+		i = left;
+		j = right;
+		do {
+			while (data[i] < pivot) i++;
+			while (pivot < data[j]) j--;
+			if (i <= j) {
+				temp = data[i];
+				data[i] = data[j];
+				data[j] = temp;
+				i++;
+				if (j == 0) break;
+				j--;
+			}
+		}
+		while (i <= j);
+		// Continue in the side containing rank k.
+		if (j < k) left = i;
+		if (k < i) right = j;
 	}
-	return average;
 }
 
 /* COMPUTE AVERAGE MEDIAN VALUE
  * @param data:				Input buffer.
- * @param median_length:	Number of elements taken for median value search.
+ * @param median_length:	Number of elements taken for median value search (clamped to MATH_MEDIAN_FILTER_LENGTH_MAX).
  * @param average_length:	Number of center elements taken for final average.
  * @return filter_out:		Output value of the median filter.
  */
 unsigned int MATH_median_filter(unsigned int* data, unsigned char median_length, unsigned char average_length) {
 	// Local variables.
 	unsigned int local_buf[MATH_MEDIAN_FILTER_LENGTH_MAX];
-	unsigned char buffer_sorted = 0;
-	unsigned char idx1 = 0;
-	unsigned char idx2 = 0;
+	unsigned char idx = 0;
 	unsigned char start_idx = 0;
 	unsigned char end_idx = 0;
 	unsigned int filter_out = 0;
-	unsigned int temp = 0;
-	// Copy input buffer into local buffer.
-	for (idx1=0 ; idx1<median_length ; idx1++) {
-		local_buf[idx1] = data[idx1];
+	// Check parameters.
+	if (median_length == 0) return 0;
+	if (median_length > MATH_MEDIAN_FILTER_LENGTH_MAX) {
+		median_length = MATH_MEDIAN_FILTER_LENGTH_MAX;
 	}
-	// Sort buffer in ascending order.
-	for (idx1=0; idx1<median_length; ++idx1) {
-		buffer_sorted = 1;
-		for (idx2=1 ; idx2<(median_length-idx1) ; ++idx2) {
-			if (local_buf[idx2 - 1] > local_buf[idx2]) {
-				temp = local_buf[idx2 - 1];
-				local_buf[idx2 - 1] = local_buf[idx2];
-				local_buf[idx2] = temp;
-				buffer_sorted = 0;
-			}
-		}
-		if (buffer_sorted != 0) break;
+	// Copy input buffer into local buffer.
+	for (idx=0 ; idx<median_length ; idx++) {
+		local_buf[idx] = data[idx];
 	}
 	// Compute average of center values if required.
 	if (average_length > 0) {
@@ -87,12 +114,73 @@ unsigned int MATH_median_filter(unsigned int* data, unsigned char median_length,
 		if (end_idx >= median_length) {
 			end_idx = (median_length - 1);
 		}
+		// Bring center elements in [start_idx, end_idx] (unordered).
+		MATH_select(local_buf, 0, (median_length - 1), start_idx);
+		MATH_select(local_buf, start_idx, (median_length - 1), end_idx);
 		// Compute average.
-		filter_out = MATH_average(&(data[start_idx]), (end_idx - start_idx + 1));
+		filter_out = MATH_average(&(local_buf[start_idx]), (end_idx - start_idx + 1));
 	}
 	else {
 		// Return median value.
+		MATH_select(local_buf, 0, (median_length - 1), (median_length / 2));
 		filter_out = local_buf[(median_length / 2)];
 	}
 	return filter_out;
 }
+
+/* RESET STATISTICS ACCUMULATOR.
+ * @param statistics:	Accumulator to reset.
+ * @return:				None.
+ */
+void MATH_statistics_reset(MATH_statistics_t* statistics) {
+	statistics -> count = 0;
+	statistics -> sum = 0;
+	statistics -> sum_of_squares = 0;
+	statistics -> min = 0xFFFFFFFF;
+	statistics -> max = 0;
+}
+
+/* ADD A SAMPLE TO STATISTICS ACCUMULATOR (NO DIVISION).
+ * @param statistics:	Accumulator to update.
+ * @param value:		New sample (variance is exact for 16-bits samples).
+ * @return:				None.
+ */
+void MATH_statistics_add(MATH_statistics_t* statistics, unsigned int value) {
+	statistics -> count++;
+	statistics -> sum += value;
+	statistics -> sum_of_squares += ((unsigned long long) value) * value;
+	if (value < (statistics -> min)) statistics -> min = value;
+	if (value > (statistics -> max)) statistics -> max = value;
+}
+
+/* GET MEAN VALUE OF STATISTICS ACCUMULATOR.
+ * @param statistics:	Accumulator.
+ * @return:				Mean of the samples added since last reset.
+ */
+unsigned int MATH_statistics_get_mean(MATH_statistics_t* statistics) {
+	if ((statistics -> count) == 0) return 0;
+	return (unsigned int) ((statistics -> sum) / (statistics -> count));
+}
+
+/* GET VARIANCE OF STATISTICS ACCUMULATOR.
+ * @param statistics:	Accumulator.
+ * @return:				Population variance of the samples added since last reset.
+ */
+unsigned int MATH_statistics_get_variance(MATH_statistics_t* statistics) {
+	// Local variables.
+	unsigned long long count = (statistics -> count);
+	unsigned long long mean = 0;
+	unsigned long long remainder = 0;
+	unsigned long long scaled_variance = 0;
+	unsigned long long variance = 0;
+	// Check count.
+	if (count == 0) return 0;
+	// With sum = (mean * n) + remainder: n.Var(X) = sum(X^2) - (n * mean^2) - (2 * mean * remainder) - (remainder^2 / n).
+	mean = (statistics -> sum) / count;
+	remainder = (statistics -> sum) - (mean * count);
+	scaled_variance = (statistics -> sum_of_squares) - (mean * mean * count) - (2 * mean * remainder);
+	// Truncate (scaled_variance - remainder^2 / n) / n without losing the fractional parts.
+	variance = scaled_variance / count;
+	if (((scaled_variance - (variance * count)) * count) < (remainder * remainder)) variance--;
+	return (unsigned int) variance;
+}
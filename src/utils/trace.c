@@ -0,0 +1,89 @@
+/*
+ * trace.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "trace.h"
+
+#ifdef TRACE
+
+#include "core.h"
+#include "lptim.h"
+
+/*** TRACE local macros ***/
+
+#define TRACE_RING_INDEX_MASK	(TRACE_RING_LENGTH - 1)
+
+#if ((TRACE_RING_LENGTH & TRACE_RING_INDEX_MASK) != 0)
+#error "TRACE_RING_LENGTH must be a power of 2."
+#endif
+
+/*** TRACE local structures ***/
+
+typedef struct {
+	TRACE_record_t ring[TRACE_RING_LENGTH];
+	volatile unsigned int write_count; // Total number of events since last reset.
+	unsigned int read_offset; // Index of the oldest record at last TRACE_get_count() call.
+} TRACE_context_t;
+
+/*** TRACE local global variables ***/
+
+static TRACE_context_t trace_ctx;
+
+/*** TRACE functions ***/
+
+/* RECORD AN EVENT (CALLABLE FROM INTERRUPTS).
+ * @param event:	Event ID (see TRACE_event_t, TRACE_EVENT_EXIT_FLAG may be set).
+ * @param argument:	Event argument (truncated to 24 bits).
+ * @return:			None.
+ */
+void __attribute__((section(".ramfunc"))) TRACE_add(unsigned char event, unsigned int argument) {
+	// Local variables.
+	TRACE_record_t record;
+	unsigned int record_idx = 0;
+	unsigned int primask = 0;
+	// Build event data before entering critical section.
+	record.data = (((unsigned int) event) << 24) | (argument & TRACE_ARGUMENT_MASK);
+	// Timestamp and store record in the same critical section to keep ring chronological.
+	CORE_save_primask(primask);
+	record.timestamp = LPTIM1_get_timestamp_ticks();
+	record_idx = (trace_ctx.write_count & TRACE_RING_INDEX_MASK);
+	trace_ctx.ring[record_idx] = record;
+	trace_ctx.write_count++;
+	CORE_restore_primask(primask);
+}
+
+/* GET NUMBER OF RECORDS AVAILABLE IN RING (SNAPSHOT USED BY FOLLOWING TRACE_get_record CALLS).
+ * @param lost_count:	Pointer to the number of overwritten records.
+ * @return:				Number of available records.
+ */
+unsigned int TRACE_get_count(unsigned int* lost_count) {
+	// Local variables.
+	unsigned int write_count = trace_ctx.write_count;
+	unsigned int count = (write_count > TRACE_RING_LENGTH) ? TRACE_RING_LENGTH : write_count;
+	(*lost_count) = (write_count - count);
+	trace_ctx.read_offset = (*lost_count);
+	return count;
+}
+
+/* READ A RECORD.
+ * @param record_idx:	Record index (0 is the oldest record at last TRACE_get_count call).
+ * @param record:		Pointer to the record.
+ * @return:				None.
+ */
+void TRACE_get_record(unsigned int record_idx, TRACE_record_t* record) {
+	(*record) = trace_ctx.ring[(trace_ctx.read_offset + record_idx) & TRACE_RING_INDEX_MASK];
+}
+
+/* CLEAR ALL RECORDS.
+ * @param:	None.
+ * @return:	None.
+ */
+void TRACE_reset(void) {
+	trace_ctx.write_count = 0;
+	trace_ctx.read_offset = 0;
+}
+
+#endif /* TRACE */
@@ -40,6 +40,7 @@ extern uint32_t __data_end__;
 #endif
 extern uint32_t __bss_start__;
 extern uint32_t __bss_end__;
+extern uint32_t __StackLimit;
 extern uint32_t __StackTop;
 
 /*----------------------------------------------------------------------------
@@ -276,6 +277,24 @@ void Reset_Handler(void) {
   }
 #endif /* __STARTUP_CLEAR_BSS_MULTIPLE || __STARTUP_CLEAR_BSS */
 
+#ifdef __STARTUP_PAINT_STACK
+/*  Stack painting (used by MEM_get_statistics to compute stack high-water).
+ *
+ *  The stack area between __StackLimit and the current stack pointer is
+ *  filled with __STARTUP_STACK_PATTERN. Words located above the current stack
+ *  pointer are used by this function and are therefore not painted.
+ */
+#ifndef __STARTUP_STACK_PATTERN
+  #define __STARTUP_STACK_PATTERN  0xA5A5A5A5
+#endif
+  __asm volatile ("mov %0, sp" : "=r" (pSrc));
+  pDest = &__StackLimit;
+
+  for ( ; pDest < pSrc ; ) {
+    *pDest++ = __STARTUP_STACK_PATTERN;
+  }
+#endif /* __STARTUP_PAINT_STACK */
+
 #ifndef __NO_SYSTEM_INIT
 	SystemInit();
 #endif
@@ -0,0 +1,176 @@
+/*
+ * test_adc.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "adc.h"
+#include "adc_model.h"
+#include "adc_reg.h"
+#include "exti.h"
+#include "lptim.h"
+#include "nvic.h"
+#include "pwr.h"
+#include "rcc.h"
+#include <stdio.h>
+
+/*** TEST ADC local macros ***/
+
+#define TEST_ADC_FULL_SCALE_12BITS		4095
+#define TEST_ADC_OVERSAMPLING_LOG2		4 // Same as driver (16-bits results).
+#define TEST_ADC_FULL_SCALE_OVERSAMPLED	(TEST_ADC_FULL_SCALE_12BITS << TEST_ADC_OVERSAMPLING_LOG2)
+#define TEST_ADC_VPV_DIVIDER_RATIO		10
+#define TEST_ADC_VMCU_MAX_MV			3600 // First point of the driver LUT.
+#define TEST_ADC_VMCU_LUT_SPAN			(32 << 10) // 32 segments of 1024 oversampled LSB.
+// Maximum differences with the division based formulas.
+#define TEST_ADC_VMCU_TOLERANCE_MV		3
+#define TEST_ADC_VRF_TOLERANCE_MV		1
+#define TEST_ADC_TMCU_TOLERANCE_DEGREES	1
+// Supply voltages used for exhaustive VRF and TMCU sweeps.
+#define TEST_ADC_VMCU_POINTS_LENGTH		6
+
+/*** TEST ADC local structures ***/
+
+typedef struct {
+	char* name;
+	int tolerance;
+	int max_error;
+	unsigned int count;
+	unsigned int error_count;
+} TEST_ADC_result_t;
+
+/*** TEST ADC local global variables ***/
+
+static const unsigned int TEST_ADC_VMCU_POINTS_MV[TEST_ADC_VMCU_POINTS_LENGTH] = {1650, 1800, 2400, 3000, 3300, 3600};
+static TEST_ADC_result_t test_adc_vmcu = {"vmcu lut", TEST_ADC_VMCU_TOLERANCE_MV, 0, 0, 0};
+static TEST_ADC_result_t test_adc_vrf = {"vrf reciprocal", TEST_ADC_VRF_TOLERANCE_MV, 0, 0, 0};
+static TEST_ADC_result_t test_adc_tmcu = {"tmcu q18", TEST_ADC_TMCU_TOLERANCE_DEGREES, 0, 0, 0};
+
+/*** TEST ADC local functions ***/
+
+/* PREVIOUS MCU SUPPLY VOLTAGE FORMULA.
+ * @param vrefint:	Oversampled VREFINT result.
+ * @return:			VMCU in mV.
+ */
+static unsigned int TEST_ADC_reference_vmcu(unsigned int vrefint) {
+	return ((VREFINT_VCC_CALIB_MV * VREFINT_CAL) << TEST_ADC_OVERSAMPLING_LOG2) / vrefint;
+}
+
+/* PREVIOUS INPUT VOLTAGE FORMULA.
+ * @param vrf:		Oversampled VRF result.
+ * @param vmcu_mv:	MCU supply voltage in mV.
+ * @return:			VRF in mV.
+ */
+static unsigned int TEST_ADC_reference_vrf(unsigned int vrf, unsigned int vmcu_mv) {
+	return (vrf * vmcu_mv * TEST_ADC_VPV_DIVIDER_RATIO) / (TEST_ADC_FULL_SCALE_OVERSAMPLED);
+}
+
+/* PREVIOUS MCU TEMPERATURE FORMULA.
+ * @param ts:		Oversampled temperature sensor result.
+ * @param vmcu_mv:	MCU supply voltage in mV.
+ * @return:			Temperature in degrees (same 8-bits storage as the driver).
+ */
+static signed char TEST_ADC_reference_tmcu(unsigned int ts, unsigned int vmcu_mv) {
+	int raw_temp_calib_16bits = (int) ((ts * vmcu_mv) / (TS_VCC_CALIB_MV));
+	int temp_calib_degrees = (raw_temp_calib_16bits - (TS_CAL1 << TEST_ADC_OVERSAMPLING_LOG2)) * ((int) (TS_CAL2_TEMP - TS_CAL1_TEMP));
+	temp_calib_degrees = (temp_calib_degrees) / ((int) ((TS_CAL2 - TS_CAL1) << TEST_ADC_OVERSAMPLING_LOG2));
+	return (signed char) (temp_calib_degrees + TS_CAL1_TEMP);
+}
+
+/* UPDATE RESULT WITH A NEW COMPARISON.
+ * @param result:	Result to update.
+ * @param error:	Difference between driver and reference values.
+ * @return:			None.
+ */
+static void TEST_ADC_update(TEST_ADC_result_t* result, int error) {
+	if (error < 0) error = (-error);
+	if (error > (result -> max_error)) result -> max_error = error;
+	if (error > (result -> tolerance)) result -> error_count++;
+	result -> count++;
+}
+
+/* CONVERT ONE SET OF RAW VALUES WITH THE DRIVER AND COMPARE WITH PREVIOUS FORMULAS.
+ * @param vrefint_raw:	12-bits VREFINT result.
+ * @param vrf_raw:		12-bits VRF result.
+ * @param ts_raw:		12-bits temperature sensor result.
+ * @return:				None.
+ */
+static void TEST_ADC_compare(int vrefint_raw, int vrf_raw, int ts_raw) {
+	// Local variables.
+	unsigned int vmcu_mv = 0;
+	unsigned int vrf_mv = 0;
+	unsigned int vrefint_min = 0;
+	unsigned int vrefint = 0;
+	signed char tmcu_degrees = 0;
+	ADC_MODEL_set_raw_value(ADC_MODEL_INPUT_VREFINT, vrefint_raw);
+	ADC_MODEL_set_raw_value(ADC_MODEL_INPUT_VRF, vrf_raw);
+	ADC_MODEL_set_raw_value(ADC_MODEL_INPUT_TMCU, ts_raw);
+	ADC1_perform_measurements();
+	ADC1_get_data(ADC_DATA_IDX_VMCU_MV, &vmcu_mv);
+	ADC1_get_data(ADC_DATA_IDX_VPV_MV, &vrf_mv);
+	ADC1_get_tmcu_comp2(&tmcu_degrees);
+	// VREFINT is clamped to the LUT range (previous formula kept the last value when VREFINT was 0).
+	if (vrefint_raw != 0) {
+		vrefint_min = ((VREFINT_VCC_CALIB_MV * VREFINT_CAL) << TEST_ADC_OVERSAMPLING_LOG2) / TEST_ADC_VMCU_MAX_MV;
+		vrefint = ((unsigned int) vrefint_raw) << TEST_ADC_OVERSAMPLING_LOG2;
+		if (vrefint < vrefint_min) vrefint = vrefint_min;
+		if (vrefint > (vrefint_min + TEST_ADC_VMCU_LUT_SPAN)) vrefint = (vrefint_min + TEST_ADC_VMCU_LUT_SPAN);
+		TEST_ADC_update(&test_adc_vmcu, ((int) vmcu_mv) - ((int) TEST_ADC_reference_vmcu(vrefint)));
+	}
+	// Other formulas are checked with the supply voltage computed by the driver.
+	TEST_ADC_update(&test_adc_vrf, ((int) vrf_mv) - ((int) TEST_ADC_reference_vrf((((unsigned int) vrf_raw) << TEST_ADC_OVERSAMPLING_LOG2), vmcu_mv)));
+	TEST_ADC_update(&test_adc_tmcu, (signed char) (tmcu_degrees - TEST_ADC_reference_tmcu((((unsigned int) ts_raw) << TEST_ADC_OVERSAMPLING_LOG2), vmcu_mv)));
+}
+
+/* PRINT RESULT.
+ * @param result:	Result to print.
+ * @return:			1 if all comparisons are within tolerance, 0 otherwise.
+ */
+static unsigned char TEST_ADC_print(TEST_ADC_result_t* result) {
+	// Local variables.
+	unsigned char status = (((result -> error_count) == 0) && ((result -> count) != 0)) ? 1 : 0;
+	printf("%s adc %s (%u values, max error %d, tolerance %d, %u out of tolerance)\n", (status != 0) ? "PASS" : "FAIL", (result -> name), (result -> count), (result -> max_error), (result -> tolerance), (result -> error_count));
+	return status;
+}
+
+/*** TEST ADC functions ***/
+
+/* MAIN FUNCTION.
+ * @param:	None.
+ * @return:	0 if all tests passed, 1 otherwise.
+ */
+int main(void) {
+	// Local variables.
+	int raw = 0;
+	int vrefint_raw = 0;
+	unsigned char point_idx = 0;
+	unsigned int failure_count = 0;
+	// Init clocks and ADC.
+	NVIC_init();
+	PWR_init();
+	RCC_init();
+	EXTI_init();
+	RCC_enable_lse();
+	LPTIM1_init();
+	ADC1_init();
+	// All VREFINT codes (other inputs follow a permutation of the 12-bits range).
+	for (raw=0 ; raw<=TEST_ADC_FULL_SCALE_12BITS ; raw++) {
+		TEST_ADC_compare(raw, ((raw * 1031) & TEST_ADC_FULL_SCALE_12BITS), ((raw * 2053) & TEST_ADC_FULL_SCALE_12BITS));
+	}
+	// All VRF and temperature sensor codes at several supply voltages.
+	for (point_idx=0 ; point_idx<TEST_ADC_VMCU_POINTS_LENGTH ; point_idx++) {
+		vrefint_raw = (VREFINT_VCC_CALIB_MV * VREFINT_CAL) / TEST_ADC_VMCU_POINTS_MV[point_idx];
+		for (raw=0 ; raw<=TEST_ADC_FULL_SCALE_12BITS ; raw++) {
+			TEST_ADC_compare(vrefint_raw, raw, raw);
+		}
+	}
+	if (TEST_ADC_print(&test_adc_vmcu) == 0) failure_count++;
+	if (TEST_ADC_print(&test_adc_vrf) == 0) failure_count++;
+	if (TEST_ADC_print(&test_adc_tmcu) == 0) failure_count++;
+	return ((failure_count == 0) ? 0 : 1);
+}
+
+#endif /* HOST */
@@ -0,0 +1,168 @@
+/*
+ * test_aes.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "aes.h"
+#include "aes_sw.h"
+#include "exti.h"
+#include "lptim.h"
+#include "mcu_api.h"
+#include "nvic.h"
+#include "nvm.h"
+#include "pwr.h"
+#include "rcc.h"
+#include "sigfox_api.h"
+#include <stdio.h>
+
+/*** TEST AES local macros ***/
+
+#define TEST_AES_CBC_NUMBER_OF_BLOCKS	4
+
+/*** TEST AES local global variables ***/
+
+// FIPS-197 appendix C.1 (AES-128 cipher example).
+static const unsigned char TEST_AES_FIPS197_KEY[AES_BLOCK_SIZE] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+static const unsigned char TEST_AES_FIPS197_PLAINTEXT[AES_BLOCK_SIZE] = {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+static const unsigned char TEST_AES_FIPS197_CIPHERTEXT[AES_BLOCK_SIZE] = {0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30, 0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A};
+// SP 800-38A appendix F.2.1 (CBC-AES128.Encrypt).
+static const unsigned char TEST_AES_SP800_38A_KEY[AES_BLOCK_SIZE] = {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+static const unsigned char TEST_AES_SP800_38A_IV[AES_BLOCK_SIZE] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+static const unsigned char TEST_AES_SP800_38A_PLAINTEXT[TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE] = {
+	0x6B, 0xC1, 0xBE, 0xE2, 0x2E, 0x40, 0x9F, 0x96, 0xE9, 0x3D, 0x7E, 0x11, 0x73, 0x93, 0x17, 0x2A,
+	0xAE, 0x2D, 0x8A, 0x57, 0x1E, 0x03, 0xAC, 0x9C, 0x9E, 0xB7, 0x6F, 0xAC, 0x45, 0xAF, 0x8E, 0x51,
+	0x30, 0xC8, 0x1C, 0x46, 0xA3, 0x5C, 0xE4, 0x11, 0xE5, 0xFB, 0xC1, 0x19, 0x1A, 0x0A, 0x52, 0xEF,
+	0xF6, 0x9F, 0x24, 0x45, 0xDF, 0x4F, 0x9B, 0x17, 0xAD, 0x2B, 0x41, 0x7B, 0xE6, 0x6C, 0x37, 0x10
+};
+static const unsigned char TEST_AES_SP800_38A_CIPHERTEXT[TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE] = {
+	0x76, 0x49, 0xAB, 0xAC, 0x81, 0x19, 0xB2, 0x46, 0xCE, 0xE9, 0x8E, 0x9B, 0x12, 0xE9, 0x19, 0x7D,
+	0x50, 0x86, 0xCB, 0x9B, 0x50, 0x72, 0x19, 0xEE, 0x95, 0xDB, 0x11, 0x3A, 0x91, 0x76, 0x78, 0xB2,
+	0x73, 0xBE, 0xD6, 0xB8, 0xE3, 0xC1, 0x74, 0x3B, 0x71, 0x16, 0xE6, 0x9E, 0x22, 0x22, 0x95, 0x16,
+	0x3F, 0xF1, 0xCA, 0xA1, 0x68, 0x1F, 0xAC, 0x09, 0x12, 0x0E, 0xCA, 0x30, 0x75, 0x86, 0xE1, 0xA7
+};
+
+/*** TEST AES local functions ***/
+
+/* COMPARE TWO BUFFERS.
+ * @param name:		Test name.
+ * @param result:	Computed data.
+ * @param expected:	Expected data.
+ * @param length:	Number of bytes to compare.
+ * @return:			1 if buffers are equal, 0 otherwise.
+ */
+static unsigned char TEST_AES_check(char* name, const unsigned char* result, const unsigned char* expected, unsigned char length) {
+	// Local variables.
+	unsigned char idx = 0;
+	unsigned char status = 1;
+	for (idx=0 ; idx<length ; idx++) {
+		if (result[idx] != expected[idx]) {
+			status = 0;
+			break;
+		}
+	}
+	printf("%s %s\n", (status != 0) ? "PASS" : "FAIL", name);
+	return status;
+}
+
+/* TEST SOFTWARE IMPLEMENTATION AGAINST REFERENCE VECTORS.
+ * @param:	None.
+ * @return:	Number of failed tests.
+ */
+static unsigned int TEST_AES_software(void) {
+	// Local variables.
+	unsigned char key[AES_BLOCK_SIZE];
+	unsigned char init_vector[AES_BLOCK_SIZE];
+	unsigned char data_in[AES_BLOCK_SIZE];
+	unsigned char data_out[TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE];
+	unsigned char block_idx = 0;
+	unsigned char idx = 0;
+	unsigned int failure_count = 0;
+	// Single block with null initialization vector (AES cipher).
+	for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) {
+		key[idx] = TEST_AES_FIPS197_KEY[idx];
+		data_in[idx] = TEST_AES_FIPS197_PLAINTEXT[idx];
+		init_vector[idx] = 0;
+	}
+	AES_SW_encrypt(data_in, data_out, init_vector, key);
+	if (TEST_AES_check("aes_sw fips197 c.1", data_out, TEST_AES_FIPS197_CIPHERTEXT, AES_BLOCK_SIZE) == 0) failure_count++;
+	// CBC chaining with cached key schedule.
+	for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) {
+		key[idx] = TEST_AES_SP800_38A_KEY[idx];
+		init_vector[idx] = TEST_AES_SP800_38A_IV[idx];
+	}
+	AES_SW_set_key(key);
+	for (block_idx=0 ; block_idx<TEST_AES_CBC_NUMBER_OF_BLOCKS ; block_idx++) {
+		for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) data_in[idx] = TEST_AES_SP800_38A_PLAINTEXT[(block_idx * AES_BLOCK_SIZE) + idx];
+		AES_SW_encrypt_block(data_in, &(data_out[block_idx * AES_BLOCK_SIZE]), init_vector);
+		for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) init_vector[idx] = data_out[(block_idx * AES_BLOCK_SIZE) + idx];
+	}
+	AES_SW_clear_key();
+	if (TEST_AES_check("aes_sw sp800-38a f.2.1", data_out, TEST_AES_SP800_38A_CIPHERTEXT, (TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE)) == 0) failure_count++;
+	return failure_count;
+}
+
+/* TEST SIGFOX AES CALLBACK (PATH SELECTED IN MCU_API) AGAINST REFERENCE VECTORS.
+ * @param:	None.
+ * @return:	Number of failed tests.
+ */
+static unsigned int TEST_AES_mcu_api(void) {
+	// Local variables.
+	sfx_u8* session_buffer = 0;
+	sfx_u8 key[AES_BLOCK_SIZE];
+	sfx_u8 data_in[TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE];
+	sfx_u8 data_out[TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE];
+	unsigned char idx = 0;
+	unsigned int failure_count = 0;
+	// Callback always starts from a null initialization vector: SP 800-38A vector is used by adding its IV to the first block.
+	for (idx=0 ; idx<(TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE) ; idx++) {
+		data_in[idx] = TEST_AES_SP800_38A_PLAINTEXT[idx];
+		if (idx < AES_BLOCK_SIZE) data_in[idx] ^= TEST_AES_SP800_38A_IV[idx];
+	}
+	for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) key[idx] = TEST_AES_SP800_38A_KEY[idx];
+	// Store vector key as device key.
+	NVM_enable();
+	for (idx=0 ; idx<AES_BLOCK_SIZE ; idx++) NVM_write_byte((NVM_ADDRESS_SIGFOX_DEVICE_KEY + idx), TEST_AES_SP800_38A_KEY[idx]);
+	NVM_disable();
+	MCU_API_malloc(0, &session_buffer);
+	// Key in argument (more blocks than a single hardware pass).
+	MCU_API_aes_128_cbc_encrypt(data_out, data_in, (TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE), key, CREDENTIALS_KEY_IN_ARGUMENT);
+	if (TEST_AES_check("mcu_api key in argument", data_out, TEST_AES_SP800_38A_CIPHERTEXT, (TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE)) == 0) failure_count++;
+	// MAC is the last cipher block computed with the device key (key is reloaded from NVM).
+	for (idx=0 ; idx<(TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE) ; idx++) data_out[idx] = 0;
+	MCU_API_aes_128_cbc_encrypt(data_out, data_in, (TEST_AES_CBC_NUMBER_OF_BLOCKS * AES_BLOCK_SIZE), 0, CREDENTIALS_PRIVATE_KEY);
+	if (TEST_AES_check("mcu_api private key mac", &(data_out[(TEST_AES_CBC_NUMBER_OF_BLOCKS - 1) * AES_BLOCK_SIZE]), &(TEST_AES_SP800_38A_CIPHERTEXT[(TEST_AES_CBC_NUMBER_OF_BLOCKS - 1) * AES_BLOCK_SIZE]), AES_BLOCK_SIZE) == 0) failure_count++;
+	// Cached key is used for the next calls of the session.
+	MCU_API_aes_128_cbc_encrypt(data_out, data_in, AES_BLOCK_SIZE, 0, CREDENTIALS_PRIVATE_KEY);
+	if (TEST_AES_check("mcu_api cached private key", data_out, TEST_AES_SP800_38A_CIPHERTEXT, AES_BLOCK_SIZE) == 0) failure_count++;
+	MCU_API_free(session_buffer);
+	return failure_count;
+}
+
+/*** TEST AES functions ***/
+
+/* MAIN FUNCTION.
+ * @param:	None.
+ * @return:	0 if all tests passed, 1 otherwise.
+ */
+int main(void) {
+	// Local variables.
+	unsigned int failure_count = 0;
+	// Init clocks, monotonic clock and NVM.
+	NVIC_init();
+	PWR_init();
+	RCC_init();
+	EXTI_init();
+	RCC_enable_lse();
+	NVM_init();
+	LPTIM1_init();
+	// Run tests.
+	failure_count += TEST_AES_software();
+	failure_count += TEST_AES_mcu_api();
+	return ((failure_count == 0) ? 0 : 1);
+}
+
+#endif /* HOST */
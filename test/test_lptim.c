@@ -0,0 +1,121 @@
+/*
+ * test_lptim.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "core.h"
+#include "exti.h"
+#include "host.h"
+#include "lptim.h"
+#include "nvic.h"
+#include "pwr.h"
+#include "rcc.h"
+#include <stdio.h>
+
+/*** TEST LPTIM local macros ***/
+
+#define TEST_LPTIM_PERIOD_TICKS		0x10000
+#define TEST_LPTIM_WINDOW_TICKS		400 // Checked range on each side of the counter roll over (~100ms).
+#define TEST_LPTIM_TOLERANCE_TICKS	2 // Maximum deviation from virtual time (register access latency).
+#define TEST_LPTIM_NUMBER_OF_WRAPS	3
+
+/*** TEST LPTIM local structures ***/
+
+typedef struct {
+	long long offset_ticks; // Virtual time minus timestamp at first sample.
+	unsigned int last_ticks;
+	unsigned int max_cnt_samples; // Number of samples taken while CNT=ARR.
+	unsigned int error_count;
+} TEST_LPTIM_context_t;
+
+/*** TEST LPTIM local global variables ***/
+
+static TEST_LPTIM_context_t test_lptim_ctx;
+
+/*** TEST LPTIM local functions ***/
+
+/* GET VIRTUAL TIME IN LPTIM TICKS.
+ * @param:	None.
+ * @return:	Number of ticks since host start.
+ */
+static long long TEST_LPTIM_get_virtual_ticks(void) {
+	return (long long) ((HOST_get_time_ns() * LPTIM_TICK_FREQUENCY_HZ) / 1000000000ULL);
+}
+
+/* SAMPLE TIMESTAMP AND CHECK IT AGAINST PREVIOUS SAMPLE AND VIRTUAL TIME.
+ * @param:	None.
+ * @return:	None.
+ */
+static void TEST_LPTIM_check_sample(void) {
+	// Local variables.
+	unsigned int ticks = LPTIM1_get_timestamp_ticks();
+	long long deviation = (TEST_LPTIM_get_virtual_ticks() - test_lptim_ctx.offset_ticks) - ((long long) ticks);
+	if ((ticks & 0xFFFF) == 0xFFFF) {
+		test_lptim_ctx.max_cnt_samples++;
+	}
+	if ((ticks < test_lptim_ctx.last_ticks) || (deviation > TEST_LPTIM_TOLERANCE_TICKS) || (deviation < -TEST_LPTIM_TOLERANCE_TICKS)) {
+		if (test_lptim_ctx.error_count == 0) {
+			printf("  timestamp %u after %u (deviation %lld ticks)\n", ticks, test_lptim_ctx.last_ticks, deviation);
+		}
+		test_lptim_ctx.error_count++;
+	}
+	test_lptim_ctx.last_ticks = ticks;
+}
+
+/* POLL TIMESTAMP ACROSS THE NEXT COUNTER ROLL OVER.
+ * @param masked:	Keep interrupts masked during the window if non zero (overflow is not serviced).
+ * @return:			1 if the test passed, 0 otherwise.
+ */
+static unsigned char TEST_LPTIM_wrap_window(unsigned char masked) {
+	// Local variables.
+	unsigned int ticks = LPTIM1_get_timestamp_ticks();
+	unsigned int wrap_ticks = ((ticks / TEST_LPTIM_PERIOD_TICKS) + 1) * TEST_LPTIM_PERIOD_TICKS;
+	unsigned int delay_ms = (((wrap_ticks - TEST_LPTIM_WINDOW_TICKS - ticks) * 1000) / LPTIM_TICK_FREQUENCY_HZ);
+	// Sleep until the window.
+	LPTIM1_delay_milliseconds(delay_ms, 0);
+	test_lptim_ctx.max_cnt_samples = 0;
+	test_lptim_ctx.error_count = 0;
+	test_lptim_ctx.last_ticks = LPTIM1_get_timestamp_ticks();
+	if (masked != 0) CORE_disable_interrupts();
+	while (test_lptim_ctx.last_ticks < (wrap_ticks + TEST_LPTIM_WINDOW_TICKS)) {
+		TEST_LPTIM_check_sample();
+	}
+	if (masked != 0) CORE_enable_interrupts();
+	// Overflow must be serviced without any jump once interrupts are enabled again.
+	TEST_LPTIM_check_sample();
+	return (((test_lptim_ctx.error_count == 0) && (test_lptim_ctx.max_cnt_samples != 0)) ? 1 : 0);
+}
+
+/*** TEST LPTIM functions ***/
+
+/* MAIN FUNCTION.
+ * @param:	None.
+ * @return:	0 if all tests passed, 1 otherwise.
+ */
+int main(void) {
+	// Local variables.
+	unsigned char idx = 0;
+	unsigned char result = 0;
+	unsigned int failure_count = 0;
+	// Init clocks and monotonic clock.
+	NVIC_init();
+	PWR_init();
+	RCC_init();
+	EXTI_init();
+	RCC_enable_lse();
+	LPTIM1_init();
+	test_lptim_ctx.offset_ticks = TEST_LPTIM_get_virtual_ticks() - ((long long) LPTIM1_get_timestamp_ticks());
+	// Counter roll over with overflow interrupt serviced, then pending.
+	for (idx=0 ; idx<TEST_LPTIM_NUMBER_OF_WRAPS ; idx++) {
+		result = TEST_LPTIM_wrap_window(idx & 0b1);
+		printf("%s lptim wrap %u (%s, %u samples at CNT=ARR)\n", (result != 0) ? "PASS" : "FAIL", idx, ((idx & 0b1) != 0) ? "interrupts masked" : "interrupts enabled", test_lptim_ctx.max_cnt_samples);
+		if (result == 0) failure_count++;
+	}
+	return ((failure_count == 0) ? 0 : 1);
+}
+
+#endif /* HOST */
@@ -0,0 +1,254 @@
+/*
+ * test_math.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifdef HOST
+
+#include "math.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** TEST MATH local macros ***/
+
+#define TEST_MATH_AVERAGE_LENGTH_MAX	255 // Length is given on 8 bits.
+#define TEST_MATH_RANDOM_WINDOWS		20000
+#define TEST_MATH_STATISTICS_COUNT_MAX	100000
+#define TEST_MATH_SAMPLE_MAX_16BITS		0xFFFF
+
+/*** TEST MATH local structures ***/
+
+typedef struct {
+	unsigned int random_state;
+	unsigned int failure_count;
+} TEST_MATH_context_t;
+
+/*** TEST MATH local global variables ***/
+
+static TEST_MATH_context_t test_math_ctx = {0x12345678, 0};
+
+/*** TEST MATH local functions ***/
+
+/* GET A PSEUDO RANDOM NUMBER (REPRODUCIBLE SEQUENCE).
+ * @param:	None.
+ * @return:	32-bits random value.
+ */
+static unsigned int TEST_MATH_random(void) {
+	// Xorshift generator.
+	test_math_ctx.random_state ^= (test_math_ctx.random_state << 13);
+	test_math_ctx.random_state ^= (test_math_ctx.random_state >> 17);
+	test_math_ctx.random_state ^= (test_math_ctx.random_state << 5);
+	return test_math_ctx.random_state;
+}
+
+/* COMPARISON FUNCTION FOR QSORT.
+ * @param a:	First element.
+ * @param b:	Second element.
+ * @return:		Sign of (a - b).
+ */
+static int TEST_MATH_compare(const void* a, const void* b) {
+	unsigned int value_a = *((const unsigned int*) a);
+	unsigned int value_b = *((const unsigned int*) b);
+	return (value_a > value_b) - (value_a < value_b);
+}
+
+/* CHECK A RESULT.
+ * @param name:		Test name.
+ * @param result:	Computed value.
+ * @param expected:	Expected value.
+ * @return:			1 if values are equal, 0 otherwise.
+ */
+static unsigned char TEST_MATH_check(char* name, unsigned long long result, unsigned long long expected) {
+	if (result == expected) return 1;
+	printf("  %s: %llu instead of %llu\n", name, result, expected);
+	test_math_ctx.failure_count++;
+	return 0;
+}
+
+/* REFERENCE MEDIAN FILTER (FULL SORT).
+ * @param data:				Input buffer.
+ * @param median_length:	Number of elements.
+ * @param average_length:	Number of center elements taken for final average.
+ * @return:					Expected filter output.
+ */
+static unsigned int TEST_MATH_reference_median_filter(unsigned int* data, unsigned char median_length, unsigned char average_length) {
+	// Local variables.
+	unsigned int sorted[MATH_MEDIAN_FILTER_LENGTH_MAX];
+	unsigned long long sum = 0;
+	unsigned char start_idx = 0;
+	unsigned char end_idx = 0;
+	unsigned char idx = 0;
+	if (median_length == 0) return 0;
+	if (median_length > MATH_MEDIAN_FILTER_LENGTH_MAX) median_length = MATH_MEDIAN_FILTER_LENGTH_MAX;
+	for (idx=0 ; idx<median_length ; idx++) sorted[idx] = data[idx];
+	qsort(sorted, median_length, sizeof(unsigned int), &TEST_MATH_compare);
+	if (average_length == 0) return sorted[median_length / 2];
+	if (average_length > median_length) average_length = median_length;
+	start_idx = (median_length / 2) - (average_length / 2);
+	end_idx = (median_length / 2) + (average_length / 2);
+	if (end_idx >= median_length) end_idx = (median_length - 1);
+	for (idx=start_idx ; idx<=end_idx ; idx++) sum += sorted[idx];
+	return (unsigned int) (sum / (end_idx - start_idx + 1));
+}
+
+/* TEST AVERAGE FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void TEST_MATH_average(void) {
+	// Local variables.
+	unsigned int data[TEST_MATH_AVERAGE_LENGTH_MAX];
+	unsigned long long sum = 0;
+	unsigned int failure_count = test_math_ctx.failure_count;
+	unsigned int window = 0;
+	unsigned char length = 0;
+	unsigned int idx = 0;
+	// Length 0 and 1.
+	data[0] = 0xDEADBEEF;
+	TEST_MATH_check("average length 0", MATH_average(data, 0), 0);
+	TEST_MATH_check("average length 1", MATH_average(data, 1), 0xDEADBEEF);
+	// Maximum length with maximum values (sum does not fit on 32 bits).
+	for (idx=0 ; idx<TEST_MATH_AVERAGE_LENGTH_MAX ; idx++) data[idx] = 0xFFFFFFFF;
+	TEST_MATH_check("average length max", MATH_average(data, TEST_MATH_AVERAGE_LENGTH_MAX), 0xFFFFFFFF);
+	// Random buffers (result is truncated).
+	for (window=0 ; window<TEST_MATH_RANDOM_WINDOWS ; window++) {
+		length = (unsigned char) ((TEST_MATH_random() % TEST_MATH_AVERAGE_LENGTH_MAX) + 1);
+		sum = 0;
+		for (idx=0 ; idx<length ; idx++) {
+			data[idx] = TEST_MATH_random();
+			sum += data[idx];
+		}
+		if (TEST_MATH_check("average random", MATH_average(data, length), (sum / length)) == 0) break;
+	}
+	printf("%s math average\n", (failure_count == test_math_ctx.failure_count) ? "PASS" : "FAIL");
+}
+
+/* TEST MEDIAN FILTER FUNCTION.
+ * @param:	None.
+ * @return:	None.
+ */
+static void TEST_MATH_median_filter(void) {
+	// Local variables.
+	unsigned int data[MATH_MEDIAN_FILTER_LENGTH_MAX + 1];
+	unsigned int copy[MATH_MEDIAN_FILTER_LENGTH_MAX + 1];
+	unsigned int failure_count = test_math_ctx.failure_count;
+	unsigned int window = 0;
+	unsigned char median_length = 0;
+	unsigned char average_length = 0;
+	unsigned char idx = 0;
+	// Length 0 and 1.
+	data[0] = 1234;
+	TEST_MATH_check("median length 0", MATH_median_filter(data, 0, 0), 0);
+	TEST_MATH_check("median length 1", MATH_median_filter(data, 1, 0), 1234);
+	TEST_MATH_check("median length 1 average 1", MATH_median_filter(data, 1, 1), 1234);
+	TEST_MATH_check("median length 1 average clamped", MATH_median_filter(data, 1, 5), 1234);
+	// Maximum length (decreasing values, then all equal) and clamped length.
+	for (idx=0 ; idx<=MATH_MEDIAN_FILTER_LENGTH_MAX ; idx++) data[idx] = (MATH_MEDIAN_FILTER_LENGTH_MAX - idx);
+	TEST_MATH_check("median length max", MATH_median_filter(data, MATH_MEDIAN_FILTER_LENGTH_MAX, 0), TEST_MATH_reference_median_filter(data, MATH_MEDIAN_FILTER_LENGTH_MAX, 0));
+	TEST_MATH_check("median length clamped", MATH_median_filter(data, (MATH_MEDIAN_FILTER_LENGTH_MAX + 1), 0), TEST_MATH_reference_median_filter(data, MATH_MEDIAN_FILTER_LENGTH_MAX, 0));
+	for (idx=0 ; idx<=MATH_MEDIAN_FILTER_LENGTH_MAX ; idx++) data[idx] = 0xFFFFFFFF;
+	TEST_MATH_check("median length max equal values", MATH_median_filter(data, MATH_MEDIAN_FILTER_LENGTH_MAX, MATH_MEDIAN_FILTER_LENGTH_MAX), 0xFFFFFFFF);
+	// Random windows with duplicates, input buffer must not be modified.
+	for (window=0 ; window<TEST_MATH_RANDOM_WINDOWS ; window++) {
+		median_length = (unsigned char) ((TEST_MATH_random() % MATH_MEDIAN_FILTER_LENGTH_MAX) + 1);
+		average_length = (unsigned char) (TEST_MATH_random() % (median_length + 2));
+		for (idx=0 ; idx<median_length ; idx++) {
+			data[idx] = ((window & 0b1) != 0) ? (TEST_MATH_random() % 8) : TEST_MATH_random();
+			copy[idx] = data[idx];
+		}
+		if (TEST_MATH_check("median random", MATH_median_filter(data, median_length, average_length), TEST_MATH_reference_median_filter(copy, median_length, average_length)) == 0) break;
+		for (idx=0 ; idx<median_length ; idx++) {
+			if (TEST_MATH_check("median input buffer", data[idx], copy[idx]) == 0) break;
+		}
+	}
+	printf("%s math median filter\n", (failure_count == test_math_ctx.failure_count) ? "PASS" : "FAIL");
+}
+
+/* CHECK STATISTICS ACCUMULATOR AGAINST EXACT MEAN AND VARIANCE.
+ * @param name:			Test name.
+ * @param statistics:	Accumulator.
+ * @param data:			Samples added to the accumulator.
+ * @param count:		Number of samples.
+ * @return:				None.
+ */
+static void TEST_MATH_check_statistics(char* name, MATH_statistics_t* statistics, unsigned int* data, unsigned int count) {
+	// Local variables.
+	unsigned __int128 sum = 0;
+	unsigned __int128 sum_of_squares = 0;
+	unsigned int min = 0xFFFFFFFF;
+	unsigned int max = 0;
+	unsigned long long expected_mean = 0;
+	unsigned long long expected_variance = 0;
+	unsigned int idx = 0;
+	for (idx=0 ; idx<count ; idx++) {
+		sum += data[idx];
+		sum_of_squares += ((unsigned __int128) data[idx]) * data[idx];
+		if (data[idx] < min) min = data[idx];
+		if (data[idx] > max) max = data[idx];
+	}
+	if (count != 0) {
+		// Population variance (n.sum(x^2) - sum(x)^2) / n^2, truncated.
+		expected_mean = (unsigned long long) (sum / count);
+		expected_variance = (unsigned long long) (((sum_of_squares * count) - (sum * sum)) / (((unsigned __int128) count) * count));
+	}
+	if (TEST_MATH_check(name, MATH_statistics_get_mean(statistics), expected_mean) == 0) return;
+	if (TEST_MATH_check(name, MATH_statistics_get_variance(statistics), expected_variance) == 0) return;
+	if (count == 0) return;
+	if (TEST_MATH_check(name, (statistics -> min), min) == 0) return;
+	TEST_MATH_check(name, (statistics -> max), max);
+}
+
+/* TEST STATISTICS ACCUMULATOR.
+ * @param:	None.
+ * @return:	None.
+ */
+static void TEST_MATH_statistics(void) {
+	// Local variables.
+	static unsigned int data[TEST_MATH_STATISTICS_COUNT_MAX];
+	MATH_statistics_t statistics;
+	unsigned int failure_count = test_math_ctx.failure_count;
+	unsigned int window = 0;
+	unsigned int count = 0;
+	unsigned int idx = 0;
+	// No sample and single sample.
+	MATH_statistics_reset(&statistics);
+	TEST_MATH_check_statistics("statistics count 0", &statistics, data, 0);
+	data[0] = TEST_MATH_SAMPLE_MAX_16BITS;
+	MATH_statistics_add(&statistics, data[0]);
+	TEST_MATH_check_statistics("statistics count 1", &statistics, data, 1);
+	// Small sets where the mean is not an integer.
+	for (window=0 ; window<TEST_MATH_RANDOM_WINDOWS ; window++) {
+		count = (TEST_MATH_random() % 16) + 1;
+		MATH_statistics_reset(&statistics);
+		for (idx=0 ; idx<count ; idx++) {
+			data[idx] = (TEST_MATH_random() % 16);
+			MATH_statistics_add(&statistics, data[idx]);
+		}
+		TEST_MATH_check_statistics("statistics small sets", &statistics, data, count);
+	}
+	// Maximum count with full scale 16-bits samples.
+	MATH_statistics_reset(&statistics);
+	for (idx=0 ; idx<TEST_MATH_STATISTICS_COUNT_MAX ; idx++) {
+		data[idx] = ((idx & 0b1) != 0) ? TEST_MATH_SAMPLE_MAX_16BITS : (TEST_MATH_random() & TEST_MATH_SAMPLE_MAX_16BITS);
+		MATH_statistics_add(&statistics, data[idx]);
+	}
+	TEST_MATH_check_statistics("statistics count max", &statistics, data, TEST_MATH_STATISTICS_COUNT_MAX);
+	printf("%s math statistics\n", (failure_count == test_math_ctx.failure_count) ? "PASS" : "FAIL");
+}
+
+/*** TEST MATH functions ***/
+
+/* MAIN FUNCTION.
+ * @param:	None.
+ * @return:	0 if all tests passed, 1 otherwise.
+ */
+int main(void) {
+	TEST_MATH_average();
+	TEST_MATH_median_filter();
+	TEST_MATH_statistics();
+	return ((test_math_ctx.failure_count == 0) ? 0 : 1);
+}
+
+#endif /* HOST */